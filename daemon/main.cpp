@@ -141,8 +141,8 @@ main(int argc, char *argv[])
 
     if(!result["colour"].as< bool >())
     {
-      llarp::LogContext::Instance().logStream =
-          std::make_unique< llarp::OStreamLogStream >(false, std::cerr);
+      llarp::LogContext::Instance().SetLogStream(
+          std::make_unique< llarp::OStreamLogStream >(false, std::cerr));
     }
 
     if(result.count("help"))
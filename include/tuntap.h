@@ -108,6 +108,8 @@ typedef struct in6_addr t_tun_in6_addr;
 #define TUNTAP_MODE_ETHERNET 0x0001
 #define TUNTAP_MODE_TUNNEL 0x0002
 #define TUNTAP_MODE_PERSIST 0x0004
+/* linux only: virtio net headers on every packet, with tso and csum offload */
+#define TUNTAP_MODE_VNET_HDR 0x0008
 
 #define TUNTAP_LOG_NONE 0x0000
 #define TUNTAP_LOG_DEBUG 0x0001
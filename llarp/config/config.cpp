@@ -175,6 +175,24 @@ namespace llarp
     {
       m_blockBogons = setOptBool(val);
     }
+    if(key == "udp-batching")
+    {
+      m_udpBatching = IsTrueValue(val);
+      LogInfo("batched udp io ", m_udpBatching ? "enabled" : "disabled");
+    }
+    if(key == "link-shards")
+    {
+      m_linkShards = svtoi(val);
+      if(m_linkShards <= 0)
+      {
+        LogWarn("link shards invalid value: '", val, "' defaulting to 1");
+        m_linkShards = 1;
+      }
+      else
+      {
+        LogDebug("set to use ", m_linkShards, " udp shards per link");
+      }
+    }
   }
 
   void
@@ -393,7 +411,7 @@ namespace llarp
       LogError("syslog not supported on win32");
 #else
       LogInfo("Switching to syslog");
-      LogContext::Instance().logStream = std::make_unique< SysLogStream >();
+      LogContext::Instance().SetLogStream(std::make_unique< SysLogStream >());
 #endif
     }
     if(key == "type" && val == "json")
@@ -608,6 +626,8 @@ llarp_generic_ensure_config(std::ofstream &f, std::string basepath,
   f << "# hard limit of routers globally we are connected to at any given "
        "time\n";
   f << "max-routers=" << std::to_string(limits.DefaultMaxRouters) << std::endl;
+  f << "# uncomment to move udp datagrams in batches (linux only)\n";
+  f << "#udp-batching=true\n";
   f << "\n\n";
 
   // logging
@@ -125,6 +125,10 @@ namespace llarp
 
     std::string m_DefaultLinkProto = "iwp";
 
+    bool m_udpBatching = false;
+
+    int m_linkShards = 1;
+
    public:
     // clang-format off
     size_t jobQueueSize() const                { return fromEnv(m_JobQueueSize, "JOB_QUEUE_SIZE"); }
@@ -143,6 +147,8 @@ namespace llarp
     int numNetThreads() const                  { return fromEnv(m_numNetThreads, "NUM_NET_THREADS"); }
     std::string defaultLinkProto() const       { return fromEnv(m_DefaultLinkProto, "LINK_PROTO"); }
     absl::optional< bool > blockBogons() const { return fromEnv(m_blockBogons, "BLOCK_BOGONS"); }
+    bool udpBatching() const                   { return fromEnv(m_udpBatching, "UDP_BATCHING"); }
+    int linkShards() const                     { return fromEnv(m_linkShards, "LINK_SHARDS"); }
     // clang-format on
 
     void
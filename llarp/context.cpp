@@ -154,6 +154,10 @@ __        ___    ____  _   _ ___ _   _  ____
 
     m_metricsPublisher->setDefault(absl::Seconds(30));
 
+    // made before there was a manager to register with
+    if(logic)
+      logic->EnableMetrics();
+
     m_scheduler->start();
   }
 
@@ -20,6 +20,26 @@
 
 namespace llarp
 {
+  /// one in place xchacha20 operation for Crypto::xchacha20_batch
+  struct XChaCha20Job
+  {
+    byte_t *buf;
+    size_t sz;
+    const SharedSecret *key;
+    TunnelNonce nonce;
+  };
+
+  /// one ed25519 signature check for Crypto::verify_batch
+  struct VerifyJob
+  {
+    const PubKey *signer;
+    const byte_t *data;
+    size_t size;
+    const Signature *sig;
+    /// set by verify_batch
+    bool valid;
+  };
+
   /// library crypto configuration
   struct Crypto
   {
@@ -35,6 +55,11 @@ namespace llarp
     xchacha20_alt(const llarp_buffer_t &, const llarp_buffer_t &,
                   const SharedSecret &, const byte_t *) = 0;
 
+    /// xchacha symmetric cipher applied in place to n buffers at once, the
+    /// same buffer may show up in more than one job
+    virtual bool
+    xchacha20_batch(XChaCha20Job *jobs, size_t n) = 0;
+
     /// path dh creator's side
     virtual bool
     dh_client(SharedSecret &, const PubKey &, const SecretKey &,
@@ -63,6 +88,12 @@ namespace llarp
     /// ed25519 verify
     virtual bool
     verify(const PubKey &, const llarp_buffer_t &, const Signature &) = 0;
+    /// ed25519 verify n signatures in one call, sets valid on every job and
+    /// returns true if they all are. a backend that checks the batch as a
+    /// whole must still check the jobs one at a time when it fails, so that
+    /// one bad signature doesn't fail the rest
+    virtual bool
+    verify_batch(VerifyJob *jobs, size_t n) = 0;
     /// seed to secretkey
     virtual bool
     seed_to_secretkey(llarp::SecretKey &, const llarp::IdentitySecret &) = 0;
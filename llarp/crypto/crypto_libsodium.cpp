@@ -1,4 +1,6 @@
 #include <crypto/crypto_libsodium.hpp>
+#include <crypto/ed25519_batch.hpp>
+#include <crypto/xchacha20_avx2.hpp>
 #include <sodium/crypto_generichash.h>
 #include <sodium/crypto_sign.h>
 #include <sodium/crypto_scalarmult.h>
@@ -81,6 +83,7 @@ namespace llarp
       else
       {
         ntru_init(0);
+        m_BatchAVX2 = xchacha20_avx2_supported();
       }
       int seed = 0;
       randombytes(reinterpret_cast< unsigned char * >(&seed), sizeof(seed));
@@ -107,6 +110,25 @@ namespace llarp
           == 0;
     }
 
+    bool
+    CryptoLibSodium::xchacha20_batch(XChaCha20Job *jobs, size_t n)
+    {
+      if(m_BatchAVX2 && n > 1)
+      {
+        xchacha20_avx2(jobs, n);
+        return true;
+      }
+      for(size_t idx = 0; idx < n; ++idx)
+      {
+        const auto &job = jobs[idx];
+        if(crypto_stream_xchacha20_xor(job.buf, job.buf, job.sz,
+                                       job.nonce.data(), job.key->data())
+           != 0)
+          return false;
+      }
+      return true;
+    }
+
     bool
     CryptoLibSodium::dh_client(llarp::SharedSecret &shared, const PubKey &pk,
                                const SecretKey &sk, const TunnelNonce &n)
@@ -180,6 +202,12 @@ namespace llarp
           != -1;
     }
 
+    bool
+    CryptoLibSodium::verify_batch(VerifyJob *jobs, size_t n)
+    {
+      return ed25519_verify_batch(jobs, n);
+    }
+
     bool
     CryptoLibSodium::seed_to_secretkey(llarp::SecretKey &secret,
                                        const llarp::IdentitySecret &seed)
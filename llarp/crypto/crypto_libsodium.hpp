@@ -23,6 +23,10 @@ namespace llarp
       xchacha20_alt(const llarp_buffer_t &, const llarp_buffer_t &,
                     const SharedSecret &, const byte_t *) override;
 
+      /// xchacha symmetric cipher (batched, in place)
+      bool
+      xchacha20_batch(XChaCha20Job *jobs, size_t n) override;
+
       /// path dh creator's side
       bool
       dh_client(SharedSecret &, const PubKey &, const SecretKey &,
@@ -52,6 +56,9 @@ namespace llarp
       bool
       verify(const PubKey &, const llarp_buffer_t &,
              const Signature &) override;
+      /// ed25519 verify many
+      bool
+      verify_batch(VerifyJob *jobs, size_t n) override;
 
       /// seed to secretkey
       bool
@@ -82,6 +89,10 @@ namespace llarp
 
       bool
       check_identity_privkey(const SecretKey &) override;
+
+     private:
+      /// use the multi buffer avx2 xchacha20 for batches
+      bool m_BatchAVX2 = false;
     };
   }  // namespace sodium
 
@@ -42,6 +42,12 @@ namespace llarp
       return true;
     }
 
+    bool
+    xchacha20_batch(XChaCha20Job *, size_t) override
+    {
+      return true;
+    }
+
     bool
     dh_client(SharedSecret &shared, const PubKey &pk, const SecretKey &,
               const TunnelNonce &) override
@@ -119,6 +125,14 @@ namespace llarp
       return true;
     }
 
+    bool
+    verify_batch(VerifyJob *jobs, size_t n) override
+    {
+      for(size_t idx = 0; idx < n; ++idx)
+        jobs[idx].valid = true;
+      return true;
+    }
+
     bool
     seed_to_secretkey(SecretKey &key, const IdentitySecret &secret) override
     {
@@ -0,0 +1,740 @@
+#include <crypto/ed25519_batch.hpp>
+
+#include <sodium/crypto_hash_sha512.h>
+#include <sodium/crypto_sign.h>
+#include <sodium/randombytes.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SIZEOF_INT128__)
+#define LLARP_ED25519_BATCH 1
+#endif
+
+namespace llarp
+{
+  namespace sodium
+  {
+    static bool
+    VerifyEach(VerifyJob *jobs, size_t n)
+    {
+      bool all = true;
+      for(size_t idx = 0; idx < n; ++idx)
+      {
+        auto &job = jobs[idx];
+        job.valid = crypto_sign_verify_detached(job.sig->data(), job.data,
+                                                job.size, job.signer->data())
+            != -1;
+        all &= job.valid;
+      }
+      return all;
+    }
+
+#ifdef LLARP_ED25519_BATCH
+    // everything below only ever sees public values, so none of it is
+    // constant time
+
+    using u64  = uint64_t;
+    using u128 = unsigned __int128;
+
+    /// fewer than this are quicker one at a time
+    static constexpr size_t BatchMin = 4;
+    /// most jobs checked together, so one bad signature only sends this many
+    /// back through libsodium
+    static constexpr size_t BatchMax = 64;
+
+    static inline u64
+    Load64(const byte_t *p)
+    {
+      u64 r = 0;
+      for(int idx = 7; idx >= 0; --idx)
+        r = (r << 8) | p[idx];
+      return r;
+    }
+
+    static inline void
+    Store64(byte_t *p, u64 v)
+    {
+      for(int idx = 0; idx < 8; ++idx, v >>= 8)
+        p[idx] = byte_t(v);
+    }
+
+    // field elements mod 2^255 - 19 in five 51 bit limbs. every function
+    // hands back limbs below 2^52, which is what Mul and Sq count on.
+
+    static constexpr u64 Mask51 = (u64(1) << 51) - 1;
+
+    struct Fe
+    {
+      u64 v[5];
+    };
+
+    static inline void
+    Carry(Fe &h)
+    {
+      h.v[1] += h.v[0] >> 51;
+      h.v[0] &= Mask51;
+      h.v[2] += h.v[1] >> 51;
+      h.v[1] &= Mask51;
+      h.v[3] += h.v[2] >> 51;
+      h.v[2] &= Mask51;
+      h.v[4] += h.v[3] >> 51;
+      h.v[3] &= Mask51;
+      h.v[0] += 19 * (h.v[4] >> 51);
+      h.v[4] &= Mask51;
+    }
+
+    static inline Fe
+    Add(const Fe &f, const Fe &g)
+    {
+      Fe h;
+      for(int idx = 0; idx < 5; ++idx)
+        h.v[idx] = f.v[idx] + g.v[idx];
+      Carry(h);
+      return h;
+    }
+
+    /// f - g, with 4p added so no limb goes negative
+    static inline Fe
+    Sub(const Fe &f, const Fe &g)
+    {
+      Fe h;
+      h.v[0] = (f.v[0] + 0x1FFFFFFFFFFFB4ULL) - g.v[0];
+      for(int idx = 1; idx < 5; ++idx)
+        h.v[idx] = (f.v[idx] + 0x1FFFFFFFFFFFFCULL) - g.v[idx];
+      Carry(h);
+      return h;
+    }
+
+    static inline Fe
+    Neg(const Fe &f)
+    {
+      return Sub(Fe{{0, 0, 0, 0, 0}}, f);
+    }
+
+    static inline Fe
+    Reduce(u128 r0, u128 r1, u128 r2, u128 r3, u128 r4)
+    {
+      Fe h;
+      r1 += u64(r0 >> 51);
+      h.v[0] = u64(r0) & Mask51;
+      r2 += u64(r1 >> 51);
+      h.v[1] = u64(r1) & Mask51;
+      r3 += u64(r2 >> 51);
+      h.v[2] = u64(r2) & Mask51;
+      r4 += u64(r3 >> 51);
+      h.v[3] = u64(r3) & Mask51;
+      h.v[0] += 19 * u64(r4 >> 51);
+      h.v[4] = u64(r4) & Mask51;
+      h.v[1] += h.v[0] >> 51;
+      h.v[0] &= Mask51;
+      return h;
+    }
+
+    static inline Fe
+    Mul(const Fe &f, const Fe &g)
+    {
+      const u64 f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3],
+                f4 = f.v[4];
+      const u64 g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3],
+                g4 = g.v[4];
+      const u64 g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3,
+                g4_19 = 19 * g4;
+      return Reduce(u128(f0) * g0 + u128(f1) * g4_19 + u128(f2) * g3_19
+                        + u128(f3) * g2_19 + u128(f4) * g1_19,
+                    u128(f0) * g1 + u128(f1) * g0 + u128(f2) * g4_19
+                        + u128(f3) * g3_19 + u128(f4) * g2_19,
+                    u128(f0) * g2 + u128(f1) * g1 + u128(f2) * g0
+                        + u128(f3) * g4_19 + u128(f4) * g3_19,
+                    u128(f0) * g3 + u128(f1) * g2 + u128(f2) * g1
+                        + u128(f3) * g0 + u128(f4) * g4_19,
+                    u128(f0) * g4 + u128(f1) * g3 + u128(f2) * g2
+                        + u128(f3) * g1 + u128(f4) * g0);
+    }
+
+    static inline Fe
+    Sq(const Fe &f)
+    {
+      const u64 f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3],
+                f4 = f.v[4];
+      const u64 d0 = 2 * f0, d1 = 2 * f1, d2 = 2 * f2, d3 = 2 * f3;
+      const u64 f3_19 = 19 * f3, f4_19 = 19 * f4;
+      return Reduce(u128(f0) * f0 + u128(d1) * f4_19 + u128(d2) * f3_19,
+                    u128(d0) * f1 + u128(d2) * f4_19 + u128(f3) * f3_19,
+                    u128(d0) * f2 + u128(f1) * f1 + u128(d3) * f4_19,
+                    u128(d0) * f3 + u128(d1) * f2 + u128(f4) * f4_19,
+                    u128(d0) * f4 + u128(d1) * f3 + u128(f2) * f2);
+    }
+
+    static inline Fe
+    Sqn(Fe f, int n)
+    {
+      while(n-- > 0)
+        f = Sq(f);
+      return f;
+    }
+
+    /// low 255 bits, may not be fully reduced
+    static Fe
+    FromBytes(const byte_t *s)
+    {
+      return Fe{{Load64(s) & Mask51, (Load64(s + 6) >> 3) & Mask51,
+                 (Load64(s + 12) >> 6) & Mask51, (Load64(s + 19) >> 1) & Mask51,
+                 (Load64(s + 24) >> 12) & Mask51}};
+    }
+
+    /// canonical little endian encoding
+    static void
+    ToBytes(byte_t *s, Fe t)
+    {
+      Carry(t);
+      Carry(t);
+      // now below 2^255, add 19 and see if that carries past 2^255
+      t.v[0] += 19;
+      Carry(t);
+      // subtract the 19 again, or p if it did carry (the borrow off the top
+      // is the 2^255 we dropped)
+      t.v[0] += (u64(1) << 51) - 19;
+      for(int idx = 1; idx < 5; ++idx)
+        t.v[idx] += (u64(1) << 51) - 1;
+      for(int idx = 0; idx < 4; ++idx)
+      {
+        t.v[idx + 1] += t.v[idx] >> 51;
+        t.v[idx] &= Mask51;
+      }
+      t.v[4] &= Mask51;
+      Store64(s, t.v[0] | (t.v[1] << 51));
+      Store64(s + 8, (t.v[1] >> 13) | (t.v[2] << 38));
+      Store64(s + 16, (t.v[2] >> 26) | (t.v[3] << 25));
+      Store64(s + 24, (t.v[3] >> 39) | (t.v[4] << 12));
+    }
+
+    static bool
+    IsZero(const Fe &f)
+    {
+      byte_t s[32];
+      ToBytes(s, f);
+      return std::all_of(s, s + 32, [](byte_t b) { return b == 0; });
+    }
+
+    static bool
+    IsNegative(const Fe &f)
+    {
+      byte_t s[32];
+      ToBytes(s, f);
+      return s[0] & 1;
+    }
+
+    /// z^(2^250 - 1), and z^11 on the way
+    static Fe
+    Pow2250m1(const Fe &z, Fe &z11)
+    {
+      const Fe z2 = Sq(z);
+      const Fe z9 = Mul(Sqn(z2, 2), z);
+      z11         = Mul(z9, z2);
+      const Fe t5   = Mul(Sq(z11), z9);
+      const Fe t10  = Mul(Sqn(t5, 5), t5);
+      const Fe t20  = Mul(Sqn(t10, 10), t10);
+      const Fe t40  = Mul(Sqn(t20, 20), t20);
+      const Fe t50  = Mul(Sqn(t40, 10), t10);
+      const Fe t100 = Mul(Sqn(t50, 50), t50);
+      const Fe t200 = Mul(Sqn(t100, 100), t100);
+      return Mul(Sqn(t200, 50), t50);
+    }
+
+    /// z^(p - 2)
+    static Fe
+    Invert(const Fe &z)
+    {
+      Fe z11;
+      const Fe t = Pow2250m1(z, z11);
+      return Mul(Sqn(t, 5), z11);
+    }
+
+    /// z^((p - 5) / 8)
+    static Fe
+    Pow22523(const Fe &z)
+    {
+      Fe z11;
+      return Mul(Sqn(Pow2250m1(z, z11), 2), z);
+    }
+
+    // points on -x^2 + y^2 = 1 + d x^2 y^2 in extended coordinates,
+    // x = X/Z, y = Y/Z, T = XY/Z
+
+    struct Point
+    {
+      Fe X, Y, Z, T;
+    };
+
+    /// a point readied for adding, (Y+X, Y-X, 2Z, 2dT)
+    struct Cached
+    {
+      Fe YplusX, YminusX, Z2, T2d;
+    };
+
+    static constexpr Fe FeOne = {{1, 0, 0, 0, 0}};
+
+    static const Point Identity = {{{0, 0, 0, 0, 0}}, FeOne, FeOne,
+                                   {{0, 0, 0, 0, 0}}};
+
+    /// odd multiples P, 3P .. 15P of a point, for window 5 wNAF digits
+    static constexpr size_t TableSize = 8;
+
+    struct Curve
+    {
+      Fe d, d2, sqrtm1;
+      Cached base[TableSize];
+
+      Curve();
+
+      static const Curve &
+      Get()
+      {
+        static const Curve curve;
+        return curve;
+      }
+    };
+
+    static Cached
+    ToCached(const Point &p, const Fe &d2)
+    {
+      return Cached{Add(p.Y, p.X), Sub(p.Y, p.X), Add(p.Z, p.Z),
+                    Mul(p.T, d2)};
+    }
+
+    /// p + q, or p - q if negate (add-2008-hwcd-3)
+    static Point
+    AddCached(const Point &p, const Cached &q, bool negate)
+    {
+      const Fe a = Mul(Sub(p.Y, p.X), negate ? q.YplusX : q.YminusX);
+      const Fe b = Mul(Add(p.Y, p.X), negate ? q.YminusX : q.YplusX);
+      const Fe c = Mul(p.T, q.T2d);
+      const Fe d = Mul(p.Z, q.Z2);
+      const Fe e = Sub(b, a);
+      const Fe f = negate ? Add(d, c) : Sub(d, c);
+      const Fe g = negate ? Sub(d, c) : Add(d, c);
+      const Fe h = Add(b, a);
+      return Point{Mul(e, f), Mul(g, h), Mul(f, g), Mul(e, h)};
+    }
+
+    /// 2p (dbl-2008-hwcd)
+    static Point
+    Double(const Point &p)
+    {
+      const Fe a  = Sq(p.X);
+      const Fe b  = Sq(p.Y);
+      const Fe zz = Sq(p.Z);
+      const Fe c  = Add(zz, zz);
+      const Fe ab = Add(a, b);
+      const Fe e  = Sub(Sq(Add(p.X, p.Y)), ab);
+      const Fe g  = Sub(b, a);
+      const Fe f  = Sub(g, c);
+      const Fe h  = Neg(ab);
+      return Point{Mul(e, f), Mul(g, h), Mul(f, g), Mul(e, h)};
+    }
+
+    static bool
+    IsIdentity(const Point &p)
+    {
+      return IsZero(p.X) && IsZero(Sub(p.Y, p.Z));
+    }
+
+    static bool
+    HasSmallOrder(const Point &p)
+    {
+      return IsIdentity(Double(Double(Double(p))));
+    }
+
+    /// decode a point, false if it isn't one or isn't canonically encoded
+    static bool
+    Decompress(Point &p, const byte_t *s, const Curve &curve)
+    {
+      const Fe y = FromBytes(s);
+      byte_t check[32];
+      ToBytes(check, y);
+      if(std::memcmp(check, s, 31) != 0 || check[31] != (s[31] & 0x7f))
+        return false;
+      const Fe y2 = Sq(y);
+      const Fe u  = Sub(y2, FeOne);
+      const Fe v  = Add(Mul(y2, curve.d), FeOne);
+      const Fe v3 = Mul(Sq(v), v);
+      const Fe v7 = Mul(Sq(v3), v);
+      // x = u v^3 (u v^7)^((p - 5) / 8) is sqrt(u / v) or sqrt(-u / v)
+      Fe x = Mul(Mul(Pow22523(Mul(u, v7)), u), v3);
+
+      const Fe vx2 = Mul(v, Sq(x));
+      if(!IsZero(Sub(vx2, u)))
+      {
+        if(!IsZero(Add(vx2, u)))
+          return false;
+        x = Mul(x, curve.sqrtm1);
+      }
+      const bool sign = s[31] >> 7;
+      if(sign && IsZero(x))
+        return false;
+      if(IsNegative(x) != sign)
+        x = Neg(x);
+      p = Point{x, y, FeOne, Mul(x, y)};
+      return true;
+    }
+
+    /// P, 3P .. 15P
+    static void
+    OddMultiples(Cached *table, const Point &p, const Fe &d2)
+    {
+      const Cached twice = ToCached(Double(p), d2);
+      Point multiple     = p;
+      table[0]           = ToCached(multiple, d2);
+      for(size_t idx = 1; idx < TableSize; ++idx)
+      {
+        multiple   = AddCached(multiple, twice, false);
+        table[idx] = ToCached(multiple, d2);
+      }
+    }
+
+    Curve::Curve()
+    {
+      // d = -121665 / 121666
+      d  = Mul(Neg(Fe{{121665, 0, 0, 0, 0}}), Invert(Fe{{121666, 0, 0, 0, 0}}));
+      d2 = Add(d, d);
+      // sqrt(-1) = 2^((p - 1) / 4), (p - 1) / 4 = 2^253 - 5
+      const Fe two = {{2, 0, 0, 0, 0}};
+      Fe unused;
+      sqrtm1 = Mul(Sqn(Pow2250m1(two, unused), 3), Mul(Sq(two), two));
+      // the base point is the one with y = 4/5 and x even
+      byte_t encoded[32];
+      ToBytes(encoded, Mul(Fe{{4, 0, 0, 0, 0}}, Invert(Fe{{5, 0, 0, 0, 0}})));
+      Point b;
+      Decompress(b, encoded, *this);
+      OddMultiples(base, b, d2);
+    }
+
+    // scalars mod the group order
+    // L = 2^252 + 27742317777372353535851937790883648493
+    // in four 64 bit limbs
+
+    struct Scalar
+    {
+      u64 v[4];
+    };
+
+    static constexpr Scalar Order = {{0x5812631a5cf5d3edULL,
+                                      0x14def9dea2f79cd6ULL, 0,
+                                      0x1000000000000000ULL}};
+
+    static Scalar
+    LoadScalar(const byte_t *s)
+    {
+      return Scalar{{Load64(s), Load64(s + 8), Load64(s + 16), Load64(s + 24)}};
+    }
+
+    static bool
+    BelowOrder(const Scalar &a)
+    {
+      for(int idx = 3; idx >= 0; --idx)
+      {
+        if(a.v[idx] != Order.v[idx])
+          return a.v[idx] < Order.v[idx];
+      }
+      return false;
+    }
+
+    static void
+    SubOrder(Scalar &a)
+    {
+      u64 borrow = 0;
+      for(int idx = 0; idx < 4; ++idx)
+      {
+        const u128 diff = u128(a.v[idx]) - Order.v[idx] - borrow;
+        a.v[idx]        = u64(diff);
+        borrow          = u64(diff >> 64) & 1;
+      }
+    }
+
+    /// a + b for a, b < L
+    static Scalar
+    AddMod(const Scalar &a, const Scalar &b)
+    {
+      Scalar r;
+      u64 carry = 0;
+      for(int idx = 0; idx < 4; ++idx)
+      {
+        const u128 sum = u128(a.v[idx]) + b.v[idx] + carry;
+        r.v[idx]       = u64(sum);
+        carry          = u64(sum >> 64);
+      }
+      if(!BelowOrder(r))
+        SubOrder(r);
+      return r;
+    }
+
+    static Scalar
+    NegMod(const Scalar &a)
+    {
+      Scalar r   = Order;
+      u64 borrow = 0;
+      for(int idx = 0; idx < 4; ++idx)
+      {
+        const u128 diff = u128(r.v[idx]) - a.v[idx] - borrow;
+        r.v[idx]        = u64(diff);
+        borrow          = u64(diff >> 64) & 1;
+      }
+      return BelowOrder(r) ? r : Scalar{{0, 0, 0, 0}};
+    }
+
+    /// constants for montgomery multiplication mod L, R = 2^256
+    struct Montgomery
+    {
+      /// -1/L mod 2^64
+      u64 inv;
+      /// R^2 mod L
+      Scalar rr;
+
+      Montgomery()
+      {
+        u64 x = Order.v[0];
+        for(int idx = 0; idx < 5; ++idx)
+          x *= 2 - Order.v[0] * x;
+        inv = -x;
+        rr  = Scalar{{1, 0, 0, 0}};
+        for(int idx = 0; idx < 512; ++idx)
+          rr = AddMod(rr, rr);
+      }
+
+      static const Montgomery &
+      Get()
+      {
+        static const Montgomery mont;
+        return mont;
+      }
+
+      /// a * b / R mod L, for any a and b < L
+      Scalar
+      Mul(const Scalar &a, const Scalar &b) const
+      {
+        u64 t[6] = {0, 0, 0, 0, 0, 0};
+        for(int i = 0; i < 4; ++i)
+        {
+          u64 carry = 0;
+          for(int j = 0; j < 4; ++j)
+          {
+            const u128 s = u128(a.v[j]) * b.v[i] + t[j] + carry;
+            t[j]         = u64(s);
+            carry        = u64(s >> 64);
+          }
+          u128 s = u128(t[4]) + carry;
+          t[4]   = u64(s);
+          t[5]   = u64(s >> 64);
+
+          const u64 m = t[0] * inv;
+          s           = u128(m) * Order.v[0] + t[0];
+          carry       = u64(s >> 64);
+          for(int j = 1; j < 4; ++j)
+          {
+            s        = u128(m) * Order.v[j] + t[j] + carry;
+            t[j - 1] = u64(s);
+            carry    = u64(s >> 64);
+          }
+          s    = u128(t[4]) + carry;
+          t[3] = u64(s);
+          t[4] = t[5] + u64(s >> 64);
+        }
+        // below 2L, which is below 2^254
+        Scalar r{{t[0], t[1], t[2], t[3]}};
+        if(!BelowOrder(r))
+          SubOrder(r);
+        return r;
+      }
+    };
+
+    /// a * b mod L for a, b < L
+    static Scalar
+    MulMod(const Scalar &a, const Scalar &b)
+    {
+      const auto &mont = Montgomery::Get();
+      return mont.Mul(mont.Mul(a, b), mont.rr);
+    }
+
+    /// 512 bit little endian number mod L
+    static Scalar
+    ReduceWide(const byte_t *s)
+    {
+      Scalar lo = LoadScalar(s);
+      while(!BelowOrder(lo))
+        SubOrder(lo);
+      const auto &mont = Montgomery::Get();
+      // hi * 2^256 = hi * R^2 / R
+      return AddMod(lo, mont.Mul(LoadScalar(s + 32), mont.rr));
+    }
+
+    /// window 5 wNAF of a scalar below 2^253, odd digits in -15..15
+    static void
+    Slide(int8_t *r, const Scalar &a)
+    {
+      for(int idx = 0; idx < 256; ++idx)
+        r[idx] = (a.v[idx / 64] >> (idx % 64)) & 1;
+      for(int idx = 0; idx < 256; ++idx)
+      {
+        if(!r[idx])
+          continue;
+        for(int b = 1; b <= 6 && idx + b < 256; ++b)
+        {
+          if(!r[idx + b])
+            continue;
+          if(r[idx] + (r[idx + b] << b) <= 15)
+          {
+            r[idx] += r[idx + b] << b;
+            r[idx + b] = 0;
+          }
+          else if(r[idx] - (r[idx + b] << b) >= -15)
+          {
+            r[idx] -= r[idx + b] << b;
+            for(int k = idx + b; k < 256; ++k)
+            {
+              if(!r[k])
+              {
+                r[k] = 1;
+                break;
+              }
+              r[k] = 0;
+            }
+          }
+          else
+            break;
+        }
+      }
+    }
+
+    /// jobs that take part in one check, the points and scalars of
+    /// sum z_i*R_i + sum z_i*h_i*A_i - (sum z_i*S_i)*B
+    struct Batch
+    {
+      std::vector< size_t > jobs;
+      std::vector< Cached > tables;
+      std::vector< int8_t > digits;
+      Scalar sumS{{0, 0, 0, 0}};
+
+      void
+      AddTerm(const Point &p, const Scalar &s, const Curve &curve)
+      {
+        tables.resize(tables.size() + TableSize);
+        OddMultiples(tables.data() + tables.size() - TableSize, p, curve.d2);
+        digits.resize(digits.size() + 256);
+        Slide(digits.data() + digits.size() - 256, s);
+      }
+
+      /// true if the sum, times the cofactor, is the identity
+      bool
+      Check(const Curve &curve)
+      {
+        const size_t terms = tables.size() / TableSize;
+        int8_t baseDigits[256];
+        Slide(baseDigits, NegMod(sumS));
+        Point acc = Identity;
+        for(int bit = 255; bit >= 0; --bit)
+        {
+          acc = Double(acc);
+          const int8_t digit = baseDigits[bit];
+          if(digit)
+            acc = AddCached(acc, curve.base[std::abs(digit) / 2], digit < 0);
+          for(size_t term = 0; term < terms; ++term)
+          {
+            const int8_t d = digits[term * 256 + bit];
+            if(d)
+              acc = AddCached(acc, tables[term * TableSize + std::abs(d) / 2],
+                              d < 0);
+          }
+        }
+        return HasSmallOrder(acc);
+      }
+    };
+
+    static bool
+    VerifyChunk(VerifyJob *jobs, size_t n)
+    {
+      const Curve &curve = Curve::Get();
+      std::vector< u64 > weights(2 * n);
+      randombytes_buf(weights.data(), weights.size() * sizeof(u64));
+
+      Batch batch;
+      batch.jobs.reserve(n);
+      batch.tables.reserve(2 * n * TableSize);
+      batch.digits.reserve(2 * n * 256);
+      bool all = true;
+      for(size_t idx = 0; idx < n; ++idx)
+      {
+        auto &job          = jobs[idx];
+        const byte_t *sig  = job.sig->data();
+        const byte_t *key  = job.signer->data();
+        const Scalar s     = LoadScalar(sig + 32);
+        Point r, a;
+        // anything libsodium might see differently is left to libsodium
+        if(!BelowOrder(s) || !Decompress(r, sig, curve)
+           || !Decompress(a, key, curve) || HasSmallOrder(r)
+           || HasSmallOrder(a))
+        {
+          all &= VerifyEach(&job, 1);
+          continue;
+        }
+        byte_t digest[64];
+        crypto_hash_sha512_state hash;
+        crypto_hash_sha512_init(&hash);
+        crypto_hash_sha512_update(&hash, sig, 32);
+        crypto_hash_sha512_update(&hash, key, 32);
+        crypto_hash_sha512_update(&hash, job.data, job.size);
+        crypto_hash_sha512_final(&hash, digest);
+        // 128 random bits, never zero
+        const Scalar z{{weights[2 * idx] | 1, weights[2 * idx + 1], 0, 0}};
+        batch.AddTerm(r, z, curve);
+        batch.AddTerm(a, MulMod(z, ReduceWide(digest)), curve);
+        batch.sumS = AddMod(batch.sumS, MulMod(z, s));
+        batch.jobs.push_back(idx);
+      }
+      if(batch.jobs.empty())
+        return all;
+      if(batch.Check(curve))
+      {
+        for(const size_t idx : batch.jobs)
+          jobs[idx].valid = true;
+        return all;
+      }
+      // at least one is bad, find out which
+      for(const size_t idx : batch.jobs)
+        all &= VerifyEach(&jobs[idx], 1);
+      return all;
+    }
+
+    bool
+    ed25519_verify_batch_supported()
+    {
+      return true;
+    }
+
+    bool
+    ed25519_verify_batch(VerifyJob *jobs, size_t n)
+    {
+      if(n < BatchMin)
+        return VerifyEach(jobs, n);
+      bool all = true;
+      for(size_t idx = 0; idx < n; idx += BatchMax)
+        all &= VerifyChunk(jobs + idx, std::min(BatchMax, n - idx));
+      return all;
+    }
+#else
+    bool
+    ed25519_verify_batch_supported()
+    {
+      return false;
+    }
+
+    bool
+    ed25519_verify_batch(VerifyJob *jobs, size_t n)
+    {
+      return VerifyEach(jobs, n);
+    }
+#endif
+  }  // namespace sodium
+}  // namespace llarp
@@ -0,0 +1,29 @@
+#ifndef LLARP_CRYPTO_ED25519_BATCH_HPP
+#define LLARP_CRYPTO_ED25519_BATCH_HPP
+
+#include <crypto/crypto.hpp>
+
+namespace llarp
+{
+  namespace sodium
+  {
+    /// true if this build has the 128 bit multiplies ed25519_verify_batch
+    /// needs, without them it checks each job with libsodium
+    bool
+    ed25519_verify_batch_supported();
+
+    /// verify n ed25519 signatures with one randomized multi scalar check
+    /// (z_i random: 8 * (sum z_i*S_i*B - sum z_i*R_i - sum z_i*h_i*A_i) == 0)
+    /// and check the jobs one at a time with crypto_sign_verify_detached only
+    /// when that fails, or for a job too odd to take part in it. sets valid on
+    /// every job and returns true if they all are.
+    ///
+    /// unlike libsodium the check is cofactored, so a signature whose R or
+    /// key has a small order part may pass here and fail there. only the
+    /// holder of the key can make one, it doesn't let anyone else forge.
+    bool
+    ed25519_verify_batch(VerifyJob *jobs, size_t n);
+  }  // namespace sodium
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,91 @@
+#include <crypto/signature_cache.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  constexpr size_t SignatureCache::DefaultCapacity;
+  constexpr size_t SignatureCache::NumShards;
+
+  SignatureCache::SignatureCache(size_t capacity)
+      : m_ShardCapacity(std::max< size_t >(1, capacity / NumShards))
+  {
+  }
+
+  SignatureCache::Shard&
+  SignatureCache::ShardFor(const Key& k)
+  {
+    // the hash takes the front of the signature, shard by the back
+    return m_Shards[k.sig[k.sig.size() - 1] % NumShards];
+  }
+
+  bool
+  SignatureCache::Check(const PubKey& signer, const Signature& sig,
+                        const ShortHash& digest, llarp_time_t now)
+  {
+    const Key k{signer, sig, digest};
+    auto& shard = ShardFor(k);
+    {
+      util::Lock lock(&shard.mutex);
+      auto itr = shard.entries.find(k);
+      if(itr != shard.entries.end())
+      {
+        if(now < itr->second)
+        {
+          m_Hits.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+        shard.entries.erase(itr);
+      }
+    }
+    m_Misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  void
+  SignatureCache::Add(const PubKey& signer, const Signature& sig,
+                      const ShortHash& digest, llarp_time_t expires)
+  {
+    const Key k{signer, sig, digest};
+    auto& shard = ShardFor(k);
+    util::Lock lock(&shard.mutex);
+    if(shard.entries.size() >= m_ShardCapacity
+       && shard.entries.find(k) == shard.entries.end())
+    {
+      // full, make room by dropping whatever comes first
+      shard.entries.erase(shard.entries.begin());
+    }
+    shard.entries[k] = expires;
+  }
+
+  void
+  SignatureCache::Clear()
+  {
+    for(auto& shard : m_Shards)
+    {
+      util::Lock lock(&shard.mutex);
+      shard.entries.clear();
+    }
+  }
+
+  size_t
+  SignatureCache::Size() const
+  {
+    size_t sz = 0;
+    for(const auto& shard : m_Shards)
+    {
+      util::Lock lock(&shard.mutex);
+      sz += shard.entries.size();
+    }
+    return sz;
+  }
+
+  util::StatusObject
+  SignatureCache::ExtractStatus() const
+  {
+    return util::StatusObject{{"size", Size()},
+                              {"capacity", m_ShardCapacity * NumShards},
+                              {"hits", Hits()},
+                              {"misses", Misses()}};
+  }
+}  // namespace llarp
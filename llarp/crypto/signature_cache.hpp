@@ -0,0 +1,103 @@
+#ifndef LLARP_CRYPTO_SIGNATURE_CACHE_HPP
+#define LLARP_CRYPTO_SIGNATURE_CACHE_HPP
+
+#include <crypto/types.hpp>
+#include <util/status.hpp>
+#include <util/thread/threading.hpp>
+#include <util/types.hpp>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <array>
+#include <atomic>
+
+namespace llarp
+{
+  /// remembers signatures we already checked so verifying the same signed
+  /// object again costs a hash of its content instead of the curve math.
+  /// an entry is the signer, the signature and a hash of the signed content,
+  /// so changing any of them misses. entries are dropped once the object
+  /// they are for expires, and the cache holds at most `capacity` of them.
+  ///
+  /// safe to use from any thread.
+  struct SignatureCache
+  {
+    static constexpr size_t DefaultCapacity = 8192;
+    static constexpr size_t NumShards       = 16;
+
+    explicit SignatureCache(size_t capacity = DefaultCapacity);
+
+    /// true if `sig` by `signer` over content hashing to `digest` was
+    /// verified before and has not expired at `now`
+    bool
+    Check(const PubKey& signer, const Signature& sig, const ShortHash& digest,
+          llarp_time_t now);
+
+    /// remember a good signature until `expires`
+    void
+    Add(const PubKey& signer, const Signature& sig, const ShortHash& digest,
+        llarp_time_t expires);
+
+    void
+    Clear();
+
+    size_t
+    Size() const;
+
+    uint64_t
+    Hits() const
+    {
+      return m_Hits.load(std::memory_order_relaxed);
+    }
+
+    uint64_t
+    Misses() const
+    {
+      return m_Misses.load(std::memory_order_relaxed);
+    }
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    struct Key
+    {
+      PubKey signer;
+      Signature sig;
+      ShortHash digest;
+
+      bool
+      operator==(const Key& other) const
+      {
+        return sig == other.sig && signer == other.signer
+            && digest == other.digest;
+      }
+
+      struct Hash
+      {
+        size_t
+        operator()(const Key& k) const
+        {
+          return Signature::Hash{}(k.sig);
+        }
+      };
+    };
+
+    struct Shard
+    {
+      mutable util::Mutex mutex;
+      absl::flat_hash_map< Key, llarp_time_t, Key::Hash > entries
+          GUARDED_BY(mutex);
+    };
+
+    Shard&
+    ShardFor(const Key& k);
+
+    const size_t m_ShardCapacity;
+    std::array< Shard, NumShards > m_Shards;
+    std::atomic< uint64_t > m_Hits{0};
+    std::atomic< uint64_t > m_Misses{0};
+  };
+}  // namespace llarp
+
+#endif
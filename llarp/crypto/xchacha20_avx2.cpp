@@ -0,0 +1,154 @@
+#include <crypto/xchacha20_avx2.hpp>
+
+#include <sodium/crypto_core_hchacha20.h>
+#include <sodium/utils.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LLARP_XCHACHA20_AVX2 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace llarp
+{
+  namespace sodium
+  {
+#ifdef LLARP_XCHACHA20_AVX2
+    static constexpr size_t Lanes     = 8;
+    static constexpr size_t BlockSize = 64;
+
+    bool
+    xchacha20_avx2_supported()
+    {
+      return __builtin_cpu_supports("avx2");
+    }
+
+    template < int bits >
+    static inline AVX2_TARGET __m256i
+    Rotl(__m256i v)
+    {
+      return _mm256_or_si256(_mm256_slli_epi32(v, bits),
+                             _mm256_srli_epi32(v, 32 - bits));
+    }
+
+    static inline AVX2_TARGET void
+    QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+    {
+      a = _mm256_add_epi32(a, b);
+      d = Rotl< 16 >(_mm256_xor_si256(d, a));
+      c = _mm256_add_epi32(c, d);
+      b = Rotl< 12 >(_mm256_xor_si256(b, c));
+      a = _mm256_add_epi32(a, b);
+      d = Rotl< 8 >(_mm256_xor_si256(d, a));
+      c = _mm256_add_epi32(c, d);
+      b = Rotl< 7 >(_mm256_xor_si256(b, c));
+    }
+
+    static inline uint32_t
+    Load32(const byte_t* ptr)
+    {
+      uint32_t val;
+      std::memcpy(&val, ptr, sizeof(val));
+      return val;
+    }
+
+    /// run up to 8 jobs in parallel, one per lane
+    static AVX2_TARGET void
+    XChaCha20Lanes(XChaCha20Job* jobs, size_t lanes)
+    {
+      // state words laid out word major so each row loads into one register
+      alignas(32) uint32_t init[16][Lanes];
+      alignas(32) uint32_t stream[16][Lanes];
+      size_t blocks = 0;
+      std::memset(init, 0, sizeof(init));
+      for(size_t lane = 0; lane < lanes; ++lane)
+      {
+        const auto& job = jobs[lane];
+        byte_t subkey[32];
+        // xchacha20 is chacha20 keyed by hchacha20 over the first 16 bytes of
+        // the nonce with the remaining 8 as the chacha20 nonce
+        crypto_core_hchacha20(subkey, job.nonce.data(), job.key->data(),
+                              nullptr);
+        init[0][lane] = 0x61707865;
+        init[1][lane] = 0x3320646e;
+        init[2][lane] = 0x79622d32;
+        init[3][lane] = 0x6b206574;
+        for(size_t idx = 0; idx < 8; ++idx)
+          init[4 + idx][lane] = Load32(subkey + (idx * 4));
+        init[14][lane] = Load32(job.nonce.data() + 16);
+        init[15][lane] = Load32(job.nonce.data() + 20);
+        sodium_memzero(subkey, sizeof(subkey));
+        blocks = std::max(blocks, (job.sz + BlockSize - 1) / BlockSize);
+      }
+
+      __m256i state[16];
+      for(size_t idx = 0; idx < 16; ++idx)
+        state[idx] = _mm256_load_si256(reinterpret_cast< __m256i* >(init[idx]));
+
+      for(size_t block = 0; block < blocks; ++block)
+      {
+        const __m256i counter = _mm256_set1_epi32(block);
+        __m256i x[16];
+        std::copy(state, state + 16, x);
+        x[12] = counter;
+        for(int round = 0; round < 10; ++round)
+        {
+          QuarterRound(x[0], x[4], x[8], x[12]);
+          QuarterRound(x[1], x[5], x[9], x[13]);
+          QuarterRound(x[2], x[6], x[10], x[14]);
+          QuarterRound(x[3], x[7], x[11], x[15]);
+          QuarterRound(x[0], x[5], x[10], x[15]);
+          QuarterRound(x[1], x[6], x[11], x[12]);
+          QuarterRound(x[2], x[7], x[8], x[13]);
+          QuarterRound(x[3], x[4], x[9], x[14]);
+        }
+        for(size_t idx = 0; idx < 16; ++idx)
+        {
+          const __m256i in = idx == 12 ? counter : state[idx];
+          _mm256_store_si256(reinterpret_cast< __m256i* >(stream[idx]),
+                             _mm256_add_epi32(x[idx], in));
+        }
+
+        const size_t offset = block * BlockSize;
+        for(size_t lane = 0; lane < lanes; ++lane)
+        {
+          const auto& job = jobs[lane];
+          if(offset >= job.sz)
+            continue;
+          uint32_t ks[16];
+          for(size_t idx = 0; idx < 16; ++idx)
+            ks[idx] = stream[idx][lane];
+          const byte_t* ksbytes = reinterpret_cast< const byte_t* >(ks);
+          byte_t* ptr           = job.buf + offset;
+          const size_t sz       = std::min(BlockSize, job.sz - offset);
+          for(size_t idx = 0; idx < sz; ++idx)
+            ptr[idx] ^= ksbytes[idx];
+        }
+      }
+      sodium_memzero(init, sizeof(init));
+      sodium_memzero(stream, sizeof(stream));
+    }
+
+    void
+    xchacha20_avx2(XChaCha20Job* jobs, size_t n)
+    {
+      for(size_t idx = 0; idx < n; idx += Lanes)
+        XChaCha20Lanes(jobs + idx, std::min(Lanes, n - idx));
+    }
+#else
+    bool
+    xchacha20_avx2_supported()
+    {
+      return false;
+    }
+
+    void
+    xchacha20_avx2(XChaCha20Job*, size_t)
+    {
+    }
+#endif
+  }  // namespace sodium
+}  // namespace llarp
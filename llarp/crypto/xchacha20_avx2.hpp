@@ -0,0 +1,22 @@
+#ifndef LLARP_CRYPTO_XCHACHA20_AVX2_HPP
+#define LLARP_CRYPTO_XCHACHA20_AVX2_HPP
+
+#include <crypto/crypto.hpp>
+
+namespace llarp
+{
+  namespace sodium
+  {
+    /// true if this build and the cpu we run on can use xchacha20_avx2
+    bool
+    xchacha20_avx2_supported();
+
+    /// multi buffer xchacha20, runs the chacha rounds for 8 jobs side by side
+    /// in avx2 lanes, output is identical to crypto_stream_xchacha20_xor on
+    /// each job. only call if xchacha20_avx2_supported() returned true.
+    void
+    xchacha20_avx2(XChaCha20Job *jobs, size_t n);
+  }  // namespace sodium
+}  // namespace llarp
+
+#endif
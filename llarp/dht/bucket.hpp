@@ -3,8 +3,10 @@
 
 #include <dht/kademlia.hpp>
 #include <dht/key.hpp>
+#include <dht/routingtable.hpp>
 #include <util/status.hpp>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -20,7 +22,7 @@ namespace llarp
       using Random_t        = std::function< uint64_t() >;
 
       Bucket(const Key_t& us, Random_t r)
-          : nodes(XorMetric(us)), random(std::move(r))
+          : random(std::move(r)), table(us), nodes(XorMetric(us))
       {
       }
 
@@ -41,55 +43,53 @@ namespace llarp
         return nodes.size();
       }
 
-      struct SetIntersector
+      /// every node by key, changes go through PutNode and friends so the
+      /// table stays in step
+      const BucketStorage_t&
+      Storage() const
       {
-        bool
-        operator()(const typename BucketStorage_t::value_type& lhs,
-                   const Key_t& rhs)
-        {
-          return lhs.first < rhs;
-        }
-
-        bool
-        operator()(const Key_t& lhs,
-                   const typename BucketStorage_t::value_type& rhs)
-        {
-          return lhs < rhs.first;
-        }
-      };
+        return nodes;
+      }
 
       bool
       GetRandomNodeExcluding(Key_t& result,
                              const std::set< Key_t >& exclude) const
       {
-        std::vector< typename BucketStorage_t::value_type > candidates;
-        std::set_difference(nodes.begin(), nodes.end(), exclude.begin(),
-                            exclude.end(), std::back_inserter(candidates),
-                            SetIntersector());
-
-        if(candidates.empty())
+        // where the excluded keys we have are in our order, so a random
+        // rank among the others can be stepped over them
+        std::vector< size_t > skip;
+        for(const auto& key : exclude)
+        {
+          if(table.Has(key))
+            skip.emplace_back(table.Rank(key));
+        }
+        if(nodes.size() <= skip.size())
         {
           return false;
         }
-        result = candidates[random() % candidates.size()].first;
+        std::sort(skip.begin(), skip.end());
+        size_t rank = random() % (nodes.size() - skip.size());
+        for(const auto excluded : skip)
+        {
+          if(excluded > rank)
+            break;
+          ++rank;
+        }
+        result = table.Select(rank);
         return true;
       }
 
       bool
       FindClosest(const Key_t& target, Key_t& result) const
       {
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for(const auto& item : nodes)
+        std::vector< Key_t > closest;
+        table.Closest(target, 1, {}, closest);
+        if(closest.empty())
         {
-          auto curDist = item.first ^ target;
-          if(curDist < mindist)
-          {
-            mindist = curDist;
-            result  = item.first;
-          }
+          return false;
         }
-        return nodes.size() > 0;
+        result = closest[0];
+        return true;
       }
 
       bool
@@ -113,9 +113,7 @@ namespace llarp
         size_t sz        = nodes.size();
         while(N)
         {
-          auto itr = nodes.begin();
-          std::advance(itr, random() % sz);
-          if(result.insert(itr->first).second)
+          if(result.insert(table.Select(random() % sz)).second)
           {
             --N;
           }
@@ -129,42 +127,24 @@ namespace llarp
       {
         Key_t maxdist;
         maxdist.Fill(0xff);
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for(const auto& item : nodes)
+        std::vector< Key_t > closest;
+        table.Closest(target, 1, exclude, closest);
+        if(closest.empty() || !((closest[0] ^ target) < maxdist))
         {
-          if(exclude.count(item.first))
-          {
-            continue;
-          }
-
-          auto curDist = item.first ^ target;
-          if(curDist < mindist)
-          {
-            mindist = curDist;
-            result  = item.first;
-          }
+          return false;
         }
-        return mindist < maxdist;
+        result = closest[0];
+        return true;
       }
 
       bool
       GetManyNearExcluding(const Key_t& target, std::set< Key_t >& result,
                            size_t N, const std::set< Key_t >& exclude) const
       {
-        std::set< Key_t > s(exclude.begin(), exclude.end());
-
-        Key_t peer;
-        while(N--)
-        {
-          if(!FindCloseExcluding(target, peer, s))
-          {
-            return false;
-          }
-          s.insert(peer);
-          result.insert(peer);
-        }
-        return true;
+        std::vector< Key_t > closest;
+        table.Closest(target, N, exclude, closest);
+        result.insert(closest.begin(), closest.end());
+        return closest.size() == N;
       }
 
       void
@@ -174,6 +154,7 @@ namespace llarp
         if(itr == nodes.end() || itr->second < val)
         {
           nodes[val.ID] = val;
+          table.Insert(val.ID);
         }
       }
 
@@ -184,6 +165,7 @@ namespace llarp
         if(itr != nodes.end())
         {
           nodes.erase(itr);
+          table.Erase(key);
         }
       }
 
@@ -202,7 +184,10 @@ namespace llarp
         while(itr != nodes.end())
         {
           if(pred(itr->first))
+          {
+            table.Erase(itr->first);
             itr = nodes.erase(itr);
+          }
           else
             ++itr;
         }
@@ -212,10 +197,16 @@ namespace llarp
       Clear()
       {
         nodes.clear();
+        table.Clear();
       }
 
-      BucketStorage_t nodes;
       Random_t random;
+      /// the same keys as nodes in k-buckets, answers the closest and
+      /// random queries without walking every node
+      RoutingTable table;
+
+     private:
+      BucketStorage_t nodes;
     };
   }  // namespace dht
 }  // namespace llarp
@@ -29,6 +29,10 @@ namespace llarp
   {
     AbstractContext::~AbstractContext() = default;
 
+    /// how long a bucket may go without a lookup landing in it before we
+    /// look up a random key in its range
+    static constexpr llarp_time_t BucketRefreshInterval = 10 * 60 * 1000;
+
     struct Context final : public AbstractContext
     {
       Context();
@@ -164,14 +168,18 @@ namespace llarp
       void
       Explore(size_t N = 3);
 
+      /// drop peers that keep failing us and refresh the stalest bucket
+      void
+      RefreshBuckets();
+
       llarp::AbstractRouter* router{nullptr};
       // for router contacts
       std::unique_ptr< Bucket< RCNode > > _nodes;
 
       // for introduction sets
-      std::unique_ptr< Bucket< ISNode > > _services;
+      std::unique_ptr< IntroSetBucket > _services;
 
-      Bucket< ISNode >*
+      IntroSetBucket*
       services() override
       {
         return _services.get();
@@ -344,35 +352,37 @@ namespace llarp
       const auto num = std::min(router->NumberOfConnectedRouters(), size_t(4));
       if(num)
         Explore(num);
+      RefreshBuckets();
       router->logic()->call_later(
           interval,
           std::bind(&llarp::dht::Context::handle_explore_timer, this,
                     interval));
     }
 
+    void
+    Context::RefreshBuckets()
+    {
+      _nodes->RemoveIf([&](const Key_t& k) -> bool {
+        return router->routerProfiling().IsBad(k.as_array());
+      });
+      const auto now = Now();
+      Key_t target;
+      if(!_nodes->table.Refresh(now - BucketRefreshInterval, now, target))
+        return;
+      const RouterID id(target.as_array());
+      if(!HasRouterLookup(id))
+        LookupRouter(id, nullptr);
+    }
+
     void
     Context::handle_cleaner_timer(__attribute__((unused)) uint64_t interval)
     {
       // clean up transactions
       CleanupTX();
 
+      // expire intro sets
       if(_services)
-      {
-        // expire intro sets
-        auto now    = Now();
-        auto& nodes = _services->nodes;
-        auto itr    = nodes.begin();
-        while(itr != nodes.end())
-        {
-          if(itr->second.introset.IsExpired(now))
-          {
-            llarp::LogDebug("introset expired ", itr->second.introset.A.Addr());
-            itr = nodes.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+        _services->ExpireIntroSets(Now());
       ScheduleCleanupTimer();
     }
 
@@ -381,46 +391,7 @@ namespace llarp
         const service::Tag& tag, size_t max,
         const std::set< service::IntroSet >& exclude)
     {
-      std::set< service::IntroSet > found;
-      auto& nodes = _services->nodes;
-      if(nodes.size() == 0)
-      {
-        return found;
-      }
-      auto itr = nodes.begin();
-      // start at random middle point
-      auto start = llarp::randint() % nodes.size();
-      std::advance(itr, start);
-      auto end            = itr;
-      std::string tagname = tag.ToString();
-      while(itr != nodes.end())
-      {
-        if(itr->second.introset.topic.ToString() == tagname)
-        {
-          if(exclude.count(itr->second.introset) == 0)
-          {
-            found.insert(itr->second.introset);
-            if(found.size() == max)
-              return found;
-          }
-        }
-        ++itr;
-      }
-      itr = nodes.begin();
-      while(itr != end)
-      {
-        if(itr->second.introset.topic.ToString() == tagname)
-        {
-          if(exclude.count(itr->second.introset) == 0)
-          {
-            found.insert(itr->second.introset);
-            if(found.size() == max)
-              return found;
-          }
-        }
-        ++itr;
-      }
-      return found;
+      return _services->GetRandomWithTagExcluding(tag, max, exclude);
     }
 
     void
@@ -479,8 +450,9 @@ namespace llarp
         const llarp::service::Address& addr) const
     {
       auto key = addr.ToKey();
-      auto itr = _services->nodes.find(key);
-      if(itr == _services->nodes.end())
+      const auto& stored = _services->Storage();
+      auto itr           = stored.find(key);
+      if(itr == stored.end())
         return nullptr;
       return &itr->second.introset;
     }
@@ -518,7 +490,7 @@ namespace llarp
       router    = r;
       ourKey    = us;
       _nodes    = std::make_unique< Bucket< RCNode > >(ourKey, llarp::randint);
-      _services = std::make_unique< Bucket< ISNode > >(ourKey, llarp::randint);
+      _services = std::make_unique< IntroSetBucket >(ourKey, llarp::randint);
       llarp::LogDebug("initialize dht with key ", ourKey);
       // start exploring
 
@@ -596,6 +568,7 @@ namespace llarp
     {
       TXOwner asker(whoasked, txid);
       TXOwner peer(askpeer, ++ids);
+      _nodes->table.Touch(addr.ToKey(), Now());
       _pendingIntrosetLookups.NewTX(
           peer, asker, addr,
           new ServiceAddressLookup(asker, addr, this, R, handler));
@@ -609,6 +582,7 @@ namespace llarp
     {
       TXOwner asker(whoasked, txid);
       TXOwner peer(askpeer, ++ids);
+      _nodes->table.Touch(addr.ToKey(), Now());
       _pendingIntrosetLookups.NewTX(
           peer, asker, addr,
           new ServiceAddressLookup(asker, addr, this, 0, handler));
@@ -704,6 +678,7 @@ namespace llarp
     {
       const TXOwner asker(whoasked, txid);
       const TXOwner peer(askpeer, ++ids);
+      _nodes->table.Touch(Key_t(target), Now());
       _pendingRouterLookups.NewTX(
           peer, asker, target,
           new RecursiveRouterLookup(asker, target, this, handler));
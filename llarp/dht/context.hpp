@@ -3,6 +3,7 @@
 
 #include <dht/bucket.hpp>
 #include <dht/dht.h>
+#include <dht/introsetbucket.hpp>
 #include <dht/key.hpp>
 #include <dht/message.hpp>
 #include <dht/messages/findintro.hpp>
@@ -162,7 +163,7 @@ namespace llarp
       virtual const PendingExploreLookups&
       pendingExploreLookups() const = 0;
 
-      virtual Bucket< ISNode >*
+      virtual IntroSetBucket*
       services() = 0;
 
       virtual bool&
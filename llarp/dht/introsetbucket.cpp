@@ -0,0 +1,148 @@
+#include <dht/introsetbucket.hpp>
+
+#include <util/logging/logger.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace llarp
+{
+  namespace dht
+  {
+    IntroSetBucket::IntroSetBucket(const Key_t& us, Random_t r)
+        : m_Bucket(us, std::move(r))
+    {
+    }
+
+    void
+    IntroSetBucket::PutNode(const ISNode& val)
+    {
+      auto itr = m_Bucket.Storage().find(val.ID);
+      if(itr != m_Bucket.Storage().end())
+      {
+        if(not(itr->second < val))
+          return;
+        Unindex(itr->first, itr->second);
+      }
+      m_Bucket.PutNode(val);
+      Index(val.ID, val);
+    }
+
+    void
+    IntroSetBucket::DelNode(const Key_t& key)
+    {
+      auto itr = m_Bucket.Storage().find(key);
+      if(itr == m_Bucket.Storage().end())
+        return;
+      Unindex(itr->first, itr->second);
+      m_Bucket.DelNode(key);
+    }
+
+    void
+    IntroSetBucket::Clear()
+    {
+      m_Bucket.Clear();
+      m_Tagged.clear();
+      m_TagSlot.clear();
+      m_Expiry.clear();
+    }
+
+    std::set< service::IntroSet >
+    IntroSetBucket::GetRandomWithTagExcluding(
+        const service::Tag& tag, size_t max,
+        const std::set< service::IntroSet >& exclude) const
+    {
+      std::set< service::IntroSet > found;
+      const auto itr = m_Tagged.find(tag);
+      if(itr == m_Tagged.end() || max == 0)
+        return found;
+      const auto& keys = itr->second;
+      // start at a random one and wrap around
+      const size_t start = m_Bucket.random() % keys.size();
+      for(size_t idx = 0; idx < keys.size(); ++idx)
+      {
+        const auto& introset =
+            m_Bucket.Storage().at(keys[(start + idx) % keys.size()]).introset;
+        if(exclude.count(introset))
+          continue;
+        found.insert(introset);
+        if(found.size() == max)
+          break;
+      }
+      return found;
+    }
+
+    void
+    IntroSetBucket::ExpireIntroSets(llarp_time_t now)
+    {
+      const std::greater< Expiry_t > later;
+      while(not m_Expiry.empty() && m_Expiry.front().first < now)
+      {
+        std::pop_heap(m_Expiry.begin(), m_Expiry.end(), later);
+        const Expiry_t expiry = m_Expiry.back();
+        m_Expiry.pop_back();
+        auto itr = m_Bucket.Storage().find(expiry.second);
+        if(itr == m_Bucket.Storage().end())
+          continue;
+        const auto& introset = itr->second.introset;
+        // replaced by one that lives longer since this was pushed
+        if(introset.GetNewestIntroExpiration() != expiry.first)
+          continue;
+        llarp::LogDebug("introset expired ", introset.A.Addr());
+        Unindex(itr->first, itr->second);
+        m_Bucket.DelNode(expiry.second);
+      }
+    }
+
+    size_t
+    IntroSetBucket::TagCount(const service::Tag& tag) const
+    {
+      const auto itr = m_Tagged.find(tag);
+      if(itr == m_Tagged.end())
+        return 0;
+      return itr->second.size();
+    }
+
+    void
+    IntroSetBucket::Index(const Key_t& key, const ISNode& val)
+    {
+      auto& keys     = m_Tagged[val.introset.topic];
+      m_TagSlot[key] = keys.size();
+      keys.emplace_back(key);
+
+      const std::greater< Expiry_t > later;
+      // drop entries that are no longer any use once they outnumber what
+      // we store, so a busy introset being republished can't grow the heap
+      if(m_Expiry.size() > 2 * m_Bucket.Storage().size() + 64)
+      {
+        m_Expiry.clear();
+        for(const auto& item : m_Bucket.Storage())
+          m_Expiry.emplace_back(
+              item.second.introset.GetNewestIntroExpiration(), item.first);
+        std::make_heap(m_Expiry.begin(), m_Expiry.end(), later);
+        return;
+      }
+      m_Expiry.emplace_back(val.introset.GetNewestIntroExpiration(), key);
+      std::push_heap(m_Expiry.begin(), m_Expiry.end(), later);
+    }
+
+    void
+    IntroSetBucket::Unindex(const Key_t& key, const ISNode& val)
+    {
+      auto itr = m_Tagged.find(val.introset.topic);
+      auto pos = m_TagSlot.find(key);
+      if(itr == m_Tagged.end() || pos == m_TagSlot.end())
+        return;
+      // swap with the last one so removal doesn't shift the rest
+      auto& keys        = itr->second;
+      const size_t slot = pos->second;
+      m_TagSlot.erase(pos);
+      keys[slot] = keys.back();
+      keys.pop_back();
+      if(slot < keys.size())
+        m_TagSlot[keys[slot]] = slot;
+      if(keys.empty())
+        m_Tagged.erase(itr);
+    }
+  }  // namespace dht
+}  // namespace llarp
@@ -0,0 +1,97 @@
+#ifndef LLARP_DHT_INTROSETBUCKET_HPP
+#define LLARP_DHT_INTROSETBUCKET_HPP
+
+#include <dht/bucket.hpp>
+#include <dht/node.hpp>
+#include <service/intro_set.hpp>
+#include <service/tag.hpp>
+
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// the introsets we store, indexed by tag so a tag lookup only looks at
+    /// introsets with that tag and by expiry so cleanup only looks at the
+    /// ones that expired
+    struct IntroSetBucket
+    {
+      using Storage_t = Bucket< ISNode >::BucketStorage_t;
+      using Random_t  = Bucket< ISNode >::Random_t;
+
+      IntroSetBucket(const Key_t& us, Random_t r);
+
+      util::StatusObject
+      ExtractStatus() const
+      {
+        return m_Bucket.ExtractStatus();
+      }
+
+      size_t
+      size() const
+      {
+        return m_Bucket.size();
+      }
+
+      /// every introset we store by address, changes go through the members
+      /// below so the indexes stay in step
+      const Storage_t&
+      Storage() const
+      {
+        return m_Bucket.Storage();
+      }
+
+      /// store an introset unless we have a newer one for the same address
+      void
+      PutNode(const ISNode& val);
+
+      void
+      DelNode(const Key_t& key);
+
+      void
+      Clear();
+
+      /// get up to `max` introsets with topic `tag` that are not in
+      /// `exclude`, starting at a random one
+      std::set< service::IntroSet >
+      GetRandomWithTagExcluding(
+          const service::Tag& tag, size_t max,
+          const std::set< service::IntroSet >& exclude) const;
+
+      /// drop every introset that expired before `now`
+      void
+      ExpireIntroSets(llarp_time_t now);
+
+      /// how many introsets we have with topic `tag`
+      size_t
+      TagCount(const service::Tag& tag) const;
+
+     private:
+      void
+      Index(const Key_t& key, const ISNode& val);
+
+      void
+      Unindex(const Key_t& key, const ISNode& val);
+
+      /// when an introset expires and its key, the heap holds one of these
+      /// per put, entries for introsets that were replaced or removed are
+      /// skipped when they come up
+      using Expiry_t = std::pair< llarp_time_t, Key_t >;
+
+      Bucket< ISNode > m_Bucket;
+      std::unordered_map< service::Tag, std::vector< Key_t >,
+                          service::Tag::Hash >
+          m_Tagged;
+      /// where each key is in its tag's vector
+      std::unordered_map< Key_t, size_t, Key_t::Hash > m_TagSlot;
+      /// min heap on expiry time
+      std::vector< Expiry_t > m_Expiry;
+    };
+  }  // namespace dht
+}  // namespace llarp
+
+#endif
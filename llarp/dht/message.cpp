@@ -130,5 +130,19 @@ namespace llarp
       ListDecoder dec(relayed, from, list);
       return bencode_read_list(dec, buf);
     }
+
+    void
+    VerifyIntroSets(const std::vector< IMessage::Ptr_t > &msgs,
+                    llarp_time_t now)
+    {
+      std::vector< const service::IntroSet * > sets;
+      for(const auto &msg : msgs)
+        msg->CollectIntroSets(sets);
+      // a single one costs the same verified where it is handled
+      if(sets.size() < 2)
+        return;
+      std::vector< char > valid;
+      service::IntroSet::VerifyBatch(sets, now, valid);
+    }
   }  // namespace dht
 }  // namespace llarp
@@ -5,11 +5,17 @@
 #include <dht/key.hpp>
 #include <path/path_types.hpp>
 #include <util/bencode.hpp>
+#include <util/types.hpp>
 
 #include <vector>
 
 namespace llarp
 {
+  namespace service
+  {
+    struct IntroSet;
+  }  // namespace service
+
   namespace dht
   {
     constexpr size_t MAX_MSG_SIZE = 2048;
@@ -35,6 +41,13 @@ namespace llarp
       virtual bool
       DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val) = 0;
 
+      /// put the introsets handling this message verifies into sets
+      virtual void
+      CollectIntroSets(std::vector< const service::IntroSet* >& sets) const
+      {
+        (void)sets;
+      }
+
       Key_t From;
       PathID_t pathID;
       uint64_t version = LLARP_PROTO_VERSION;
@@ -47,6 +60,13 @@ namespace llarp
     DecodeMesssageList(Key_t from, llarp_buffer_t* buf,
                        std::vector< IMessage::Ptr_t >& dst,
                        bool relayed = false);
+
+    /// hand the introset signatures of a whole message list to one
+    /// verify_batch call, handling the messages then finds them in the
+    /// verify cache
+    void
+    VerifyIntroSets(const std::vector< IMessage::Ptr_t >& msgs,
+                    llarp_time_t now);
   }  // namespace dht
 }  // namespace llarp
 
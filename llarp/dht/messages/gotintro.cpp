@@ -25,16 +25,16 @@ namespace llarp
     {
       auto &dht = *ctx->impl;
 
-      for(const auto &introset : I)
+      std::vector< const service::IntroSet * > sets;
+      CollectIntroSets(sets);
+      std::vector< char > valid;
+      if(service::IntroSet::VerifyBatch(sets, dht.Now(), valid) != sets.size())
       {
-        if(!introset.Verify(dht.Now()))
-        {
-          LogWarn(
-              "Invalid introset while handling direct GotIntro "
-              "from ",
-              From);
-          return false;
-        }
+        LogWarn(
+            "Invalid introset while handling direct GotIntro "
+            "from ",
+            From);
+        return false;
       }
       TXOwner owner(From, T);
       auto tagLookup = dht.pendingTagLookups().GetPendingLookupFrom(owner);
@@ -54,6 +54,14 @@ namespace llarp
       bool
       HandleMessage(llarp_dht_context* ctx,
                     std::vector< IMessage::Ptr_t >& replies) const override;
+
+      void
+      CollectIntroSets(
+          std::vector< const service::IntroSet* >& sets) const override
+      {
+        for(const auto& introset : I)
+          sets.emplace_back(&introset);
+      }
     };
 
     struct RelayedGotIntroMessage final : public GotIntroMessage
@@ -111,9 +111,32 @@ namespace llarp
       {
         LogDebug("got ", R.size(), " results in GRM for lookup");
         if(R.size() == 0)
+        {
           dht.pendingRouterLookups().NotFound(owner, K);
-        else
+          return true;
+        }
+        // hand all the signatures to one verify_batch call, the lookup then
+        // only sees the good ones and finds them in the verify cache
+        std::vector< char > valid;
+        const size_t good = RouterContact::VerifyBatch(R, dht.Now(), valid);
+        if(good == R.size())
+        {
           dht.pendingRouterLookups().Found(owner, R[0].pubkey, R);
+          return true;
+        }
+        // a reply with only forged RCs didn't find anything
+        if(good == 0)
+        {
+          dht.pendingRouterLookups().NotFound(owner, K);
+          return true;
+        }
+        std::vector< RouterContact > found;
+        for(size_t idx = 0; idx < R.size(); ++idx)
+        {
+          if(valid[idx])
+            found.emplace_back(R[idx]);
+        }
+        dht.pendingRouterLookups().Found(owner, R[0].pubkey, found);
         return true;
       }
       llarp::LogWarn("Unwarranted GRM from ", From, " txid=", txid);
@@ -42,6 +42,13 @@ namespace llarp
       HandleMessage(
           llarp_dht_context* ctx,
           std::vector< std::unique_ptr< IMessage > >& replies) const override;
+
+      void
+      CollectIntroSets(
+          std::vector< const service::IntroSet* >& sets) const override
+      {
+        sets.emplace_back(&I);
+      }
     };
   }  // namespace dht
 }  // namespace llarp
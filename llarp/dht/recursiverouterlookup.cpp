@@ -39,6 +39,14 @@ namespace llarp
       return parent->Nodes()->FindCloseExcluding(K, nextPeer, exclude);
     }
 
+    size_t
+    RecursiveRouterLookup::Parallelism() const
+    {
+      // lookups we start, ours or a local path's, ask several peers at
+      // once, ones we recurse on for another router stay on one path
+      return whoasked.node == parent->OurKey() ? LookupAlpha : 0;
+    }
+
     void
     RecursiveRouterLookup::DoNextRequest(const Key_t &peer)
     {
@@ -22,6 +22,9 @@ namespace llarp
       bool
       GetNextPeer(Key_t &nextPeer, const std::set< Key_t > &exclude) override;
 
+      size_t
+      Parallelism() const override;
+
       void
       DoNextRequest(const Key_t &peer) override;
 
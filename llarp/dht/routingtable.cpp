@@ -0,0 +1,309 @@
+#include <dht/routingtable.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace llarp
+{
+  namespace dht
+  {
+    constexpr size_t RoutingTable::BucketSize;
+    constexpr uint32_t RoutingTable::Root;
+    constexpr uint32_t RoutingTable::None;
+
+    static constexpr size_t KeyBits = Key_t::SIZE * 8;
+
+    RoutingTable::RoutingTable(const Key_t& us) : m_Us(us), m_Nodes(1)
+    {
+    }
+
+    bool
+    RoutingTable::Insert(const Key_t& key)
+    {
+      if(Has(key))
+        return false;
+      uint32_t idx = Root;
+      size_t depth = 0;
+      while(not m_Nodes[idx].IsBucket())
+      {
+        m_Nodes[idx].count++;
+        idx = m_Nodes[idx].child[Bit(key, depth++)];
+      }
+      m_Nodes[idx].keys.emplace_back(key);
+      m_Nodes[idx].count++;
+      Split(idx, depth);
+      return true;
+    }
+
+    bool
+    RoutingTable::Erase(const Key_t& key)
+    {
+      if(not Has(key))
+        return false;
+      uint32_t idx      = Root;
+      uint32_t collapse = None;
+      size_t depth      = 0;
+      while(not m_Nodes[idx].IsBucket())
+      {
+        // the highest subtree that fits in one bucket again gets merged
+        if(--m_Nodes[idx].count <= BucketSize && collapse == None)
+          collapse = idx;
+        idx = m_Nodes[idx].child[Bit(key, depth++)];
+      }
+      auto& keys = m_Nodes[idx].keys;
+      auto itr   = std::find(keys.begin(), keys.end(), key);
+      *itr       = keys.back();
+      keys.pop_back();
+      m_Nodes[idx].count--;
+      if(collapse != None)
+        Collapse(collapse);
+      return true;
+    }
+
+    bool
+    RoutingTable::Has(const Key_t& key) const
+    {
+      uint32_t idx = Root;
+      size_t depth = 0;
+      while(not m_Nodes[idx].IsBucket())
+        idx = m_Nodes[idx].child[Bit(key, depth++)];
+      const auto& keys = m_Nodes[idx].keys;
+      return std::find(keys.begin(), keys.end(), key) != keys.end();
+    }
+
+    void
+    RoutingTable::Clear()
+    {
+      m_Nodes.clear();
+      m_Nodes.emplace_back();
+      m_Free.clear();
+    }
+
+    void
+    RoutingTable::Closest(const Key_t& target, size_t N,
+                          const std::set< Key_t >& exclude,
+                          std::vector< Key_t >& result) const
+    {
+      result.clear();
+      if(N == 0)
+        return;
+      Collect(Root, 0, target, N, exclude, result);
+      // buckets came in order, only the keys inside them are not
+      std::sort(result.begin(), result.end(),
+                [&target](const Key_t& left, const Key_t& right) {
+                  return (left ^ target) < (right ^ target);
+                });
+      if(result.size() > N)
+        result.resize(N);
+    }
+
+    Key_t
+    RoutingTable::Select(size_t rank) const
+    {
+      uint32_t idx = Root;
+      size_t depth = 0;
+      while(not m_Nodes[idx].IsBucket())
+      {
+        const auto& node   = m_Nodes[idx];
+        const int near     = Bit(m_Us, depth++);
+        const size_t below = m_Nodes[node.child[near]].count;
+        if(rank < below)
+          idx = node.child[near];
+        else
+        {
+          rank -= below;
+          idx = node.child[1 - near];
+        }
+      }
+      std::vector< Key_t > keys = m_Nodes[idx].keys;
+      std::nth_element(keys.begin(), keys.begin() + rank, keys.end(),
+                       [&](const Key_t& left, const Key_t& right) {
+                         return (left ^ m_Us) < (right ^ m_Us);
+                       });
+      return keys[rank];
+    }
+
+    size_t
+    RoutingTable::Rank(const Key_t& key) const
+    {
+      uint32_t idx = Root;
+      size_t depth = 0;
+      size_t rank  = 0;
+      while(not m_Nodes[idx].IsBucket())
+      {
+        const auto& node = m_Nodes[idx];
+        const int near   = Bit(m_Us, depth);
+        const int side   = Bit(key, depth++);
+        if(side != near)
+          rank += m_Nodes[node.child[near]].count;
+        idx = node.child[side];
+      }
+      const Key_t dist = key ^ m_Us;
+      for(const auto& other : m_Nodes[idx].keys)
+      {
+        if((other ^ m_Us) < dist)
+          rank++;
+      }
+      return rank;
+    }
+
+    void
+    RoutingTable::Touch(const Key_t& target, llarp_time_t now)
+    {
+      uint32_t idx = Root;
+      size_t depth = 0;
+      while(not m_Nodes[idx].IsBucket())
+        idx = m_Nodes[idx].child[Bit(target, depth++)];
+      m_Nodes[idx].lookedUp = std::max(m_Nodes[idx].lookedUp, now);
+    }
+
+    bool
+    RoutingTable::Refresh(llarp_time_t before, llarp_time_t now, Key_t& target)
+    {
+      // walk every bucket keeping the prefix that leads to it
+      std::vector< std::tuple< uint32_t, size_t, Key_t > > stack;
+      stack.emplace_back(Root, 0, Key_t{});
+      uint32_t oldest = None;
+      size_t oldestDepth = 0;
+      Key_t oldestPrefix;
+      while(not stack.empty())
+      {
+        uint32_t idx;
+        size_t depth;
+        Key_t prefix;
+        std::tie(idx, depth, prefix) = stack.back();
+        stack.pop_back();
+        const auto& node = m_Nodes[idx];
+        if(node.count == 0)
+          continue;
+        if(node.IsBucket())
+        {
+          if(oldest == None || node.lookedUp < m_Nodes[oldest].lookedUp)
+          {
+            oldest       = idx;
+            oldestDepth  = depth;
+            oldestPrefix = prefix;
+          }
+          continue;
+        }
+        stack.emplace_back(node.child[0], depth + 1, prefix);
+        prefix[depth / 8] |= 1 << (7 - (depth % 8));
+        stack.emplace_back(node.child[1], depth + 1, prefix);
+      }
+      if(oldest == None || m_Nodes[oldest].lookedUp >= before)
+        return false;
+      target.Randomize();
+      for(size_t bit = 0; bit < oldestDepth; ++bit)
+      {
+        const byte_t mask = 1 << (7 - (bit % 8));
+        target[bit / 8] &= ~mask;
+        target[bit / 8] |= oldestPrefix[bit / 8] & mask;
+      }
+      m_Nodes[oldest].lookedUp = now;
+      return true;
+    }
+
+    size_t
+    RoutingTable::Buckets() const
+    {
+      const size_t buckets =
+          std::count_if(m_Nodes.begin(), m_Nodes.end(),
+                        [](const Node& node) { return node.IsBucket(); });
+      return buckets - m_Free.size();
+    }
+
+    uint32_t
+    RoutingTable::NewNode()
+    {
+      if(m_Free.empty())
+      {
+        m_Nodes.emplace_back();
+        return m_Nodes.size() - 1;
+      }
+      const uint32_t idx = m_Free.back();
+      m_Free.pop_back();
+      return idx;
+    }
+
+    void
+    RoutingTable::Split(uint32_t idx, size_t depth)
+    {
+      while(m_Nodes[idx].count > BucketSize && depth < KeyBits)
+      {
+        const uint32_t lo = NewNode();
+        const uint32_t hi = NewNode();
+        auto& node        = m_Nodes[idx];
+        for(const auto& key : node.keys)
+        {
+          auto& child = m_Nodes[Bit(key, depth) ? hi : lo];
+          child.keys.emplace_back(key);
+          child.count++;
+        }
+        m_Nodes[lo].lookedUp = node.lookedUp;
+        m_Nodes[hi].lookedUp = node.lookedUp;
+        node.keys.clear();
+        node.keys.shrink_to_fit();
+        node.child[0] = lo;
+        node.child[1] = hi;
+        // only one side can still be over
+        idx = m_Nodes[lo].count > BucketSize ? lo : hi;
+        depth++;
+      }
+    }
+
+    void
+    RoutingTable::Collapse(uint32_t idx)
+    {
+      std::vector< Key_t > keys;
+      llarp_time_t lookedUp = Gather(m_Nodes[idx].child[0], keys);
+      lookedUp = std::max(lookedUp, Gather(m_Nodes[idx].child[1], keys));
+      auto& node    = m_Nodes[idx];
+      node.child[0] = None;
+      node.child[1] = None;
+      node.keys     = std::move(keys);
+      node.lookedUp = lookedUp;
+    }
+
+    llarp_time_t
+    RoutingTable::Gather(uint32_t idx, std::vector< Key_t >& keys)
+    {
+      llarp_time_t lookedUp = m_Nodes[idx].lookedUp;
+      if(m_Nodes[idx].IsBucket())
+        keys.insert(keys.end(), m_Nodes[idx].keys.begin(),
+                    m_Nodes[idx].keys.end());
+      else
+      {
+        for(const uint32_t child : m_Nodes[idx].child)
+          lookedUp = std::max(lookedUp, Gather(child, keys));
+      }
+      m_Nodes[idx] = Node{};
+      m_Free.push_back(idx);
+      return lookedUp;
+    }
+
+    void
+    RoutingTable::Collect(uint32_t idx, size_t depth, const Key_t& target,
+                          size_t N, const std::set< Key_t >& exclude,
+                          std::vector< Key_t >& result) const
+    {
+      const auto& node = m_Nodes[idx];
+      if(node.count == 0)
+        return;
+      if(node.IsBucket())
+      {
+        for(const auto& key : node.keys)
+        {
+          if(exclude.count(key) == 0)
+            result.emplace_back(key);
+        }
+        return;
+      }
+      // everything on the side the target is on is closer than anything on
+      // the other side
+      const int side = Bit(target, depth);
+      Collect(node.child[side], depth + 1, target, N, exclude, result);
+      if(result.size() < N)
+        Collect(node.child[1 - side], depth + 1, target, N, exclude, result);
+    }
+  }  // namespace dht
+}  // namespace llarp
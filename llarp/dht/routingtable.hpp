@@ -0,0 +1,129 @@
+#ifndef LLARP_DHT_ROUTINGTABLE_HPP
+#define LLARP_DHT_ROUTINGTABLE_HPP
+
+#include <dht/key.hpp>
+#include <util/types.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// the keys of the nodes we know kept in k-buckets: a binary tree split
+    /// by prefix length where each leaf is a bucket of at most BucketSize
+    /// keys sharing a prefix. a bucket that overflows is split on its next
+    /// bit rather than dropping anyone, so the closest keys to a target are
+    /// found by walking O(log n) buckets instead of every key we know.
+    class RoutingTable
+    {
+     public:
+      static constexpr size_t BucketSize = 8;
+
+      explicit RoutingTable(const Key_t& us);
+
+      /// returns false if we have it already
+      bool
+      Insert(const Key_t& key);
+
+      /// returns false if we don't have it
+      bool
+      Erase(const Key_t& key);
+
+      bool
+      Has(const Key_t& key) const;
+
+      void
+      Clear();
+
+      size_t
+      Size() const
+      {
+        return m_Nodes[Root].count;
+      }
+
+      /// get up to `N` keys closest to `target` that are not in `exclude`,
+      /// closest first
+      void
+      Closest(const Key_t& target, size_t N, const std::set< Key_t >& exclude,
+              std::vector< Key_t >& result) const;
+
+      /// get the key `rank` places from us, i.e. the rank-th key in the
+      /// order of XorMetric(us). rank must be less than Size()
+      Key_t
+      Select(size_t rank) const;
+
+      /// how many of our keys are closer to us than `key`
+      size_t
+      Rank(const Key_t& key) const;
+
+      /// mark the bucket `target` falls in as looked up at `now`
+      void
+      Touch(const Key_t& target, llarp_time_t now);
+
+      /// find the bucket that was looked up least recently and not since
+      /// `before`, put a random key in its range in `target` and mark it
+      /// looked up at `now`. returns false if every bucket is fresh.
+      bool
+      Refresh(llarp_time_t before, llarp_time_t now, Key_t& target);
+
+      /// how many buckets the keys are spread over
+      size_t
+      Buckets() const;
+
+     private:
+      static constexpr uint32_t Root = 0;
+      static constexpr uint32_t None = UINT32_MAX;
+
+      struct Node
+      {
+        /// both None for a bucket
+        uint32_t child[2] = {None, None};
+        size_t count      = 0;
+        std::vector< Key_t > keys;
+        llarp_time_t lookedUp = 0;
+
+        bool
+        IsBucket() const
+        {
+          return child[0] == None;
+        }
+      };
+
+      static int
+      Bit(const Key_t& key, size_t depth)
+      {
+        return (key[depth / 8] >> (7 - (depth % 8))) & 1;
+      }
+
+      uint32_t
+      NewNode();
+
+      /// split bucket `idx` at `depth` until no bucket is over size
+      void
+      Split(uint32_t idx, size_t depth);
+
+      /// turn the subtree at `idx` back into one bucket
+      void
+      Collapse(uint32_t idx);
+
+      /// move every key under `idx` into `keys` and free the nodes, returns
+      /// when any of the buckets was last looked up
+      llarp_time_t
+      Gather(uint32_t idx, std::vector< Key_t >& keys);
+
+      void
+      Collect(uint32_t idx, size_t depth, const Key_t& target, size_t N,
+              const std::set< Key_t >& exclude,
+              std::vector< Key_t >& result) const;
+
+      const Key_t m_Us;
+      std::vector< Node > m_Nodes;
+      std::vector< uint32_t > m_Free;
+    };
+  }  // namespace dht
+}  // namespace llarp
+
+#endif
@@ -50,6 +50,14 @@ namespace llarp
       return false;
     }
 
+    size_t
+    ServiceAddressLookup::Parallelism() const
+    {
+      // LocalServiceAddressLookup asks on our key too, so a path's lookup
+      // fans out like ours
+      return whoasked.node == parent->OurKey() ? LookupAlpha : 0;
+    }
+
     void
     ServiceAddressLookup::Start(const TXOwner &peer)
     {
@@ -28,6 +28,9 @@ namespace llarp
       bool
       GetNextPeer(Key_t &next, const std::set< Key_t > &exclude) override;
 
+      size_t
+      Parallelism() const override;
+
       void
       Start(const TXOwner &peer) override;
 
@@ -5,8 +5,10 @@
 #include <dht/txowner.hpp>
 #include <util/logging/logger.hpp>
 #include <util/status.hpp>
+#include <util/types.hpp>
 
 #include <set>
+#include <type_traits>
 #include <vector>
 
 namespace llarp
@@ -15,6 +17,14 @@ namespace llarp
   {
     struct AbstractContext;
 
+    /// how many peers a lookup of our own asks at once
+    constexpr size_t LookupAlpha = 3;
+    /// how many peers a lookup of our own asks for each one it asks at once
+    /// before giving up
+    constexpr size_t LookupMaxPeers = 12;
+    /// how long a lookup of our own waits on one peer before asking another
+    constexpr llarp_time_t LookupPeerTimeout = 2000;
+
     template < typename K, typename V >
     struct TX
     {
@@ -23,6 +33,14 @@ namespace llarp
       std::set< Key_t > peersAsked;
       std::vector< V > valuesFound;
       TXOwner whoasked;
+      /// requests sent that were not answered yet, when Parallelism() > 0
+      size_t pending = 0;
+      /// peers we were told are closer to the target, when Parallelism() > 0
+      std::vector< Key_t > closerPeers;
+      /// the closest peer that answered without the value, peers no closer
+      /// than it are not worth asking, when Parallelism() > 0
+      Key_t closestAnswered;
+      bool anyAnswered = false;
 
       TX(const TXOwner& asker, const K& k, AbstractContext* p)
           : target(k), parent(p), whoasked(asker)
@@ -31,6 +49,23 @@ namespace llarp
 
       virtual ~TX() = default;
 
+      /// how many peers to keep asking at once, the holder then fans the
+      /// lookup out itself and sends every request with Start(). 0 asks one
+      /// peer at a time through AskNextPeer()
+      virtual size_t
+      Parallelism() const
+      {
+        return 0;
+      }
+
+      /// the key peers are measured against when Parallelism() > 0, lookups
+      /// for keys that aren't dht keys don't fan out and never use it
+      Key_t
+      TargetKey() const
+      {
+        return MakeKey(target, std::is_constructible< Key_t, const K& >{});
+      }
+
       void
       OnFound(const Key_t& askedPeer, const V& value);
 
@@ -73,6 +108,19 @@ namespace llarp
 
       virtual void
       SendReply() = 0;
+
+     private:
+      static Key_t
+      MakeKey(const K& k, std::true_type)
+      {
+        return Key_t{k};
+      }
+
+      static Key_t
+      MakeKey(const K&, std::false_type)
+      {
+        return {};
+      }
     };
 
     template < typename K, typename V >
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -24,6 +25,13 @@ namespace llarp
       std::unordered_map< K, llarp_time_t, K_Hash > timeouts;
       // maps remote peer with tx to handle reply from them
       std::unordered_map< TXOwner, TXPtr, TXOwner::Hash > tx;
+      struct Asked
+      {
+        TXOwner owner;
+        llarp_time_t at;
+      };
+      // maps each remote peer a parallel tx asked to the owner of that tx
+      std::unordered_map< TXOwner, Asked, TXOwner::Hash > parallel;
 
       const TX< K, V >*
       GetPendingLookupFrom(const TXOwner& owner) const;
@@ -91,6 +99,23 @@ namespace llarp
 
       void
       Expire(llarp_time_t now);
+
+     private:
+      /// a peer a parallel tx asked does not have it, or did not answer when
+      /// `answered` is false
+      void
+      PeerNotFound(const TXOwner& from, const std::unique_ptr< Key_t >& next,
+                   bool answered);
+
+      /// send the lookup owned by `owner` to `peer` as well
+      void
+      Ask(const TXOwner& owner, TX< K, V >& t, const Key_t& peer);
+
+      /// ask more peers until Parallelism() requests are pending or none we
+      /// know are closer than the closest one that answered, returns false
+      /// if none are pending
+      bool
+      AskMore(const TXOwner& owner, TX< K, V >& t);
     };
 
     template < typename K, typename V, typename K_Hash,
@@ -102,7 +127,16 @@ namespace llarp
       auto itr = tx.find(owner);
       if(itr == tx.end())
       {
-        return nullptr;
+        auto asked = parallel.find(owner);
+        if(asked == parallel.end())
+        {
+          return nullptr;
+        }
+        itr = tx.find(asked->second.owner);
+        if(itr == tx.end())
+        {
+          return nullptr;
+        }
       }
 
       return itr->second.get();
@@ -128,6 +162,13 @@ namespace llarp
       if(count == 0)
       {
         t->Start(askpeer);
+        if(t->Parallelism())
+        {
+          t->peersAsked.insert(askpeer.node);
+          parallel.emplace(askpeer, Asked{askpeer, time_now_ms()});
+          t->pending = 1;
+          AskMore(askpeer, *t);
+        }
       }
     }
 
@@ -137,8 +178,14 @@ namespace llarp
     TXHolder< K, V, K_Hash, requestTimeoutMS >::NotFound(
         const TXOwner& from, const std::unique_ptr< Key_t >& next)
     {
+      if(parallel.find(from) != parallel.end())
+      {
+        PeerNotFound(from, next, true);
+        return;
+      }
       auto txitr = tx.find(from);
-      if(txitr == tx.end())
+      // a parallel tx heard from this peer already
+      if(txitr == tx.end() || txitr->second->Parallelism())
       {
         return;
       }
@@ -148,6 +195,94 @@ namespace llarp
         Inform(from, txitr->second->target, {}, true, true);
     }
 
+    template < typename K, typename V, typename K_Hash,
+               llarp_time_t requestTimeoutMS >
+    void
+    TXHolder< K, V, K_Hash, requestTimeoutMS >::PeerNotFound(
+        const TXOwner& from, const std::unique_ptr< Key_t >& next,
+        bool answered)
+    {
+      auto asked = parallel.find(from);
+      if(asked == parallel.end())
+      {
+        return;
+      }
+      const TXOwner owner = asked->second.owner;
+      parallel.erase(asked);
+      auto txitr = tx.find(owner);
+      if(txitr == tx.end())
+      {
+        return;
+      }
+      auto& t = *txitr->second;
+      --t.pending;
+      if(answered)
+      {
+        const Key_t target = t.TargetKey();
+        if(!t.anyAnswered
+           || (from.node ^ target) < (t.closestAnswered ^ target))
+          t.closestAnswered = from.node;
+        t.anyAnswered = true;
+        // a hint that isn't closer than who gave it doesn't get us anywhere
+        if(next && (*next ^ target) < (from.node ^ target)
+           && t.peersAsked.count(*next) == 0)
+          t.closerPeers.emplace_back(*next);
+      }
+      if(!AskMore(owner, t))
+        Inform(owner, t.target, {}, true, true);
+    }
+
+    template < typename K, typename V, typename K_Hash,
+               llarp_time_t requestTimeoutMS >
+    void
+    TXHolder< K, V, K_Hash, requestTimeoutMS >::Ask(const TXOwner& owner,
+                                                    TX< K, V >& t,
+                                                    const Key_t& peer)
+    {
+      // same txid, the reply is told apart by who it came from
+      const TXOwner askpeer(peer, owner.txid);
+      t.peersAsked.insert(peer);
+      parallel.emplace(askpeer, Asked{owner, time_now_ms()});
+      ++t.pending;
+      t.Start(askpeer);
+    }
+
+    template < typename K, typename V, typename K_Hash,
+               llarp_time_t requestTimeoutMS >
+    bool
+    TXHolder< K, V, K_Hash, requestTimeoutMS >::AskMore(const TXOwner& owner,
+                                                        TX< K, V >& t)
+    {
+      const size_t maxPeers = LookupMaxPeers * t.Parallelism();
+      const Key_t target = t.TargetKey();
+      Key_t peer;
+      while(t.pending < t.Parallelism() && t.peersAsked.size() < maxPeers)
+      {
+        // the peer we heard of last is the furthest along, then the closest
+        // we know ourselves
+        const bool hinted = !t.closerPeers.empty();
+        if(hinted)
+        {
+          peer = t.closerPeers.back();
+          t.closerPeers.pop_back();
+          if(t.peersAsked.count(peer))
+            continue;
+        }
+        else if(!t.GetNextPeer(peer, t.peersAsked))
+          break;
+        if(t.anyAnswered
+           && !((peer ^ target) < (t.closestAnswered ^ target)))
+        {
+          // the ones we know ourselves only get further away from here
+          if(hinted)
+            continue;
+          break;
+        }
+        Ask(owner, t, peer);
+      }
+      return t.pending > 0;
+    }
+
     template < typename K, typename V, typename K_Hash,
                llarp_time_t requestTimeoutMS >
     void
@@ -171,6 +306,16 @@ namespace llarp
           {
             txitr->second->SendReply();
             tx.erase(txitr);
+            // replies still coming from the other peers it asked are
+            // unwarranted now
+            auto asked = parallel.begin();
+            while(asked != parallel.end())
+            {
+              if(asked->second.owner == itr->second)
+                asked = parallel.erase(asked);
+              else
+                ++asked;
+            }
           }
         }
         ++itr;
@@ -192,6 +337,18 @@ namespace llarp
     void
     TXHolder< K, V, K_Hash, requestTimeoutMS >::Expire(llarp_time_t now)
     {
+      // a peer that is slow to answer a parallel tx counts as not having
+      // it, so the tx moves on to the next one
+      std::vector< TXOwner > slow;
+      for(const auto& item : parallel)
+      {
+        if(now > item.second.at
+           && now - item.second.at >= LookupPeerTimeout)
+          slow.emplace_back(item.first);
+      }
+      for(const auto& peer : slow)
+        PeerNotFound(peer, nullptr, false);
+
       auto itr = timeouts.begin();
       while(itr != timeouts.end())
       {
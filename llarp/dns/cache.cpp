@@ -0,0 +1,262 @@
+#include <dns/cache.hpp>
+
+#include <dns/dns.hpp>
+#include <util/endian.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace llarp
+{
+  namespace dns
+  {
+    constexpr size_t Cache::NumShards;
+    constexpr size_t Cache::DefaultMaxEntries;
+    constexpr RR_TTL_t Cache::MaxTTL;
+    constexpr RR_TTL_t Cache::MaxNegativeTTL;
+    constexpr RR_TTL_t Cache::PrefetchPercent;
+    constexpr uint64_t Cache::PrefetchMinHits;
+
+    /// move pos past a possibly compressed name
+    static bool
+    SkipName(const Cache::Buffer_t& msg, size_t& pos)
+    {
+      while(pos < msg.size())
+      {
+        const byte_t len = msg[pos];
+        if(len == 0)
+        {
+          ++pos;
+          return true;
+        }
+        if((len & 0xc0) == 0xc0)
+        {
+          pos += 2;
+          return pos <= msg.size();
+        }
+        if(len & 0xc0)
+          return false;
+        pos += 1 + len;
+      }
+      return false;
+    }
+
+    /// what we need to know about a reply to cache it
+    struct ReplyInfo
+    {
+      uint16_t rcode  = 0;
+      bool truncated  = false;
+      size_t answers  = 0;
+      RR_TTL_t minTTL = Cache::MaxTTL;
+      /// min of the soa's ttl and minimum field, rfc 2308 section 5
+      RR_TTL_t soaTTL = 0;
+      bool hasSOA     = false;
+      std::vector< size_t > ttlOffsets;
+    };
+
+    /// walk the records of a reply without decoding names
+    static bool
+    ParseReply(const Cache::Buffer_t& msg, ReplyInfo& info)
+    {
+      if(msg.size() < MessageHeader::Size)
+        return false;
+      const uint16_t fields = bufbe16toh(msg.data() + 2);
+      info.rcode            = fields & flags_RCODEMask;
+      info.truncated        = fields & flags_TC;
+      const size_t qdcount  = bufbe16toh(msg.data() + 4);
+      const size_t ancount  = bufbe16toh(msg.data() + 6);
+      const size_t nscount  = bufbe16toh(msg.data() + 8);
+      const size_t arcount  = bufbe16toh(msg.data() + 10);
+      size_t pos            = MessageHeader::Size;
+      for(size_t idx = 0; idx < qdcount; ++idx)
+      {
+        if(!SkipName(msg, pos))
+          return false;
+        pos += 4;
+      }
+      const size_t records = ancount + nscount + arcount;
+      for(size_t idx = 0; idx < records; ++idx)
+      {
+        // type, class, ttl and rdata length after the name
+        if(!SkipName(msg, pos) || pos + 10 > msg.size())
+          return false;
+        const RRType_t type  = bufbe16toh(msg.data() + pos);
+        const RR_TTL_t ttl   = bufbe32toh(msg.data() + pos + 4);
+        const size_t rdlen   = bufbe16toh(msg.data() + pos + 8);
+        const size_t rdstart = pos + 10;
+        if(rdstart + rdlen > msg.size())
+          return false;
+        // the ttl of an opt record is edns flags
+        if(type != qTypeOPT)
+        {
+          info.ttlOffsets.emplace_back(pos + 4);
+          info.minTTL = std::min(info.minTTL, ttl);
+        }
+        const bool authority = idx >= ancount && idx < ancount + nscount;
+        if(authority && type == qTypeSOA && rdlen >= 4)
+        {
+          // minimum is the last field
+          info.hasSOA = true;
+          const RR_TTL_t minimum = bufbe32toh(msg.data() + rdstart + rdlen - 4);
+          info.soaTTL            = std::min(ttl, minimum);
+        }
+        pos = rdstart + rdlen;
+      }
+      info.answers = ancount;
+      return true;
+    }
+
+    Cache::Cache(size_t maxEntries)
+        : m_MaxPerShard(std::max< size_t >(1, maxEntries / NumShards))
+    {
+    }
+
+    std::string
+    Cache::Key(const Question& q)
+    {
+      std::string key = q.qname;
+      std::transform(key.begin(), key.end(), key.begin(),
+                     [](unsigned char ch) { return std::tolower(ch); });
+      key += ':';
+      key += std::to_string(q.qtype);
+      key += ':';
+      key += std::to_string(q.qclass);
+      return key;
+    }
+
+    Cache::Shard&
+    Cache::ShardFor(const std::string& key)
+    {
+      return m_Shards[std::hash< std::string >{}(key) % NumShards];
+    }
+
+    bool
+    Cache::Get(const std::string& key, MsgID_t id, llarp_time_t now,
+               Buffer_t& reply, bool& prefetch)
+    {
+      prefetch     = false;
+      Shard& shard = ShardFor(key);
+      util::Lock lock(&shard.mutex);
+      auto itr = shard.index.find(key);
+      if(itr == shard.index.end())
+      {
+        m_Misses++;
+        return false;
+      }
+      Entry& entry = *itr->second;
+      if(now >= entry.ExpiresAt())
+      {
+        shard.lru.erase(itr->second);
+        shard.index.erase(itr);
+        m_Size--;
+        m_Expired++;
+        m_Misses++;
+        return false;
+      }
+      shard.lru.splice(shard.lru.begin(), shard.lru, itr->second);
+      entry.hits++;
+      if(entry.negative)
+        m_NegativeHits++;
+      else
+        m_Hits++;
+
+      const llarp_time_t left = entry.ExpiresAt() - now;
+      if(not entry.prefetching && entry.hits >= PrefetchMinHits
+         && left * 100 <= llarp_time_t(entry.ttl) * 1000 * PrefetchPercent)
+      {
+        entry.prefetching = true;
+        prefetch          = true;
+      }
+
+      reply = entry.reply;
+      htobe16buf(reply.data(), id);
+      const RR_TTL_t elapsed = (now - entry.insertedAt) / 1000;
+      for(const auto offset : entry.ttlOffsets)
+      {
+        const RR_TTL_t ttl = bufbe32toh(reply.data() + offset);
+        htobe32buf(reply.data() + offset, ttl > elapsed ? ttl - elapsed : 0);
+      }
+      return true;
+    }
+
+    bool
+    Cache::Put(const std::string& key, const Buffer_t& reply, llarp_time_t now)
+    {
+      ReplyInfo info;
+      if(!ParseReply(reply, info) || info.truncated)
+      {
+        m_Uncacheable++;
+        return false;
+      }
+      RR_TTL_t ttl  = 0;
+      bool negative = false;
+      if(info.rcode == flags_RCODENoError && info.answers > 0)
+        ttl = std::min(info.minTTL, MaxTTL);
+      else if((info.rcode == flags_RCODENameError
+               || info.rcode == flags_RCODENoError)
+              && info.hasSOA)
+      {
+        // nxdomain or nodata
+        ttl      = std::min(info.soaTTL, MaxNegativeTTL);
+        negative = true;
+      }
+      if(ttl == 0)
+      {
+        m_Uncacheable++;
+        return false;
+      }
+
+      Shard& shard = ShardFor(key);
+      util::Lock lock(&shard.mutex);
+      auto itr = shard.index.find(key);
+      if(itr != shard.index.end())
+      {
+        shard.lru.erase(itr->second);
+        shard.index.erase(itr);
+        m_Size--;
+      }
+      shard.lru.emplace_front();
+      Entry& entry     = shard.lru.front();
+      entry.key        = key;
+      entry.reply      = reply;
+      entry.ttlOffsets = std::move(info.ttlOffsets);
+      entry.insertedAt = now;
+      entry.ttl        = ttl;
+      entry.negative   = negative;
+      shard.index[key] = shard.lru.begin();
+      m_Size++;
+      while(shard.lru.size() > m_MaxPerShard)
+      {
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        m_Size--;
+        m_Evicted++;
+      }
+      return true;
+    }
+
+    size_t
+    Cache::Size() const
+    {
+      return m_Size.load();
+    }
+
+    util::StatusObject
+    Cache::ExtractStatus() const
+    {
+      const uint64_t hits    = m_Hits.load() + m_NegativeHits.load();
+      const uint64_t lookups = hits + m_Misses.load();
+      return util::StatusObject{
+          {"entries", Size()},
+          {"maxEntries", m_MaxPerShard * NumShards},
+          {"hits", m_Hits.load()},
+          {"negativeHits", m_NegativeHits.load()},
+          {"misses", m_Misses.load()},
+          {"hitRatio", lookups ? double(hits) / lookups : 0.0},
+          {"expired", m_Expired.load()},
+          {"evicted", m_Evicted.load()},
+          {"uncacheable", m_Uncacheable.load()}};
+    }
+  }  // namespace dns
+}  // namespace llarp
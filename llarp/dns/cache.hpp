@@ -0,0 +1,116 @@
+#ifndef LLARP_DNS_CACHE_HPP
+#define LLARP_DNS_CACHE_HPP
+
+#include <dns/message.hpp>
+#include <util/status.hpp>
+#include <util/thread/threading.hpp>
+#include <util/types.hpp>
+
+#include <absl/base/thread_annotations.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  namespace dns
+  {
+    /// ttl aware cache of dns replies in wire format keyed by question. split
+    /// into shards that each have their own lock and lru so lookups for
+    /// different names don't contend.
+    ///
+    /// replies are kept as we got them and only the ttls and message id are
+    /// rewritten on the way out, so nothing upstream sent is lost to a
+    /// decode and encode round trip.
+    struct Cache
+    {
+      using Buffer_t = std::vector< byte_t >;
+
+      static constexpr size_t NumShards         = 16;
+      static constexpr size_t DefaultMaxEntries = 4096;
+      /// keep nothing longer than this whatever the ttl says
+      static constexpr RR_TTL_t MaxTTL = 86400;
+      /// rfc 2308 says 1 to 3 hours, we'd rather notice new names sooner
+      static constexpr RR_TTL_t MaxNegativeTTL = 900;
+      /// refresh an entry once this much of its ttl is left
+      static constexpr RR_TTL_t PrefetchPercent = 10;
+      /// only refresh entries that were asked for at least this often
+      static constexpr uint64_t PrefetchMinHits = 2;
+
+      explicit Cache(size_t maxEntries = DefaultMaxEntries);
+
+      /// what we cache a question under, names are case insensitive
+      static std::string
+      Key(const Question& q);
+
+      /// get a reply for key with id as its message id and the ttls counted
+      /// down. prefetch is set on the first hit that finds the entry close
+      /// enough to expiry that it should be refreshed.
+      bool
+      Get(const std::string& key, MsgID_t id, llarp_time_t now,
+          Buffer_t& reply, bool& prefetch);
+
+      /// cache a reply to key for as long as its ttls allow. negative replies
+      /// are only cached with an soa to take the ttl from as per rfc 2308.
+      /// returns false if the reply can't be cached.
+      bool
+      Put(const std::string& key, const Buffer_t& reply, llarp_time_t now);
+
+      size_t
+      Size() const;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Entry
+      {
+        std::string key;
+        Buffer_t reply;
+        /// where the ttls we count down are in reply
+        std::vector< size_t > ttlOffsets;
+        llarp_time_t insertedAt;
+        RR_TTL_t ttl;
+        bool negative;
+        uint64_t hits    = 0;
+        bool prefetching = false;
+
+        llarp_time_t
+        ExpiresAt() const
+        {
+          return insertedAt + llarp_time_t(ttl) * 1000;
+        }
+      };
+
+      using LRU_t = std::list< Entry >;
+
+      struct Shard
+      {
+        util::Mutex mutex;
+        /// most recently used at the front
+        LRU_t lru GUARDED_BY(mutex);
+        std::unordered_map< std::string, LRU_t::iterator > index
+            GUARDED_BY(mutex);
+      };
+
+      Shard&
+      ShardFor(const std::string& key);
+
+      const size_t m_MaxPerShard;
+      std::array< Shard, NumShards > m_Shards;
+      std::atomic< size_t > m_Size{0};
+      std::atomic< uint64_t > m_Hits{0};
+      std::atomic< uint64_t > m_NegativeHits{0};
+      std::atomic< uint64_t > m_Misses{0};
+      std::atomic< uint64_t > m_Expired{0};
+      std::atomic< uint64_t > m_Evicted{0};
+      std::atomic< uint64_t > m_Uncacheable{0};
+    };
+  }  // namespace dns
+}  // namespace llarp
+
+#endif
@@ -1,7 +1,10 @@
 #include <dns/server.hpp>
 
 #include <crypto/crypto.hpp>
+#include <dns/dns.hpp>
+#include <util/endian.hpp>
 #include <util/thread/logic.hpp>
+#include <util/time.hpp>
 #include <array>
 #include <utility>
 
@@ -9,6 +12,9 @@ namespace llarp
 {
   namespace dns
   {
+    constexpr llarp_time_t Proxy::PendingTimeout;
+    constexpr llarp_time_t Proxy::ResendInterval;
+
     Proxy::Proxy(llarp_ev_loop_ptr serverLoop, Logic_ptr serverLogic,
                  llarp_ev_loop_ptr clientLoop, Logic_ptr clientLogic,
                  IQueryHandler* h)
@@ -31,6 +37,26 @@ namespace llarp
     {
     }
 
+    util::StatusObject
+    Proxy::ExtractStatus() const
+    {
+      auto obj          = m_Cache.ExtractStatus();
+      obj["coalesced"]  = m_Coalesced.load();
+      obj["prefetched"] = m_Prefetched.load();
+      return obj;
+    }
+
+    bool
+    Proxy::Pending::HasWaiter(const llarp::Addr& from, MsgID_t txid) const
+    {
+      for(const auto& waiter : waiters)
+      {
+        if(waiter.txid == txid && waiter.from == from)
+          return true;
+      }
+      return false;
+    }
+
     bool
     Proxy::Start(const llarp::Addr addr,
                  const std::vector< llarp::Addr >& resolvers)
@@ -134,10 +160,21 @@ namespace llarp
       });
     }
 
+    void
+    Proxy::SendRawServerMessageTo(llarp::Addr to, Buffer_t buf)
+    {
+      auto self = shared_from_this();
+      LogicCall(m_ServerLogic, [to, buf, self]() {
+        const llarp_buffer_t tmpbuf(buf);
+        llarp_ev_udp_sendto(&self->m_Server, to, tmpbuf);
+      });
+    }
+
     void
     Proxy::HandlePktClient(llarp::Addr from, Buffer_t buf)
     {
       MessageHeader hdr;
+      Question question;
       {
         llarp_buffer_t pkt(buf);
         if(!hdr.Decode(&pkt))
@@ -145,21 +182,124 @@ namespace llarp
           llarp::LogWarn("failed to parse dns header from ", from);
           return;
         }
+        // a txid is easy to guess, so only something that answers exactly
+        // what we asked may go into the cache
+        if((hdr.fields & flags_QR) == 0 || hdr.qd_count != 1
+           || !question.Decode(&pkt))
+        {
+          llarp::LogWarn("dropping dns packet from ", from,
+                         " that is not a reply");
+          return;
+        }
       }
       TX tx    = {hdr.id, from};
       auto itr = m_Forwarded.find(tx);
       if(itr == m_Forwarded.end())
         return;
+      if(Cache::Key(question) != itr->second)
+      {
+        llarp::LogWarn("dropping dns reply from ", from,
+                       " to a question we did not ask");
+        return;
+      }
+      const std::string key = itr->second;
+      m_Forwarded.erase(itr);
+      HandleReply(key, buf);
+    }
 
-      const Addr requester = itr->second;
-      auto self            = shared_from_this();
-      LogicCall(m_ServerLogic, [=]() {
-        // forward reply to requester via server
-        const llarp_buffer_t tmpbuf(buf);
-        llarp_ev_udp_sendto(&self->m_Server, requester, tmpbuf);
+    void
+    Proxy::HandleReply(const std::string& key, const Buffer_t& reply)
+    {
+      m_Cache.Put(key, reply, llarp::time_now_ms());
+      auto itr = m_Pending.find(key);
+      // a second answer to something we resent
+      if(itr == m_Pending.end())
+        return;
+      for(const auto& tx : itr->second.sent)
+        m_Forwarded.erase(tx);
+      for(const auto& waiter : itr->second.waiters)
+      {
+        Buffer_t buf = reply;
+        htobe16buf(buf.data(), waiter.txid);
+        SendRawServerMessageTo(waiter.from, std::move(buf));
+      }
+      m_Pending.erase(itr);
+    }
+
+    void
+    Proxy::ExpirePending(llarp_time_t now)
+    {
+      if(now - m_LastExpire < PendingTimeout)
+        return;
+      m_LastExpire = now;
+      auto itr     = m_Pending.begin();
+      while(itr != m_Pending.end())
+      {
+        if(now - itr->second.startedAt > PendingTimeout)
+        {
+          for(const auto& tx : itr->second.sent)
+            m_Forwarded.erase(tx);
+          itr = m_Pending.erase(itr);
+        }
+        else
+          ++itr;
+      }
+    }
+
+    void
+    Proxy::SendUpstream(const std::string& key, Pending& pending,
+                        const Buffer_t& query, llarp_time_t now)
+    {
+      TX tx = {0, PickRandomResolver()};
+      do
+      {
+        tx.txid = llarp::randint();
+      } while(m_Forwarded.find(tx) != m_Forwarded.end());
+      m_Forwarded[tx]  = key;
+      pending.lastSent = now;
+      pending.sent.emplace_back(tx);
+
+      Buffer_t pkt = query;
+      htobe16buf(pkt.data(), tx.txid);
+      auto self = shared_from_this();
+      LogicCall(m_ClientLogic, [self, tx, pkt]() {
+        // do query
+        const llarp_buffer_t tmpbuf(pkt);
+        llarp_ev_udp_sendto(&self->m_Client, tx.from, tmpbuf);
       });
-      // remove pending
-      m_Forwarded.erase(itr);
+    }
+
+    void
+    Proxy::StartResolving(const std::string& key, Message&& msg,
+                          const Buffer_t& query, bool hooked, llarp_time_t now)
+    {
+      Pending& pending  = m_Pending[key];
+      pending.startedAt = now;
+      pending.hooked    = hooked;
+      if(not hooked)
+      {
+        SendUpstream(key, pending, query, now);
+        return;
+      }
+      auto self        = shared_from_this();
+      const auto reply = [self, key](Message answer) {
+        LogicCall(self->m_ServerLogic, [self, key, answer]() {
+          std::array< byte_t, 1500 > tmp = {{0}};
+          llarp_buffer_t buf(tmp);
+          if(!answer.Encode(&buf))
+          {
+            llarp::LogWarn("failed to encode dns message when sending");
+            return;
+          }
+          self->HandleReply(key, Buffer_t(buf.base, buf.cur));
+        });
+      };
+      // the handler may have answered already, so no touching pending after
+      if(!m_QueryHandler->HandleHookedDNSMessage(std::move(msg), reply))
+      {
+        llarp::LogWarn("failed to handle hooked dns");
+        m_Pending.erase(key);
+      }
     }
 
     void
@@ -173,8 +313,6 @@ namespace llarp
         return;
       }
 
-      TX tx    = {hdr.id, from};
-      auto itr = m_Forwarded.find(tx);
       Message msg(hdr);
       if(!msg.Decode(&pkt))
       {
@@ -200,45 +338,61 @@ namespace llarp
         }
       }
 
-      auto self = shared_from_this();
-      if(m_QueryHandler && m_QueryHandler->ShouldHookDNSMessage(msg))
-      {
-        if(!m_QueryHandler->HandleHookedDNSMessage(
-               std::move(msg),
-               std::bind(&Proxy::SendServerMessageTo, self, from,
-                         std::placeholders::_1)))
-        {
-          llarp::LogWarn("failed to handle hooked dns");
-        }
-      }
-      else if(m_Resolvers.size() == 0)
+      const bool hooked =
+          m_QueryHandler && m_QueryHandler->ShouldHookDNSMessage(msg);
+      if(msg.questions.size() != 1 || (not hooked && m_Resolvers.size() == 0))
       {
-        // no upstream resolvers
+        // no upstream resolvers or a query we can't key
         // let's serv fail it
         msg.AddServFail();
 
         SendServerMessageTo(from, std::move(msg));
+        return;
       }
-      else if(itr == m_Forwarded.end())
+
+      const auto now        = llarp::time_now_ms();
+      const std::string key = Cache::Key(msg.questions[0]);
+      Buffer_t reply;
+      bool prefetch = false;
+      if(m_Cache.Get(key, hdr.id, now, reply, prefetch))
       {
-        // new forwarded query
-        tx.from         = PickRandomResolver();
-        m_Forwarded[tx] = from;
-        LogicCall(m_ClientLogic, [=] {
-          // do query
-          const llarp_buffer_t tmpbuf(buf);
-          llarp_ev_udp_sendto(&self->m_Client, tx.from, tmpbuf);
-        });
+        SendRawServerMessageTo(from, std::move(reply));
+        // refresh it before it expires so popular names never miss
+        if(prefetch && m_Pending.find(key) == m_Pending.end())
+        {
+          m_Prefetched++;
+          StartResolving(key, std::move(msg), buf, hooked, now);
+        }
+        return;
+      }
+
+      ExpirePending(now);
+      auto itr = m_Pending.find(key);
+      if(itr != m_Pending.end() && now - itr->second.startedAt > PendingTimeout)
+      {
+        for(const auto& tx : itr->second.sent)
+          m_Forwarded.erase(tx);
+        m_Pending.erase(itr);
+        itr = m_Pending.end();
+      }
+      if(itr == m_Pending.end())
+      {
+        // the handler may answer right away so we wait on it before asking
+        m_Pending[key].waiters.push_back({from, hdr.id});
+        StartResolving(key, std::move(msg), buf, hooked, now);
+        return;
       }
-      else
+      Pending& pending = itr->second;
+      if(not pending.HasWaiter(from, hdr.id))
+      {
+        // someone else asked already, wait on their answer
+        pending.waiters.push_back({from, hdr.id});
+        m_Coalesced++;
+      }
+      else if(not pending.hooked && now - pending.lastSent >= ResendInterval)
       {
         // send the query again because it's probably FEC from the requester
-        const auto resolver = itr->first.from;
-        LogicCall(m_ClientLogic, [=] {
-          // send it
-          const llarp_buffer_t tmpbuf(buf);
-          llarp_ev_udp_sendto(&self->m_Client, resolver, tmpbuf);
-        });
+        SendUpstream(key, pending, buf, now);
       }
     }
 
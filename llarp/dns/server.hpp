@@ -1,12 +1,14 @@
 #ifndef LLARP_DNS_SERVER_HPP
 #define LLARP_DNS_SERVER_HPP
 
+#include <dns/cache.hpp>
 #include <dns/message.hpp>
 #include <ev/ev.h>
 #include <net/net.hpp>
 #include <util/string_view.hpp>
 #include <util/thread/logic.hpp>
 
+#include <atomic>
 #include <unordered_map>
 
 namespace llarp
@@ -28,8 +30,16 @@ namespace llarp
                              std::function< void(Message) > sendReply) = 0;
     };
 
+    /// answers queries from its cache, hands them to the query handler if it
+    /// hooks them and forwards the rest to upstream resolvers. identical
+    /// queries in flight at the same time share one upstream request.
     struct Proxy : public std::enable_shared_from_this< Proxy >
     {
+      /// give up on a question if nothing answered it for this long
+      static constexpr llarp_time_t PendingTimeout = 5000;
+      /// send a query upstream again if the requester retries after this
+      static constexpr llarp_time_t ResendInterval = 1000;
+
       using Logic_ptr = std::shared_ptr< Logic >;
       Proxy(llarp_ev_loop_ptr serverLoop, Logic_ptr serverLogic,
             llarp_ev_loop_ptr clientLoop, Logic_ptr clientLogic,
@@ -42,6 +52,9 @@ namespace llarp
       void
       Stop();
 
+      util::StatusObject
+      ExtractStatus() const;
+
       using Buffer_t = std::vector< uint8_t >;
 
      private:
@@ -72,6 +85,30 @@ namespace llarp
       void
       SendServerMessageTo(llarp::Addr to, Message msg);
 
+      void
+      SendRawServerMessageTo(llarp::Addr to, Buffer_t buf);
+
+      struct Pending;
+
+      /// start resolving the question under key for whoever waits on it in
+      /// m_Pending
+      void
+      StartResolving(const std::string& key, Message&& msg,
+                     const Buffer_t& query, bool hooked, llarp_time_t now);
+
+      void
+      SendUpstream(const std::string& key, Pending& pending,
+                   const Buffer_t& query, llarp_time_t now);
+
+      /// cache a reply to the question under key and send it to everyone
+      /// waiting on it
+      void
+      HandleReply(const std::string& key, const Buffer_t& reply);
+
+      /// forget questions nothing answered in time
+      void
+      ExpirePending(llarp_time_t now);
+
       llarp::Addr
       PickRandomResolver() const;
 
@@ -106,8 +143,33 @@ namespace llarp
         };
       };
 
-      // maps tx to who to send reply to
-      std::unordered_map< TX, llarp::Addr, TX::Hash > m_Forwarded;
+      /// a question we are waiting on an answer to
+      struct Pending
+      {
+        struct Waiter
+        {
+          llarp::Addr from;
+          MsgID_t txid;
+        };
+
+        std::vector< Waiter > waiters;
+        /// what we sent upstream for it
+        std::vector< TX > sent;
+        llarp_time_t startedAt = 0;
+        llarp_time_t lastSent  = 0;
+        bool hooked            = false;
+
+        bool
+        HasWaiter(const llarp::Addr& from, MsgID_t txid) const;
+      };
+
+      Cache m_Cache;
+      std::unordered_map< std::string, Pending > m_Pending;
+      llarp_time_t m_LastExpire = 0;
+      // maps upstream tx to the question it asks
+      std::unordered_map< TX, std::string, TX::Hash > m_Forwarded;
+      std::atomic< uint64_t > m_Coalesced{0};
+      std::atomic< uint64_t > m_Prefetched{0};
     };
   }  // namespace dns
 }  // namespace llarp
@@ -31,7 +31,7 @@ llarp_ev_loop_run_single_process(llarp_ev_loop_ptr ev,
   {
     ev->update_time();
     ev->tick(EV_TICK_INTERVAL);
-    llarp::LogContext::Instance().logStream->Tick(ev->time_now());
+    llarp::LogContext::Instance().Tick(ev->time_now());
   }
   logic->clear_event_loop();
   ev->stopped();
@@ -47,6 +47,48 @@ llarp_ev_add_udp(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
   return -1;
 }
 
+int
+llarp_ev_add_udp_batched(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
+                         const struct sockaddr *src)
+{
+  udp->parent = ev;
+  if(ev->udp_listen_batched(udp, src))
+    return 0;
+  return -1;
+}
+
+int
+llarp_ev_add_udp_shard(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
+                       const struct sockaddr *src, size_t index, size_t count)
+{
+  udp->parent = ev;
+  if(ev->udp_listen_shard(udp, src, index, count))
+    return 0;
+  return -1;
+}
+
+size_t
+llarp_ev_udp_shard_for(const struct sockaddr *remote, size_t count)
+{
+  if(count <= 1)
+    return 0;
+  // last 32 bits of the remote ip in host order, this is the word the
+  // reuseport steering program loads so both sides agree
+  uint32_t word = 0;
+  if(remote->sa_family == AF_INET)
+  {
+    const auto *sin = reinterpret_cast< const sockaddr_in * >(remote);
+    std::memcpy(&word, &sin->sin_addr, sizeof(word));
+  }
+  else
+  {
+    const auto *sin6 = reinterpret_cast< const sockaddr_in6 * >(remote);
+    std::memcpy(&word, sin6->sin6_addr.s6_addr + 12, sizeof(word));
+  }
+  const uint32_t hash = (ntohl(word) * LLARP_UDP_SHARD_MULTIPLIER) >> 16;
+  return hash % count;
+}
+
 int
 llarp_ev_close_udp(struct llarp_udp_io *udp)
 {
@@ -32,6 +32,9 @@
 
 #define EV_TICK_INTERVAL 10
 
+/// multiplicative hash constant used to pick the udp shard for a remote
+#define LLARP_UDP_SHARD_MULTIPLIER 0x9e3779b1u
+
 // forward declare
 struct llarp_threadpool;
 
@@ -95,6 +98,23 @@ int
 llarp_ev_add_udp(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
                  const struct sockaddr *src);
 
+/// add UDP handler that drains and flushes datagrams in batches
+/// (recvmmsg/sendmmsg on linux), behaves as llarp_ev_add_udp elsewhere
+int
+llarp_ev_add_udp_batched(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
+                         const struct sockaddr *src);
+
+/// add UDP handler as shard index of count batched sockets bound to the same
+/// address with SO_REUSEPORT, datagrams from a remote are steered to the
+/// shard llarp_ev_udp_shard_for picks for it. returns -1 where unsupported
+int
+llarp_ev_add_udp_shard(struct llarp_ev_loop *ev, struct llarp_udp_io *udp,
+                       const struct sockaddr *src, size_t index, size_t count);
+
+/// index of the shard that owns remote when there are count shards
+size_t
+llarp_ev_udp_shard_for(const struct sockaddr *remote, size_t count);
+
 /// send a UDP packet
 int
 llarp_ev_udp_sendto(struct llarp_udp_io *udp, const struct sockaddr *to,
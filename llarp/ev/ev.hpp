@@ -4,6 +4,7 @@
 #include <net/net_addr.hpp>
 #include <ev/ev.h>
 #include <util/buffer.hpp>
+#include <util/buffer_pool.hpp>
 #include <util/codel.hpp>
 #include <util/thread/threading.hpp>
 
@@ -757,6 +758,22 @@ struct llarp_ev_loop
   virtual bool
   udp_listen(llarp_udp_io* l, const sockaddr* src) = 0;
 
+  /// listen for udp in batched mode, falls back to udp_listen if the
+  /// platform has no batched datagram syscalls
+  virtual bool
+  udp_listen_batched(llarp_udp_io* l, const sockaddr* src)
+  {
+    return udp_listen(l, src);
+  }
+
+  /// listen for udp as shard index of count sockets sharing src, returns
+  /// false if the platform can't do that
+  virtual bool
+  udp_listen_shard(llarp_udp_io*, const sockaddr*, size_t, size_t)
+  {
+    return false;
+  }
+
   virtual bool
   udp_close(llarp_udp_io* l) = 0;
   /// deregister event listener
@@ -825,45 +842,35 @@ struct llarp_ev_loop
   call_soon(std::function< void(void) > f) = 0;
 };
 
+/// a single datagram held in a pooled buffer
 struct PacketBuffer
 {
-  PacketBuffer(PacketBuffer&& other)
-  {
-    _ptr       = other._ptr;
-    _sz        = other._sz;
-    other._ptr = nullptr;
-    other._sz  = 0;
-  }
+  PacketBuffer(PacketBuffer&& other) = default;
 
   PacketBuffer(const PacketBuffer&) = delete;
 
   PacketBuffer&
   operator=(const PacketBuffer&) = delete;
 
-  PacketBuffer() : PacketBuffer(nullptr, 0){};
-  explicit PacketBuffer(size_t sz) : _sz{sz}
-  {
-    _ptr = new char[sz];
-  }
-  PacketBuffer(char* buf, size_t sz)
+  PacketBuffer&
+  operator=(PacketBuffer&&) = default;
+
+  PacketBuffer() = default;
+  explicit PacketBuffer(size_t sz) : _buf{sz}
   {
-    _ptr = buf;
-    _sz  = sz;
   }
-  ~PacketBuffer()
+  explicit PacketBuffer(llarp::PooledBuffer buf) : _buf{std::move(buf)}
   {
-    if(_ptr)
-      delete[] _ptr;
   }
   byte_t*
   data()
   {
-    return (byte_t*)_ptr;
+    return _buf.data();
   }
   size_t
   size()
   {
-    return _sz;
+    return _buf.size();
   }
   byte_t& operator[](size_t sz)
   {
@@ -872,15 +879,11 @@ struct PacketBuffer
   void
   reserve(size_t sz)
   {
-    if(_ptr)
-      delete[] _ptr;
-    _ptr = new char[sz];
-    _sz  = sz;
+    _buf = llarp::PooledBuffer(sz);
   }
 
  private:
-  char* _ptr = nullptr;
-  size_t _sz = 0;
+  llarp::PooledBuffer _buf;
 };
 
 struct PacketEvent
@@ -1,9 +1,21 @@
 #include <ev/ev_libuv.hpp>
 #include <net/net_addr.hpp>
+#include <net/offload.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
 
+#include <array>
 #include <cstring>
+#include <limits>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 namespace libuv
 {
@@ -389,14 +401,23 @@ namespace libuv
     uv_check_t m_Ticker;
   };
 
-  struct udp_glue : public glue
+  /// common interface for the udp glue implementations
+  struct udp_glue_base : public glue
+  {
+    /// get all packets recv'd since the last call
+    virtual bool
+    RecvMany(llarp_pkt_list* pkts) = 0;
+  };
+
+  struct udp_glue : public udp_glue_base
   {
     uv_udp_t m_Handle;
     uv_check_t m_Ticker;
     llarp_udp_io* const m_UDP;
     llarp::Addr m_Addr;
     llarp_pkt_list m_LastPackets;
-    std::array< char, 1500 > m_Buffer;
+    /// pooled buffer libuv reads the next datagram into
+    llarp::PooledBuffer m_RecvBuf;
 
     udp_glue(uv_loop_t* loop, llarp_udp_io* udp, const sockaddr* src)
         : m_UDP(udp), m_Addr(*src)
@@ -408,11 +429,14 @@ namespace libuv
     }
 
     static void
-    Alloc(uv_handle_t*, size_t suggested_size, uv_buf_t* buf)
+    Alloc(uv_handle_t* h, size_t, uv_buf_t* buf)
     {
-      const size_t sz = std::min(suggested_size, size_t{1500});
-      buf->base       = new char[sz];
-      buf->len        = sz;
+      udp_glue* glue = static_cast< udp_glue* >(h->data);
+      // reuse the buffer unless the last datagram was handed off in it
+      if(glue->m_RecvBuf.empty())
+        glue->m_RecvBuf = llarp::PooledBuffer(size_t{1500});
+      buf->base = (char*)glue->m_RecvBuf.data();
+      buf->len  = glue->m_RecvBuf.size();
     }
 
     static void
@@ -422,13 +446,10 @@ namespace libuv
       udp_glue* glue = static_cast< udp_glue* >(handle->data);
       if(addr)
         glue->RecvFrom(nread, buf, addr);
-      if(nread <= 0 || glue->m_UDP == nullptr
-         || glue->m_UDP->recvfrom != nullptr)
-        delete[] buf->base;
     }
 
     bool
-    RecvMany(llarp_pkt_list* pkts)
+    RecvMany(llarp_pkt_list* pkts) override
     {
       *pkts         = std::move(m_LastPackets);
       m_LastPackets = llarp_pkt_list();
@@ -448,7 +469,8 @@ namespace libuv
         }
         else
         {
-          PacketBuffer pbuf(buf->base, pktsz);
+          m_RecvBuf.resize(pktsz);
+          PacketBuffer pbuf(std::move(m_RecvBuf));
           m_LastPackets.emplace_back(PacketEvent{*fromaddr, std::move(pbuf)});
         }
       }
@@ -471,7 +493,8 @@ namespace libuv
     static int
     SendTo(llarp_udp_io* udp, const sockaddr* to, const byte_t* ptr, size_t sz)
     {
-      auto* self = static_cast< udp_glue* >(udp->impl);
+      auto* self =
+          static_cast< udp_glue* >(static_cast< udp_glue_base* >(udp->impl));
       if(self == nullptr)
         return -1;
       uv_buf_t buf = uv_buf_init((char*)ptr, sz);
@@ -503,7 +526,7 @@ namespace libuv
         return false;
 #endif
       m_UDP->sendto = &SendTo;
-      m_UDP->impl   = this;
+      m_UDP->impl   = static_cast< udp_glue_base* >(this);
       return true;
     }
 
@@ -527,6 +550,483 @@ namespace libuv
     }
   };
 
+#if defined(__linux__)
+  /// udp glue that drains the socket with recvmmsg and flushes queued sends
+  /// with sendmmsg once per event loop iteration, consecutive equal sized
+  /// datagrams to the same remote are coalesced with UDP GSO when available
+  struct udp_batch_glue : public udp_glue_base
+  {
+    /// max number of datagrams moved per syscall
+    static constexpr size_t BatchSize = 64;
+    /// max number of recvmmsg calls per readable event
+    static constexpr size_t MaxDrainRounds = 16;
+    /// largest datagram we handle
+    static constexpr size_t MaxPacketSize = 1500;
+    /// largest payload the kernel accepts for one gso send
+    static constexpr size_t MaxGSOBytes = 64000;
+
+    struct SendSlot
+    {
+      sockaddr_storage to;
+      socklen_t tolen;
+      size_t sz;
+      std::array< byte_t, MaxPacketSize > data;
+    };
+
+    uv_poll_t m_Handle;
+    uv_check_t m_Ticker;
+    uv_async_t m_Flusher;
+    uv_loop_t* const m_Loop;
+    llarp_udp_io* const m_UDP;
+    llarp::Addr m_Addr;
+    llarp_pkt_list m_LastPackets;
+    int m_FD          = -1;
+    bool m_GSO        = false;
+    bool m_Closing    = false;
+    int m_OpenHandles = 0;
+
+    std::array< llarp::PooledBuffer, BatchSize > m_RecvSlots;
+    std::array< sockaddr_storage, BatchSize > m_RecvFrom;
+    std::array< iovec, BatchSize > m_RecvIOV;
+    std::array< mmsghdr, BatchSize > m_RecvMsgs;
+
+    std::mutex m_SendMutex;
+    std::array< SendSlot, BatchSize > m_SendQueue;
+    size_t m_SendCount = 0;
+    std::array< iovec, BatchSize > m_SendIOV;
+    std::array< mmsghdr, BatchSize > m_SendMsgs;
+    std::array< std::array< char, CMSG_SPACE(sizeof(uint16_t)) >, BatchSize >
+        m_SendControl;
+
+    /// our index among the sockets sharing m_Addr and how many there are
+    size_t m_ShardIndex = 0;
+    size_t m_NumShards  = 1;
+
+    udp_batch_glue(uv_loop_t* loop, llarp_udp_io* udp, const sockaddr* src,
+                   size_t shardIndex = 0, size_t numShards = 1)
+        : m_Loop(loop)
+        , m_UDP(udp)
+        , m_Addr(*src)
+        , m_ShardIndex(shardIndex)
+        , m_NumShards(numShards)
+    {
+      m_Handle.data  = this;
+      m_Ticker.data  = this;
+      m_Flusher.data = this;
+      std::memset(m_RecvMsgs.data(), 0, sizeof(m_RecvMsgs));
+      for(size_t idx = 0; idx < BatchSize; ++idx)
+      {
+        ArmSlot(idx);
+        m_RecvMsgs[idx].msg_hdr.msg_name   = &m_RecvFrom[idx];
+        m_RecvMsgs[idx].msg_hdr.msg_iov    = &m_RecvIOV[idx];
+        m_RecvMsgs[idx].msg_hdr.msg_iovlen = 1;
+      }
+    }
+
+    ~udp_batch_glue() override
+    {
+      if(m_FD != -1)
+        ::close(m_FD);
+    }
+
+    /// put a fresh buffer into a recv slot whose buffer was handed off
+    void
+    ArmSlot(size_t idx)
+    {
+      m_RecvSlots[idx]        = llarp::PooledBuffer(MaxPacketSize);
+      m_RecvIOV[idx].iov_base = m_RecvSlots[idx].data();
+      m_RecvIOV[idx].iov_len  = MaxPacketSize;
+    }
+
+    static socklen_t
+    SockLen(const sockaddr* addr)
+    {
+      return addr->sa_family == AF_INET ? sizeof(sockaddr_in)
+                                        : sizeof(sockaddr_in6);
+    }
+
+    static void
+    OnPoll(uv_poll_t* h, int status, int events)
+    {
+      if(status == 0 && (events & UV_READABLE))
+        static_cast< udp_batch_glue* >(h->data)->Drain();
+    }
+
+    void
+    Drain()
+    {
+      for(size_t round = 0; round < MaxDrainRounds; ++round)
+      {
+        for(auto& msg : m_RecvMsgs)
+        {
+          msg.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+          msg.msg_hdr.msg_flags   = 0;
+        }
+        const int got = ::recvmmsg(m_FD, m_RecvMsgs.data(), BatchSize,
+                                   MSG_DONTWAIT, nullptr);
+        if(got <= 0)
+          return;
+        for(int idx = 0; idx < got; ++idx)
+          RecvFrom(idx, m_RecvMsgs[idx]);
+        if(static_cast< size_t >(got) < BatchSize)
+          return;
+      }
+    }
+
+    void
+    RecvFrom(size_t idx, const mmsghdr& msg)
+    {
+      if(m_UDP == nullptr || msg.msg_len == 0
+         || (msg.msg_hdr.msg_flags & MSG_TRUNC))
+        return;
+      const auto* from = reinterpret_cast< const sockaddr* >(&m_RecvFrom[idx]);
+      if(m_UDP->recvfrom)
+      {
+        const llarp_buffer_t pkt(m_RecvSlots[idx].data(), msg.msg_len);
+        m_UDP->recvfrom(m_UDP, from, ManagedBuffer{pkt});
+      }
+      else
+      {
+        m_RecvSlots[idx].resize(msg.msg_len);
+        PacketBuffer pbuf(std::move(m_RecvSlots[idx]));
+        m_LastPackets.emplace_back(PacketEvent{*from, std::move(pbuf)});
+        ArmSlot(idx);
+      }
+    }
+
+    bool
+    RecvMany(llarp_pkt_list* pkts) override
+    {
+      *pkts         = std::move(m_LastPackets);
+      m_LastPackets = llarp_pkt_list();
+      return pkts->size() > 0;
+    }
+
+    static int
+    SendTo(llarp_udp_io* udp, const sockaddr* to, const byte_t* ptr, size_t sz)
+    {
+      auto* self = static_cast< udp_glue_base* >(udp->impl);
+      if(self == nullptr)
+        return -1;
+      return static_cast< udp_batch_glue* >(self)->QueueSend(to, ptr, sz);
+    }
+
+    int
+    QueueSend(const sockaddr* to, const byte_t* ptr, size_t sz)
+    {
+      const socklen_t tolen = SockLen(to);
+      if(sz > MaxPacketSize)
+        return ::sendto(m_FD, ptr, sz, MSG_DONTWAIT, to, tolen);
+      bool wakeup = false;
+      {
+        std::unique_lock< std::mutex > lock(m_SendMutex);
+        if(m_SendCount == BatchSize)
+          FlushLocked();
+        wakeup     = m_SendCount == 0;
+        auto& slot = m_SendQueue[m_SendCount++];
+        std::memcpy(&slot.to, to, tolen);
+        slot.tolen = tolen;
+        slot.sz    = sz;
+        std::copy_n(ptr, sz, slot.data.begin());
+      }
+      // flush from the event loop if nobody fills the batch before then
+      if(wakeup)
+        uv_async_send(&m_Flusher);
+      return sz;
+    }
+
+    /// return true if the slot at idx can ride as a gso segment behind first
+    bool
+    CanCoalesce(const SendSlot& first, size_t idx, size_t total) const
+    {
+      const auto& slot = m_SendQueue[idx];
+      return slot.sz <= first.sz && total + slot.sz <= MaxGSOBytes
+          && slot.tolen == first.tolen
+          && std::memcmp(&slot.to, &first.to, first.tolen) == 0;
+    }
+
+    /// build one mmsghdr starting at send slot idx, return the number of
+    /// slots it covers
+    size_t
+    BuildMessage(size_t idx, mmsghdr& msg, iovec* iov, char* control)
+    {
+      const auto& first = m_SendQueue[idx];
+      size_t segs       = 0;
+      size_t total      = 0;
+      do
+      {
+        auto& slot         = m_SendQueue[idx + segs];
+        iov[segs].iov_base = slot.data.data();
+        iov[segs].iov_len  = slot.sz;
+        total += slot.sz;
+        ++segs;
+        // a short segment terminates a gso train
+        if(slot.sz < first.sz)
+          break;
+      } while(m_GSO && idx + segs < m_SendCount
+              && CanCoalesce(first, idx + segs, total));
+
+      std::memset(&msg, 0, sizeof(msg));
+      msg.msg_hdr.msg_name    = const_cast< sockaddr_storage* >(&first.to);
+      msg.msg_hdr.msg_namelen = first.tolen;
+      msg.msg_hdr.msg_iov     = iov;
+      msg.msg_hdr.msg_iovlen  = segs;
+#ifdef UDP_SEGMENT
+      if(segs > 1)
+      {
+        msg.msg_hdr.msg_control    = control;
+        msg.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+        cmsghdr* cm                = CMSG_FIRSTHDR(&msg.msg_hdr);
+        cm->cmsg_level             = SOL_UDP;
+        cm->cmsg_type              = UDP_SEGMENT;
+        cm->cmsg_len               = CMSG_LEN(sizeof(uint16_t));
+        const uint16_t segsz       = first.sz;
+        std::memcpy(CMSG_DATA(cm), &segsz, sizeof(segsz));
+      }
+#else
+      (void)control;
+#endif
+      return segs;
+    }
+
+    /// send everything queued, caller holds m_SendMutex
+    void
+    FlushLocked()
+    {
+      size_t nmsgs = 0;
+      size_t idx   = 0;
+      while(idx < m_SendCount)
+      {
+        idx += BuildMessage(idx, m_SendMsgs[nmsgs], &m_SendIOV[idx],
+                            m_SendControl[nmsgs].data());
+        ++nmsgs;
+      }
+      size_t sent = 0;
+      while(sent < nmsgs)
+      {
+        const int ret =
+            ::sendmmsg(m_FD, m_SendMsgs.data() + sent, nmsgs - sent, 0);
+        if(ret > 0)
+        {
+          sent += ret;
+          continue;
+        }
+        if(ret == -1 && errno == EIO && m_GSO)
+        {
+          // the device can't checksum gso trains, resend them one by one
+          llarp::LogWarn("udp gso unsupported on ", m_Addr, ", disabling");
+          m_GSO = false;
+          errno = 0;
+          FlushUnsegmented(sent);
+          break;
+        }
+        llarp::LogDebug("sendmmsg dropped ", nmsgs - sent, " datagrams via ",
+                        m_Addr, ": ", strerror(errno));
+        errno = 0;
+        break;
+      }
+      m_SendCount = 0;
+    }
+
+    /// resend all datagrams from message index msgidx onward without gso
+    void
+    FlushUnsegmented(size_t msgidx)
+    {
+      size_t slot = 0;
+      for(size_t idx = 0; idx < msgidx; ++idx)
+        slot += m_SendMsgs[idx].msg_hdr.msg_iovlen;
+      size_t nmsgs = 0;
+      for(; slot < m_SendCount; ++slot)
+        nmsgs += BuildMessage(slot, m_SendMsgs[nmsgs], &m_SendIOV[slot],
+                              m_SendControl[nmsgs].data());
+      size_t sent = 0;
+      while(sent < nmsgs)
+      {
+        const int ret =
+            ::sendmmsg(m_FD, m_SendMsgs.data() + sent, nmsgs - sent, 0);
+        if(ret <= 0)
+        {
+          errno = 0;
+          return;
+        }
+        sent += ret;
+      }
+    }
+
+    void
+    Flush()
+    {
+      std::unique_lock< std::mutex > lock(m_SendMutex);
+      if(m_SendCount)
+        FlushLocked();
+    }
+
+    static void
+    OnTick(uv_check_t* t)
+    {
+      static_cast< udp_batch_glue* >(t->data)->Tick();
+    }
+
+    void
+    Tick()
+    {
+      Flush();
+      if(m_UDP && m_UDP->tick)
+        m_UDP->tick(m_UDP);
+    }
+
+    bool
+    Bind()
+    {
+      m_FD = ::socket(m_Addr.af(), SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                      0);
+      if(m_FD == -1)
+      {
+        llarp::LogError("failed to create udp socket for ", m_Addr, " ",
+                        strerror(errno));
+        return false;
+      }
+      const sockaddr* addr = m_Addr;
+      if(m_NumShards > 1 && not JoinShards())
+        return false;
+      if(::bind(m_FD, addr, SockLen(addr)) == -1)
+      {
+        llarp::LogError("failed to bind to ", m_Addr, " ", strerror(errno));
+        return false;
+      }
+      if(m_NumShards > 1 && m_ShardIndex == 0)
+        SteerShards();
+#ifdef UDP_SEGMENT
+      {
+        int segsz     = 0;
+        socklen_t len = sizeof(segsz);
+        m_GSO = ::getsockopt(m_FD, SOL_UDP, UDP_SEGMENT, &segsz, &len) == 0;
+      }
+#endif
+      // handles are opened in the order Close() tears them down
+      if(uv_poll_init(m_Loop, &m_Handle, m_FD))
+        return false;
+      ++m_OpenHandles;
+      if(uv_poll_start(&m_Handle, UV_READABLE, &OnPoll))
+      {
+        llarp::LogError("failed to start recving packets via ", m_Addr);
+        return false;
+      }
+      if(uv_check_init(m_Loop, &m_Ticker))
+        return false;
+      ++m_OpenHandles;
+      if(uv_check_start(&m_Ticker, &OnTick))
+      {
+        llarp::LogError("failed to start ticker");
+        return false;
+      }
+      if(uv_async_init(m_Loop, &m_Flusher, [](uv_async_t* h) {
+           static_cast< udp_batch_glue* >(h->data)->Flush();
+         }))
+      {
+        llarp::LogError("failed to set up send flusher for ", m_Addr);
+        return false;
+      }
+      ++m_OpenHandles;
+      m_UDP->fd     = m_FD;
+      m_UDP->sendto = &SendTo;
+      m_UDP->impl   = static_cast< udp_glue_base* >(this);
+      if(m_NumShards > 1)
+        llarp::LogInfo("batched udp io on ", m_Addr, " shard ", m_ShardIndex,
+                       " of ", m_NumShards, m_GSO ? " with gso" : "");
+      else
+        llarp::LogInfo("batched udp io on ", m_Addr,
+                       m_GSO ? " with gso" : "");
+      return true;
+    }
+
+    /// share the port with the other shards, must happen before bind
+    bool
+    JoinShards()
+    {
+      int on = 1;
+      if(::setsockopt(m_FD, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == -1)
+      {
+        llarp::LogError("cannot share ", m_Addr, " between shards: ",
+                        strerror(errno));
+        return false;
+      }
+      return true;
+    }
+
+    /// have the kernel hand datagrams to the shard llarp_ev_udp_shard_for
+    /// picks for their source, a reuseport group runs the program of its
+    /// first socket so only shard 0 installs it. without it the kernel hashes
+    /// the whole 4 tuple, which still works but loses the affinity.
+    void
+    SteerShards()
+    {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+      // loads the last word of the source ip from the network header, which
+      // for v4 mapped traffic on a v6 socket is still an ipv4 header
+      static constexpr uint32_t net = SKF_NET_OFF;
+      sock_filter code[]            = {
+          BPF_STMT(BPF_LD | BPF_B | BPF_ABS, net),
+          BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 4),
+          BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 6, 2, 0),
+          BPF_STMT(BPF_LD | BPF_W | BPF_ABS, net + 12),
+          BPF_JUMP(BPF_JMP | BPF_JA, 1, 0, 0),
+          BPF_STMT(BPF_LD | BPF_W | BPF_ABS, net + 20),
+          BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, LLARP_UDP_SHARD_MULTIPLIER),
+          BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+          BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, uint32_t(m_NumShards)),
+          BPF_STMT(BPF_RET | BPF_A, 0),
+      };
+      sock_fprog prog;
+      prog.len    = sizeof(code) / sizeof(code[0]);
+      prog.filter = code;
+      if(::setsockopt(m_FD, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                      sizeof(prog))
+         == 0)
+        return;
+      llarp::LogWarn("cannot steer shards on ", m_Addr, ": ", strerror(errno));
+      errno = 0;
+#else
+      llarp::LogWarn("cannot steer shards on ", m_Addr,
+                     ": no reuseport bpf support");
+#endif
+    }
+
+    static void
+    OnClosed(uv_handle_t* h)
+    {
+      auto* glue = static_cast< udp_batch_glue* >(h->data);
+      h->data    = nullptr;
+      if(glue && --glue->m_OpenHandles == 0)
+        delete glue;
+    }
+
+    void
+    Close() override
+    {
+      if(m_Closing)
+        return;
+      m_Closing   = true;
+      m_UDP->impl = nullptr;
+      Flush();
+      const int opened = m_OpenHandles;
+      uv_poll_stop(&m_Handle);
+      uv_close((uv_handle_t*)&m_Handle, &OnClosed);
+      // give the port back now, the handles only finish closing when the
+      // loop runs again and a loop that never ran would hold it forever
+      ::close(m_FD);
+      m_FD = -1;
+      if(opened > 1)
+      {
+        uv_check_stop(&m_Ticker);
+        uv_close((uv_handle_t*)&m_Ticker, &OnClosed);
+      }
+      if(opened > 2)
+        uv_close((uv_handle_t*)&m_Flusher, &OnClosed);
+    }
+  };
+#endif
+
   struct pipe_glue : public glue
   {
     byte_t m_Buffer[1024 * 8];
@@ -602,14 +1102,34 @@ namespace libuv
 #else
   struct tun_glue : public glue
   {
+    using VnetHeader = llarp::net::VnetHeader;
+
+#if defined(__linux__) && !defined(ANDROID)
+    /// open the device with virtio net headers so the kernel can hand us
+    /// tso super packets and take coalesced ones
+    static constexpr bool TryOffloads = true;
+#else
+    static constexpr bool TryOffloads = false;
+#endif
+    /// most reads we do per poll wakeup before giving the loop back
+    static constexpr size_t MaxReadsPerPoll = 64;
+
     uv_poll_t m_Handle;
     uv_check_t m_Ticker;
     llarp_tun_io* const m_Tun;
     device* const m_Device;
-    byte_t m_Buffer[1500];
+    std::array< byte_t, sizeof(VnetHeader) + llarp::net::MaxOffloadSize >
+        m_Buffer;
+    bool m_Offloads = false;
+    llarp::net::TCPCoalescer m_Coalescer;
+    const llarp::net::TCPCoalescer::Writer m_WriteOffloaded;
     bool readpkt;
 
-    tun_glue(llarp_tun_io* tun) : m_Tun(tun), m_Device(tuntap_init())
+    tun_glue(llarp_tun_io* tun)
+        : m_Tun(tun)
+        , m_Device(tuntap_init())
+        , m_WriteOffloaded(
+              llarp::util::memFn(&tun_glue::WriteOffloaded, this))
     {
       m_Handle.data = this;
       m_Ticker.data = this;
@@ -640,21 +1160,48 @@ namespace libuv
     void
     Read()
     {
-      auto sz = tuntap_read(m_Device, m_Buffer, sizeof(m_Buffer));
-      if(sz > 0)
+      for(size_t reads = 0; reads < MaxReadsPerPoll; ++reads)
       {
+        auto sz = tuntap_read(m_Device, m_Buffer.data(), m_Buffer.size());
+        if(sz <= 0)
+          return;
         llarp::LogDebug("tun read ", sz);
-        const llarp_buffer_t pkt(m_Buffer, sz);
-        if(m_Tun && m_Tun->recvpkt)
-          m_Tun->recvpkt(m_Tun, pkt);
+        if(m_Offloads)
+          ReadOffloaded(sz);
+        else
+          Recv(llarp_buffer_t(m_Buffer.data(), sz));
       }
     }
 
+    void
+    ReadOffloaded(size_t sz)
+    {
+      if(sz < sizeof(VnetHeader))
+        return;
+      VnetHeader hdr;
+      std::memcpy(&hdr, m_Buffer.data(), sizeof(VnetHeader));
+      byte_t* pkt = m_Buffer.data() + sizeof(VnetHeader);
+      if(not llarp::net::SegmentOffloaded(
+             hdr, pkt, sz - sizeof(VnetHeader),
+             [&](const llarp_buffer_t& seg) { Recv(seg); }))
+        llarp::LogDebug("dropping offloaded packet on ", m_Tun->ifname);
+    }
+
+    void
+    Recv(const llarp_buffer_t& pkt)
+    {
+      if(m_Tun && m_Tun->recvpkt)
+        m_Tun->recvpkt(m_Tun, pkt);
+    }
+
     void
     Tick()
     {
       if(m_Tun->before_write)
         m_Tun->before_write(m_Tun);
+      // whatever got written since the last tick goes out coalesced
+      if(m_Offloads)
+        m_Coalescer.Flush(m_WriteOffloaded);
       if(m_Tun->tick)
         m_Tun->tick(m_Tun);
     }
@@ -686,7 +1233,25 @@ namespace libuv
     bool
     Write(const byte_t* pkt, size_t sz)
     {
+      if(m_Offloads)
+        return m_Coalescer.Write(pkt, sz, m_WriteOffloaded);
+      return tuntap_write(m_Device, (void*)pkt, sz) != -1;
+    }
+
+    bool
+    WriteOffloaded(const VnetHeader& hdr, const byte_t* pkt, size_t sz)
+    {
+#if defined(__linux__)
+      std::array< iovec, 2 > iov;
+      iov[0].iov_base = (void*)&hdr;
+      iov[0].iov_len  = sizeof(VnetHeader);
+      iov[1].iov_base = (void*)pkt;
+      iov[1].iov_len  = sz;
+      return ::writev(m_Device->tun_fd, iov.data(), iov.size()) != -1;
+#else
+      (void)hdr;
       return tuntap_write(m_Device, (void*)pkt, sz) != -1;
+#endif
     }
 
     static bool
@@ -700,7 +1265,13 @@ namespace libuv
     Init(uv_loop_t* loop)
     {
       memcpy(m_Device->if_name, m_Tun->ifname, sizeof(m_Device->if_name));
-      if(tuntap_start(m_Device, TUNTAP_MODE_TUNNEL, 0) == -1)
+      const int mode = TUNTAP_MODE_TUNNEL;
+      m_Offloads     = TryOffloads
+          && tuntap_start(m_Device, mode | TUNTAP_MODE_VNET_HDR, 0) != -1;
+      if(TryOffloads && not m_Offloads)
+        llarp::LogWarn("no offloads on ", m_Tun->ifname,
+                       ", falling back to a packet per read");
+      if(not m_Offloads && tuntap_start(m_Device, mode, 0) == -1)
       {
         llarp::LogError("failed to start up ", m_Tun->ifname);
         return false;
@@ -753,15 +1324,21 @@ namespace libuv
   OnAsyncWake(uv_async_t* async_handle)
   {
     Loop* loop = static_cast< Loop* >(async_handle->data);
-    loop->process_timer_queue();
-    loop->process_cancel_queue();
+    loop->process_timers();
+  }
+
+  static void
+  OnWheelTimer(uv_timer_t* timer)
+  {
+    Loop* loop = static_cast< Loop* >(timer->data);
+    loop->process_timers();
   }
 
   Loop::Loop()
       : llarp_ev_loop()
       , m_LogicCalls(1024)
-      , m_timerQueue(20)
-      , m_timerCancelQueue(20)
+      , m_TimerWheel(llarp::time_now_ms())
+      , m_WheelWakeAt(std::numeric_limits< llarp_time_t >::max())
   {
   }
 
@@ -789,14 +1366,20 @@ namespace libuv
         auto f = l->m_LogicCalls.popFront();
         f();
       }
+      // run logic calls a batch at a time so the loop can still get to io,
+      // if some are left over come back for them
+      if(l->m_Logic && l->m_Logic->RunQueued())
+        uv_async_send(h);
     });
     m_TickTimer       = new uv_timer_t;
     m_TickTimer->data = this;
     m_Run.store(true);
-    m_nextID.store(0);
 
     m_WakeUp.data = this;
     uv_async_init(&m_Impl, &m_WakeUp, &OnAsyncWake);
+    m_WheelTimer.data = this;
+    if(uv_timer_init(&m_Impl, &m_WheelTimer) == -1)
+      return false;
     return uv_timer_init(&m_Impl, m_TickTimer) != -1;
   }
 
@@ -842,99 +1425,48 @@ namespace libuv
     return 0;
   }
 
-  struct TimerData
-  {
-    Loop* loop;
-    uint64_t job_id;
-  };
-
-  void
-  CloseUVTimer(uv_timer_t* timer)
-  {
-    // have to delete timer handle this way because libuv.
-    uv_timer_stop(timer);
-    uv_close((uv_handle_t*)timer,
-             [](uv_handle_t* handle) { delete(uv_timer_t*)handle; });
-  }
-
-  static void
-  OnUVTimer(uv_timer_t* timer)
-  {
-    TimerData* timer_data = static_cast< TimerData* >(timer->data);
-    Loop* loop            = timer_data->loop;
-    loop->do_timer_job(timer_data->job_id);
-
-    delete timer_data;
-    CloseUVTimer(timer);
-  }
-
   uint32_t
   Loop::call_after_delay(llarp_time_t delay_ms,
                          std::function< void(void) > callback)
   {
-    PendingTimer timer;
-    timer.delay_ms  = delay_ms;
-    timer.callback  = callback;
-    timer.job_id    = m_nextID++;
-    uint64_t job_id = timer.job_id;
-
-    m_timerQueue.pushBack(std::move(timer));
-    uv_async_send(&m_WakeUp);
-
+    const auto now = llarp::time_now_ms();
+    const auto job_id =
+        m_TimerWheel.Schedule(now, delay_ms, std::move(callback));
+    // only poke the event loop when the wheel timer would fire too late
+    if(now + delay_ms < m_WheelWakeAt.load())
+      uv_async_send(&m_WakeUp);
     return job_id;
   }
 
   void
   Loop::cancel_delayed_call(uint32_t job_id)
   {
-    m_timerCancelQueue.pushBack(job_id);
-    uv_async_send(&m_WakeUp);
+    m_TimerWheel.Cancel(job_id);
   }
 
   void
-  Loop::process_timer_queue()
+  Loop::process_timers()
   {
-    while(not m_timerQueue.empty())
-    {
-      PendingTimer job = m_timerQueue.popFront();
-      uint64_t job_id  = job.job_id;
-      m_pendingCalls.emplace(job_id, std::move(job.callback));
-
-      TimerData* timer_data = new TimerData;
-      timer_data->loop      = this;
-      timer_data->job_id    = job_id;
-
-      uv_timer_t* newTimer = new uv_timer_t;
-      newTimer->data       = (void*)timer_data;
-
-      uv_timer_init(&m_Impl, newTimer);
-      uv_timer_start(newTimer, &OnUVTimer, job.delay_ms, 0);
-    }
-  }
-
-  void
-  Loop::process_cancel_queue()
-  {
-    while(not m_timerCancelQueue.empty())
-    {
-      uint64_t job_id = m_timerCancelQueue.popFront();
-      auto itr        = m_pendingCalls.find(job_id);
-      if(itr != m_pendingCalls.end())
-      {
-        m_pendingCalls.erase(itr);
-      }
+    // anything scheduled from here on wakes us up again
+    m_WheelWakeAt.store(std::numeric_limits< llarp_time_t >::max());
+    const auto now = llarp::time_now_ms();
+    std::vector< Callback > expired;
+    if(m_TimerWheel.Advance(now, expired))
+    {
+      // hand everything that expired this round to logic in one go
+      LogicCall(m_Logic, [expired = std::move(expired)]() {
+        for(const auto& f : expired)
+          f();
+      });
     }
-  }
-
-  void
-  Loop::do_timer_job(uint64_t job_id)
-  {
-    auto itr = m_pendingCalls.find(job_id);
-    if(itr != m_pendingCalls.end())
+    const auto next = m_TimerWheel.TimeUntilNext(now);
+    if(next == std::numeric_limits< llarp_time_t >::max())
     {
-      LogicCall(m_Logic, itr->second);
-      m_pendingCalls.erase(itr);
+      uv_timer_stop(&m_WheelTimer);
+      return;
     }
+    m_WheelWakeAt.store(now + next);
+    uv_timer_start(&m_WheelTimer, &OnWheelTimer, next, 0);
   }
 
   void
@@ -977,7 +1509,7 @@ namespace libuv
   Loop::udp_listen(llarp_udp_io* udp, const sockaddr* src)
   {
     auto* impl = new udp_glue(&m_Impl, udp, src);
-    udp->impl  = impl;
+    udp->impl  = static_cast< udp_glue_base* >(impl);
     if(impl->Bind())
     {
       return true;
@@ -986,6 +1518,54 @@ namespace libuv
     return false;
   }
 
+  bool
+  Loop::udp_listen_batched(llarp_udp_io* udp, const sockaddr* src)
+  {
+#if defined(__linux__)
+    auto* impl = new udp_batch_glue(&m_Impl, udp, src);
+    if(impl->Bind())
+    {
+      return true;
+    }
+    if(impl->m_OpenHandles == 0)
+    {
+      delete impl;
+      return false;
+    }
+    // some handles made it onto the loop, let them close before we free
+    impl->Close();
+    return false;
+#else
+    return udp_listen(udp, src);
+#endif
+  }
+
+  bool
+  Loop::udp_listen_shard(llarp_udp_io* udp, const sockaddr* src, size_t index,
+                         size_t count)
+  {
+#if defined(__linux__)
+    auto* impl = new udp_batch_glue(&m_Impl, udp, src, index, count);
+    if(impl->Bind())
+    {
+      return true;
+    }
+    if(impl->m_OpenHandles == 0)
+    {
+      delete impl;
+      return false;
+    }
+    impl->Close();
+    return false;
+#else
+    (void)udp;
+    (void)src;
+    (void)index;
+    (void)count;
+    return false;
+#endif
+  }
+
   bool
   Loop::add_ticker(std::function< void(void) > func)
   {
@@ -1003,7 +1583,7 @@ namespace libuv
   {
     if(udp == nullptr)
       return false;
-    auto* glue = static_cast< udp_glue* >(udp->impl);
+    auto* glue = static_cast< udp_glue_base* >(udp->impl);
     if(glue == nullptr)
       return false;
     glue->Close();
@@ -1062,5 +1642,6 @@ namespace libuv
 bool
 llarp_ev_udp_recvmany(struct llarp_udp_io* u, struct llarp_pkt_list* pkts)
 {
-  return static_cast< libuv::udp_glue* >(u->impl)->RecvMany(pkts);
+  auto* glue = static_cast< libuv::udp_glue_base* >(u->impl);
+  return glue && glue->RecvMany(pkts);
 }
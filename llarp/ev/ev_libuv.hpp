@@ -7,9 +7,10 @@
 #include <functional>
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
+#include <util/thread/timerwheel.hpp>
 #include <util/meta/memfn.hpp>
 
-#include <map>
+#include <atomic>
 
 namespace libuv
 {
@@ -17,13 +18,6 @@ namespace libuv
   {
     typedef std::function< void(void) > Callback;
 
-    struct PendingTimer
-    {
-      uint64_t job_id;
-      llarp_time_t delay_ms;
-      Callback callback;
-    };
-
     Loop();
 
     bool
@@ -55,14 +49,9 @@ namespace libuv
     void
     cancel_delayed_call(uint32_t job_id) override;
 
+    /// advance the timer wheel, hand expired calls to logic and rearm
     void
-    process_timer_queue();
-
-    void
-    process_cancel_queue();
-
-    void
-    do_timer_job(uint64_t job_id);
+    process_timers();
 
     void
     stop() override;
@@ -76,6 +65,13 @@ namespace libuv
     bool
     udp_listen(llarp_udp_io* l, const sockaddr* src) override;
 
+    bool
+    udp_listen_batched(llarp_udp_io* l, const sockaddr* src) override;
+
+    bool
+    udp_listen_shard(llarp_udp_io* l, const sockaddr* src, size_t index,
+                     size_t count) override;
+
     bool
     udp_close(llarp_udp_io* l) override;
 
@@ -121,7 +117,8 @@ namespace libuv
     set_logic(std::shared_ptr< llarp::Logic > l) override
     {
       m_Logic = l;
-      m_Logic->SetQueuer(llarp::util::memFn(&Loop::call_soon, this));
+      m_Logic->SetWaker(
+          [self = this]() { uv_async_send(&self->m_LogicCaller); });
     }
 
     std::shared_ptr< llarp::Logic > m_Logic;
@@ -142,12 +139,11 @@ namespace libuv
     uint64_t last_time;
     uint64_t loop_run_count;
 #endif
-    std::atomic< uint32_t > m_nextID;
-
-    std::map< uint32_t, Callback > m_pendingCalls;
-
-    llarp::thread::Queue< PendingTimer > m_timerQueue;
-    llarp::thread::Queue< uint32_t > m_timerCancelQueue;
+    llarp::thread::TimerWheel m_TimerWheel;
+    /// the single libuv timer driving m_TimerWheel
+    uv_timer_t m_WheelTimer;
+    /// when m_WheelTimer is due to fire
+    std::atomic< llarp_time_t > m_WheelWakeAt;
   };
 
 }  // namespace libuv
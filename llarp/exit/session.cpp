@@ -202,7 +202,7 @@ namespace llarp
         if(!pkt.Load(buf))
           return false;
         m_LastUse = m_router->Now();
-        m_Downstream.emplace(counter, pkt);
+        m_Downstream.emplace(counter, std::move(pkt));
         return true;
       }
       return false;
@@ -62,6 +62,7 @@ namespace llarp
         exitsObj[item.first.ToString()] = item.second->ExtractStatus();
       }
       obj["exits"] = exitsObj;
+      obj["dns"]   = m_Resolver->ExtractStatus();
       return obj;
     }
 
@@ -326,7 +327,7 @@ namespace llarp
       const huint128_t ip = GetIfAddr();
       m_KeyToIP[us]       = ip;
       m_IPToKey[ip]       = us;
-      m_IPActivity[ip]    = std::numeric_limits< llarp_time_t >::max();
+      m_AddressPool.Pin(ip);
       m_SNodeKeys.insert(us);
       if(m_ShouldInitTun)
       {
@@ -405,7 +406,6 @@ namespace llarp
         found.h = m_KeyToIP[pk].h;
 
       MarkIPActive(found);
-      m_KeyToIP.rehash(0);
       assert(HasLocalMappedAddrFor(pk));
       return found;
     }
@@ -413,27 +413,18 @@ namespace llarp
     huint128_t
     ExitEndpoint::AllocateNewAddress()
     {
-      if(m_NextAddr < m_HigestAddr)
-        return ++m_NextAddr;
-
-      // find oldest activity ip address
-      huint128_t found = {0};
-      llarp_time_t min = std::numeric_limits< llarp_time_t >::max();
-      auto itr         = m_IPActivity.begin();
-      while(itr != m_IPActivity.end())
-      {
-        if(itr->second < min)
-        {
-          found.h = itr->first.h;
-          min     = itr->second;
-        }
-        ++itr;
-      }
-      // kick old ident off exit
+      const llarp_time_t now = GetRouter()->Now();
+      huint128_t found       = {0};
+      if(m_AddressPool.Allocate(found, now))
+        return found;
+      // kick the least recently active ident off the exit and take its
+      // address
       // TODO: DoS
+      if(not m_AddressPool.Oldest(found))
+        return found;
       PubKey pk = m_IPToKey[found];
       KickIdentOffExit(pk);
-
+      m_AddressPool.Allocate(found, now);
       return found;
     }
 
@@ -450,6 +441,7 @@ namespace llarp
       huint128_t ip = m_KeyToIP[pk];
       m_KeyToIP.erase(pk);
       m_IPToKey.erase(ip);
+      m_AddressPool.Release(ip);
       auto range    = m_ActiveExits.equal_range(pk);
       auto exit_itr = range.first;
       while(exit_itr != range.second)
@@ -459,7 +451,7 @@ namespace llarp
     void
     ExitEndpoint::MarkIPActive(huint128_t ip)
     {
-      m_IPActivity[ip] = GetRouter()->Now();
+      m_AddressPool.Touch(ip, GetRouter()->Now());
     }
 
     void
@@ -579,8 +571,8 @@ namespace llarp
         strncpy(m_Tun.ifaddr, host_str.c_str(), sizeof(m_Tun.ifaddr) - 1);
         m_Tun.netmask = std::atoi(nmask_str.c_str());
         m_IfAddr      = m_OurRange.addr;
-        m_NextAddr    = m_IfAddr;
         m_HigestAddr  = m_OurRange.HighestAddr();
+        m_AddressPool.SetRange(m_IfAddr, m_HigestAddr);
         LogInfo(Name(), " set ifaddr range to ", m_Tun.ifaddr, "/",
                 m_Tun.netmask, " lo=", m_IfAddr, " hi=", m_HigestAddr);
         m_UseV6 = false;
@@ -4,6 +4,8 @@
 #include <exit/endpoint.hpp>
 #include <handlers/tun.hpp>
 #include <dns/server.hpp>
+#include <net/address_pool.hpp>
+
 #include <unordered_map>
 
 namespace llarp
@@ -166,11 +168,10 @@ namespace llarp
       huint128_t m_IfAddr;
       huint128_t m_HigestAddr;
 
-      huint128_t m_NextAddr;
       IPRange m_OurRange;
 
-      std::unordered_map< huint128_t, llarp_time_t, huint128_t::Hash >
-          m_IPActivity;
+      /// addresses we hand out to clients, in order of last activity
+      net::AddressPool m_AddressPool;
 
       llarp_tun_io m_Tun;
 
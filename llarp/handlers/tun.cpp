@@ -87,12 +87,14 @@ namespace llarp
         resolvers.emplace_back(addr.ToString());
       obj["ustreamResolvers"] = resolvers;
       obj["localResolver"]    = m_LocalResolverAddr.ToString();
+      obj["dns"]              = m_Resolver->ExtractStatus();
       util::StatusObject ips{};
-      for(const auto &item : m_IPActivity)
+      for(const auto &item : m_IPToAddr)
       {
-        util::StatusObject ipObj{{"lastActive", item.second}};
+        util::StatusObject ipObj{
+            {"lastActive", m_AddressPool.LastActive(item.first)}};
         std::string remoteStr;
-        AlignedBuffer< 32 > addr = m_IPToAddr.at(item.first);
+        const AlignedBuffer< 32 > &addr = item.second;
         if(m_SNodes.at(addr))
           remoteStr = RouterID(addr.as_array()).ToString();
         else
@@ -103,7 +105,7 @@ namespace llarp
       }
       obj["addrs"]  = ips;
       obj["ourIP"]  = m_OurIP.ToString();
-      obj["nextIP"] = m_NextIP.ToString();
+      obj["nextIP"] = m_AddressPool.Next().ToString();
       obj["maxIP"]  = m_MaxIP.ToString();
       return obj;
     }
@@ -737,9 +739,12 @@ namespace llarp
         return false;
       }
 
-      m_NextIP        = m_OurIP;
       m_OurRange.addr = m_OurIP;
       m_MaxIP         = m_OurRange.HighestAddr();
+      // we never handed out the top of the range
+      huint128_t highest = m_MaxIP;
+      --highest;
+      m_AddressPool.SetRange(m_OurIP, highest);
       llarp::LogInfo(Name(), " set ", ifname, " to have address ", m_OurIP);
       llarp::LogInfo(Name(), " allocated up to ", m_MaxIP, " on range ",
                      m_OurRange);
@@ -896,7 +901,7 @@ namespace llarp
             if(pkt.IsV4())
             {
               auto hdr = pkt.Header();
-              if(pkt.sz < sizeof(*hdr)
+              if(pkt.size() < sizeof(*hdr)
                  || (hdr->saddr != 0 && *(byte_t *)&(hdr->saddr) == 0)
                  || (hdr->daddr != 0 && *(byte_t *)&(hdr->daddr) == 0)
                  || ((hdr->saddr == 0) != (hdr->daddr == 0)))
@@ -936,53 +941,30 @@ namespace llarp
           return itr->second;
         }
       }
-      // allocate new address
-      if(m_NextIP < m_MaxIP)
+      if(not m_AddressPool.Allocate(nextIP, now))
       {
-        do
+        // we are full, take back the least recently active address
+        // TODO: prevent DoS
+        if(not m_AddressPool.Oldest(nextIP))
         {
-          nextIP = ++m_NextIP;
-        } while(m_IPToAddr.find(nextIP) != m_IPToAddr.end()
-                && m_NextIP < m_MaxIP);
-        if(nextIP < m_MaxIP)
-        {
-          m_AddrToIP[ident]  = nextIP;
-          m_IPToAddr[nextIP] = ident;
-          m_SNodes[ident]    = snode;
-          llarp::LogInfo(Name(), " mapped ", ident, " to ", nextIP);
-          MarkIPActive(nextIP);
+          llarp::LogError(Name(), " no address left to map ", ident, " to");
           return nextIP;
         }
-      }
-
-      // we are full
-      // expire least active ip
-      // TODO: prevent DoS
-      std::pair< huint128_t, llarp_time_t > oldest = {huint128_t{0}, 0};
-
-      // find oldest entry
-      auto itr = m_IPActivity.begin();
-      while(itr != m_IPActivity.end())
-      {
-        if(itr->second <= now)
+        auto itr = m_IPToAddr.find(nextIP);
+        if(itr != m_IPToAddr.end())
         {
-          if((now - itr->second) > oldest.second)
-          {
-            oldest.first  = itr->first;
-            oldest.second = itr->second;
-          }
+          llarp::LogInfo(Name(), " unmapped ", itr->second, " from ", nextIP);
+          m_AddrToIP.erase(itr->second);
+          m_SNodes.erase(itr->second);
+          m_IPToAddr.erase(itr);
         }
-        ++itr;
+        m_AddressPool.Release(nextIP);
+        m_AddressPool.Allocate(nextIP, now);
       }
-      // remap address
-      m_IPToAddr[oldest.first] = ident;
-      m_AddrToIP[ident]        = oldest.first;
-      m_SNodes[ident]          = snode;
-      nextIP                   = oldest.first;
-
-      // mark ip active
-      m_IPActivity[nextIP] = std::max(m_IPActivity[nextIP], now);
-
+      m_AddrToIP[ident]  = nextIP;
+      m_IPToAddr[nextIP] = ident;
+      m_SNodes[ident]    = snode;
+      llarp::LogInfo(Name(), " mapped ", ident, " to ", nextIP);
       return nextIP;
     }
 
@@ -996,13 +978,13 @@ namespace llarp
     TunEndpoint::MarkIPActive(huint128_t ip)
     {
       llarp::LogDebug(Name(), " address ", ip, " is active");
-      m_IPActivity[ip] = std::max(Now(), m_IPActivity[ip]);
+      m_AddressPool.Touch(ip, Now());
     }
 
     void
     TunEndpoint::MarkIPActiveForever(huint128_t ip)
     {
-      m_IPActivity[ip] = std::numeric_limits< uint64_t >::max();
+      m_AddressPool.Pin(ip);
     }
 
     void
@@ -1019,20 +1001,21 @@ namespace llarp
       auto _pkts      = std::move(self->m_TunPkts);
       self->m_TunPkts = std::vector< net::IPPacket >();
 
-      LogicCall(self->EndpointLogic(), [tun, self, pkts = std::move(_pkts)]() {
-        for(auto &pkt : pkts)
-        {
-          self->m_UserToNetworkPktQueue.Emplace(pkt);
-        }
-        self->FlushToUser([self, tun](net::IPPacket &pkt) -> bool {
-          if(!llarp_ev_tun_async_write(tun, pkt.Buffer()))
-          {
-            llarp::LogWarn(self->Name(), " packet dropped");
-            return true;
-          }
-          return false;
-        });
-      });
+      LogicCall(self->EndpointLogic(),
+                [tun, self, pkts = std::move(_pkts)]() mutable {
+                  for(auto &pkt : pkts)
+                  {
+                    self->m_UserToNetworkPktQueue.Emplace(std::move(pkt));
+                  }
+                  self->FlushToUser([self, tun](net::IPPacket &pkt) -> bool {
+                    if(!llarp_ev_tun_async_write(tun, pkt.ConstBuffer()))
+                    {
+                      llarp::LogWarn(self->Name(), " packet dropped");
+                      return true;
+                    }
+                    return false;
+                  });
+                });
     }
 
     void
@@ -1043,7 +1026,7 @@ namespace llarp
       net::IPPacket pkt;
       if(not pkt.Load(b))
         return;
-      self->m_TunPkts.emplace_back(pkt);
+      self->m_TunPkts.emplace_back(std::move(pkt));
     }
 
     TunEndpoint::~TunEndpoint() = default;
@@ -4,6 +4,7 @@
 #include <dns/server.hpp>
 #include <ev/ev.h>
 #include <ev/vpnio.hpp>
+#include <net/address_pool.hpp>
 #include <net/ip.hpp>
 #include <net/net.hpp>
 #include <service/endpoint.hpp>
@@ -288,13 +289,10 @@ namespace llarp
       /// our dns resolver
       std::shared_ptr< dns::Proxy > m_Resolver;
 
-      /// maps ip address to timestamp last active
-      std::unordered_map< huint128_t, llarp_time_t, huint128_t::Hash >
-          m_IPActivity;
+      /// addresses we hand out to remotes, in order of last activity
+      net::AddressPool m_AddressPool;
       /// our ip address (host byte order)
       huint128_t m_OurIP;
-      /// next ip address to allocate (host byte order)
-      huint128_t m_NextIP;
       /// highest ip address to allocate (host byte order)
       huint128_t m_MaxIP;
       /// our ip range we are using
@@ -0,0 +1,129 @@
+#include <iwp/congestion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    constexpr llarp_time_t RTTEstimator::InitialRTO;
+    constexpr llarp_time_t RTTEstimator::MinRTO;
+    constexpr llarp_time_t RTTEstimator::MaxRTO;
+
+    void
+    RTTEstimator::Sample(llarp_time_t rtt)
+    {
+      const double sample = rtt;
+      if(m_Sampled)
+      {
+        m_RTTVar = (0.75 * m_RTTVar) + (0.25 * std::abs(m_SRTT - sample));
+        m_SRTT   = (0.875 * m_SRTT) + (0.125 * sample);
+      }
+      else
+      {
+        m_SRTT    = sample;
+        m_RTTVar  = sample / 2;
+        m_Sampled = true;
+      }
+      const auto rto = static_cast< llarp_time_t >(m_SRTT + (4 * m_RTTVar));
+      m_RTO          = std::max(MinRTO, std::min(MaxRTO, rto));
+    }
+
+    util::StatusObject
+    RTTEstimator::ExtractStatus() const
+    {
+      return {{"srtt", m_SRTT}, {"rttvar", m_RTTVar}, {"rto", RTO()}};
+    }
+
+    size_t
+    FixedInterval::SendBudget(llarp_time_t, size_t, const RTTEstimator&)
+    {
+      return std::numeric_limits< size_t >::max();
+    }
+
+    size_t
+    FixedInterval::Window() const
+    {
+      return std::numeric_limits< size_t >::max();
+    }
+
+    constexpr double Cubic::InitialWindow;
+    constexpr double Cubic::MinWindow;
+    constexpr double Cubic::MaxWindow;
+    constexpr double Cubic::Beta;
+    constexpr double Cubic::C;
+
+    size_t
+    Cubic::SendBudget(llarp_time_t now, size_t inflight,
+                      const RTTEstimator& rtt)
+    {
+      const auto window = static_cast< size_t >(m_Window);
+      if(inflight >= window)
+        return 0;
+      if(not rtt.HasSample())
+        return window - inflight;
+      // refill at a bit over a window per rtt, faster while we are still
+      // probing in slow start, and never bank more than a quarter window
+      const double gain  = m_Window < m_SSThresh ? 2.0 : 1.25;
+      const double rate  = gain * m_Window / std::max(rtt.SRTT(), 1.0);
+      const double burst = std::max(MinWindow * 2, m_Window / 4);
+      if(now > m_LastRefill)
+        m_Tokens = std::min(burst, m_Tokens + rate * (now - m_LastRefill));
+      m_LastRefill = now;
+      return std::min(window - inflight, static_cast< size_t >(m_Tokens));
+    }
+
+    void
+    Cubic::OnSent(size_t frags, llarp_time_t)
+    {
+      m_Tokens = std::max(0.0, m_Tokens - frags);
+    }
+
+    void
+    Cubic::OnAcked(size_t frags, llarp_time_t now, const RTTEstimator& rtt)
+    {
+      if(m_Window < m_SSThresh)
+      {
+        m_Window = std::min(MaxWindow, m_Window + frags);
+        return;
+      }
+      if(m_EpochStart == 0)
+      {
+        m_EpochStart = now;
+        m_Origin     = std::max(m_Window, m_WMax);
+        m_K          = std::cbrt(std::max(0.0, m_WMax - m_Window) / C);
+        m_RenoWindow = m_Window;
+      }
+      const double t =
+          (static_cast< double >(now - m_EpochStart) + rtt.SRTT()) / 1000.0;
+      double target = m_Origin + (C * std::pow(t - m_K, 3));
+      m_RenoWindow += frags * (3 * (1 - Beta) / (1 + Beta)) / m_Window;
+      target = std::max(target, m_RenoWindow);
+      if(target > m_Window)
+        m_Window += frags * (target - m_Window) / m_Window;
+      else
+        m_Window += frags * 0.01 / m_Window;
+      m_Window = std::min(MaxWindow, m_Window);
+    }
+
+    void
+    Cubic::OnLoss(llarp_time_t now, const RTTEstimator& rtt)
+    {
+      // everything lost from the same window is one congestion event
+      if(m_LastLoss && now - m_LastLoss < rtt.SRTT())
+        return;
+      m_LastLoss = now;
+      // fast convergence, let go of bandwidth sooner if we lost it again
+      // before getting back to where we last lost it
+      if(m_Window < m_WMax)
+        m_WMax = m_Window * (1 + Beta) / 2;
+      else
+        m_WMax = m_Window;
+      m_Window     = std::max(MinWindow, m_Window * Beta);
+      m_SSThresh   = m_Window;
+      m_EpochStart = 0;
+    }
+  }  // namespace iwp
+}  // namespace llarp
@@ -0,0 +1,206 @@
+#ifndef LLARP_IWP_CONGESTION_HPP
+#define LLARP_IWP_CONGESTION_HPP
+
+#include <util/status.hpp>
+#include <util/types.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// smoothed round trip time and retransmit timeout from ack timing as in
+    /// rfc 6298, fed only with samples from fragments sent once
+    struct RTTEstimator
+    {
+      /// retransmit timeout before we have any samples
+      static constexpr llarp_time_t InitialRTO = 400;
+      static constexpr llarp_time_t MinRTO     = 100;
+      static constexpr llarp_time_t MaxRTO     = 2000;
+
+      /// maxAckDelay is how long the remote may sit on an ack, it is added
+      /// on top of the rtt based timeout
+      explicit RTTEstimator(llarp_time_t maxAckDelay = 0)
+          : m_MaxAckDelay(maxAckDelay)
+      {
+      }
+
+      void
+      Sample(llarp_time_t rtt);
+
+      bool
+      HasSample() const
+      {
+        return m_Sampled;
+      }
+
+      /// smoothed rtt in ms, 0 until we have a sample
+      double
+      SRTT() const
+      {
+        return m_SRTT;
+      }
+
+      llarp_time_t
+      RTO() const
+      {
+        return m_RTO + m_MaxAckDelay;
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      llarp_time_t m_MaxAckDelay;
+      double m_SRTT      = 0;
+      double m_RTTVar    = 0;
+      llarp_time_t m_RTO = InitialRTO;
+      bool m_Sampled     = false;
+    };
+
+    /// decides how many fragments a session may have in flight and how fast
+    /// they go out, all counts are in fragments
+    struct CongestionControl
+    {
+      virtual ~CongestionControl() = default;
+
+      virtual const char*
+      Name() const = 0;
+
+      /// how many more fragments we may send right now
+      virtual size_t
+      SendBudget(llarp_time_t now, size_t inflight,
+                 const RTTEstimator& rtt) = 0;
+
+      virtual void
+      OnSent(size_t frags, llarp_time_t now) = 0;
+
+      virtual void
+      OnAcked(size_t frags, llarp_time_t now, const RTTEstimator& rtt) = 0;
+
+      /// fragments were lost, either acks skipped over them or they timed out
+      virtual void
+      OnLoss(llarp_time_t now, const RTTEstimator& rtt) = 0;
+
+      /// how long sent fragments wait for an ack before they count as lost
+      virtual llarp_time_t
+      RetransmitTimeout(const RTTEstimator& rtt) const = 0;
+
+      /// fragments we currently allow in flight
+      virtual size_t
+      Window() const = 0;
+    };
+
+    using CongestionControl_ptr = std::unique_ptr< CongestionControl >;
+    using CongestionControlFactory =
+        std::function< CongestionControl_ptr(void) >;
+
+    /// no window and no pacing, everything goes out at once and unacked
+    /// fragments are resent on a fixed interval
+    struct FixedInterval final : public CongestionControl
+    {
+      explicit FixedInterval(llarp_time_t interval) : m_Interval(interval)
+      {
+      }
+
+      const char*
+      Name() const override
+      {
+        return "fixed";
+      }
+
+      size_t
+      SendBudget(llarp_time_t, size_t, const RTTEstimator&) override;
+
+      void
+      OnSent(size_t, llarp_time_t) override
+      {
+      }
+
+      void
+      OnAcked(size_t, llarp_time_t, const RTTEstimator&) override
+      {
+      }
+
+      void
+      OnLoss(llarp_time_t, const RTTEstimator&) override
+      {
+      }
+
+      llarp_time_t
+      RetransmitTimeout(const RTTEstimator&) const override
+      {
+        return m_Interval;
+      }
+
+      size_t
+      Window() const override;
+
+     private:
+      const llarp_time_t m_Interval;
+    };
+
+    /// cubic window growth (rfc 8312) with sends paced over the smoothed rtt
+    /// so a full window never leaves in a single burst
+    struct Cubic final : public CongestionControl
+    {
+      static constexpr double InitialWindow = 10;
+      static constexpr double MinWindow     = 2;
+      static constexpr double MaxWindow     = 4096;
+      /// multiplicative decrease
+      static constexpr double Beta = 0.7;
+      /// growth scale
+      static constexpr double C = 0.4;
+
+      const char*
+      Name() const override
+      {
+        return "cubic";
+      }
+
+      size_t
+      SendBudget(llarp_time_t now, size_t inflight,
+                 const RTTEstimator& rtt) override;
+
+      void
+      OnSent(size_t frags, llarp_time_t now) override;
+
+      void
+      OnAcked(size_t frags, llarp_time_t now,
+              const RTTEstimator& rtt) override;
+
+      void
+      OnLoss(llarp_time_t now, const RTTEstimator& rtt) override;
+
+      llarp_time_t
+      RetransmitTimeout(const RTTEstimator& rtt) const override
+      {
+        return rtt.RTO();
+      }
+
+      size_t
+      Window() const override
+      {
+        return static_cast< size_t >(m_Window);
+      }
+
+     private:
+      double m_Window   = InitialWindow;
+      double m_SSThresh = MaxWindow;
+      double m_WMax     = 0;
+      double m_K        = 0;
+      double m_Origin   = 0;
+      /// window a reno flow would have, we never grow slower than it
+      double m_RenoWindow       = 0;
+      llarp_time_t m_EpochStart = 0;
+      llarp_time_t m_LastLoss   = 0;
+      /// fragments the pacer lets out before it has to wait
+      double m_Tokens           = InitialWindow;
+      llarp_time_t m_LastRefill = 0;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
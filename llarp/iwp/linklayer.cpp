@@ -16,6 +16,9 @@ namespace llarp
                          PumpDoneHandler pumpDone, bool allowInbound)
         : ILinkLayer(keyManager, getrc, h, sign, est, reneg, timeout, closed,
                      pumpDone)
+        , m_MakeCongestionControl{[]() -> CongestionControl_ptr {
+          return std::make_unique< Cubic >();
+        }}
         , permitInbound{allowInbound}
     {
     }
@@ -43,10 +46,10 @@ namespace llarp
     void
     LinkLayer::RecvFrom(const Addr& from, ILinkSession::Packet_t pkt)
     {
-      std::shared_ptr< ILinkSession > session;
-      auto itr          = m_AuthedAddrs.find(from);
+      // established sessions are the common case and need no lock
+      auto session      = m_AuthedAddrs.Get(from);
       bool isNewSession = false;
-      if(itr == m_AuthedAddrs.end())
+      if(not session)
       {
         ACQUIRE_LOCK(Lock_t lock, m_PendingMutex);
         if(m_Pending.count(from) == 0)
@@ -58,21 +61,15 @@ namespace llarp
         }
         session = m_Pending.find(from)->second;
       }
-      else
+      bool success = session->Recv_LL(std::move(pkt));
+      if(!success and isNewSession)
       {
-        ACQUIRE_LOCK(Lock_t lock, m_AuthedLinksMutex);
-        auto range = m_AuthedLinks.equal_range(itr->second);
-        session    = range.first->second;
-      }
-      if(session)
-      {
-        bool success = session->Recv_LL(std::move(pkt));
-        if(!success and isNewSession)
-        {
-          LogWarn(
-              "Brand new session failed; removing from pending sessions list");
-          m_Pending.erase(m_Pending.find(from));
-        }
+        LogWarn(
+            "Brand new session failed; removing from pending sessions list");
+        ACQUIRE_LOCK(Lock_t lock, m_PendingMutex);
+        auto itr = m_Pending.find(from);
+        if(itr != m_Pending.end() && itr->second == session)
+          m_Pending.erase(itr);
       }
     }
 
@@ -81,14 +78,14 @@ namespace llarp
     {
       if(!ILinkLayer::MapAddr(r, s))
         return false;
-      m_AuthedAddrs.emplace(s->GetRemoteEndpoint(), r);
+      m_AuthedAddrs.Put(s->GetRemoteEndpoint(), s->BorrowSelf());
       return true;
     }
 
     void
     LinkLayer::UnmapAddr(const Addr& a)
     {
-      m_AuthedAddrs.erase(a);
+      m_AuthedAddrs.Remove(a);
     }
 
     std::shared_ptr< ILinkSession >
@@ -5,7 +5,9 @@
 #include <crypto/crypto.hpp>
 #include <crypto/encrypted.hpp>
 #include <crypto/types.hpp>
+#include <iwp/congestion.hpp>
 #include <link/server.hpp>
+#include <link/session_index.hpp>
 #include <util/thread/thread_pool.hpp>
 #include <config/key_manager.hpp>
 
@@ -47,8 +49,23 @@ namespace llarp
       void
       QueueWork(std::function< void(void) > work);
 
+      /// use controllers from f for sessions made from now on
+      void
+      SetCongestionControl(CongestionControlFactory f)
+      {
+        m_MakeCongestionControl = std::move(f);
+      }
+
+      CongestionControl_ptr
+      MakeCongestionControl() const
+      {
+        return m_MakeCongestionControl();
+      }
+
      private:
-      std::unordered_map< Addr, RouterID, Addr::Hash > m_AuthedAddrs;
+      CongestionControlFactory m_MakeCongestionControl;
+      /// established sessions by remote address, looked up without locking
+      SessionIndex m_AuthedAddrs;
       const bool permitInbound;
     };
 
@@ -44,41 +44,105 @@ namespace llarp
     }
 
     bool
-    OutboundMessage::ShouldFlush(llarp_time_t now) const
+    OutboundMessage::ShouldFlush(llarp_time_t now, llarp_time_t rto) const
     {
-      return now - m_LastFlush >= Session::TXFlushInterval;
+      return m_InFlight.any() && now - m_LastFlush >= rto;
     }
 
-    void
+    OutboundMessage::AckResult
     OutboundMessage::Ack(byte_t bitmask)
     {
-      m_Acks = std::bitset< 8 >(bitmask);
+      AckResult result;
+      const std::bitset< MaxFragments > acks(bitmask);
+      const auto fresh = acks & m_InFlight;
+      result.acked     = fresh.count();
+      // anything that went out before a fragment they have but which they
+      // don't have themselves is gone
+      uint16_t latest = 0;
+      bool any        = false;
+      for(size_t idx = 0; idx < MaxFragments; ++idx)
+      {
+        if(fresh.test(idx) && (not any || m_SendOrder[idx] > latest))
+        {
+          latest = m_SendOrder[idx];
+          any    = true;
+        }
+      }
+      m_Acks |= acks;
+      m_InFlight &= ~acks;
+      if(any)
+      {
+        for(size_t idx = 0; idx < MaxFragments; ++idx)
+        {
+          if(m_InFlight.test(idx) && m_SendOrder[idx] < latest)
+          {
+            m_InFlight.reset(idx);
+            result.lost++;
+          }
+        }
+      }
+      if(result.lost)
+        m_Retransmitted = true;
+      return result;
     }
 
-    void
-    OutboundMessage::FlushUnAcked(
-        std::function< void(ILinkSession::Packet_t) > sendpkt, llarp_time_t now)
+    size_t
+    OutboundMessage::SendFragments(const SendFunc_t& sendpkt,
+                                   llarp_time_t now, size_t budget,
+                                   size_t& resent)
     {
       /// overhead for a data packet in plaintext
       static constexpr size_t Overhead = 10;
-      uint16_t idx                     = 0;
-      const auto datasz                = m_Data.size();
-      while(idx < datasz)
+      if(budget == 0)
+        return 0;
+      if(not m_XMITSent)
+      {
+        sendpkt(XMIT());
+        m_XMITSent  = true;
+        m_LastFlush = now;
+        m_StartedAt = now;
+      }
+      size_t sent       = 0;
+      uint16_t idx      = 0;
+      const auto datasz = m_Data.size();
+      while(idx < datasz && sent < budget)
       {
-        if(not m_Acks[idx / FragmentSize])
+        const size_t frag = idx / FragmentSize;
+        if(not m_Acks[frag] && not m_InFlight[frag])
         {
           const size_t fragsz =
               idx + FragmentSize < datasz ? FragmentSize : datasz - idx;
-          auto frag = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
-          htobe16buf(frag.data() + 2 + PacketOverhead, idx);
-          htobe64buf(frag.data() + 4 + PacketOverhead, m_MsgID);
+          auto pkt = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
+          htobe16buf(pkt.data() + 2 + PacketOverhead, idx);
+          htobe64buf(pkt.data() + 4 + PacketOverhead, m_MsgID);
           std::copy(m_Data.begin() + idx, m_Data.begin() + idx + fragsz,
-                    frag.data() + PacketOverhead + Overhead + 2);
-          sendpkt(std::move(frag));
+                    pkt.data() + PacketOverhead + Overhead + 2);
+          sendpkt(std::move(pkt));
+          if(m_EverSent[frag])
+          {
+            m_Retransmitted = true;
+            resent++;
+          }
+          m_EverSent.set(frag);
+          m_InFlight.set(frag);
+          m_SendOrder[frag] = m_NextSendOrder++;
+          sent++;
         }
         idx += FragmentSize;
       }
-      m_LastFlush = now;
+      if(sent)
+        m_LastFlush = now;
+      return sent;
+    }
+
+    size_t
+    OutboundMessage::ExpireInFlight()
+    {
+      const size_t lost = m_InFlight.count();
+      m_InFlight.reset();
+      if(lost)
+        m_Retransmitted = true;
+      return lost;
     }
 
     bool
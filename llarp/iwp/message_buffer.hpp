@@ -1,5 +1,6 @@
 #ifndef LLARP_IWP_MESSAGE_BUFFER_HPP
 #define LLARP_IWP_MESSAGE_BUFFER_HPP
+#include <array>
 #include <vector>
 #include <constants/link_layer.hpp>
 #include <link/session.hpp>
@@ -31,6 +32,8 @@ namespace llarp
 
     /// max size of data fragments
     static constexpr size_t FragmentSize = 1024;
+    /// max number of fragments in a message
+    static constexpr size_t MaxFragments = MAX_LINK_MSG_SIZE / FragmentSize;
     /// plaintext header overhead size
     static constexpr size_t CommandOverhead = 2;
 
@@ -43,24 +46,61 @@ namespace llarp
 
       ILinkSession::Message_t m_Data;
       uint64_t m_MsgID = 0;
-      std::bitset< MAX_LINK_MSG_SIZE / FragmentSize > m_Acks;
+      std::bitset< MaxFragments > m_Acks;
+      /// fragments sent that we have neither an ack nor a loss verdict for
+      std::bitset< MaxFragments > m_InFlight;
+      /// fragments we have sent at least once
+      std::bitset< MaxFragments > m_EverSent;
+      /// order fragments last went out in, acks for a later send mean the
+      /// earlier ones are lost
+      std::array< uint16_t, MaxFragments > m_SendOrder{};
+      uint16_t m_NextSendOrder = 0;
+      bool m_XMITSent          = false;
+      /// we resent something so acks no longer time a single round trip
+      bool m_Retransmitted = false;
       ILinkSession::CompletionHandler m_Completed;
       llarp_time_t m_LastFlush = 0;
       ShortHash m_Digest;
+      /// when we queued it, restarted when the XMIT first goes out so time
+      /// spent held back by the congestion window is not held against it
       llarp_time_t m_StartedAt = 0;
 
+      using SendFunc_t = std::function< void(ILinkSession::Packet_t) >;
+
+      struct AckResult
+      {
+        /// in flight fragments this ack covers
+        size_t acked = 0;
+        /// in flight fragments sent before an acked one that are still unacked
+        size_t lost = 0;
+      };
+
       ILinkSession::Packet_t
       XMIT() const;
 
-      void
+      AckResult
       Ack(byte_t bitmask);
 
-      void
-      FlushUnAcked(std::function< void(ILinkSession::Packet_t) > sendpkt,
-                   llarp_time_t now);
+      /// put up to budget unacked fragments that are not in flight on the
+      /// wire, the XMIT goes first the first time. returns how many fragments
+      /// went out and adds the ones we had sent before to resent
+      size_t
+      SendFragments(const SendFunc_t& sendpkt, llarp_time_t now,
+                    size_t budget, size_t& resent);
+
+      /// give up waiting on everything in flight, returns how many that was
+      size_t
+      ExpireInFlight();
+
+      size_t
+      NumInFlight() const
+      {
+        return m_InFlight.count();
+      }
 
+      /// has fragments in flight for at least rto
       bool
-      ShouldFlush(llarp_time_t now) const;
+      ShouldFlush(llarp_time_t now, llarp_time_t rto) const;
 
       void
       Completed();
@@ -86,7 +126,7 @@ namespace llarp
       uint64_t m_MsgID            = 0;
       llarp_time_t m_LastACKSent  = 0;
       llarp_time_t m_LastActiveAt = 0;
-      std::bitset< MAX_LINK_MSG_SIZE / FragmentSize > m_Acks;
+      std::bitset< MaxFragments > m_Acks;
 
       void
       HandleData(uint16_t idx, const llarp_buffer_t& buf, llarp_time_t now);
@@ -37,6 +37,7 @@ namespace llarp
         , m_RemoteAddr(ai)
         , m_ChosenAI(ai)
         , m_RemoteRC(rc)
+        , m_CC(p->MakeCongestionControl())
     {
       token.Zero();
       GotLIM = util::memFn(&Session::GotOutboundLIM, this);
@@ -50,6 +51,7 @@ namespace llarp
         , m_Parent(p)
         , m_CreatedAt{p->Now()}
         , m_RemoteAddr(from)
+        , m_CC(p->MakeCongestionControl())
     {
       token.Randomize();
       GotLIM          = util::memFn(&Session::GotInboundLIM, this);
@@ -123,6 +125,8 @@ namespace llarp
       {
         LogError("failed to encode LIM for ", m_RemoteAddr);
       }
+      // pooled buffers are recycled, don't pad with whatever was in there
+      std::fill(buf.cur, data.end(), 0);
       if(!SendMessageBuffer(std::move(data), h))
       {
         LogError("failed to send LIM to ", m_RemoteAddr);
@@ -182,49 +186,87 @@ namespace llarp
     Session::SendMessageBuffer(ILinkSession::Message_t buf,
                                ILinkSession::CompletionHandler completed)
     {
-      if(m_TXMsgs.size() >= MaxSendQueueSize)
+      if(m_TXMsgs.Count() >= MaxSendQueueSize)
         return false;
       const auto now   = m_Parent->Now();
-      const auto msgid = m_TXID++;
-      auto& msg =
-          m_TXMsgs
-              .emplace(msgid,
-                       OutboundMessage{msgid, std::move(buf), now, completed})
-              .first->second;
-      EncryptAndSend(msg.XMIT());
-      if(buf.size() > FragmentSize)
-      {
-        msg.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
-      }
+      const auto msgid = m_TXID;
+      // a slot still held by an old message means we are a full window ahead
+      // of it, back off until it is acked or times out
+      auto* msg = m_TXMsgs.Emplace(
+          msgid, OutboundMessage{msgid, std::move(buf), now, completed});
+      if(msg == nullptr)
+        return false;
+      m_TXID++;
+      FlushTX(now);
       LogDebug("send message ", msgid);
       return true;
     }
 
+    void
+    Session::FlushTX(llarp_time_t now)
+    {
+      const OutboundMessage::SendFunc_t send =
+          util::memFn(&Session::EncryptAndSend, this);
+      const auto rto = m_CC->RetransmitTimeout(m_RTT);
+      m_TXMsgs.ForEach([&](uint64_t, OutboundMessage& msg) {
+        if(msg.ShouldFlush(now, rto))
+        {
+          m_InFlight -= msg.ExpireInFlight();
+          m_CC->OnLoss(now, m_RTT);
+        }
+      });
+      const size_t budget = m_CC->SendBudget(now, m_InFlight, m_RTT);
+      if(budget == 0)
+        return;
+      size_t sent   = 0;
+      size_t resent = 0;
+      m_TXMsgs.ForEach([&](uint64_t, OutboundMessage& msg) {
+        sent += msg.SendFragments(send, now, budget - sent, resent);
+      });
+      m_InFlight += sent;
+      m_TXFragments += sent;
+      m_Retransmits += resent;
+      m_CC->OnSent(sent, now);
+    }
+
+    void
+    Session::GotAcks(OutboundMessage& msg, size_t acked, llarp_time_t now)
+    {
+      if(acked == 0)
+        return;
+      // only a message that went out once times a single round trip
+      if(not msg.m_Retransmitted && now >= msg.m_LastFlush)
+        m_RTT.Sample(now - msg.m_LastFlush);
+      m_InFlight -= acked;
+      m_CC->OnAcked(acked, now, m_RTT);
+    }
+
     void
     Session::SendMACK()
     {
       // send multi acks
-      while(m_SendMACKs.size() > 0)
+      auto itr = m_SendMACKs.cbegin();
+      while(itr != m_SendMACKs.cend())
       {
-        const auto sz  = m_SendMACKs.size();
-        const auto max = Session::MaxACKSInMACK;
-        auto numAcks   = std::min(sz, max);
+        const size_t sz  = m_SendMACKs.cend() - itr;
+        const size_t max = Session::MaxACKSInMACK;
+        auto numAcks     = std::min(sz, max);
         auto mack =
             CreatePacket(Command::eMACK, 1 + (numAcks * sizeof(uint64_t)));
         mack[PacketOverhead + CommandOverhead] =
             byte_t{static_cast< byte_t >(numAcks)};
         byte_t* ptr = mack.data() + 3 + PacketOverhead;
         LogDebug("send ", numAcks, " macks to ", m_RemoteAddr);
-        auto itr = m_SendMACKs.begin();
         while(numAcks > 0)
         {
           htobe64buf(ptr, *itr);
-          itr = m_SendMACKs.erase(itr);
+          ++itr;
           numAcks--;
           ptr += sizeof(uint64_t);
         }
         EncryptAndSend(std::move(mack));
       }
+      m_SendMACKs.clear();
     }
 
     void
@@ -235,22 +277,13 @@ namespace llarp
       {
         if(ShouldPing())
           SendKeepAlive();
-        for(auto& item : m_RXMsgs)
-        {
-          if(item.second.ShouldSendACKS(now))
-          {
-            item.second.SendACKS(util::memFn(&Session::EncryptAndSend, this),
-                                 now);
-          }
-        }
-        for(auto& item : m_TXMsgs)
-        {
-          if(item.second.ShouldFlush(now))
+        m_RXMsgs.ForEach([&](uint64_t, InboundMessage& msg) {
+          if(msg.ShouldSendACKS(now))
           {
-            item.second.FlushUnAcked(
-                util::memFn(&Session::EncryptAndSend, this), now);
+            msg.SendACKS(util::memFn(&Session::EncryptAndSend, this), now);
           }
-        }
+        });
+        FlushTX(now);
       }
       auto self = shared_from_this();
       if(m_EncryptNext && !m_EncryptNext->empty())
@@ -302,9 +335,15 @@ namespace llarp
               {"rx", m_CurrentRX},
               {"state", m_State},
               {"inbound", m_Inbound},
-              {"replayFilter", m_ReplayFilter.size()},
-              {"txMsgs", m_TXMsgs.size()},
-              {"rxMsgs", m_RXMsgs.size()},
+              {"replayFilter", m_ReplayFilter.Count()},
+              {"congestionControl", m_CC->Name()},
+              {"window", uint64_t(m_CC->Window())},
+              {"inflight", uint64_t(m_InFlight)},
+              {"rtt", m_RTT.ExtractStatus()},
+              {"txFragments", m_TXFragments},
+              {"retransmits", m_Retransmits},
+              {"txMsgs", m_TXMsgs.Count()},
+              {"rxMsgs", m_RXMsgs.Count()},
               {"remoteAddr", m_RemoteAddr.ToString()},
               {"remoteRC", m_RemoteRC.ExtractStatus()}};
     }
@@ -343,47 +382,24 @@ namespace llarp
         m_ResetRatesAt = now + 1000;
       }
       // remove pending outbound messsages that timed out
-      // inform waiters
-      {
-        auto itr = m_TXMsgs.begin();
-        while(itr != m_TXMsgs.end())
-        {
-          if(itr->second.IsTimedOut(now))
-          {
-            itr->second.InformTimeout();
-            itr = m_TXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // remove pending inbound messages that timed out
-        auto itr = m_RXMsgs.begin();
-        while(itr != m_RXMsgs.end())
-        {
-          if(itr->second.IsTimedOut(now))
-          {
-            m_ReplayFilter.emplace(itr->first, now);
-            itr = m_RXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // decay replay window
-        auto itr = m_ReplayFilter.begin();
-        while(itr != m_ReplayFilter.end())
-        {
-          if(itr->second + ReplayWindow <= now)
-          {
-            itr = m_ReplayFilter.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+      // inform waiters once they are out of the window as that may send more
+      std::vector< OutboundMessage > timedOut;
+      m_TXMsgs.EraseIf([&](uint64_t, OutboundMessage& msg) -> bool {
+        if(not msg.IsTimedOut(now))
+          return false;
+        m_InFlight -= msg.NumInFlight();
+        timedOut.emplace_back(std::move(msg));
+        return true;
+      });
+      // remove pending inbound messages that timed out
+      m_RXMsgs.EraseIf([&](uint64_t rxid, InboundMessage& msg) -> bool {
+        if(not msg.IsTimedOut(now))
+          return false;
+        m_ReplayFilter.Insert(rxid);
+        return true;
+      });
+      for(auto& msg : timedOut)
+        msg.InformTimeout();
     }
 
     using Introduction = AlignedBuffer< PubKey::SIZE + PubKey::SIZE
@@ -653,16 +669,19 @@ namespace llarp
         return;
       }
       LogDebug("got ", int(numAcks), " mack from ", m_RemoteAddr);
+      const auto now = m_Parent->Now();
       byte_t* ptr = data.data() + CommandOverhead + PacketOverhead + 1;
       while(numAcks > 0)
       {
         uint64_t acked = bufbe64toh(ptr);
         LogDebug("mack containing txid=", acked, " from ", m_RemoteAddr);
-        auto itr = m_TXMsgs.find(acked);
-        if(itr != m_TXMsgs.end())
+        auto* msg = m_TXMsgs.Find(acked);
+        if(msg)
         {
-          itr->second.Completed();
-          m_TXMsgs.erase(itr);
+          GotAcks(*msg, msg->NumInFlight(), now);
+          auto done = std::move(*msg);
+          m_TXMsgs.Erase(acked);
+          done.Completed();
         }
         else
         {
@@ -684,10 +703,10 @@ namespace llarp
       uint64_t txid =
           bufbe64toh(data.data() + CommandOverhead + PacketOverhead);
       LogDebug("got nack on ", txid, " from ", m_RemoteAddr);
-      auto itr = m_TXMsgs.find(txid);
-      if(itr != m_TXMsgs.end())
+      auto* msg = m_TXMsgs.Find(txid);
+      if(msg)
       {
-        EncryptAndSend(itr->second.XMIT());
+        EncryptAndSend(msg->XMIT());
       }
       m_LastRX = m_Parent->Now();
     }
@@ -708,56 +727,56 @@ namespace llarp
                   + sizeof(uint64_t) + PacketOverhead};
       LogDebug("rxid=", rxid, " sz=", sz, " h=", h.ToHex());
       m_LastRX = m_Parent->Now();
+      // check for replay
+      if(m_ReplayFilter.Contains(rxid))
       {
-        // check for replay
-        auto itr = m_ReplayFilter.find(rxid);
-        if(itr != m_ReplayFilter.end())
-        {
-          m_SendMACKs.emplace(rxid);
-          LogDebug("duplicate rxid=", rxid, " from ", m_RemoteAddr);
-          return;
-        }
+        m_SendMACKs.emplace_back(rxid);
+        LogDebug("duplicate rxid=", rxid, " from ", m_RemoteAddr);
+        return;
       }
       {
         const auto now = m_Parent->Now();
-        auto itr       = m_RXMsgs.find(rxid);
-        if(itr == m_RXMsgs.end())
+        if(auto* held = m_RXMsgs.AtSlot(rxid))
+        {
+          if(held->first >= rxid)
+          {
+            LogDebug("got duplicate xmit on ", rxid, " from ", m_RemoteAddr);
+            return;
+          }
+          // they are a full window past it so they gave up on it
+          const auto stale = held->first;
+          m_ReplayFilter.Insert(stale);
+          m_RXMsgs.Erase(stale);
+        }
+        auto* msg =
+            m_RXMsgs.Emplace(rxid, InboundMessage{rxid, sz, std::move(h), now});
+
+        auto _sizeDelta = data.size()
+            - (CommandOverhead + sizeof(uint16_t) + sizeof(uint64_t)
+               + PacketOverhead + 32);
+        if(_sizeDelta == 0)
         {
-          itr = m_RXMsgs
-                    .emplace(
-                        rxid,
-                        InboundMessage{rxid, sz, std::move(h), m_Parent->Now()})
-                    .first;
-
-          auto _sizeDelta = data.size()
-              - (CommandOverhead + sizeof(uint16_t) + sizeof(uint64_t)
-                 + PacketOverhead + 32);
-          if(_sizeDelta == 0)
+          sz = std::min(sz, uint16_t{FragmentSize});
           {
-            sz = std::min(sz, uint16_t{FragmentSize});
+            const llarp_buffer_t buf(data.data() + (data.size() - sz), sz);
+            msg->HandleData(0, buf, now);
+            if(not msg->IsCompleted())
+            {
+              return;
+            }
+            if(not msg->Verify())
             {
-              const llarp_buffer_t buf(data.data() + (data.size() - sz), sz);
-              itr->second.HandleData(0, buf, now);
-              if(not itr->second.IsCompleted())
-              {
-                return;
-              }
-              if(not itr->second.Verify())
-              {
-                LogError("bad short xmit hash from ", m_RemoteAddr);
-                return;
-              }
+              LogError("bad short xmit hash from ", m_RemoteAddr);
+              return;
             }
-            auto msg = std::move(itr->second);
-            const llarp_buffer_t buf(msg.m_Data);
-            m_Parent->HandleMessage(this, buf);
-            m_ReplayFilter.emplace(rxid, m_Parent->Now());
-            m_SendMACKs.emplace(rxid);
-            m_RXMsgs.erase(rxid);
           }
+          auto done = std::move(*msg);
+          m_RXMsgs.Erase(rxid);
+          m_ReplayFilter.Insert(rxid);
+          m_SendMACKs.emplace_back(rxid);
+          const llarp_buffer_t buf(done.m_Data);
+          m_Parent->HandleMessage(this, buf);
         }
-        else
-          LogDebug("got duplicate xmit on ", rxid, " from ", m_RemoteAddr);
       }
     }
 
@@ -774,10 +793,10 @@ namespace llarp
       uint16_t sz = bufbe16toh(data.data() + CommandOverhead + PacketOverhead);
       uint64_t rxid = bufbe64toh(data.data() + CommandOverhead
                                  + sizeof(uint16_t) + PacketOverhead);
-      auto itr      = m_RXMsgs.find(rxid);
-      if(itr == m_RXMsgs.end())
+      auto* msg     = m_RXMsgs.Find(rxid);
+      if(msg == nullptr)
       {
-        if(m_ReplayFilter.find(rxid) == m_ReplayFilter.end())
+        if(not m_ReplayFilter.Contains(rxid))
         {
           LogDebug("no rxid=", rxid, " for ", m_RemoteAddr);
           auto nack = CreatePacket(Command::eNACK, 8);
@@ -787,7 +806,7 @@ namespace llarp
         else
         {
           LogDebug("replay hit for rxid=", rxid, " for ", m_RemoteAddr);
-          m_SendMACKs.emplace(rxid);
+          m_SendMACKs.emplace_back(rxid);
         }
         return;
       }
@@ -795,24 +814,24 @@ namespace llarp
       {
         const llarp_buffer_t buf(data.data() + PacketOverhead + 12,
                                  data.size() - (PacketOverhead + 12));
-        itr->second.HandleData(sz, buf, m_Parent->Now());
+        msg->HandleData(sz, buf, m_Parent->Now());
       }
 
-      if(itr->second.IsCompleted())
+      if(msg->IsCompleted())
       {
-        if(itr->second.Verify())
+        auto done = std::move(*msg);
+        m_RXMsgs.Erase(rxid);
+        if(done.Verify())
         {
-          auto msg = std::move(itr->second);
-          const llarp_buffer_t buf(msg.m_Data);
+          m_ReplayFilter.Insert(rxid);
+          m_SendMACKs.emplace_back(rxid);
+          const llarp_buffer_t buf(done.m_Data);
           m_Parent->HandleMessage(this, buf);
-          m_ReplayFilter.emplace(itr->first, m_Parent->Now());
-          m_SendMACKs.emplace(itr->first);
         }
         else
         {
-          LogError("hash missmatch for message ", itr->first);
+          LogError("hash missmatch for message ", rxid);
         }
-        m_RXMsgs.erase(itr);
       }
     }
 
@@ -827,24 +846,28 @@ namespace llarp
       const auto now = m_Parent->Now();
       m_LastRX       = now;
       uint64_t txid  = bufbe64toh(data.data() + 2 + PacketOverhead);
-      auto itr       = m_TXMsgs.find(txid);
-      if(itr == m_TXMsgs.end())
+      auto* msg      = m_TXMsgs.Find(txid);
+      if(msg == nullptr)
       {
         LogDebug("no txid=", txid, " for ", m_RemoteAddr);
         return;
       }
-      itr->second.Ack(data[10 + PacketOverhead]);
-
-      if(itr->second.IsTransmitted())
+      const auto result = msg->Ack(data[10 + PacketOverhead]);
+      GotAcks(*msg, result.acked, now);
+      if(result.lost)
       {
-        LogDebug("sent message ", itr->first);
-        itr->second.Completed();
-        itr = m_TXMsgs.erase(itr);
+        // the holes get refilled by the next FlushTX as the window allows
+        m_InFlight -= result.lost;
+        m_CC->OnLoss(now, m_RTT);
       }
-      else
+
+      if(msg->IsTransmitted())
       {
-        itr->second.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this),
-                                 now);
+        LogDebug("sent message ", txid);
+        m_InFlight -= msg->NumInFlight();
+        auto done = std::move(*msg);
+        m_TXMsgs.Erase(txid);
+        done.Completed();
       }
     }
 
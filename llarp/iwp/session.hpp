@@ -2,10 +2,12 @@
 #define LLARP_IWP_SESSION_HPP
 
 #include <link/session.hpp>
+#include <iwp/congestion.hpp>
 #include <iwp/linklayer.hpp>
 #include <iwp/message_buffer.hpp>
-#include <unordered_set>
+#include <util/sequence_window.hpp>
 #include <deque>
+#include <vector>
 
 namespace llarp
 {
@@ -25,11 +27,9 @@ namespace llarp
       static constexpr llarp_time_t DeliveryTimeout = 500;
       /// Time how long we wait to recieve a message
       static constexpr llarp_time_t ReceivalTimeout = (DeliveryTimeout * 8) / 5;
-      /// How long to keep a replay window for
-      static constexpr llarp_time_t ReplayWindow = (ReceivalTimeout * 3) / 2;
       /// How often to acks RX messages
       static constexpr llarp_time_t ACKResendInterval = DeliveryTimeout / 2;
-      /// How often to retransmit TX fragments
+      /// How often to retransmit TX fragments without congestion control
       static constexpr llarp_time_t TXFlushInterval = (DeliveryTimeout / 5) * 4;
       /// How often we send a keepalive
       static constexpr llarp_time_t PingInterval = 5000;
@@ -37,6 +37,11 @@ namespace llarp
       static constexpr llarp_time_t SessionAliveTimeout = PingInterval * 5;
       /// maximum number of messages we can ack in a multiack
       static constexpr std::size_t MaxACKSInMACK = 1024 / sizeof(uint64_t);
+      /// how far apart the message ids we track at once may be, a peer never
+      /// has more than this many ids in flight
+      static constexpr std::size_t MessageWindowSize = 1024;
+      static_assert(MessageWindowSize >= MaxSendQueueSize,
+                    "message window must hold a full send queue");
 
       /// outbound session
       Session(LinkLayer* parent, const RouterContact& rc,
@@ -105,7 +110,7 @@ namespace llarp
       size_t
       SendQueueBacklog() const override
       {
-        return m_TXMsgs.size();
+        return m_TXMsgs.Count();
       }
 
       ILinkLayer*
@@ -175,13 +180,22 @@ namespace llarp
       void
       ResetRates();
 
-      std::unordered_map< uint64_t, InboundMessage > m_RXMsgs;
-      std::unordered_map< uint64_t, OutboundMessage > m_TXMsgs;
+      /// paces and windows our fragments
+      CongestionControl_ptr m_CC;
+      /// they only ack partial messages every ACKResendInterval
+      RTTEstimator m_RTT{ACKResendInterval};
+      /// fragments sent and not yet acked or lost across all messages
+      size_t m_InFlight      = 0;
+      uint64_t m_TXFragments = 0;
+      uint64_t m_Retransmits = 0;
 
-      /// maps rxid to time recieved
-      std::unordered_map< uint64_t, llarp_time_t > m_ReplayFilter;
-      /// set of rx messages to send in next round of multiacks
-      std::unordered_set< uint64_t > m_SendMACKs;
+      util::SequenceWindow< InboundMessage, MessageWindowSize > m_RXMsgs;
+      util::SequenceWindow< OutboundMessage, MessageWindowSize > m_TXMsgs;
+
+      /// rxids we are done with
+      util::ReplayWindow< MessageWindowSize * 2 > m_ReplayFilter;
+      /// rx messages to send in next round of multiacks
+      std::vector< uint64_t > m_SendMACKs;
 
       using CryptoQueue_t   = std::vector< Packet_t >;
       using CryptoQueue_ptr = std::shared_ptr< CryptoQueue_t >;
@@ -218,6 +232,14 @@ namespace llarp
       void
       SendMACK();
 
+      /// resend what timed out and send what the window lets us
+      void
+      FlushTX(llarp_time_t now);
+
+      /// account for fragments of msg leaving flight for good
+      void
+      GotAcks(OutboundMessage& msg, size_t acked, llarp_time_t now);
+
       void
       GenerateAndSendIntro();
 
@@ -29,7 +29,7 @@ namespace llarp
     GetSessionMaker() const = 0;
 
     virtual bool
-    SendTo(const RouterID &remote, const llarp_buffer_t &buf,
+    SendTo(const RouterID &remote, ILinkSession::Message_t buf,
            ILinkSession::CompletionHandler completed) = 0;
 
     virtual bool
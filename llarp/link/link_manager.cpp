@@ -35,7 +35,7 @@ namespace llarp
   }
 
   bool
-  LinkManager::SendTo(const RouterID &remote, const llarp_buffer_t &buf,
+  LinkManager::SendTo(const RouterID &remote, ILinkSession::Message_t buf,
                       ILinkSession::CompletionHandler completed)
   {
     if(stopping)
@@ -51,7 +51,7 @@ namespace llarp
       return false;
     }
 
-    return link->SendTo(remote, buf, completed);
+    return link->SendTo(remote, std::move(buf), completed);
   }
 
   bool
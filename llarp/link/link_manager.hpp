@@ -27,7 +27,7 @@ namespace llarp
     GetSessionMaker() const override;
 
     bool
-    SendTo(const RouterID &remote, const llarp_buffer_t &buf,
+    SendTo(const RouterID &remote, ILinkSession::Message_t buf,
            ILinkSession::CompletionHandler completed) override;
 
     bool
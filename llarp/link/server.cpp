@@ -33,7 +33,10 @@ namespace llarp
   {
   }
 
-  ILinkLayer::~ILinkLayer() = default;
+  ILinkLayer::~ILinkLayer()
+  {
+    StopShards();
+  }
 
   bool
   ILinkLayer::HasSessionTo(const RouterID& id)
@@ -126,9 +129,103 @@ namespace llarp
     else if(!GetIFAddr(ifname, m_ourAddr, af))
       m_ourAddr = Addr(ifname);
     m_ourAddr.port(port);
+    StopShards();
+    if(m_NumShards > 1 && ConfigureShards())
+      return true;
+    if(m_BatchedIO || m_NumShards > 1)
+      return llarp_ev_add_udp_batched(m_Loop.get(), &m_udp, m_ourAddr) != -1;
     return llarp_ev_add_udp(m_Loop.get(), &m_udp, m_ourAddr) != -1;
   }
 
+  bool
+  ILinkLayer::ConfigureShards()
+  {
+    if(llarp_ev_add_udp_shard(m_Loop.get(), &m_udp, m_ourAddr, 0, m_NumShards)
+       == -1)
+    {
+      LogWarn(Name(), " cannot shard udp on ", m_ourAddr,
+              ", using one socket");
+      return false;
+    }
+    if(m_ourAddr.port() == 0)
+    {
+      // the other shards must join the port the kernel gave us
+      sockaddr_storage bound;
+      socklen_t boundlen = sizeof(bound);
+      if(::getsockname(m_udp.fd, (sockaddr*)&bound, &boundlen) == -1)
+      {
+        llarp_ev_close_udp(&m_udp);
+        return false;
+      }
+      m_ourAddr.port(Addr((const sockaddr&)bound).port());
+    }
+    for(size_t idx = 1; idx < m_NumShards; ++idx)
+    {
+      auto shard           = std::make_unique< Shard >();
+      shard->loop          = llarp_make_ev_loop();
+      shard->udp.user      = this;
+      shard->udp.recvfrom  = nullptr;
+      shard->udp.tick      = &ILinkLayer::udp_tick;
+      const sockaddr* addr = m_ourAddr;
+      if(llarp_ev_add_udp_shard(shard->loop.get(), &shard->udp, addr, idx,
+                                m_NumShards)
+         == -1)
+      {
+        LogError(Name(), " failed to add udp shard ", idx, " on ", m_ourAddr);
+        // nothing may stay in the reuseport group or the fallback socket
+        // cannot bind
+        CloseShard(*shard);
+        StopShards();
+        llarp_ev_close_udp(&m_udp);
+        return false;
+      }
+      m_Shards.emplace_back(std::move(shard));
+    }
+    LogInfo(Name(), " spread udp io on ", m_ourAddr, " over ", m_NumShards,
+            " shards");
+    return true;
+  }
+
+  llarp_udp_io*
+  ILinkLayer::ShardUDP(const Addr& remote)
+  {
+    if(m_Shards.empty())
+      return &m_udp;
+    const sockaddr* addr = remote;
+    const size_t idx     = llarp_ev_udp_shard_for(addr, NumShards());
+    return idx == 0 ? &m_udp : &m_Shards[idx - 1]->udp;
+  }
+
+  void
+  ILinkLayer::CloseShard(Shard& shard)
+  {
+    auto loop = shard.loop;
+    auto* udp = &shard.udp;
+    if(shard.thread.joinable())
+    {
+      // close in the shard's own loop, the iteration that runs this also
+      // runs the close callbacks before the thread sees the loop stopped
+      loop->call_soon([loop, udp]() {
+        llarp_ev_close_udp(udp);
+        loop->stop();
+      });
+      shard.thread.join();
+      return;
+    }
+    // never started, run one iteration ourselves so the glue gets freed
+    llarp_ev_close_udp(udp);
+    loop->tick(0);
+    loop->stop();
+  }
+
+  void
+  ILinkLayer::StopShards()
+  {
+    for(const auto& shard : m_Shards)
+      CloseShard(*shard);
+    m_Shards.clear();
+  }
+
   void
   ILinkLayer::Pump()
   {
@@ -291,6 +388,22 @@ namespace llarp
   {
     m_Worker = worker;
     m_Logic  = l;
+    for(const auto& shard : m_Shards)
+    {
+      if(shard->thread.joinable())
+        continue;
+      const std::string name = std::string(Name()) + "-shard";
+      auto loop              = shard->loop;
+      shard->thread          = std::thread([loop, name]() {
+        util::SetThreadName(name);
+        while(loop->running())
+        {
+          loop->update_time();
+          loop->tick(EV_TICK_INTERVAL);
+        }
+        loop->stopped();
+      });
+    }
     ScheduleTick(LINK_LAYER_TICK_INTERVAL);
     return true;
   }
@@ -335,6 +448,7 @@ namespace llarp
   {
     if(m_Logic && tick_id)
       m_Logic->remove_call(tick_id);
+    StopShards();
     {
       ACQUIRE_LOCK(Lock_t l, m_AuthedLinksMutex);
       auto itr = m_AuthedLinks.begin();
@@ -389,7 +503,7 @@ namespace llarp
   }
 
   bool
-  ILinkLayer::SendTo(const RouterID& remote, const llarp_buffer_t& buf,
+  ILinkLayer::SendTo(const RouterID& remote, ILinkSession::Message_t buf,
                      ILinkSession::CompletionHandler completed)
   {
     std::shared_ptr< ILinkSession > s;
@@ -411,9 +525,7 @@ namespace llarp
         ++itr;
       }
     }
-    ILinkSession::Message_t pkt(buf.sz);
-    std::copy_n(buf.base, buf.sz, pkt.begin());
-    return s && s->SendMessageBuffer(std::move(pkt), completed);
+    return s && s->SendMessageBuffer(std::move(buf), completed);
   }
 
   bool
@@ -471,10 +583,14 @@ namespace llarp
   {
     ILinkLayer* link = static_cast< ILinkLayer* >(udp->user);
     auto pkts        = std::make_shared< llarp_pkt_list >();
-    llarp_ev_udp_recvmany(&link->m_udp, pkts.get());
+    llarp_ev_udp_recvmany(udp, pkts.get());
     auto logic = link->logic();
     if(logic == nullptr)
       return;
+    // the other shards tick on their own loop, only bother logic when they
+    // have something for it, m_udp drives Pump
+    if(udp != &link->m_udp && pkts->empty())
+      return;
     LogicCall(logic, [pkts, link]() {
       auto itr = pkts->begin();
       while(itr != pkts->end())
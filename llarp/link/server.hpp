@@ -13,7 +13,9 @@
 
 #include <list>
 #include <memory>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -87,13 +89,36 @@ namespace llarp
     void
     SendTo_LL(const llarp::Addr& to, const llarp_buffer_t& pkt)
     {
-      llarp_ev_udp_sendto(&m_udp, to, pkt);
+      llarp_ev_udp_sendto(ShardUDP(to), to, pkt);
     }
 
     virtual bool
     Configure(llarp_ev_loop_ptr loop, const std::string& ifname, int af,
               uint16_t port);
 
+    /// move datagrams in batches, takes effect on the next Configure
+    void
+    SetBatchedIO(bool batched)
+    {
+      m_BatchedIO = batched;
+    }
+
+    /// spread datagram io over n sockets sharing our port, each polled by its
+    /// own event loop thread, implies batched io. takes effect on the next
+    /// Configure
+    void
+    SetShards(size_t n)
+    {
+      m_NumShards = std::max(n, size_t{1});
+    }
+
+    /// number of sockets our datagram io is spread over
+    size_t
+    NumShards() const
+    {
+      return m_Shards.size() + 1;
+    }
+
     virtual std::shared_ptr< ILinkSession >
     NewOutboundSession(const RouterContact& rc, const AddressInfo& ai) = 0;
 
@@ -129,7 +154,7 @@ namespace llarp
     KeepAliveSessionTo(const RouterID& remote);
 
     virtual bool
-    SendTo(const RouterID& remote, const llarp_buffer_t& buf,
+    SendTo(const RouterID& remote, ILinkSession::Message_t buf,
            ILinkSession::CompletionHandler completed);
 
     virtual bool
@@ -213,7 +238,31 @@ namespace llarp
     void
     ScheduleTick(uint64_t interval);
 
+    /// the socket the kernel steers datagrams from this remote to
+    llarp_udp_io*
+    ShardUDP(const Addr& remote);
+
+    bool
+    ConfigureShards();
+
+    /// extra socket sharing our port, shard 0 is m_udp on m_Loop
+    struct Shard
+    {
+      llarp_ev_loop_ptr loop;
+      llarp_udp_io udp;
+      std::thread thread;
+    };
+
+    /// close a shard's socket and free its glue, started or not
+    void
+    CloseShard(Shard& shard);
+
+    void
+    StopShards();
+
     uint32_t tick_id;
+    size_t m_NumShards = 1;
+    std::vector< std::unique_ptr< Shard > > m_Shards;
     const SecretKey& m_RouterEncSecret;
 
    protected:
@@ -232,6 +281,7 @@ namespace llarp
     llarp_ev_loop_ptr m_Loop;
     Addr m_ourAddr;
     llarp_udp_io m_udp;
+    bool m_BatchedIO = false;
     SecretKey m_SecretKey;
 
     using AuthedLinks =
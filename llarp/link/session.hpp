@@ -46,7 +46,7 @@ namespace llarp
     using CompletionHandler = std::function< void(DeliveryStatus) >;
 
     using Packet_t  = PacketBuffer;
-    using Message_t = std::vector< byte_t >;
+    using Message_t = PooledBuffer;
 
     /// send a message buffer to the remote endpoint
     virtual bool
@@ -0,0 +1,171 @@
+#include <link/session_index.hpp>
+
+#include <cstring>
+
+namespace llarp
+{
+  static constexpr size_t MinCapacity = 64;
+
+  SessionIndex::Entry SessionIndex::Tombstone;
+
+  SessionIndex::Table::Table(size_t capacity)
+      : mask(capacity - 1), slots(new std::atomic< Entry* >[capacity])
+  {
+    for(size_t idx = 0; idx < capacity; ++idx)
+      slots[idx].store(nullptr, std::memory_order_relaxed);
+  }
+
+  SessionIndex::SessionIndex() : m_Table(new Table(MinCapacity))
+  {
+  }
+
+  SessionIndex::~SessionIndex()
+  {
+    Table* table = m_Table.load();
+    for(size_t idx = 0; idx <= table->mask; ++idx)
+    {
+      Entry* entry = table->slots[idx].load();
+      if(entry && entry != &Tombstone)
+        delete entry;
+    }
+    delete table;
+  }
+
+  SessionIndex::Key
+  SessionIndex::Pack(const Addr& addr)
+  {
+    Key key{{0, 0, 0}};
+    key[0] = (static_cast< uint64_t >(addr.af()) << 16) | addr.port();
+    if(addr.af() == AF_INET)
+      std::memcpy(&key[1], addr.addr4(), sizeof(in_addr));
+    else
+      std::memcpy(&key[1], addr.addr6(), sizeof(in6_addr));
+    return key;
+  }
+
+  size_t
+  SessionIndex::HashKey(const Key& key)
+  {
+    // murmur3 finalizer over each word
+    uint64_t h = 0;
+    for(auto word : key)
+    {
+      h ^= word;
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+    }
+    return h;
+  }
+
+  std::atomic< SessionIndex::Entry* >*
+  SessionIndex::Find(const Table* table, const Key& key) const
+  {
+    size_t idx = HashKey(key) & table->mask;
+    for(size_t probes = 0; probes <= table->mask; ++probes)
+    {
+      auto& slot   = table->slots[idx];
+      Entry* entry = slot.load(std::memory_order_acquire);
+      if(entry == nullptr)
+        return nullptr;
+      if(entry != &Tombstone && entry->key == key)
+        return &slot;
+      idx = (idx + 1) & table->mask;
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr< ILinkSession >
+  SessionIndex::Get(const Addr& addr) const
+  {
+    const Key key = Pack(addr);
+    thread::EpochManager::Guard guard(m_Epochs);
+    const Table* table = m_Table.load(std::memory_order_acquire);
+    auto* slot         = Find(table, key);
+    if(slot == nullptr)
+      return nullptr;
+    return slot->load(std::memory_order_acquire)->session;
+  }
+
+  void
+  SessionIndex::Put(const Addr& addr, std::shared_ptr< ILinkSession > session)
+  {
+    const Key key = Pack(addr);
+    Entry* entry  = new Entry{key, std::move(session)};
+    util::Lock lock(&m_WriteMutex);
+    Table* table = m_Table.load();
+    if(auto* slot = Find(table, key))
+    {
+      Entry* old = slot->exchange(entry);
+      m_Epochs.Retire([old]() { delete old; });
+      return;
+    }
+    // keep at least half the slots empty so probes stay short
+    if((m_Used + 1) * 2 > table->mask + 1)
+    {
+      Rehash();
+      table = m_Table.load();
+    }
+    size_t idx = HashKey(key) & table->mask;
+    while(true)
+    {
+      Entry* current = table->slots[idx].load();
+      if(current == nullptr || current == &Tombstone)
+      {
+        if(current == nullptr)
+          ++m_Used;
+        table->slots[idx].store(entry, std::memory_order_release);
+        ++m_Live;
+        return;
+      }
+      idx = (idx + 1) & table->mask;
+    }
+  }
+
+  bool
+  SessionIndex::Remove(const Addr& addr)
+  {
+    const Key key = Pack(addr);
+    util::Lock lock(&m_WriteMutex);
+    auto* slot = Find(m_Table.load(), key);
+    if(slot == nullptr)
+      return false;
+    Entry* old = slot->exchange(&Tombstone);
+    --m_Live;
+    m_Epochs.Retire([old]() { delete old; });
+    return true;
+  }
+
+  size_t
+  SessionIndex::Size() const
+  {
+    util::Lock lock(&m_WriteMutex);
+    return m_Live;
+  }
+
+  void
+  SessionIndex::Rehash()
+  {
+    Table* old      = m_Table.load();
+    size_t capacity = MinCapacity;
+    while(capacity < (m_Live + 1) * 4)
+      capacity *= 2;
+    Table* table = new Table(capacity);
+    for(size_t idx = 0; idx <= old->mask; ++idx)
+    {
+      Entry* entry = old->slots[idx].load();
+      if(entry == nullptr || entry == &Tombstone)
+        continue;
+      size_t pos = HashKey(entry->key) & table->mask;
+      while(table->slots[pos].load(std::memory_order_relaxed))
+        pos = (pos + 1) & table->mask;
+      table->slots[pos].store(entry, std::memory_order_relaxed);
+    }
+    m_Used = m_Live;
+    // entries move over as is, only the old slot array goes away
+    m_Table.store(table, std::memory_order_release);
+    m_Epochs.Retire([old]() { delete old; });
+  }
+}  // namespace llarp
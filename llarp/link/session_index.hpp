@@ -0,0 +1,95 @@
+#ifndef LLARP_LINK_SESSION_INDEX_HPP
+#define LLARP_LINK_SESSION_INDEX_HPP
+
+#include <link/session.hpp>
+#include <net/net_addr.hpp>
+#include <util/thread/epoch.hpp>
+#include <util/thread/threading.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace llarp
+{
+  /// concurrent remote address to session map for demultiplexing inbound
+  /// datagrams
+  ///
+  /// lookups never take a lock so any number of receive threads can run them
+  /// in parallel, it is an open addressing table keyed on the packed
+  /// sockaddr whose removed entries and outgrown tables are reclaimed once
+  /// no lookup can still see them. inserts and removals are serialized.
+  struct SessionIndex
+  {
+    SessionIndex();
+
+    ~SessionIndex();
+
+    SessionIndex(const SessionIndex&) = delete;
+
+    SessionIndex&
+    operator=(const SessionIndex&) = delete;
+
+    /// get the session for addr or nullptr, lock free
+    std::shared_ptr< ILinkSession >
+    Get(const Addr& addr) const;
+
+    /// map addr to session, replacing whatever was mapped to it before
+    void
+    Put(const Addr& addr, std::shared_ptr< ILinkSession > session)
+        LOCKS_EXCLUDED(m_WriteMutex);
+
+    /// unmap addr, return false if it was not mapped
+    bool
+    Remove(const Addr& addr) LOCKS_EXCLUDED(m_WriteMutex);
+
+    size_t
+    Size() const LOCKS_EXCLUDED(m_WriteMutex);
+
+   private:
+    /// address family, port and address packed into 3 words
+    using Key = std::array< uint64_t, 3 >;
+
+    struct Entry
+    {
+      Key key;
+      std::shared_ptr< ILinkSession > session;
+    };
+
+    struct Table
+    {
+      explicit Table(size_t capacity);
+
+      const size_t mask;
+      std::unique_ptr< std::atomic< Entry* >[] > slots;
+    };
+
+    static Key
+    Pack(const Addr& addr);
+
+    static size_t
+    HashKey(const Key& key);
+
+    /// find the slot holding key in table, nullptr if absent
+    std::atomic< Entry* >*
+    Find(const Table* table, const Key& key) const;
+
+    /// rebuild into a table sized for the live entries and retire the old
+    /// one
+    void
+    Rehash() EXCLUSIVE_LOCKS_REQUIRED(m_WriteMutex);
+
+    /// marks a removed slot so probing carries on past it
+    static Entry Tombstone;
+
+    std::atomic< Table* > m_Table;
+    mutable thread::EpochManager m_Epochs;
+    mutable util::Mutex m_WriteMutex;
+    /// live entries
+    size_t m_Live GUARDED_BY(m_WriteMutex) = 0;
+    /// live entries plus tombstones
+    size_t m_Used GUARDED_BY(m_WriteMutex) = 0;
+  };
+}  // namespace llarp
+
+#endif
@@ -67,6 +67,7 @@ namespace llarp
     DHTImmediateMessage reply;
     reply.session = session;
     bool result   = true;
+    dht::VerifyIntroSets(msgs, router->Now());
     for(auto &msg : msgs)
     {
       result &= msg->HandleMessage(router->dht(), reply.msgs);
@@ -32,6 +32,12 @@ namespace llarp
     {
       return "DHTImmediate";
     }
+
+    TrafficClass
+    Traffic() const override
+    {
+      return TrafficClass::DHT;
+    }
   };
 }  // namespace llarp
 
@@ -13,6 +13,16 @@ namespace llarp
   struct ILinkSession;
   struct AbstractRouter;
 
+  /// kinds of link traffic, the outbound scheduler gives each its own share
+  /// of the link so bulk data can't starve the rest
+  enum class TrafficClass
+  {
+    Control,
+    PathBuild,
+    DHT,
+    Data
+  };
+
   /// parsed link layer message
   struct ILinkMessage
   {
@@ -55,6 +65,13 @@ namespace llarp
     // the name of this kind of message
     virtual const char*
     Name() const = 0;
+
+    /// what kind of traffic this message is when we send it
+    virtual TrafficClass
+    Traffic() const
+    {
+      return TrafficClass::Control;
+    }
   };
 
 }  // namespace llarp
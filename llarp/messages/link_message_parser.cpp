@@ -10,7 +10,7 @@
 #include <router_contact.hpp>
 #include <util/buffer.hpp>
 #include <util/logging/logger.hpp>
-#include <util/metrics/metrics.hpp>
+#include <util/metrics/sharded.hpp>
 
 #include <memory>
 
@@ -29,11 +29,40 @@ namespace llarp
     msg_holder_t() = default;
   };
 
+  /// looked up once so counting a message is cheap
+  struct LinkMessageParser::rx_metrics_t
+  {
+    /// how many of the peers sending us the most messages we publish
+    static constexpr size_t TopPeers = 16;
+
+    metrics::ShardedCounter d;
+    metrics::ShardedCounter u;
+    metrics::ShardedCounter m;
+    metrics::ShardedCounter c;
+    metrics::ShardedCounter s;
+    metrics::ShardedCounter x;
+    metrics::TopKCounter< RouterID > peers;
+
+    explicit rx_metrics_t(const msg_holder_t& h)
+        : d(h.d.Name(), "RX")
+        , u(h.u.Name(), "RX")
+        , m(h.m.Name(), "RX")
+        , c(h.c.Name(), "RX")
+        , s(h.s.Name(), "RX")
+        , x(h.x.Name(), "RX")
+        , peers("LinkMessage", "RX", TopPeers)
+    {
+    }
+  };
+
+  constexpr size_t LinkMessageParser::rx_metrics_t::TopPeers;
+
   LinkMessageParser::LinkMessageParser(AbstractRouter* _router)
       : router(_router)
       , from(nullptr)
       , msg(nullptr)
       , holder(std::make_unique< msg_holder_t >())
+      , rxMetrics(std::make_unique< rx_metrics_t >(*holder))
   {
   }
 
@@ -78,21 +107,27 @@ namespace llarp
           break;
         case 'd':
           msg = &holder->d;
+          rxMetrics->d.tick();
           break;
         case 'u':
           msg = &holder->u;
+          rxMetrics->u.tick();
           break;
         case 'm':
           msg = &holder->m;
+          rxMetrics->m.tick();
           break;
         case 'c':
           msg = &holder->c;
+          rxMetrics->c.tick();
           break;
         case 's':
           msg = &holder->s;
+          rxMetrics->s.tick();
           break;
         case 'x':
           msg = &holder->x;
+          rxMetrics->x.tick();
           break;
         default:
           return false;
@@ -100,8 +135,7 @@ namespace llarp
 
       if(!isLIM)
       {
-        metrics::integerTick(msg->Name(), "RX", 1, "id",
-                             RouterID(from->GetPubKey()).ToString());
+        rxMetrics->peers.tick(RouterID(from->GetPubKey()));
       }
 
       msg->session = from;
@@ -44,8 +44,10 @@ namespace llarp
     ILinkMessage* msg;
 
     struct msg_holder_t;
+    struct rx_metrics_t;
 
     std::unique_ptr< msg_holder_t > holder;
+    std::unique_ptr< rx_metrics_t > rxMetrics;
   };
 }  // namespace llarp
 #endif
@@ -46,6 +46,8 @@ namespace llarp
       return false;
     if(!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
       return false;
+    if(X.size() > MaxSize)
+      return false;
     if(!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
     return read;
@@ -57,7 +59,7 @@ namespace llarp
     auto path = r->pathContext().GetByDownstream(session->GetPubKey(), pathid);
     if(path)
     {
-      return path->HandleUpstream(llarp_buffer_t(X), Y, r);
+      return path->HandleUpstream(X, Y, r);
     }
     return false;
   }
@@ -102,6 +104,8 @@ namespace llarp
       return false;
     if(!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
       return false;
+    if(X.size() > MaxSize)
+      return false;
     if(!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
     return read;
@@ -113,7 +117,7 @@ namespace llarp
     auto path = r->pathContext().GetByUpstream(session->GetPubKey(), pathid);
     if(path)
     {
-      return path->HandleDownstream(llarp_buffer_t(X), Y, r);
+      return path->HandleDownstream(X, Y, r);
     }
     llarp::LogWarn("unhandled downstream message id=", pathid);
     return false;
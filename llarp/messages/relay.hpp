@@ -1,10 +1,11 @@
 #ifndef LLARP_MESSAGES_RELAY_HPP
 #define LLARP_MESSAGES_RELAY_HPP
 
-#include <crypto/encrypted.hpp>
+#include <constants/link_layer.hpp>
 #include <crypto/types.hpp>
 #include <messages/link_message.hpp>
 #include <path/path_types.hpp>
+#include <util/buffer_pool.hpp>
 
 #include <vector>
 
@@ -12,7 +13,10 @@ namespace llarp
 {
   struct RelayUpstreamMessage : public ILinkMessage
   {
-    Encrypted< MAX_LINK_MSG_SIZE - 128 > X;
+    /// max size of the relayed payload
+    static constexpr size_t MaxSize = MAX_LINK_MSG_SIZE - 128;
+
+    PooledBuffer X;
     TunnelNonce Y;
 
     bool
@@ -32,11 +36,20 @@ namespace llarp
     {
       return "RelayUpstream";
     }
+
+    TrafficClass
+    Traffic() const override
+    {
+      return TrafficClass::Data;
+    }
   };
 
   struct RelayDownstreamMessage : public ILinkMessage
   {
-    Encrypted< MAX_LINK_MSG_SIZE - 128 > X;
+    /// max size of the relayed payload
+    static constexpr size_t MaxSize = MAX_LINK_MSG_SIZE - 128;
+
+    PooledBuffer X;
     TunnelNonce Y;
 
     bool
@@ -56,6 +69,12 @@ namespace llarp
     {
       return "RelayDownstream";
     }
+
+    TrafficClass
+    Traffic() const override
+    {
+      return TrafficClass::Data;
+    }
   };
 }  // namespace llarp
 
@@ -171,26 +171,25 @@ namespace llarp
         && txid == other.txid && rxid == other.rxid;
   }
 
-  struct LRCMFrameDecrypt
+  /// a commit waiting in the path context's pipeline for our record to be
+  /// decrypted
+  struct LRCMFrameDecrypt : public path::PendingCommit
   {
-    using Context       = llarp::path::PathContext;
-    using Hop           = llarp::path::TransitHop;
-    using Decrypter     = AsyncFrameDecrypter< LRCMFrameDecrypt >;
-    using Decrypter_ptr = std::unique_ptr< Decrypter >;
-    Decrypter_ptr decrypter;
+    using Context = llarp::path::PathContext;
+    using Hop     = llarp::path::TransitHop;
     std::array< EncryptedFrame, 8 > frames;
     Context* context;
     // decrypted record
     LR_CommitRecord record;
     // the actual hop
     std::shared_ptr< Hop > hop;
+    // set once decrypted if we are the last hop
+    bool farthest = false;
 
     const absl::optional< llarp::Addr > fromAddr;
 
-    LRCMFrameDecrypt(Context* ctx, Decrypter_ptr dec,
-                     const LR_CommitMessage* commit)
-        : decrypter(std::move(dec))
-        , frames(commit->frames)
+    LRCMFrameDecrypt(Context* ctx, const LR_CommitMessage* commit)
+        : frames(commit->frames)
         , context(ctx)
         , hop(std::make_shared< Hop >())
         , fromAddr(commit->session->GetRemoteRC().IsPublicRouter()
@@ -200,7 +199,13 @@ namespace llarp
       hop->info.downstream = commit->session->GetPubKey();
     }
 
-    ~LRCMFrameDecrypt() = default;
+    ~LRCMFrameDecrypt() override = default;
+
+    RouterID
+    From() const override
+    {
+      return hop->info.downstream;
+    }
 
     static void
     OnForwardLRCMResult(AbstractRouter* router, const PathID_t pathid,
@@ -242,209 +247,201 @@ namespace llarp
     }
 
     /// this is done from logic thread
-    static void
-    SendLRCM(std::shared_ptr< LRCMFrameDecrypt > self)
+    void
+    SendLRCM()
     {
-      if(self->context->HasTransitHop(self->hop->info))
+      if(context->HasTransitHop(hop->info))
       {
-        llarp::LogError("duplicate transit hop ", self->hop->info);
-        OnForwardLRCMResult(self->context->Router(), self->hop->info.rxID,
-                            self->hop->info.downstream, self->hop->pathKey,
+        llarp::LogError("duplicate transit hop ", hop->info);
+        OnForwardLRCMResult(context->Router(), hop->info.rxID,
+                            hop->info.downstream, hop->pathKey,
                             SendStatus::Congestion);
-        self->hop = nullptr;
+        hop = nullptr;
         return;
       }
 
-      if(self->fromAddr.has_value())
+      if(fromAddr.has_value())
       {
         // only do ip limiting from non service nodes
-        if(self->context->CheckPathLimitHitByIP(self->fromAddr.value()))
+        if(context->CheckPathLimitHitByIP(fromAddr.value()))
         {
           // we hit a limit so tell it to slow tf down
-          llarp::LogError("client path build hit limit ", self->hop->info);
-          OnForwardLRCMResult(self->context->Router(), self->hop->info.rxID,
-                              self->hop->info.downstream, self->hop->pathKey,
+          llarp::LogError("client path build hit limit ", hop->info);
+          OnForwardLRCMResult(context->Router(), hop->info.rxID,
+                              hop->info.downstream, hop->pathKey,
                               SendStatus::Congestion);
-          self->hop = nullptr;
+          hop = nullptr;
           return;
         }
       }
 
-      if(!self->context->Router()->ConnectionToRouterAllowed(
-             self->hop->info.upstream))
+      if(!context->Router()->ConnectionToRouterAllowed(hop->info.upstream))
       {
         // we are not allowed to forward it ... now what?
-        llarp::LogError("path to ", self->hop->info.upstream,
+        llarp::LogError("path to ", hop->info.upstream,
                         "not allowed, dropping build request on the floor");
-        OnForwardLRCMResult(self->context->Router(), self->hop->info.rxID,
-                            self->hop->info.downstream, self->hop->pathKey,
+        OnForwardLRCMResult(context->Router(), hop->info.rxID,
+                            hop->info.downstream, hop->pathKey,
                             SendStatus::InvalidRouter);
-        self->hop = nullptr;
+        hop = nullptr;
         return;
       }
       // persist sessions to upstream and downstream routers until the commit
       // ends
-      self->context->Router()->PersistSessionUntil(
-          self->hop->info.downstream, self->hop->ExpireTime() + 10000);
-      self->context->Router()->PersistSessionUntil(
-          self->hop->info.upstream, self->hop->ExpireTime() + 10000);
+      context->Router()->PersistSessionUntil(hop->info.downstream,
+                                             hop->ExpireTime() + 10000);
+      context->Router()->PersistSessionUntil(hop->info.upstream,
+                                             hop->ExpireTime() + 10000);
       // put hop
-      self->context->PutTransitHop(self->hop);
+      context->PutTransitHop(hop);
       // if we have an rc for this hop...
-      if(self->record.nextRC)
+      if(record.nextRC)
       {
         // ... and it matches the next hop ...
-        if(self->record.nextHop == self->record.nextRC->pubkey)
+        if(record.nextHop == record.nextRC->pubkey)
         {
           // ... and it's valid
-          const auto now = self->context->Router()->Now();
-          if(self->record.nextRC->IsPublicRouter()
-             && self->record.nextRC->Verify(now))
+          const auto now = context->Router()->Now();
+          if(record.nextRC->IsPublicRouter() && record.nextRC->Verify(now))
           {
-            self->context->Router()->nodedb()->UpdateAsyncIfNewer(
-                *self->record.nextRC.get());
+            context->Router()->nodedb()->UpdateAsyncIfNewer(
+                *record.nextRC.get());
           }
         }
       }
       // forward to next hop
       using std::placeholders::_1;
-      auto func = std::bind(&OnForwardLRCMResult, self->context->Router(),
-                            self->hop->info.rxID, self->hop->info.downstream,
-                            self->hop->pathKey, _1);
-      self->context->ForwardLRCM(self->hop->info.upstream, self->frames, func);
-      self->hop = nullptr;
+      auto func =
+          std::bind(&OnForwardLRCMResult, context->Router(), hop->info.rxID,
+                    hop->info.downstream, hop->pathKey, _1);
+      context->ForwardLRCM(hop->info.upstream, frames, func);
+      hop = nullptr;
     }
 
     // this is called from the logic thread
-    static void
-    SendPathConfirm(std::shared_ptr< LRCMFrameDecrypt > self)
+    void
+    SendPathConfirm()
     {
       // send path confirmation
       // TODO: other status flags?
       uint64_t status = LR_StatusRecord::SUCCESS;
-      if(self->context->HasTransitHop(self->hop->info))
+      if(context->HasTransitHop(hop->info))
       {
         status = LR_StatusRecord::FAIL_DUPLICATE_HOP;
       }
       else
       {
         // persist session to downstream until path expiration
-        self->context->Router()->PersistSessionUntil(
-            self->hop->info.downstream, self->hop->ExpireTime() + 10000);
+        context->Router()->PersistSessionUntil(hop->info.downstream,
+                                               hop->ExpireTime() + 10000);
         // put hop
-        self->context->PutTransitHop(self->hop);
+        context->PutTransitHop(hop);
       }
 
-      if(!LR_StatusMessage::CreateAndSend(
-             self->context->Router(), self->hop->info.rxID,
-             self->hop->info.downstream, self->hop->pathKey, status))
+      if(!LR_StatusMessage::CreateAndSend(context->Router(), hop->info.rxID,
+                                          hop->info.downstream, hop->pathKey,
+                                          status))
       {
-        llarp::LogError("failed to send path confirmation for ",
-                        self->hop->info);
+        llarp::LogError("failed to send path confirmation for ", hop->info);
       }
-      self->hop = nullptr;
+      hop = nullptr;
     }
 
     // TODO: If decryption has succeeded here but we otherwise don't
     //       want to or can't accept the path build request, send
     //       a status message saying as much.
-    static void
-    HandleDecrypted(llarp_buffer_t* buf,
-                    std::shared_ptr< LRCMFrameDecrypt > self)
+    // this is called from a worker thread
+    bool
+    Decrypt() override
     {
-      auto now   = self->context->Router()->Now();
-      auto& info = self->hop->info;
-      if(!buf)
+      auto now   = context->Router()->Now();
+      auto& info = hop->info;
+      if(!frames[0].DecryptInPlace(context->EncryptionSecretKey()))
       {
         llarp::LogError("LRCM decrypt failed from ", info.downstream);
-        self->decrypter = nullptr;
-        return;
+        return false;
       }
+      auto buf = frames[0].Buffer();
       buf->cur = buf->base + EncryptedFrameOverheadSize;
       llarp::LogDebug("decrypted LRCM from ", info.downstream);
       // successful decrypt
-      if(!self->record.BDecode(buf))
+      if(!record.BDecode(buf))
       {
         llarp::LogError("malformed frame inside LRCM from ", info.downstream);
-        self->decrypter = nullptr;
-        return;
+        return false;
       }
 
-      info.txID = self->record.txid;
-      info.rxID = self->record.rxid;
+      info.txID = record.txid;
+      info.rxID = record.rxid;
 
       if(info.txID.IsZero() || info.rxID.IsZero())
       {
         llarp::LogError("LRCM refusing zero pathid");
-        self->decrypter = nullptr;
-        return;
+        return false;
       }
 
-      info.upstream = self->record.nextHop;
+      info.upstream = record.nextHop;
 
       // generate path key as we are in a worker thread
       auto crypto = CryptoManager::instance();
-      if(!crypto->dh_server(self->hop->pathKey, self->record.commkey,
-                            self->context->EncryptionSecretKey(),
-                            self->record.tunnelNonce))
+      if(!crypto->dh_server(hop->pathKey, record.commkey,
+                            context->EncryptionSecretKey(), record.tunnelNonce))
       {
         llarp::LogError("LRCM DH Failed ", info);
-        self->decrypter = nullptr;
-        return;
+        return false;
       }
       // generate hash of hop key for nonce mutation
-      crypto->shorthash(self->hop->nonceXOR,
-                        llarp_buffer_t(self->hop->pathKey));
-      if(self->record.work && self->record.work->IsValid(now))
+      crypto->shorthash(hop->nonceXOR, llarp_buffer_t(hop->pathKey));
+      if(record.work && record.work->IsValid(now))
       {
         llarp::LogDebug("LRCM extended lifetime by ",
-                        self->record.work->extendedLifetime, " seconds for ",
-                        info);
-        self->hop->lifetime += 1000 * self->record.work->extendedLifetime;
+                        record.work->extendedLifetime, " seconds for ", info);
+        hop->lifetime += 1000 * record.work->extendedLifetime;
       }
-      else if(self->record.lifetime < 600 && self->record.lifetime > 10)
+      else if(record.lifetime < 600 && record.lifetime > 10)
       {
-        self->hop->lifetime = self->record.lifetime;
-        llarp::LogDebug("LRCM short lifespan set to ", self->hop->lifetime,
+        hop->lifetime = record.lifetime;
+        llarp::LogDebug("LRCM short lifespan set to ", hop->lifetime,
                         " seconds for ", info);
       }
 
       // TODO: check if we really want to accept it
-      self->hop->started = now;
+      hop->started = now;
 
-      size_t sz = self->frames[0].size();
+      size_t sz = frames[0].size();
       // shift
-      std::array< EncryptedFrame, 8 > frames;
-      frames[0] = self->frames[1];
-      frames[1] = self->frames[2];
-      frames[2] = self->frames[3];
-      frames[3] = self->frames[4];
-      frames[4] = self->frames[5];
-      frames[5] = self->frames[6];
-      frames[6] = self->frames[7];
+      std::array< EncryptedFrame, 8 > shifted;
+      shifted[0] = frames[1];
+      shifted[1] = frames[2];
+      shifted[2] = frames[3];
+      shifted[3] = frames[4];
+      shifted[4] = frames[5];
+      shifted[5] = frames[6];
+      shifted[6] = frames[7];
       // put our response on the end
-      frames[7] = EncryptedFrame(sz - EncryptedFrameOverheadSize);
+      shifted[7] = EncryptedFrame(sz - EncryptedFrameOverheadSize);
       // random junk for now
-      frames[7].Randomize();
-      self->frames = std::move(frames);
-      if(self->context->HopIsUs(info.upstream))
+      shifted[7].Randomize();
+      frames = std::move(shifted);
+      farthest = context->HopIsUs(info.upstream);
+      return true;
+    }
+
+    // this is called from the logic thread
+    void
+    Finish() override
+    {
+      if(farthest)
       {
         // we are the farthest hop
-        llarp::LogDebug("We are the farthest hop for ", info);
+        llarp::LogDebug("We are the farthest hop for ", hop->info);
         // send a LRSM down the path
-        LogicCall(self->context->logic(), [=]() {
-          SendPathConfirm(self);
-          self->decrypter = nullptr;
-        });
+        SendPathConfirm();
       }
       else
       {
         // forward upstream
-        // we are still in the worker thread so post job to logic
-        LogicCall(self->context->logic(), [=]() {
-          SendLRCM(self);
-          self->decrypter = nullptr;
-        });
+        SendLRCM();
       }
     }
   };
@@ -452,15 +449,8 @@ namespace llarp
   bool
   LR_CommitMessage::AsyncDecrypt(llarp::path::PathContext* context) const
   {
-    auto decrypter = std::make_unique< LRCMFrameDecrypt::Decrypter >(
-        context->EncryptionSecretKey(), &LRCMFrameDecrypt::HandleDecrypted);
-    // copy frames so we own them
-    auto frameDecrypt = std::make_shared< LRCMFrameDecrypt >(
-        context, std::move(decrypter), this);
-
-    // decrypt frames async
-    frameDecrypt->decrypter->AsyncDecrypt(
-        context->Worker(), frameDecrypt->frames[0], frameDecrypt);
-    return true;
+    // copy frames so we own them, decrypted in a batch with other commits
+    return context->QueueCommit(
+        std::make_shared< LRCMFrameDecrypt >(context, this));
   }
 }  // namespace llarp
@@ -79,6 +79,12 @@ namespace llarp
     {
       return "RelayCommit";
     }
+
+    TrafficClass
+    Traffic() const override
+    {
+      return TrafficClass::PathBuild;
+    }
   };
 }  // namespace llarp
 
@@ -103,6 +103,12 @@ namespace llarp
     {
       return "RelayStatus";
     }
+
+    TrafficClass
+    Traffic() const override
+    {
+      return TrafficClass::PathBuild;
+    }
   };
 }  // namespace llarp
 
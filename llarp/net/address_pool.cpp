@@ -0,0 +1,184 @@
+#include <net/address_pool.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace llarp
+{
+  namespace net
+  {
+    constexpr size_t AddressPool::MaxPendingTouches;
+    constexpr uint32_t AddressPool::None;
+
+    void
+    AddressPool::SetRange(huint128_t lowest, huint128_t highest)
+    {
+      m_Next    = lowest;
+      m_Highest = highest;
+    }
+
+    bool
+    AddressPool::Allocate(huint128_t& ip, llarp_time_t now)
+    {
+      uint32_t idx = None;
+      // fresh addresses first so one that was just let go of isn't handed
+      // to someone else right away
+      while(idx == None && m_Next < m_Highest)
+      {
+        ++m_Next;
+        if(Find(m_Next) == None)
+          idx = Add(m_Next);
+      }
+      if(idx == None)
+      {
+        if(m_Free.empty())
+          return false;
+        idx = m_Free.back();
+        m_Free.pop_back();
+        m_Entries[idx].free = false;
+      }
+      m_Entries[idx].lastActive = now;
+      Link(idx);
+      ip = m_Entries[idx].ip;
+      return true;
+    }
+
+    bool
+    AddressPool::Oldest(huint128_t& ip)
+    {
+      Flush();
+      if(m_Head == None)
+        return false;
+      ip = m_Entries[m_Head].ip;
+      return true;
+    }
+
+    void
+    AddressPool::Touch(huint128_t ip, llarp_time_t now)
+    {
+      // a burst of packets to the same address only needs the one
+      if(not m_Touched.empty() && m_Touched.back().first == ip)
+      {
+        m_Touched.back().second = now;
+        return;
+      }
+      m_Touched.emplace_back(ip, now);
+      if(m_Touched.size() >= MaxPendingTouches)
+        Flush();
+    }
+
+    void
+    AddressPool::Flush()
+    {
+      // touches are in the order they happened so moving each to the most
+      // recently active end keeps the list in order
+      for(const auto& touch : m_Touched)
+      {
+        const uint32_t idx = Find(touch.first);
+        if(idx == None)
+          continue;
+        Entry& entry = m_Entries[idx];
+        if(entry.pinned || entry.free)
+          continue;
+        entry.lastActive = std::max(entry.lastActive, touch.second);
+        Unlink(idx);
+        Link(idx);
+      }
+      m_Touched.clear();
+    }
+
+    void
+    AddressPool::Pin(huint128_t ip)
+    {
+      uint32_t idx = Find(ip);
+      if(idx == None)
+        idx = Add(ip);
+      else if(m_Entries[idx].pinned)
+        return;
+      else if(m_Entries[idx].free)
+      {
+        m_Free.erase(std::find(m_Free.begin(), m_Free.end(), idx));
+        m_Entries[idx].free = false;
+      }
+      else
+        Unlink(idx);
+      Entry& entry     = m_Entries[idx];
+      entry.pinned     = true;
+      entry.lastActive = std::numeric_limits< llarp_time_t >::max();
+    }
+
+    void
+    AddressPool::Release(huint128_t ip)
+    {
+      const uint32_t idx = Find(ip);
+      if(idx == None)
+        return;
+      Entry& entry = m_Entries[idx];
+      if(entry.free)
+        return;
+      if(not entry.pinned)
+        Unlink(idx);
+      entry.pinned     = false;
+      entry.free       = true;
+      entry.lastActive = 0;
+      m_Free.push_back(idx);
+    }
+
+    llarp_time_t
+    AddressPool::LastActive(huint128_t ip) const
+    {
+      const uint32_t idx = Find(ip);
+      if(idx == None)
+        return 0;
+      return m_Entries[idx].lastActive;
+    }
+
+    void
+    AddressPool::Link(uint32_t idx)
+    {
+      Entry& entry = m_Entries[idx];
+      entry.prev   = m_Tail;
+      entry.next   = None;
+      if(m_Tail == None)
+        m_Head = idx;
+      else
+        m_Entries[m_Tail].next = idx;
+      m_Tail = idx;
+    }
+
+    void
+    AddressPool::Unlink(uint32_t idx)
+    {
+      Entry& entry = m_Entries[idx];
+      if(entry.prev == None)
+        m_Head = entry.next;
+      else
+        m_Entries[entry.prev].next = entry.next;
+      if(entry.next == None)
+        m_Tail = entry.prev;
+      else
+        m_Entries[entry.next].prev = entry.prev;
+      entry.prev = None;
+      entry.next = None;
+    }
+
+    uint32_t
+    AddressPool::Find(huint128_t ip) const
+    {
+      const auto itr = m_Index.find(ip);
+      if(itr == m_Index.end())
+        return None;
+      return itr->second;
+    }
+
+    uint32_t
+    AddressPool::Add(huint128_t ip)
+    {
+      const uint32_t idx = m_Entries.size();
+      m_Entries.emplace_back();
+      m_Entries.back().ip = ip;
+      m_Index.emplace(ip, idx);
+      return idx;
+    }
+  }  // namespace net
+}  // namespace llarp
@@ -0,0 +1,115 @@
+#ifndef LLARP_NET_ADDRESS_POOL_HPP
+#define LLARP_NET_ADDRESS_POOL_HPP
+
+#include <net/net_int.hpp>
+#include <util/types.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace net
+  {
+    /// hands out the addresses of a range and keeps the ones it handed out
+    /// in order of when they were last active, so the least recently active
+    /// one can be taken back when the range runs out. allocating, touching
+    /// and taking back are all O(1).
+    class AddressPool
+    {
+     public:
+      /// how many touches we hold on to before putting them in order
+      static constexpr size_t MaxPendingTouches = 1024;
+
+      /// hand out the addresses after `lowest` up to and including `highest`
+      void
+      SetRange(huint128_t lowest, huint128_t highest);
+
+      /// get an address nobody has, returns false if they are all taken
+      bool
+      Allocate(huint128_t& ip, llarp_time_t now);
+
+      /// get the least recently active address that was handed out and
+      /// isn't pinned, returns false if there isn't one
+      bool
+      Oldest(huint128_t& ip);
+
+      /// mark an address active, cheap enough to call per packet as the
+      /// reordering is batched
+      void
+      Touch(huint128_t ip, llarp_time_t now);
+
+      /// never take this address back and never hand it out
+      void
+      Pin(huint128_t ip);
+
+      /// make an address available to hand out again
+      void
+      Release(huint128_t ip);
+
+      /// put pending touches in order
+      void
+      Flush();
+
+      /// when an address was last active, 0 if it is not ours and
+      /// the maximum time if it is pinned
+      llarp_time_t
+      LastActive(huint128_t ip) const;
+
+      /// how many addresses are handed out or pinned
+      size_t
+      Size() const
+      {
+        return m_Index.size() - m_Free.size();
+      }
+
+      /// the last address handed out for the first time
+      huint128_t
+      Next() const
+      {
+        return m_Next;
+      }
+
+     private:
+      static constexpr uint32_t None = UINT32_MAX;
+
+      struct Entry
+      {
+        huint128_t ip;
+        llarp_time_t lastActive = 0;
+        uint32_t prev           = None;
+        uint32_t next           = None;
+        bool pinned             = false;
+        bool free               = false;
+      };
+
+      /// put an entry at the most recently active end
+      void
+      Link(uint32_t idx);
+
+      void
+      Unlink(uint32_t idx);
+
+      uint32_t
+      Find(huint128_t ip) const;
+
+      uint32_t
+      Add(huint128_t ip);
+
+      huint128_t m_Next    = {0};
+      huint128_t m_Highest = {0};
+      /// least recently active end
+      uint32_t m_Head = None;
+      /// most recently active end
+      uint32_t m_Tail = None;
+      std::vector< Entry > m_Entries;
+      std::vector< uint32_t > m_Free;
+      std::unordered_map< huint128_t, uint32_t, huint128_t::Hash > m_Index;
+      std::vector< std::pair< huint128_t, llarp_time_t > > m_Touched;
+    };
+  }  // namespace net
+}  // namespace llarp
+
+#endif
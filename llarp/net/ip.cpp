@@ -87,26 +87,33 @@ namespace llarp
     bool
     IPPacket::Load(const llarp_buffer_t &pkt)
     {
-      if(pkt.sz > sizeof(buf) or pkt.sz == 0)
+      if(pkt.sz > MaxSize or pkt.sz == 0)
         return false;
-      sz = pkt.sz;
-      std::copy_n(pkt.base, sz, buf);
+      buf = pkt;
       return true;
     }
 
+    void
+    IPPacket::Detach()
+    {
+      if(not buf.unique())
+        buf = PooledBuffer(buf.data(), buf.size());
+    }
+
     ManagedBuffer
     IPPacket::ConstBuffer() const
     {
-      const byte_t *ptr = buf;
-      llarp_buffer_t b(ptr, sz);
+      const byte_t *ptr = buf.data();
+      llarp_buffer_t b(ptr, buf.size());
       return ManagedBuffer(b);
     }
 
     ManagedBuffer
     IPPacket::Buffer()
     {
-      byte_t *ptr = buf;
-      llarp_buffer_t b(ptr, sz);
+      Detach();
+      byte_t *ptr = buf.data();
+      llarp_buffer_t b(ptr, buf.size());
       return ManagedBuffer(b);
     }
 
@@ -312,7 +319,9 @@ namespace llarp
     {
       llarp::LogDebug("set src=", nSrcIP, " dst=", nDstIP);
 
-      auto hdr = Header();
+      Detach();
+      auto hdr      = (ip_header *)buf.data();
+      const auto sz = buf.size();
 
       auto oSrcIP = nuint32_t{hdr->saddr};
       auto oDstIP = nuint32_t{hdr->daddr};
@@ -321,7 +330,7 @@ namespace llarp
       auto ihs = size_t(hdr->ihl * 4);
       if(ihs <= sz)
       {
-        auto pld = buf + ihs;
+        auto pld = buf.data() + ihs;
         auto psz = sz - ihs;
 
         auto fragoff = size_t((ntohs(hdr->frag_off) & 0x1Fff) * 8);
@@ -357,12 +366,14 @@ namespace llarp
     IPPacket::UpdateIPv6Address(huint128_t src, huint128_t dst)
     {
       const size_t ihs = 4 + 4 + 16 + 16;
+      const auto sz    = buf.size();
 
       // XXX should've been checked at upper level?
       if(sz <= ihs)
         return;
 
-      auto hdr = HeaderV6();
+      Detach();
+      auto hdr = (ipv6_header *)buf.data();
 
       const auto oldSrcIP    = hdr->srcaddr;
       const auto oldDstIP    = hdr->dstaddr;
@@ -376,7 +387,7 @@ namespace llarp
       const uint32_t *nDstIP = in6_uint32_ptr(hdr->dstaddr);
 
       // TODO IPv6 header options
-      auto pld = buf + ihs;
+      auto pld = buf.data() + ihs;
       auto psz = sz - ihs;
 
       size_t fragoff = 0;
@@ -4,6 +4,7 @@
 #include <ev/ev.h>
 #include <net/net.hpp>
 #include <util/buffer.hpp>
+#include <util/buffer_pool.hpp>
 #include <util/time.hpp>
 
 #ifndef _WIN32
@@ -96,7 +97,9 @@ namespace llarp
 {
   namespace net
   {
-    /// an Packet
+    /// an Packet, a small handle to its bytes in a pooled buffer so handing
+    /// it along queues doesn't copy them. copies share the bytes, anything
+    /// that changes them in place gets a private copy first.
     struct IPPacket
     {
       static huint128_t
@@ -112,9 +115,14 @@ namespace llarp
       TruncateV6(huint128_t x);
 
       static constexpr size_t MaxSize = 1500;
-      llarp_time_t timestamp;
-      size_t sz;
-      byte_t buf[MaxSize];
+      llarp_time_t timestamp = 0;
+      PooledBuffer buf;
+
+      size_t
+      size() const
+      {
+        return buf.size();
+      }
 
       ManagedBuffer
       Buffer();
@@ -165,7 +173,7 @@ namespace llarp
         bool
         operator()(const IPPacket& left, const IPPacket& right)
         {
-          return left.sz < right.sz;
+          return left.size() < right.size();
         }
       };
 
@@ -178,28 +186,16 @@ namespace llarp
         }
       };
 
-      inline ip_header*
-      Header()
-      {
-        return (ip_header*)&buf[0];
-      }
-
       inline const ip_header*
       Header() const
       {
-        return (ip_header*)&buf[0];
-      }
-
-      inline ipv6_header*
-      HeaderV6()
-      {
-        return (ipv6_header*)&buf[0];
+        return (const ip_header*)buf.data();
       }
 
       inline const ipv6_header*
       HeaderV6() const
       {
-        return (ipv6_header*)&buf[0];
+        return (const ipv6_header*)buf.data();
       }
 
       inline int
@@ -254,6 +250,11 @@ namespace llarp
 
       void
       UpdateIPv6Address(huint128_t src, huint128_t dst);
+
+     private:
+      /// make sure no other packet shares our bytes before we write to them
+      void
+      Detach();
     };
 
   }  // namespace net
@@ -0,0 +1,281 @@
+#include <net/offload.hpp>
+
+#include <util/endian.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace llarp
+{
+  namespace net
+  {
+    constexpr uint8_t VnetHeader::NeedsChecksum;
+    constexpr uint8_t VnetHeader::GSONone;
+    constexpr uint8_t VnetHeader::GSOTCPv4;
+    constexpr uint8_t VnetHeader::GSOTCPv6;
+
+    static constexpr uint8_t IPProtoTCP = 6;
+
+    static constexpr uint8_t TCPFin = 0x01;
+    static constexpr uint8_t TCPPsh = 0x08;
+    static constexpr uint8_t TCPAck = 0x10;
+    static constexpr uint8_t TCPCwr = 0x80;
+
+    /// biggest ip + tcp header with options
+    static constexpr size_t MaxHeaderSize = 60 + 60;
+
+    static uint32_t
+    Sum(const byte_t* buf, size_t sz, uint32_t sum = 0)
+    {
+      while(sz > 1)
+      {
+        sum += bufbe16toh(buf);
+        buf += 2;
+        sz -= 2;
+      }
+      if(sz)
+        sum += uint32_t(buf[0]) << 8;
+      return sum;
+    }
+
+    static uint16_t
+    Fold(uint32_t sum)
+    {
+      while(sum >> 16)
+        sum = (sum & 0xFFff) + (sum >> 16);
+      return uint16_t(sum);
+    }
+
+    /// pseudo header sum of a tcp segment `tcpLen` bytes long
+    static uint32_t
+    PseudoSum(const byte_t* ip, size_t tcpLen)
+    {
+      if((ip[0] >> 4) == 4)
+        return Sum(ip + 12, 8, IPProtoTCP + uint32_t(tcpLen));
+      return Sum(ip + 8, 32, IPProtoTCP + uint32_t(tcpLen));
+    }
+
+    static void
+    ChecksumIPv4(byte_t* ip, size_t ipLen)
+    {
+      htobe16buf(ip + 10, 0);
+      htobe16buf(ip + 10, uint16_t(~Fold(Sum(ip, ipLen))));
+    }
+
+    static void
+    ChecksumTCP(byte_t* ip, size_t ipLen, size_t tcpLen)
+    {
+      byte_t* tcp = ip + ipLen;
+      htobe16buf(tcp + 16, 0);
+      const uint32_t sum = Sum(tcp, tcpLen, PseudoSum(ip, tcpLen));
+      htobe16buf(tcp + 16, uint16_t(~Fold(sum)));
+    }
+
+    /// get the header sizes of a tcp packet we know how to cut up or join,
+    /// that is not a fragment and without ipv6 extension headers
+    static bool
+    ParseTCP(const byte_t* pkt, size_t sz, size_t& ipLen, size_t& tcpLen)
+    {
+      if(sz < 20)
+        return false;
+      switch(pkt[0] >> 4)
+      {
+        case 4:
+          ipLen = size_t(pkt[0] & 0x0f) * 4;
+          if(ipLen < 20 || pkt[9] != IPProtoTCP
+             || (bufbe16toh(pkt + 6) & 0x3fff) != 0)
+            return false;
+          break;
+        case 6:
+          ipLen = 40;
+          if(pkt[6] != IPProtoTCP)
+            return false;
+          break;
+        default:
+          return false;
+      }
+      if(sz < ipLen + 20)
+        return false;
+      tcpLen = size_t(pkt[ipLen + 12] >> 4) * 4;
+      return tcpLen >= 20 && sz >= ipLen + tcpLen;
+    }
+
+    bool
+    SegmentOffloaded(const VnetHeader& hdr, byte_t* pkt, size_t sz,
+                     const std::function< void(const llarp_buffer_t&) >& visit)
+    {
+      if(hdr.gsoType == VnetHeader::GSONone)
+      {
+        if(hdr.flags & VnetHeader::NeedsChecksum)
+        {
+          // the field already holds the pseudo header sum
+          const size_t field = size_t(hdr.csumStart) + hdr.csumOffset;
+          if(hdr.csumStart >= sz || field + 2 > sz)
+            return false;
+          const uint32_t sum = Sum(pkt + hdr.csumStart, sz - hdr.csumStart);
+          htobe16buf(pkt + field, uint16_t(~Fold(sum)));
+        }
+        visit(llarp_buffer_t(pkt, sz));
+        return true;
+      }
+
+      size_t ipLen, tcpLen;
+      if(hdr.gsoType != VnetHeader::GSOTCPv4
+         && hdr.gsoType != VnetHeader::GSOTCPv6)
+        return false;
+      if(not ParseTCP(pkt, sz, ipLen, tcpLen))
+        return false;
+      const bool v4 = (pkt[0] >> 4) == 4;
+      if(v4 != (hdr.gsoType == VnetHeader::GSOTCPv4) || hdr.gsoSize == 0)
+        return false;
+
+      const size_t hdrLen = ipLen + tcpLen;
+      std::array< byte_t, MaxHeaderSize > headers;
+      std::copy_n(pkt, hdrLen, headers.begin());
+      const uint32_t seq   = bufbe32toh(pkt + ipLen + 4);
+      const uint16_t id    = bufbe16toh(pkt + 4);
+      const uint8_t flags  = pkt[ipLen + 13];
+      const size_t gsoSize = hdr.gsoSize;
+
+      // each segment's headers go right in front of its payload, over the
+      // tail of the segment before it which has been visited by then
+      uint16_t idx = 0;
+      for(size_t offset = hdrLen; offset < sz; offset += gsoSize, ++idx)
+      {
+        const size_t len = std::min(gsoSize, sz - offset);
+        byte_t* seg      = pkt + offset - hdrLen;
+        std::memcpy(seg, headers.data(), hdrLen);
+        byte_t* tcp = seg + ipLen;
+        htobe32buf(tcp + 4, seq + uint32_t(offset - hdrLen));
+        uint8_t segFlags = flags;
+        if(idx > 0)
+          segFlags &= ~TCPCwr;
+        if(offset + len < sz)
+          segFlags &= ~(TCPFin | TCPPsh);
+        tcp[13] = segFlags;
+        if(v4)
+        {
+          htobe16buf(seg + 2, uint16_t(hdrLen + len));
+          htobe16buf(seg + 4, uint16_t(id + idx));
+          ChecksumIPv4(seg, ipLen);
+        }
+        else
+          htobe16buf(seg + 4, uint16_t(tcpLen + len));
+        ChecksumTCP(seg, ipLen, tcpLen + len);
+        visit(llarp_buffer_t(seg, hdrLen + len));
+      }
+      return true;
+    }
+
+    bool
+    TCPCoalescer::CanAppend(const byte_t* pkt, size_t sz, size_t ipLen,
+                            size_t tcpLen) const
+    {
+      const size_t payload = sz - ipLen - tcpLen;
+      if(m_Closed || ipLen != m_IPLen || ipLen + tcpLen != m_HdrLen
+         || payload > m_GSOSize || m_Size + payload > m_Buffer.size())
+        return false;
+      const byte_t* head = m_Buffer.data();
+      if(bufbe32toh(pkt + ipLen + 4) != m_NextSeq)
+        return false;
+      // everything but lengths, ids, sequence numbers, flags and checksums
+      // has to match
+      for(size_t idx = 0; idx < m_HdrLen; ++idx)
+      {
+        if(idx < ipLen)
+        {
+          const bool skip = m_IPLen == 40
+              ? (idx == 4 || idx == 5)
+              : ((idx >= 2 && idx <= 5) || idx == 10 || idx == 11);
+          if(skip)
+            continue;
+        }
+        else
+        {
+          const size_t off = idx - ipLen;
+          if((off >= 4 && off <= 7) || off == 13 || off == 16 || off == 17)
+            continue;
+        }
+        if(pkt[idx] != head[idx])
+          return false;
+      }
+      return true;
+    }
+
+    bool
+    TCPCoalescer::Write(const byte_t* pkt, size_t sz, const Writer& write)
+    {
+      size_t ipLen, tcpLen;
+      if(not ParseTCP(pkt, sz, ipLen, tcpLen))
+      {
+        const bool flushed = Flush(write);
+        return write(VnetHeader{}, pkt, sz) && flushed;
+      }
+      const size_t payload = sz - ipLen - tcpLen;
+      const uint8_t flags  = pkt[ipLen + 13];
+      // only plain data segments, anything else goes out as is in order
+      if(payload == 0 || (flags & ~TCPPsh) != TCPAck)
+      {
+        const bool flushed = Flush(write);
+        return write(VnetHeader{}, pkt, sz) && flushed;
+      }
+      bool flushed = true;
+      if(m_Segments > 0 && CanAppend(pkt, sz, ipLen, tcpLen))
+      {
+        std::copy_n(pkt + ipLen + tcpLen, payload, m_Buffer.begin() + m_Size);
+        m_Size += payload;
+        m_Segments++;
+        m_Buffer[m_IPLen + 13] |= flags;
+        // a short segment has to be the last one
+        m_Closed = payload < m_GSOSize || (flags & TCPPsh);
+      }
+      else
+      {
+        flushed = Flush(write);
+        std::copy_n(pkt, sz, m_Buffer.begin());
+        m_Size     = sz;
+        m_IPLen    = ipLen;
+        m_HdrLen   = ipLen + tcpLen;
+        m_GSOSize  = payload;
+        m_Segments = 1;
+        m_Closed   = flags & TCPPsh;
+      }
+      m_NextSeq = bufbe32toh(pkt + ipLen + 4) + uint32_t(payload);
+      return flushed;
+    }
+
+    bool
+    TCPCoalescer::Flush(const Writer& write)
+    {
+      if(m_Segments == 0)
+        return true;
+      byte_t* pkt = m_Buffer.data();
+      VnetHeader hdr;
+      if(m_Segments > 1)
+      {
+        const bool v4 = m_IPLen != 40;
+        if(v4)
+        {
+          htobe16buf(pkt + 2, uint16_t(m_Size));
+          ChecksumIPv4(pkt, m_IPLen);
+        }
+        else
+          htobe16buf(pkt + 4, uint16_t(m_Size - m_IPLen));
+        // the kernel finishes the checksum of every segment it cuts
+        const size_t tcpLen = m_Size - m_IPLen;
+        htobe16buf(pkt + m_IPLen + 16, Fold(PseudoSum(pkt, tcpLen)));
+        hdr.flags      = VnetHeader::NeedsChecksum;
+        hdr.gsoType    = v4 ? VnetHeader::GSOTCPv4 : VnetHeader::GSOTCPv6;
+        hdr.hdrLen     = uint16_t(m_HdrLen);
+        hdr.gsoSize    = uint16_t(m_GSOSize);
+        hdr.csumStart  = uint16_t(m_IPLen);
+        hdr.csumOffset = 16;
+      }
+      const bool ok = write(hdr, pkt, m_Size);
+      m_Size        = 0;
+      m_Segments    = 0;
+      m_Closed      = false;
+      return ok;
+    }
+  }  // namespace net
+}  // namespace llarp
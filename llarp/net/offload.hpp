@@ -0,0 +1,91 @@
+#ifndef LLARP_NET_OFFLOAD_HPP
+#define LLARP_NET_OFFLOAD_HPP
+
+#include <util/buffer.hpp>
+#include <util/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace llarp
+{
+  namespace net
+  {
+    /// the header a tun device opened with IFF_VNET_HDR puts in front of
+    /// every packet (struct virtio_net_hdr), fields are host order
+    struct VnetHeader
+    {
+      static constexpr uint8_t NeedsChecksum = 1;
+
+      static constexpr uint8_t GSONone  = 0;
+      static constexpr uint8_t GSOTCPv4 = 1;
+      static constexpr uint8_t GSOTCPv6 = 4;
+
+      uint8_t flags       = 0;
+      uint8_t gsoType     = GSONone;
+      uint16_t hdrLen     = 0;
+      uint16_t gsoSize    = 0;
+      uint16_t csumStart  = 0;
+      uint16_t csumOffset = 0;
+    };
+
+    static_assert(sizeof(VnetHeader) == 10, "must match virtio_net_hdr");
+
+    /// the biggest packet the kernel hands us or takes with offloads on
+    constexpr size_t MaxOffloadSize = 65535;
+
+    /// turn what the kernel read out of a tun device into plain IP packets:
+    /// finishes a partial checksum and cuts TSO super packets into segments
+    /// no bigger than the gso size. `pkt` is scratch, its bytes are changed.
+    /// returns false and visits nothing if the packet doesn't make sense.
+    bool
+    SegmentOffloaded(const VnetHeader& hdr, byte_t* pkt, size_t sz,
+                     const std::function< void(const llarp_buffer_t&) >& visit);
+
+    /// coalesces tcp segments of the same flow written to a tun device into
+    /// one super packet the kernel cuts up again on its side (like GRO),
+    /// so a burst of segments costs one write
+    class TCPCoalescer
+    {
+     public:
+      using Writer =
+          std::function< bool(const VnetHeader&, const byte_t*, size_t) >;
+
+      /// queue a packet, anything that can't join the pending segments
+      /// gets the pending ones flushed first. packets that can't be
+      /// coalesced at all are written right away.
+      bool
+      Write(const byte_t* pkt, size_t sz, const Writer& write);
+
+      /// write out the pending segments, call once the current batch of
+      /// writes is done
+      bool
+      Flush(const Writer& write);
+
+      /// segments waiting for a flush
+      size_t
+      Pending() const
+      {
+        return m_Segments;
+      }
+
+     private:
+      bool
+      CanAppend(const byte_t* pkt, size_t sz, size_t ipLen,
+                size_t tcpLen) const;
+
+      std::array< byte_t, MaxOffloadSize > m_Buffer;
+      size_t m_Size      = 0;
+      size_t m_IPLen     = 0;
+      size_t m_HdrLen    = 0;
+      size_t m_GSOSize   = 0;
+      size_t m_Segments  = 0;
+      uint32_t m_NextSeq = 0;
+      bool m_Closed      = false;
+    };
+  }  // namespace net
+}  // namespace llarp
+
+#endif
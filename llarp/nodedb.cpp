@@ -3,25 +3,90 @@
 #include <crypto/crypto.hpp>
 #include <router_contact.hpp>
 #include <util/buffer.hpp>
-#include <util/encode.hpp>
 #include <util/fs.hpp>
 #include <util/logging/logger.hpp>
 #include <util/mem.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/thread_pool.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
 static const char skiplist_subdirs[] = "0123456789abcdef";
 static const std::string RC_FILE_EXT = ".signed";
+static const std::string STORE_FILE  = "nodedb.store";
+
+/// rcs decoded and verified per job when loading
+static constexpr size_t VERIFY_CHUNK_SIZE = 256;
+
+/// decode count rcs with decode(idx, rc) and verify them spread over a
+/// short lived pool as wide as the machine, the disk pool is a single thread
+/// and isn't started yet when we load. valid[idx] is set for the good ones.
+static void
+VerifyInParallel(size_t count,
+                 const std::function< bool(size_t, llarp::RouterContact &) >
+                     &decode,
+                 std::vector< llarp::RouterContact > &rcs,
+                 std::vector< char > &valid)
+{
+  rcs.clear();
+  rcs.resize(count);
+  valid.assign(count, 0);
+  const auto now         = llarp::time_now_ms();
+  const auto verifyRange = [&](size_t begin, size_t end) {
+    // only what decoded goes into the batch
+    std::vector< llarp::RouterContact > chunk;
+    std::vector< size_t > owners;
+    for(size_t idx = begin; idx < end; ++idx)
+    {
+      llarp::RouterContact rc;
+      if(!decode(idx, rc))
+        continue;
+      chunk.emplace_back(std::move(rc));
+      owners.emplace_back(idx);
+    }
+    std::vector< char > verified;
+    llarp::RouterContact::VerifyBatch(chunk, now, verified);
+    for(size_t job = 0; job < chunk.size(); ++job)
+    {
+      valid[owners[job]] = verified[job];
+      rcs[owners[job]]   = std::move(chunk[job]);
+    }
+  };
+  const size_t chunks = (count + VERIFY_CHUNK_SIZE - 1) / VERIFY_CHUNK_SIZE;
+  const size_t threads =
+      std::min< size_t >(chunks, std::thread::hardware_concurrency());
+  if(threads <= 1)
+  {
+    verifyRange(0, count);
+    return;
+  }
+  llarp::thread::ThreadPool pool(threads, chunks, "nodedb-verify");
+  if(!pool.start())
+  {
+    verifyRange(0, count);
+    return;
+  }
+  for(size_t begin = 0; begin < count; begin += VERIFY_CHUNK_SIZE)
+  {
+    const size_t end = std::min(count, begin + VERIFY_CHUNK_SIZE);
+    pool.addJob([&verifyRange, begin, end]() { verifyRange(begin, end); });
+  }
+  // runs everything we queued before it joins
+  pool.stop();
+}
 
 llarp_nodedb::NetDBEntry::NetDBEntry(llarp::RouterContact value)
-    : rc(std::move(value)), inserted(llarp::time_now_ms())
+    : rc(std::make_shared< const llarp::RouterContact >(std::move(value)))
+    , inserted(llarp::time_now_ms())
 {
 }
 
+constexpr llarp_time_t llarp_nodedb::CandidatesMaxAge;
+
 bool
 llarp_nodedb::Remove(const llarp::RouterID &pk)
 {
@@ -42,6 +107,7 @@ llarp_nodedb::Clear()
 {
   llarp::util::Lock lock(&access);
   entries.clear();
+  ClearCandidates();
 }
 
 bool
@@ -51,38 +117,35 @@ llarp_nodedb::Get(const llarp::RouterID &pk, llarp::RouterContact &result)
   auto itr = entries.find(pk);
   if(itr == entries.end())
     return false;
-  result = itr->second.rc;
+  result = *itr->second.rc;
   return true;
 }
 
-void
-KillRCJobs(const std::set< std::string > &files)
-{
-  for(const auto &file : files)
-    fs::remove(file);
-}
-
 void
 llarp_nodedb::RemoveIf(
     std::function< bool(const llarp::RouterContact &rc) > filter)
 {
-  std::set< std::string > files;
+  llarp::util::Lock storeLock(&storeAccess);
+  std::vector< llarp::RouterID > removed;
   {
     llarp::util::Lock l(&access);
     auto itr = entries.begin();
     while(itr != entries.end())
     {
-      if(filter(itr->second.rc))
+      if(filter(*itr->second.rc))
       {
-        files.insert(getRCFilePath(itr->second.rc.pubkey));
+        removed.emplace_back(itr->first);
+        RemoveCandidate(itr->first);
         itr = entries.erase(itr);
       }
       else
         ++itr;
     }
   }
-
-  disk->addJob(std::bind(&KillRCJobs, files));
+  if(store == nullptr)
+    return;
+  for(const auto &pk : removed)
+    store->Remove(pk);
 }
 
 bool
@@ -92,27 +155,6 @@ llarp_nodedb::Has(const llarp::RouterID &pk)
   return entries.find(pk) != entries.end();
 }
 
-/// skiplist directory is hex encoded first nibble
-/// skiplist filename is <base32encoded>.snode.signed
-std::string
-llarp_nodedb::getRCFilePath(const llarp::RouterID &pubkey) const
-{
-  char ftmp[68] = {0};
-  const char *hexname =
-      llarp::HexEncode< llarp::AlignedBuffer< 32 >, decltype(ftmp) >(pubkey,
-                                                                     ftmp);
-  std::string hexString(hexname);
-  std::string skiplistDir;
-
-  llarp::RouterID r(pubkey);
-  std::string fname = r.ToString();
-
-  skiplistDir += hexString[0];
-  fname += RC_FILE_EXT;
-  fs::path filepath = nodePath / skiplistDir / fname;
-  return filepath.string();
-}
-
 void
 llarp_nodedb::InsertAsync(llarp::RouterContact rc,
                           std::shared_ptr< llarp::Logic > logic,
@@ -134,7 +176,7 @@ llarp_nodedb::UpdateAsyncIfNewer(llarp::RouterContact rc,
 {
   llarp::util::Lock lock(&access);
   auto itr = entries.find(rc.pubkey);
-  if(itr == entries.end() || itr->second.rc.OtherIsNewer(rc))
+  if(itr == entries.end() || itr->second.rc->OtherIsNewer(rc))
   {
     InsertAsync(rc, logic, completionHandler);
     return true;
@@ -149,44 +191,29 @@ llarp_nodedb::UpdateAsyncIfNewer(llarp::RouterContact rc,
   return false;
 }
 
-/// insert and write to disk
+/// insert and append to the store
 bool
 llarp_nodedb::Insert(const llarp::RouterContact &rc)
 {
-  std::array< byte_t, MAX_RC_SIZE > tmp;
-  llarp_buffer_t buf(tmp);
-
-  if(!rc.BEncode(&buf))
-    return false;
-
-  buf.sz        = buf.cur - buf.base;
-  auto filepath = getRCFilePath(rc.pubkey);
-  llarp::LogDebug("saving RC.pubkey ", filepath);
-  auto optional_ofs = llarp::util::OpenFileStream< std::ofstream >(
-      filepath,
-      std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
-  if(!optional_ofs)
-    return false;
-  auto &ofs = optional_ofs.value();
-  ofs.write((char *)buf.base, buf.sz);
-  ofs.flush();
-  ofs.close();
-  if(!ofs)
-  {
-    llarp::LogError("Failed to write: ", filepath);
-    return false;
-  }
-  llarp::LogDebug("saved RC.pubkey: ", filepath);
-  // save rc after writing to disk
   {
+    // keeps puts in the order entries sees them, readers only wait on access
+    llarp::util::Lock storeLock(&storeAccess);
+    if(store && !store->Put(rc))
+    {
+      llarp::LogError("failed to store RC for ", llarp::RouterID(rc.pubkey));
+      return false;
+    }
     llarp::util::Lock lock(&access);
     auto itr = entries.find(rc.pubkey.as_array());
     if(itr != entries.end())
       entries.erase(itr);
-    entries.emplace(rc.pubkey.as_array(), rc);
+    itr = entries.emplace(rc.pubkey.as_array(), rc).first;
+    AddCandidate(itr->second.rc);
     LogDebug("Added or updated RC for ", llarp::RouterID(rc.pubkey),
              " to nodedb.  Current nodedb count is: ", entries.size());
   }
+  if(store && store->ShouldCompact())
+    CompactStore();
   return true;
 }
 
@@ -198,88 +225,154 @@ llarp_nodedb::Load(const fs::path &path)
   {
     return -1;
   }
-  ssize_t loaded = 0;
+  store = std::make_unique< llarp::NodeDBStore >(path / STORE_FILE);
+  std::vector< llarp::RouterContact > rcs;
+  std::vector< char > valid;
+  const bool opened =
+      store->Open([&](const std::vector< llarp::string_view > &records) {
+        // decoded straight out of the mapping
+        VerifyInParallel(records.size(),
+                         [&](size_t idx, llarp::RouterContact &rc) -> bool {
+                           llarp_buffer_t buf(records[idx].data(),
+                                              records[idx].size());
+                           return rc.BDecode(&buf);
+                         },
+                         rcs, valid);
+      });
+  if(!opened)
+  {
+    llarp::LogError("cannot open ", store->Path(),
+                    ", keeping RCs in memory only");
+    store.reset();
+  }
+  for(size_t idx = 0; store && idx < rcs.size(); ++idx)
+  {
+    // don't verify it again next time
+    if(!valid[idx] && !rcs[idx].pubkey.IsZero())
+      store->Remove(llarp::RouterID(rcs[idx].pubkey));
+  }
+  ssize_t loaded = AddLoaded(rcs, valid, false);
+  loaded += MigrateLegacyFiles(path);
+  return loaded;
+}
 
+ssize_t
+llarp_nodedb::AddLoaded(std::vector< llarp::RouterContact > &rcs,
+                        const std::vector< char > &valid, bool persist)
+{
+  llarp::util::Lock storeLock(&storeAccess);
+  std::vector< RC_ptr > taken;
+  {
+    llarp::util::Lock lock(&access);
+    for(size_t idx = 0; idx < rcs.size(); ++idx)
+    {
+      if(!valid[idx])
+        continue;
+      const llarp::RouterID pk(rcs[idx].pubkey);
+      auto itr = entries.find(pk);
+      if(itr != entries.end())
+      {
+        if(!itr->second.rc->OtherIsNewer(rcs[idx]))
+          continue;
+        entries.erase(itr);
+      }
+      itr = entries.emplace(pk, std::move(rcs[idx])).first;
+      AddCandidate(itr->second.rc);
+      taken.emplace_back(itr->second.rc);
+    }
+  }
+  if(persist && store)
+  {
+    for(const auto &rc : taken)
+      store->Put(*rc);
+  }
+  return taken.size();
+}
+
+ssize_t
+llarp_nodedb::MigrateLegacyFiles(const fs::path &path)
+{
+  std::vector< fs::path > files;
   for(const char &ch : skiplist_subdirs)
   {
     if(!ch)
       continue;
     std::string p;
     p += ch;
-    fs::path sub = path / p;
-
-    ssize_t l = loadSubdir(sub);
-    if(l > 0)
-      loaded += l;
+    std::error_code ec;
+    if(!fs::is_directory(path / p, ec))
+      continue;
+    llarp::util::IterDir(path / p, [&](const fs::path &f) -> bool {
+      if(f.extension() == RC_FILE_EXT && fs::is_regular_file(f))
+        files.emplace_back(f);
+      return true;
+    });
   }
+  if(files.empty())
+    return 0;
+
+  std::vector< llarp::RouterContact > rcs;
+  std::vector< char > valid;
+  VerifyInParallel(files.size(),
+                   [&](size_t idx, llarp::RouterContact &rc) -> bool {
+                     return rc.Read(files[idx].string().c_str());
+                   },
+                   rcs, valid);
+  const ssize_t loaded = AddLoaded(rcs, valid, true);
+  if(store == nullptr)
+    return loaded;
+  // the files go once the store has everything we took from them
+  if(!store->Flush())
+  {
+    llarp::LogError("failed to sync ", store->Path(),
+                    ", leaving the old RC files in place");
+    return loaded;
+  }
+  std::error_code ec;
+  for(const auto &f : files)
+    fs::remove(f, ec);
+  llarp::LogInfo("moved ", loaded, " of ", files.size(),
+                 " RC files into ", store->Path());
   return loaded;
 }
 
 void
-llarp_nodedb::SaveAll()
+llarp_nodedb::CompactStore()
 {
-  std::array< byte_t, MAX_RC_SIZE > tmp;
-  llarp::util::Lock lock(&access);
-  for(const auto &item : entries)
+  // keeps writers out until the store is swapped over
+  llarp::util::Lock storeLock(&storeAccess);
+  std::vector< RC_ptr > held;
   {
-    llarp_buffer_t buf(tmp);
-
-    if(!item.second.rc.BEncode(&buf))
-      continue;
-
-    buf.sz              = buf.cur - buf.base;
-    const auto filepath = getRCFilePath(item.second.rc.pubkey);
-    auto optional_ofs   = llarp::util::OpenFileStream< std::ofstream >(
-        filepath,
-        std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
-    if(!optional_ofs)
-      continue;
-    auto &ofs = optional_ofs.value();
-    ofs.write((char *)buf.base, buf.sz);
-    ofs.flush();
-    ofs.close();
+    absl::ReaderMutexLock lock(&access);
+    held.reserve(entries.size());
+    for(const auto &item : entries)
+      held.emplace_back(item.second.rc);
   }
+  std::vector< const llarp::RouterContact * > live;
+  live.reserve(held.size());
+  for(const auto &rc : held)
+    live.emplace_back(rc.get());
+  const size_t before = store->FileSize();
+  if(store->Compact(live))
+    llarp::LogInfo("compacted ", store->Path(), " from ", before, " to ",
+                   store->FileSize(), " bytes");
 }
 
 void
-llarp_nodedb::AsyncFlushToDisk()
-{
-  disk->addJob(std::bind(&llarp_nodedb::SaveAll, this));
-}
-
-ssize_t
-llarp_nodedb::loadSubdir(const fs::path &dir)
+llarp_nodedb::SaveAll()
 {
-  ssize_t sz = 0;
-  llarp::util::IterDir(dir, [&](const fs::path &f) -> bool {
-    if(fs::is_regular_file(f) && loadfile(f))
-      sz++;
-    return true;
-  });
-  return sz;
+  if(store == nullptr)
+    return;
+  if(store->ShouldCompact())
+    CompactStore();
+  if(!store->Flush())
+    llarp::LogError("failed to sync ", store->Path());
 }
 
-bool
-llarp_nodedb::loadfile(const fs::path &fpath)
+void
+llarp_nodedb::AsyncFlushToDisk()
 {
-  if(fpath.extension() != RC_FILE_EXT)
-    return false;
-  llarp::RouterContact rc;
-  if(!rc.Read(fpath.string().c_str()))
-  {
-    llarp::LogError("failed to read file ", fpath);
-    return false;
-  }
-  if(!rc.Verify(llarp::time_now_ms()))
-  {
-    llarp::LogError(fpath, " contains invalid RC");
-    return false;
-  }
-  {
-    llarp::util::Lock lock(&access);
-    entries.emplace(rc.pubkey.as_array(), rc);
-  }
-  return true;
+  disk->addJob(std::bind(&llarp_nodedb::SaveAll, this));
 }
 
 void
@@ -289,7 +382,7 @@ llarp_nodedb::visit(std::function< bool(const llarp::RouterContact &) > visit)
   auto itr = entries.begin();
   while(itr != entries.end())
   {
-    if(!visit(itr->second.rc))
+    if(!visit(*itr->second.rc))
       return;
     ++itr;
   }
@@ -305,7 +398,7 @@ llarp_nodedb::VisitInsertedBefore(
   while(itr != entries.end())
   {
     if(itr->second.inserted < insertedAfter)
-      visit(itr->second.rc);
+      visit(*itr->second.rc);
     ++itr;
   }
 }
@@ -399,12 +492,8 @@ nodedb_async_load_rc(void *user)
 {
   auto *job = static_cast< llarp_async_load_rc * >(user);
 
-  auto fpath  = job->nodedb->getRCFilePath(job->pubkey);
-  job->loaded = job->nodedb->loadfile(fpath);
-  if(job->loaded)
-  {
-    job->nodedb->Get(job->pubkey, job->result);
-  }
+  // everything in the store was loaded into memory by Load
+  job->loaded = job->nodedb->Get(job->pubkey, job->result);
   job->logic->queue_job({job, &nodedb_inform_load_rc});
 }
 
@@ -420,24 +509,7 @@ llarp_nodedb::ensure_dir(const char *dir)
   if(ec)
     return false;
 
-  if(!fs::is_directory(path))
-    return false;
-
-  for(const char &ch : skiplist_subdirs)
-  {
-    // this seems to be a problem on all targets
-    // perhaps cpp17::fs is just as screwed-up
-    // attempting to create a folder with no name
-    if(!ch)
-      return true;
-    std::string p;
-    p += ch;
-    fs::path sub = path / p;
-    fs::create_directory(sub, ec);
-    if(ec)
-      return false;
-  }
-  return true;
+  return fs::is_directory(path);
 }
 
 void
@@ -484,128 +556,146 @@ llarp_nodedb::num_loaded() const
   return entries.size();
 }
 
-bool
-llarp_nodedb::select_random_exit(llarp::RouterContact &result)
+void
+llarp_nodedb::AddCandidate(const RC_ptr &rc)
 {
-  llarp::util::Lock lock(&access);
-  const auto sz = entries.size();
-  auto itr      = entries.begin();
-  if(sz < 3)
-    return false;
-  auto idx = llarp::randint() % sz;
-  if(idx)
-    std::advance(itr, idx - 1);
-  while(itr != entries.end())
-  {
-    if(itr->second.rc.IsExit())
+  const llarp::RouterID pk(rc->pubkey);
+  allCandidates.Insert(pk, rc);
+  if(rc->addrs.empty())
+    routableCandidates.Remove(pk);
+  else
+    routableCandidates.Insert(pk, rc);
+  if(rc->IsExit())
+    exitCandidates.Insert(pk, rc);
+  else
+    exitCandidates.Remove(pk);
+  candidatesGeneration++;
+}
+
+void
+llarp_nodedb::RemoveCandidate(const llarp::RouterID &pk)
+{
+  allCandidates.Remove(pk);
+  routableCandidates.Remove(pk);
+  exitCandidates.Remove(pk);
+  candidatesGeneration++;
+}
+
+void
+llarp_nodedb::ClearCandidates()
+{
+  allCandidates.Clear();
+  routableCandidates.Clear();
+  exitCandidates.Clear();
+  candidatesGeneration++;
+}
+
+std::shared_ptr< const llarp_nodedb::Candidates >
+llarp_nodedb::GetCandidates()
+{
+  const auto now = llarp::time_now_ms();
+  llarp::util::Lock lock(&snapshotAccess);
+  if(snapshot && snapshot->generation == candidatesGeneration.load()
+     && now - snapshot->builtAt < CandidatesMaxAge)
+    return snapshot;
+
+  auto next     = std::make_shared< Candidates >();
+  next->builtAt = now;
+
+  const auto copyFresh = [now](const CandidateSet_t &from,
+                               std::vector< RC_ptr > &to) {
+    to.reserve(from.Size());
+    for(const auto &rc : from.Values())
     {
-      result = itr->second.rc;
-      return true;
+      if(not rc->IsExpired(now))
+        to.emplace_back(rc);
     }
-    ++itr;
-  }
-  // wrap around
-  itr = entries.begin();
-  while(idx--)
+  };
   {
-    if(itr->second.rc.IsExit())
-    {
-      result = itr->second.rc;
-      return true;
-    }
-    ++itr;
+    // only a copy of pointers, writers wait for this but no sampling
+    absl::ReaderMutexLock l(&access);
+    next->generation = candidatesGeneration.load();
+    copyFresh(allCandidates, next->fresh);
+    copyFresh(routableCandidates, next->routable);
+    copyFresh(exitCandidates, next->exits);
   }
-  return false;
+  snapshot = std::move(next);
+  return snapshot;
+}
+
+bool
+llarp_nodedb::select_random_exit(llarp::RouterContact &result)
+{
+  const auto candidates = GetCandidates();
+  if(candidates->fresh.size() < 3)
+    return false;
+  const auto now = llarp::time_now_ms();
+  const auto *rc = llarp::util::SampleIf(
+      candidates->exits, &llarp::randint,
+      [now](const RC_ptr &exit) { return not exit->IsExpired(now); });
+  if(rc == nullptr)
+    return false;
+  result = **rc;
+  return true;
 }
 
 bool
 llarp_nodedb::select_random_hop(const llarp::RouterContact &prev,
                                 llarp::RouterContact &result, size_t N)
 {
-  llarp::util::Lock lock(&access);
   /// checking for "guard" status for N = 0 is done by caller inside of
   /// pathbuilder's scope
-  size_t sz = entries.size();
-  if(sz < 3)
-    return false;
   if(!N)
     return false;
-  llarp_time_t now = llarp::time_now_ms();
-
-  auto itr   = entries.begin();
-  size_t pos = llarp::randint() % sz;
-  std::advance(itr, pos);
-  auto start = itr;
-  while(itr == entries.end())
-  {
-    if(prev.pubkey != itr->second.rc.pubkey)
-    {
-      if(itr->second.rc.addrs.size() && !itr->second.rc.IsExpired(now))
-      {
-        result = itr->second.rc;
-        return true;
-      }
-    }
-    itr++;
-  }
-  itr = entries.begin();
-  while(itr != start)
-  {
-    if(prev.pubkey != itr->second.rc.pubkey)
-    {
-      if(itr->second.rc.addrs.size() && !itr->second.rc.IsExpired(now))
-      {
-        result = itr->second.rc;
-        return true;
-      }
-    }
-    ++itr;
-  }
-  return false;
+  const auto candidates = GetCandidates();
+  if(candidates->fresh.size() < 3)
+    return false;
+  const auto now = llarp::time_now_ms();
+  const auto *rc = llarp::util::SampleIf(
+      candidates->routable, &llarp::randint, [&](const RC_ptr &hop) {
+        return prev.pubkey != hop->pubkey && not hop->IsExpired(now);
+      });
+  if(rc == nullptr)
+    return false;
+  result = **rc;
+  return true;
 }
 
 bool
 llarp_nodedb::select_random_hop_excluding(
     llarp::RouterContact &result, const std::set< llarp::RouterID > &exclude)
 {
-  llarp::util::Lock lock(&access);
   /// checking for "guard" status for N = 0 is done by caller inside of
   /// pathbuilder's scope
-  const size_t sz = entries.size();
-  if(sz < 3)
-  {
+  const auto candidates = GetCandidates();
+  if(candidates->fresh.size() < 3)
     return false;
-  }
-  llarp_time_t now = llarp::time_now_ms();
+  const auto now = llarp::time_now_ms();
+  const auto *rc = llarp::util::SampleIf(
+      candidates->routable, &llarp::randint, [&](const RC_ptr &hop) {
+        return exclude.count(hop->pubkey) == 0 && not hop->IsExpired(now);
+      });
+  if(rc == nullptr)
+    return false;
+  result = **rc;
+  return true;
+}
 
-  auto itr   = entries.begin();
-  size_t pos = llarp::randint() % sz;
-  std::advance(itr, pos);
-  auto start = itr;
-  while(itr == entries.end())
-  {
-    if(exclude.count(itr->first) == 0)
-    {
-      if(itr->second.rc.addrs.size() && !itr->second.rc.IsExpired(now))
-      {
-        result = itr->second.rc;
-        return true;
-      }
-    }
-    itr++;
-  }
-  itr = entries.begin();
-  while(itr != start)
-  {
-    if(exclude.count(itr->first) == 0)
-    {
-      if(itr->second.rc.addrs.size() && !itr->second.rc.IsExpired(now))
-      {
-        result = itr->second.rc;
-        return true;
-      }
-    }
-    ++itr;
-  }
-  return false;
+bool
+llarp_nodedb::select_random_hop_weighted(
+    llarp::RouterContact &result,
+    std::function< double(const llarp::RouterContact &) > weight)
+{
+  const auto candidates = GetCandidates();
+  if(candidates->fresh.size() < 3)
+    return false;
+  const auto now = llarp::time_now_ms();
+  const auto *rc = llarp::util::SampleWeighted(
+      candidates->routable, &llarp::randint, [&](const RC_ptr &hop) {
+        return hop->IsExpired(now) ? 0 : weight(*hop);
+      });
+  if(rc == nullptr)
+    return false;
+  result = **rc;
+  return true;
 }
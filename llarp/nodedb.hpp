@@ -1,14 +1,18 @@
 #ifndef LLARP_NODEDB_HPP
 #define LLARP_NODEDB_HPP
 
+#include <nodedb_store.hpp>
 #include <router_contact.hpp>
 #include <router_id.hpp>
 #include <util/common.hpp>
 #include <util/fs.hpp>
+#include <util/sample_set.hpp>
 #include <util/thread/threading.hpp>
 
 #include <absl/base/thread_annotations.h>
 
+#include <atomic>
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -53,9 +57,12 @@ struct llarp_nodedb
   std::shared_ptr< llarp::thread::ThreadPool > disk;
   mutable llarp::util::Mutex access;  // protects entries
 
+  using RC_ptr = std::shared_ptr< const llarp::RouterContact >;
+
   struct NetDBEntry
   {
-    const llarp::RouterContact rc;
+    /// shared with the candidate sets
+    const RC_ptr rc;
     llarp_time_t inserted;
 
     NetDBEntry(llarp::RouterContact data);
@@ -66,13 +73,50 @@ struct llarp_nodedb
 
   NetDBMap_t entries GUARDED_BY(access);
   fs::path nodePath;
+  /// where entries are persisted, set up by Load. without one the nodedb
+  /// only lives in memory.
+  std::unique_ptr< llarp::NodeDBStore > store;
+  /// held by writers around their entries update and the file io that goes
+  /// with it, so the store sees them in the same order without the io
+  /// happening under access
+  llarp::util::Mutex storeAccess ACQUIRED_BEFORE(access);
+
+  using CandidateSet_t =
+      llarp::util::SampleSet< llarp::RouterID, RC_ptr, llarp::RouterID::Hash >;
+
+  /// every entry, entries with addresses and exits, kept in step with
+  /// entries so a snapshot of them is a plain copy
+  CandidateSet_t allCandidates GUARDED_BY(access);
+  CandidateSet_t routableCandidates GUARDED_BY(access);
+  CandidateSet_t exitCandidates GUARDED_BY(access);
+  /// bumped every time the candidate sets change
+  std::atomic< uint64_t > candidatesGeneration{0};
+
+  /// immutable view of the candidate sets with expired routers left out,
+  /// sampled from without holding access
+  struct Candidates
+  {
+    std::vector< RC_ptr > fresh;
+    std::vector< RC_ptr > routable;
+    std::vector< RC_ptr > exits;
+    uint64_t generation  = 0;
+    llarp_time_t builtAt = 0;
+  };
+
+  /// how long a snapshot is used for before we rebuild it to drop routers
+  /// that expired since
+  static constexpr llarp_time_t CandidatesMaxAge = 10 * 1000;
+
+  /// get the current candidates, rebuilding them if the nodedb changed
+  std::shared_ptr< const Candidates >
+  GetCandidates() LOCKS_EXCLUDED(access, snapshotAccess);
 
   bool
   Remove(const llarp::RouterID &pk) LOCKS_EXCLUDED(access);
 
   void
   RemoveIf(std::function< bool(const llarp::RouterContact &) > filter)
-      LOCKS_EXCLUDED(access);
+      LOCKS_EXCLUDED(storeAccess, access);
 
   void
   Clear() LOCKS_EXCLUDED(access);
@@ -84,12 +128,10 @@ struct llarp_nodedb
   bool
   Has(const llarp::RouterID &pk) LOCKS_EXCLUDED(access);
 
-  std::string
-  getRCFilePath(const llarp::RouterID &pubkey) const;
-
-  /// insert and write to disk
+  /// insert and append to the store
   bool
-  Insert(const llarp::RouterContact &rc) LOCKS_EXCLUDED(access);
+  Insert(const llarp::RouterContact &rc)
+      LOCKS_EXCLUDED(storeAccess, access);
 
   /// unconditional insert and write to disk in background
   /// updates the inserted time of the entry
@@ -107,18 +149,16 @@ struct llarp_nodedb
                      std::function< void(void) > completionHandler = nullptr)
       LOCKS_EXCLUDED(access);
 
+  /// open the store under path and load every valid rc in it, verifying
+  /// them in parallel. rcs left in the old one file per rc layout are moved
+  /// into the store.
   ssize_t
   Load(const fs::path &path);
 
-  ssize_t
-  loadSubdir(const fs::path &dir);
   /// save all entries to disk async
   void
   AsyncFlushToDisk();
 
-  bool
-  loadfile(const fs::path &fpath) LOCKS_EXCLUDED(access);
-
   void
   visit(std::function< bool(const llarp::RouterContact &) > visit)
       LOCKS_EXCLUDED(access);
@@ -155,11 +195,48 @@ struct llarp_nodedb
                               const std::set< llarp::RouterID > &exclude)
       LOCKS_EXCLUDED(access);
 
+  /// pick a hop with probability proportional to weight, routers weighted 0
+  /// are never picked. O(N) so prefer the uniform selects where they do.
+  bool
+  select_random_hop_weighted(
+      llarp::RouterContact &result,
+      std::function< double(const llarp::RouterContact &) > weight)
+      LOCKS_EXCLUDED(access);
+
   static bool
   ensure_dir(const char *dir);
 
+  /// sync the store to disk, compacting it first if it is mostly dead
+  /// records
   void
   SaveAll() LOCKS_EXCLUDED(access);
+
+ private:
+  /// move rcs from the one file per rc layout under path into the store
+  ssize_t
+  MigrateLegacyFiles(const fs::path &path) LOCKS_EXCLUDED(access);
+
+  /// add the valid rcs we loaded unless we have newer ones, persist puts
+  /// the ones we took into the store. moves out of rcs.
+  ssize_t
+  AddLoaded(std::vector< llarp::RouterContact > &rcs,
+            const std::vector< char > &valid, bool persist)
+      LOCKS_EXCLUDED(storeAccess, access);
+
+  void
+  CompactStore() LOCKS_EXCLUDED(storeAccess, access);
+
+  void
+  AddCandidate(const RC_ptr &rc) EXCLUSIVE_LOCKS_REQUIRED(access);
+
+  void
+  RemoveCandidate(const llarp::RouterID &pk) EXCLUSIVE_LOCKS_REQUIRED(access);
+
+  void
+  ClearCandidates() EXCLUSIVE_LOCKS_REQUIRED(access);
+
+  llarp::util::Mutex snapshotAccess ACQUIRED_BEFORE(access);
+  std::shared_ptr< const Candidates > snapshot GUARDED_BY(snapshotAccess);
 };
 
 /// struct for async rc verification
@@ -222,7 +299,7 @@ struct llarp_async_load_rc
   llarp_async_load_rc_hook_func hook;
 };
 
-/// asynchronously load an rc from disk
+/// asynchronously look up an rc, the store is already loaded in memory
 void
 llarp_nodedb_async_load_rc(struct llarp_async_load_rc *job);
 
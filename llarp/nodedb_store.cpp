@@ -0,0 +1,392 @@
+#include <nodedb_store.hpp>
+
+#include <router_contact.hpp>
+#include <util/endian.hpp>
+#include <util/logging/logger.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llarp
+{
+  constexpr char NodeDBStore::Magic[];
+  constexpr size_t NodeDBStore::MagicSize;
+  constexpr size_t NodeDBStore::RecordHeaderSize;
+  constexpr size_t NodeDBStore::MinCompactBytes;
+
+  /// body bytes before the payload, kind and pubkey
+  static constexpr size_t BodyOverhead = 1 + RouterID::SIZE;
+
+  /// fnv-1a, only there to catch torn writes
+  static uint64_t
+  Checksum(const byte_t *data, size_t sz)
+  {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t idx = 0; idx < sz; ++idx)
+    {
+      h ^= data[idx];
+      h *= 0x100000001b3ULL;
+    }
+    return h;
+  }
+
+  static bool
+  SyncFile(std::FILE *f)
+  {
+    if(std::fflush(f) != 0)
+      return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+  }
+
+  static void
+  EncodeRecord(std::vector< byte_t > &out, NodeDBStore::Kind kind,
+               const RouterID &pk, const llarp_buffer_t &payload)
+  {
+    const size_t bodysz = BodyOverhead + payload.sz;
+    out.resize(NodeDBStore::RecordHeaderSize + bodysz);
+    byte_t *body = out.data() + NodeDBStore::RecordHeaderSize;
+    body[0]      = static_cast< byte_t >(kind);
+    std::copy(pk.begin(), pk.end(), body + 1);
+    std::copy_n(payload.base, payload.sz, body + BodyOverhead);
+    htobe32buf(out.data(), bodysz);
+    htobe64buf(out.data() + 4, Checksum(body, bodysz));
+  }
+
+  /// read only view of a whole file, mapped where we can
+  struct MappedFile
+  {
+    const byte_t *data = nullptr;
+    size_t sz          = 0;
+
+    explicit MappedFile(const fs::path &path)
+    {
+#ifdef _WIN32
+      std::ifstream f(path.string(), std::ios::binary);
+      if(!f.is_open())
+        return;
+      f.seekg(0, std::ios::end);
+      m_Copy.resize(f.tellg());
+      f.seekg(0, std::ios::beg);
+      f.read((char *)m_Copy.data(), m_Copy.size());
+      data = m_Copy.data();
+      sz   = m_Copy.size();
+#else
+      const int fd = ::open(path.string().c_str(), O_RDONLY);
+      if(fd == -1)
+        return;
+      struct stat st;
+      if(::fstat(fd, &st) == 0 && st.st_size > 0)
+      {
+        void *ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(ptr != MAP_FAILED)
+        {
+          ::madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+          data = static_cast< const byte_t * >(ptr);
+          sz   = st.st_size;
+        }
+      }
+      ::close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+      if(data)
+        ::munmap(const_cast< byte_t * >(data), sz);
+#endif
+    }
+
+#ifdef _WIN32
+   private:
+    std::vector< byte_t > m_Copy;
+#endif
+  };
+
+  NodeDBStore::NodeDBStore(fs::path file) : m_Path(std::move(file))
+  {
+  }
+
+  NodeDBStore::~NodeDBStore()
+  {
+    util::Lock lock(&m_Mutex);
+    CloseFile();
+  }
+
+  void
+  NodeDBStore::CloseFile()
+  {
+    if(m_File)
+      std::fclose(m_File);
+    m_File = nullptr;
+  }
+
+  bool
+  NodeDBStore::OpenForAppend()
+  {
+    CloseFile();
+    if(util::EnsurePrivateFile(m_Path))
+    {
+      LogError("cannot create nodedb store ", m_Path);
+      return false;
+    }
+    m_File = std::fopen(m_Path.string().c_str(), "ab");
+    if(m_File == nullptr)
+    {
+      LogError("cannot open nodedb store ", m_Path, " for writing");
+      return false;
+    }
+    if(m_FileSize == 0)
+    {
+      if(std::fwrite(Magic, 1, MagicSize, m_File) != MagicSize)
+        return false;
+      m_FileSize = MagicSize;
+    }
+    return true;
+  }
+
+  bool
+  NodeDBStore::Open(Load_t load)
+  {
+    util::Lock lock(&m_Mutex);
+    CloseFile();
+    m_Live.clear();
+    m_LiveBytes = 0;
+    m_FileSize  = 0;
+
+    std::error_code ec;
+    // a compaction that didn't make it to the rename
+    fs::remove(m_Path.string() + ".tmp", ec);
+
+    size_t valid = 0;
+    size_t sz    = 0;
+    {
+      const MappedFile mapped(m_Path);
+      sz = mapped.sz;
+      if(sz >= MagicSize && std::memcmp(mapped.data, Magic, MagicSize) == 0)
+        valid = Index(mapped.data, sz, load);
+      else if(sz)
+      {
+        LogError(m_Path, " is not a nodedb store, moving it aside");
+        fs::rename(m_Path, m_Path.string() + ".bad", ec);
+        sz = 0;
+      }
+    }
+    if(valid < sz)
+    {
+      LogWarn("dropping ", sz - valid, " bytes of torn records from ", m_Path);
+      fs::resize_file(m_Path, valid, ec);
+      if(ec)
+      {
+        LogError("cannot truncate ", m_Path, ": ", ec.message());
+        return false;
+      }
+    }
+    m_FileSize = valid;
+    return OpenForAppend();
+  }
+
+  size_t
+  NodeDBStore::Index(const byte_t *data, size_t sz, const Load_t &load)
+  {
+    struct Slot
+    {
+      size_t offset;
+      size_t bodysz;
+    };
+    std::unordered_map< RouterID, Slot, RouterID::Hash > latest;
+    size_t pos = MagicSize;
+    while(pos + RecordHeaderSize + BodyOverhead <= sz)
+    {
+      const size_t bodysz = bufbe32toh(data + pos);
+      const byte_t *body  = data + pos + RecordHeaderSize;
+      if(bodysz < BodyOverhead || bodysz > sz - pos - RecordHeaderSize)
+        break;
+      if(Checksum(body, bodysz) != bufbe64toh(data + pos + 4))
+      {
+        // the length still frames it, so only this record is lost
+        LogWarn("skipping corrupt record at offset ", pos, " in ", m_Path);
+        pos += RecordHeaderSize + bodysz;
+        continue;
+      }
+      const RouterID pk(body + 1);
+      switch(static_cast< Kind >(body[0]))
+      {
+        case Kind::ePut:
+          latest[pk] = Slot{pos, bodysz};
+          break;
+        case Kind::eRemove:
+          latest.erase(pk);
+          break;
+        default:
+          LogWarn("unknown record kind ", int(body[0]), " in ", m_Path);
+      }
+      pos += RecordHeaderSize + bodysz;
+    }
+    std::vector< string_view > payloads;
+    payloads.reserve(latest.size());
+    m_Live.reserve(latest.size());
+    for(const auto &item : latest)
+    {
+      const auto &slot = item.second;
+      const byte_t *body = data + slot.offset + RecordHeaderSize;
+      payloads.emplace_back(reinterpret_cast< const char * >(body)
+                                + BodyOverhead,
+                            slot.bodysz - BodyOverhead);
+      m_Live[item.first] = RecordHeaderSize + slot.bodysz;
+      m_LiveBytes += RecordHeaderSize + slot.bodysz;
+    }
+    if(load)
+      load(payloads);
+    return pos;
+  }
+
+  bool
+  NodeDBStore::Append(Kind kind, const RouterID &pk,
+                      const llarp_buffer_t &payload)
+  {
+    if(m_File == nullptr)
+      return false;
+    std::vector< byte_t > record;
+    EncodeRecord(record, kind, pk, payload);
+    if(std::fwrite(record.data(), 1, record.size(), m_File) != record.size())
+    {
+      LogError("failed to append to ", m_Path);
+      return false;
+    }
+    m_FileSize += record.size();
+    auto itr = m_Live.find(pk);
+    if(itr != m_Live.end())
+    {
+      m_LiveBytes -= itr->second;
+      m_Live.erase(itr);
+    }
+    if(kind == Kind::ePut)
+    {
+      m_Live.emplace(pk, record.size());
+      m_LiveBytes += record.size();
+    }
+    return true;
+  }
+
+  bool
+  NodeDBStore::Put(const RouterContact &rc)
+  {
+    std::array< byte_t, MAX_RC_SIZE > tmp;
+    llarp_buffer_t buf(tmp);
+    if(!rc.BEncode(&buf))
+      return false;
+    buf.sz  = buf.cur - buf.base;
+    buf.cur = buf.base;
+    util::Lock lock(&m_Mutex);
+    return Append(Kind::ePut, RouterID(rc.pubkey), buf);
+  }
+
+  bool
+  NodeDBStore::Remove(const RouterID &pk)
+  {
+    util::Lock lock(&m_Mutex);
+    if(m_Live.find(pk) == m_Live.end())
+      return false;
+    return Append(Kind::eRemove, pk, llarp_buffer_t(nullptr, nullptr, 0));
+  }
+
+  bool
+  NodeDBStore::Flush()
+  {
+    util::Lock lock(&m_Mutex);
+    return m_File && SyncFile(m_File);
+  }
+
+  bool
+  NodeDBStore::ShouldCompact() const
+  {
+    util::Lock lock(&m_Mutex);
+    const size_t dead = m_FileSize - MagicSize - m_LiveBytes;
+    return dead >= MinCompactBytes && dead > m_LiveBytes;
+  }
+
+  bool
+  NodeDBStore::Compact(const std::vector< const RouterContact * > &live)
+  {
+    // held throughout so nothing is appended to the file we replace
+    util::Lock lock(&m_Mutex);
+    const fs::path tmpPath = m_Path.string() + ".tmp";
+    std::FILE *out         = std::fopen(tmpPath.string().c_str(), "wb");
+    if(out == nullptr)
+    {
+      LogError("cannot open ", tmpPath, " to compact nodedb store");
+      return false;
+    }
+    std::unordered_map< RouterID, size_t, RouterID::Hash > sizes;
+    sizes.reserve(live.size());
+    size_t written = MagicSize;
+    bool ok        = std::fwrite(Magic, 1, MagicSize, out) == MagicSize;
+    std::array< byte_t, MAX_RC_SIZE > tmp;
+    std::vector< byte_t > record;
+    for(const auto *rc : live)
+    {
+      if(not ok)
+        break;
+      llarp_buffer_t buf(tmp);
+      if(!rc->BEncode(&buf))
+        continue;
+      buf.sz  = buf.cur - buf.base;
+      buf.cur = buf.base;
+      const RouterID pk(rc->pubkey);
+      EncodeRecord(record, Kind::ePut, pk, buf);
+      ok = std::fwrite(record.data(), 1, record.size(), out) == record.size();
+      sizes[pk] = record.size();
+      written += record.size();
+    }
+    ok = ok && SyncFile(out);
+    std::fclose(out);
+
+    std::error_code ec;
+    if(ok)
+    {
+      CloseFile();
+      fs::rename(tmpPath, m_Path, ec);
+    }
+    if(not ok || ec)
+    {
+      LogError("failed to compact nodedb store ", m_Path);
+      fs::remove(tmpPath, ec);
+      if(m_File == nullptr)
+        OpenForAppend();
+      return false;
+    }
+    m_Live      = std::move(sizes);
+    m_LiveBytes = written - MagicSize;
+    m_FileSize  = written;
+    return OpenForAppend();
+  }
+
+  size_t
+  NodeDBStore::Count() const
+  {
+    util::Lock lock(&m_Mutex);
+    return m_Live.size();
+  }
+
+  size_t
+  NodeDBStore::FileSize() const
+  {
+    util::Lock lock(&m_Mutex);
+    return m_FileSize;
+  }
+}  // namespace llarp
@@ -0,0 +1,130 @@
+#ifndef LLARP_NODEDB_STORE_HPP
+#define LLARP_NODEDB_STORE_HPP
+
+#include <router_id.hpp>
+#include <util/buffer.hpp>
+#include <util/fs.hpp>
+#include <util/string_view.hpp>
+#include <util/thread/threading.hpp>
+
+#include <absl/base/thread_annotations.h>
+
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  struct RouterContact;
+
+  /// every router contact the nodedb knows in one append only file.
+  ///
+  /// the file is a magic header followed by records of
+  ///
+  ///   u32 body length, u64 body checksum, body
+  ///
+  /// where the body is a kind byte, the router's pubkey and for a put the
+  /// bencoded rc. the last record for a pubkey wins. a crash can only leave a
+  /// torn record at the tail which is cut off when we open the file again, a
+  /// whole record that fails its checksum is skipped and dropped at the next
+  /// compaction.
+  /// compaction writes the live records to a temporary file and renames it
+  /// over the store so we either see the old file or the new one.
+  struct NodeDBStore
+  {
+    /// the file starts with this
+    static constexpr char Magic[]     = "llarpdb1";
+    static constexpr size_t MagicSize = sizeof(Magic) - 1;
+    /// length and checksum in front of every record body
+    static constexpr size_t RecordHeaderSize = 4 + 8;
+    /// compact once this many bytes are dead and they outweigh the live ones
+    static constexpr size_t MinCompactBytes = 64 * 1024;
+
+    enum class Kind : byte_t
+    {
+      ePut    = 1,
+      eRemove = 2
+    };
+
+    /// called once with the bencoded rc of every live record, all at once so
+    /// they can be decoded in parallel while the file is still mapped
+    using Load_t = std::function< void(const std::vector< string_view > &) >;
+
+    explicit NodeDBStore(fs::path file);
+
+    ~NodeDBStore();
+
+    NodeDBStore(const NodeDBStore &) = delete;
+    NodeDBStore &
+    operator=(const NodeDBStore &) = delete;
+
+    /// map the store, index it and hand the live records to load while the
+    /// mapping is held. creates the file if there is none.
+    bool
+    Open(Load_t load) LOCKS_EXCLUDED(m_Mutex);
+
+    /// append rc, it replaces whatever we had for its pubkey
+    bool
+    Put(const RouterContact &rc) LOCKS_EXCLUDED(m_Mutex);
+
+    /// append a removal if we have pk
+    bool
+    Remove(const RouterID &pk) LOCKS_EXCLUDED(m_Mutex);
+
+    /// get what we appended onto disk
+    bool
+    Flush() LOCKS_EXCLUDED(m_Mutex);
+
+    /// enough of the file is superseded records that Compact pays off
+    bool
+    ShouldCompact() const LOCKS_EXCLUDED(m_Mutex);
+
+    /// replace the store with just the given rcs, which should be everything
+    /// live
+    bool
+    Compact(const std::vector< const RouterContact * > &live)
+        LOCKS_EXCLUDED(m_Mutex);
+
+    /// number of live records
+    size_t
+    Count() const LOCKS_EXCLUDED(m_Mutex);
+
+    /// bytes on disk including superseded records
+    size_t
+    FileSize() const LOCKS_EXCLUDED(m_Mutex);
+
+    const fs::path &
+    Path() const
+    {
+      return m_Path;
+    }
+
+   private:
+    bool
+    Append(Kind kind, const RouterID &pk, const llarp_buffer_t &payload)
+        EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+    /// index a mapped file, returns how many bytes of it are whole records
+    size_t
+    Index(const byte_t *data, size_t sz, const Load_t &load)
+        EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+    bool
+    OpenForAppend() EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+    void
+    CloseFile() EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+    const fs::path m_Path;
+    mutable util::Mutex m_Mutex;
+    std::FILE *m_File GUARDED_BY(m_Mutex) = nullptr;
+    /// size of the live record for each pubkey
+    std::unordered_map< RouterID, size_t, RouterID::Hash > m_Live
+        GUARDED_BY(m_Mutex);
+    size_t m_LiveBytes GUARDED_BY(m_Mutex) = 0;
+    size_t m_FileSize GUARDED_BY(m_Mutex)  = 0;
+  };
+}  // namespace llarp
+
+#endif
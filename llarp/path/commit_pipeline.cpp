@@ -0,0 +1,123 @@
+#include <path/commit_pipeline.hpp>
+
+#include <util/logging/logger.hpp>
+#include <util/time.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  namespace path
+  {
+    constexpr size_t CommitPipeline::BatchSize;
+    constexpr size_t CommitPipeline::MaxPerPeer;
+    constexpr size_t CommitPipeline::MaxQueued;
+    constexpr llarp_time_t CommitPipeline::MaxWait;
+
+    CommitPipeline::CommitPipeline(Dispatch_t toWorker, Dispatch_t toLogic,
+                                   size_t maxInFlight)
+        : m_ToWorker(std::move(toWorker))
+        , m_ToLogic(std::move(toLogic))
+        , m_MaxInFlight(std::max< size_t >(1, maxInFlight))
+    {
+    }
+
+    bool
+    CommitPipeline::Queue(PendingCommit_ptr commit, llarp_time_t now)
+    {
+      const RouterID from = commit->From();
+      auto& queued        = m_PerPeer[from];
+      if(queued >= MaxPerPeer || m_Queue.size() >= MaxQueued)
+      {
+        if(queued == 0)
+          m_PerPeer.erase(from);
+        m_Rejected++;
+        LogWarn("dropping LRCM from ", from, ", ", m_Queue.size(),
+                " queued");
+        return false;
+      }
+      queued++;
+      m_Accepted++;
+      m_Queue.push_back({std::move(commit), from, now});
+      Pump(now);
+      return true;
+    }
+
+    CommitPipeline::Batch_t
+    CommitPipeline::NextBatch(llarp_time_t now)
+    {
+      Batch_t batch;
+      while(not m_Queue.empty() && batch.size() < BatchSize)
+      {
+        Entry entry = std::move(m_Queue.front());
+        m_Queue.pop_front();
+        auto itr = m_PerPeer.find(entry.from);
+        if(itr != m_PerPeer.end() && --itr->second == 0)
+          m_PerPeer.erase(itr);
+        if(now > entry.queuedAt + MaxWait)
+        {
+          m_Expired++;
+          continue;
+        }
+        batch.emplace_back(std::move(entry.commit));
+      }
+      return batch;
+    }
+
+    void
+    CommitPipeline::Pump(llarp_time_t now)
+    {
+      while(m_InFlight < m_MaxInFlight && not m_Queue.empty())
+      {
+        auto batch = std::make_shared< Batch_t >(NextBatch(now));
+        if(batch->empty())
+          continue;
+        m_InFlight++;
+        m_Batches++;
+        m_ToWorker([this, batch]() { DecryptBatch(batch); });
+      }
+    }
+
+    void
+    CommitPipeline::DecryptBatch(std::shared_ptr< Batch_t > batch)
+    {
+      auto decrypted = std::make_shared< std::vector< bool > >();
+      decrypted->reserve(batch->size());
+      for(const auto& commit : *batch)
+        decrypted->push_back(commit->Decrypt());
+      m_ToLogic([this, batch, decrypted]() { FinishBatch(batch, decrypted); });
+    }
+
+    void
+    CommitPipeline::FinishBatch(
+        std::shared_ptr< Batch_t > batch,
+        std::shared_ptr< std::vector< bool > > decrypted)
+    {
+      for(size_t idx = 0; idx < batch->size(); ++idx)
+      {
+        if((*decrypted)[idx])
+        {
+          m_Decrypted++;
+          (*batch)[idx]->Finish();
+        }
+        else
+          m_BadDecrypts++;
+      }
+      m_InFlight--;
+      Pump(time_now_ms());
+    }
+
+    util::StatusObject
+    CommitPipeline::ExtractStatus() const
+    {
+      return util::StatusObject{{"queued", m_Queue.size()},
+                                {"inFlight", m_InFlight},
+                                {"batches", m_Batches},
+                                {"accepted", m_Accepted},
+                                {"rejected", m_Rejected},
+                                {"expired", m_Expired},
+                                {"decrypted", m_Decrypted},
+                                {"badDecrypts", m_BadDecrypts}};
+    }
+  }  // namespace path
+}  // namespace llarp
@@ -0,0 +1,134 @@
+#ifndef LLARP_PATH_COMMIT_PIPELINE_HPP
+#define LLARP_PATH_COMMIT_PIPELINE_HPP
+
+#include <constants/path.hpp>
+#include <router_id.hpp>
+#include <util/status.hpp>
+#include <util/types.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  namespace path
+  {
+    /// a path build request waiting for us to get to our record
+    struct PendingCommit
+    {
+      virtual ~PendingCommit() = default;
+
+      /// the router that sent it to us
+      virtual RouterID
+      From() const = 0;
+
+      /// decrypt our record and derive the hop's keys, called from a worker
+      /// thread. returns false if the request is to be dropped.
+      virtual bool
+      Decrypt() = 0;
+
+      /// accept and forward or confirm the request, called from the logic
+      /// thread after a successful Decrypt
+      virtual void
+      Finish() = 0;
+    };
+
+    using PendingCommit_ptr = std::shared_ptr< PendingCommit >;
+
+    /// queues path build requests and handles them in batches. a batch does
+    /// the decryption and dh for all its commits in one worker job and then
+    /// makes one trip back to the logic thread, instead of a job and a logic
+    /// call per commit. each peer can only have so many commits queued so one
+    /// peer's build storm can't starve the others, and the oldest commits go
+    /// first as their builds are the closest to timing out. commits that sat
+    /// here so long the build has likely timed out already are dropped.
+    ///
+    /// everything but Decrypt happens on the logic thread.
+    struct CommitPipeline
+    {
+      using Job_t      = std::function< void(void) >;
+      using Dispatch_t = std::function< void(Job_t) >;
+
+      /// most commits decrypted in one worker job
+      static constexpr size_t BatchSize = 32;
+      /// most commits queued from one peer
+      static constexpr size_t MaxPerPeer = 64;
+      /// most commits queued in total
+      static constexpr size_t MaxQueued = 4096;
+      /// drop commits that waited longer than this
+      static constexpr llarp_time_t MaxWait = build_timeout / 4;
+
+      /// toWorker runs a job on a worker thread, toLogic on the logic thread.
+      /// at most maxInFlight batches are handed to the workers at a time.
+      CommitPipeline(Dispatch_t toWorker, Dispatch_t toLogic,
+                     size_t maxInFlight);
+
+      /// queue a commit that arrived at now, false if its sender has too
+      /// many queued or we are full
+      bool
+      Queue(PendingCommit_ptr commit, llarp_time_t now);
+
+      /// hand queued commits to the workers if there is room in flight
+      void
+      Pump(llarp_time_t now);
+
+      size_t
+      Queued() const
+      {
+        return m_Queue.size();
+      }
+
+      size_t
+      InFlight() const
+      {
+        return m_InFlight;
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Entry
+      {
+        PendingCommit_ptr commit;
+        RouterID from;
+        llarp_time_t queuedAt;
+      };
+
+      using Batch_t = std::vector< PendingCommit_ptr >;
+
+      /// takes the next batch off the queue, dropping stale commits
+      Batch_t
+      NextBatch(llarp_time_t now);
+
+      /// called from a worker thread
+      void
+      DecryptBatch(std::shared_ptr< Batch_t > batch);
+
+      /// called from the logic thread once a batch was decrypted
+      void
+      FinishBatch(std::shared_ptr< Batch_t > batch,
+                  std::shared_ptr< std::vector< bool > > decrypted);
+
+      const Dispatch_t m_ToWorker;
+      const Dispatch_t m_ToLogic;
+      const size_t m_MaxInFlight;
+      size_t m_InFlight = 0;
+      /// oldest at the front
+      std::deque< Entry > m_Queue;
+      std::unordered_map< RouterID, size_t, RouterID::Hash > m_PerPeer;
+
+      uint64_t m_Accepted    = 0;
+      uint64_t m_Rejected    = 0;
+      uint64_t m_Expired     = 0;
+      uint64_t m_Decrypted   = 0;
+      uint64_t m_BadDecrypts = 0;
+      uint64_t m_Batches     = 0;
+    };
+  }  // namespace path
+}  // namespace llarp
+
+#endif
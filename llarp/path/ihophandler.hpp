@@ -5,6 +5,7 @@
 #include <util/types.hpp>
 #include <crypto/encrypted_frame.hpp>
 #include <messages/relay.hpp>
+#include <util/buffer_pool.hpp>
 #include <vector>
 
 #include <memory>
@@ -24,7 +25,7 @@ namespace llarp
   {
     struct IHopHandler
     {
-      using TrafficEvent_t   = std::pair< std::vector< byte_t >, TunnelNonce >;
+      using TrafficEvent_t   = std::pair< PooledBuffer, TunnelNonce >;
       using TrafficQueue_t   = std::vector< TrafficEvent_t >;
       using TrafficQueue_ptr = std::shared_ptr< TrafficQueue_t >;
 
@@ -40,14 +41,12 @@ namespace llarp
       virtual bool
       SendRoutingMessage(const routing::IMessage& msg, AbstractRouter* r) = 0;
 
-      // handle data in upstream direction
+      // handle data in upstream direction, X is crypted in place
       virtual bool
-      HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y,
-                     AbstractRouter*);
-      // handle data in downstream direction
+      HandleUpstream(PooledBuffer X, const TunnelNonce& Y, AbstractRouter*);
+      // handle data in downstream direction, X is crypted in place
       virtual bool
-      HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y,
-                       AbstractRouter*);
+      HandleDownstream(PooledBuffer X, const TunnelNonce& Y, AbstractRouter*);
 
       /// return timestamp last remote activity happened at
       virtual llarp_time_t
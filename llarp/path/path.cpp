@@ -54,20 +54,20 @@ namespace llarp
     }
 
     bool
-    Path::HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y,
+    Path::HandleUpstream(PooledBuffer X, const TunnelNonce& Y,
                          AbstractRouter* r)
 
     {
       return m_UpstreamReplayFilter.Insert(Y)
-          and IHopHandler::HandleUpstream(X, Y, r);
+          and IHopHandler::HandleUpstream(std::move(X), Y, r);
     }
 
     bool
-    Path::HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y,
+    Path::HandleDownstream(PooledBuffer X, const TunnelNonce& Y,
                            AbstractRouter* r)
     {
       return m_DownstreamReplayFilter.Insert(Y)
-          and IHopHandler::HandleDownstream(X, Y, r);
+          and IHopHandler::HandleDownstream(std::move(X), Y, r);
     }
 
     void
@@ -432,18 +432,24 @@ namespace llarp
     Path::UpstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
     {
       std::vector< RelayUpstreamMessage > sendmsgs(msgs->size());
-      size_t idx = 0;
+      // onion every layer of every packet in one go
+      std::vector< XChaCha20Job > jobs;
+      jobs.reserve(msgs->size() * hops.size());
       for(auto& ev : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
         TunnelNonce n = ev.second;
         for(const auto& hop : hops)
         {
-          CryptoManager::instance()->xchacha20(buf, hop.shared, n);
+          jobs.push_back({ev.first.data(), ev.first.size(), &hop.shared, n});
           n ^= hop.nonceXOR;
         }
+      }
+      CryptoManager::instance()->xchacha20_batch(jobs.data(), jobs.size());
+      size_t idx = 0;
+      for(auto& ev : *msgs)
+      {
         auto& msg  = sendmsgs[idx];
-        msg.X      = buf;
+        msg.X      = std::move(ev.first);
         msg.Y      = ev.second;
         msg.pathid = TXID();
         ++idx;
@@ -505,18 +511,25 @@ namespace llarp
     Path::DownstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
     {
       std::vector< RelayDownstreamMessage > sendMsgs(msgs->size());
+      std::vector< XChaCha20Job > jobs;
+      jobs.reserve(msgs->size() * hops.size());
       size_t idx = 0;
       for(auto& ev : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
         sendMsgs[idx].Y = ev.second;
         for(const auto& hop : hops)
         {
           sendMsgs[idx].Y ^= hop.nonceXOR;
-          CryptoManager::instance()->xchacha20(buf, hop.shared,
-                                               sendMsgs[idx].Y);
+          jobs.push_back({ev.first.data(), ev.first.size(), &hop.shared,
+                          sendMsgs[idx].Y});
         }
-        sendMsgs[idx].X = buf;
+        ++idx;
+      }
+      CryptoManager::instance()->xchacha20_batch(jobs.data(), jobs.size());
+      idx = 0;
+      for(auto& ev : *msgs)
+      {
+        sendMsgs[idx].X = std::move(ev.first);
         ++idx;
       }
       LogicCall(r->logic(),
@@ -573,7 +586,7 @@ namespace llarp
     bool
     Path::SendRoutingMessage(const routing::IMessage& msg, AbstractRouter* r)
     {
-      std::array< byte_t, MAX_LINK_MSG_SIZE / 2 > tmp;
+      PooledBuffer tmp(MAX_LINK_MSG_SIZE / 2);
       llarp_buffer_t buf(tmp);
       // should help prevent bad paths with uninitialized members
       // FIXME: Why would we get uninitialized IMessages?
@@ -596,8 +609,8 @@ namespace llarp
         CryptoManager::instance()->randbytes(buf.cur, pad_size - buf.sz);
         buf.sz = pad_size;
       }
-      buf.cur = buf.base;
-      return HandleUpstream(buf, N, r);
+      tmp.resize(buf.sz);
+      return HandleUpstream(std::move(tmp), N, r);
     }
 
     bool
@@ -253,10 +253,10 @@ namespace llarp
       Rebuild();
 
       bool
-      HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y,
+      HandleUpstream(PooledBuffer X, const TunnelNonce& Y,
                      AbstractRouter*) override;
       bool
-      HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y,
+      HandleDownstream(PooledBuffer X, const TunnelNonce& Y,
                        AbstractRouter*) override;
 
       void
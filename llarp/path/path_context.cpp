@@ -4,6 +4,10 @@
 #include <path/path.hpp>
 #include <router/abstractrouter.hpp>
 #include <router/i_outbound_message_handler.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <thread>
 
 namespace llarp
 {
@@ -15,7 +19,27 @@ namespace llarp
         : m_Router(router)
         , m_AllowTransit(false)
         , m_PathLimits(DefaultPathBuildLimit)
+        , m_Commits(
+              [&](CommitPipeline::Job_t job) {
+                Worker()->addJob(std::move(job));
+              },
+              [&](CommitPipeline::Job_t job) {
+                LogicCall(logic(), std::move(job));
+              },
+              std::thread::hardware_concurrency())
+    {
+    }
+
+    bool
+    PathContext::QueueCommit(PendingCommit_ptr commit)
+    {
+      return m_Commits.Queue(std::move(commit), m_Router->Now());
+    }
+
+    util::StatusObject
+    PathContext::ExtractCommitStatus() const
     {
+      return m_Commits.ExtractStatus();
     }
 
     void
@@ -111,21 +135,6 @@ namespace llarp
       return nullptr;
     }
 
-    template < typename Lock_t, typename Map_t, typename Key_t,
-               typename CheckValue_t >
-    bool
-    MapHas(Map_t& map, const Key_t& k, CheckValue_t check)
-    {
-      Lock_t lock(&map.first);
-      auto range = map.second.equal_range(k);
-      for(auto i = range.first; i != range.second; ++i)
-      {
-        if(check(i->second))
-          return true;
-      }
-      return false;
-    }
-
     template < typename Lock_t, typename Map_t, typename Key_t,
                typename Value_t >
     void
@@ -171,11 +180,9 @@ namespace llarp
     bool
     PathContext::HasTransitHop(const TransitHopInfo& info)
     {
-      return MapHas< SyncTransitMap_t::Lock_t >(
-          m_TransitPaths, info.txID,
-          [info](const std::shared_ptr< TransitHop >& hop) -> bool {
-            return info == hop->info;
-          });
+      return m_TransitPaths.Find(info.txID, [&info](const TransitHop& hop) {
+        return info == hop.info;
+      }) != nullptr;
     }
 
     HopHandler_ptr
@@ -191,38 +198,26 @@ namespace llarp
       if(own)
         return own;
 
-      return MapGet< SyncTransitMap_t::Lock_t >(
-          m_TransitPaths, id,
-          [remote](const std::shared_ptr< TransitHop >& hop) -> bool {
-            return hop->info.upstream == remote;
-          },
-          [](const std::shared_ptr< TransitHop >& h) -> HopHandler_ptr {
-            return h;
-          });
+      auto hop = m_TransitPaths.FindByUpstream(id, remote);
+      if(hop)
+        return *hop;
+      return nullptr;
     }
 
     bool
     PathContext::TransitHopPreviousIsRouter(const PathID_t& path,
                                             const RouterID& otherRouter)
     {
-      SyncTransitMap_t::Lock_t lock(&m_TransitPaths.first);
-      auto itr = m_TransitPaths.second.find(path);
-      if(itr == m_TransitPaths.second.end())
-        return false;
-      return itr->second->info.downstream == otherRouter;
+      return m_TransitPaths.FindByDownstream(path, otherRouter) != nullptr;
     }
 
     HopHandler_ptr
     PathContext::GetByDownstream(const RouterID& remote, const PathID_t& id)
     {
-      return MapGet< SyncTransitMap_t::Lock_t >(
-          m_TransitPaths, id,
-          [remote](const std::shared_ptr< TransitHop >& hop) -> bool {
-            return hop->info.downstream == remote;
-          },
-          [](const std::shared_ptr< TransitHop >& h) -> HopHandler_ptr {
-            return h;
-          });
+      auto hop = m_TransitPaths.FindByDownstream(id, remote);
+      if(hop)
+        return *hop;
+      return nullptr;
     }
 
     PathSet_ptr
@@ -253,17 +248,9 @@ namespace llarp
     TransitHop_ptr
     PathContext::GetPathForTransfer(const PathID_t& id)
     {
-      const RouterID us(OurRouterID());
-      auto& map = m_TransitPaths;
-      {
-        SyncTransitMap_t::Lock_t lock(&map.first);
-        auto range = map.second.equal_range(id);
-        for(auto i = range.first; i != range.second; ++i)
-        {
-          if(i->second->info.upstream == us)
-            return i->second;
-        }
-      }
+      auto hop = m_TransitPaths.FindByUpstream(id, RouterID(OurRouterID()));
+      if(hop)
+        return *hop;
       return nullptr;
     }
 
@@ -285,8 +272,8 @@ namespace llarp
     void
     PathContext::PutTransitHop(std::shared_ptr< TransitHop > hop)
     {
-      MapPut< SyncTransitMap_t::Lock_t >(m_TransitPaths, hop->info.txID, hop);
-      MapPut< SyncTransitMap_t::Lock_t >(m_TransitPaths, hop->info.rxID, hop);
+      if(!m_TransitPaths.Put(std::move(hop)))
+        LogError("not putting transit hop with zero path id");
     }
 
     void
@@ -295,21 +282,11 @@ namespace llarp
       // decay limits
       m_PathLimits.Decay(now);
 
-      {
-        SyncTransitMap_t::Lock_t lock(&m_TransitPaths.first);
-        auto& map = m_TransitPaths.second;
-        auto itr  = map.begin();
-        while(itr != map.end())
-        {
-          if(itr->second->Expired(now))
-          {
-            m_Router->outboundMessageHandler().QueueRemoveEmptyPath(itr->first);
-            itr = map.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+      m_TransitPaths.RemoveIf(
+          [now](const TransitHop& hop) { return hop.Expired(now); },
+          [&](const PathID_t& id) {
+            m_Router->outboundMessageHandler().QueueRemoveEmptyPath(id);
+          });
       {
         SyncOwnedPathsMap_t::Lock_t lock(&m_OurPaths.first);
         auto& map = m_OurPaths.second;
@@ -337,17 +314,9 @@ namespace llarp
       }
       if(h)
         return h;
-      const RouterID us(OurRouterID());
-      auto& map = m_TransitPaths;
-      {
-        SyncTransitMap_t::Lock_t lock(&map.first);
-        auto range = map.second.equal_range(id);
-        for(auto i = range.first; i != range.second; ++i)
-        {
-          if(i->second->info.upstream == us)
-            return i->second;
-        }
-      }
+      auto hop = m_TransitPaths.FindByUpstream(id, RouterID(OurRouterID()));
+      if(hop)
+        return *hop;
       return nullptr;
     }
 
@@ -2,10 +2,12 @@
 #define LLARP_PATH_CONTEXT_HPP
 
 #include <crypto/encrypted_frame.hpp>
+#include <path/commit_pipeline.hpp>
 #include <path/ihophandler.hpp>
 #include <path/path_types.hpp>
 #include <path/pathset.hpp>
 #include <path/transit_hop.hpp>
+#include <path/transit_hop_index.hpp>
 #include <routing/handler.hpp>
 #include <router/i_outbound_message_handler.hpp>
 #include <util/compare_ptr.hpp>
@@ -63,6 +65,14 @@ namespace llarp
       bool
       HandleRelayCommit(const LR_CommitMessage& msg);
 
+      /// queue a path build request to be decrypted in a batch, false if
+      /// we are not taking any more from its sender for now
+      bool
+      QueueCommit(PendingCommit_ptr commit);
+
+      util::StatusObject
+      ExtractCommitStatus() const;
+
       void
       PutTransitHop(std::shared_ptr< TransitHop > hop);
 
@@ -109,27 +119,6 @@ namespace llarp
       void
       RemovePathSet(PathSet_ptr set);
 
-      using TransitHopsMap_t =
-          std::unordered_multimap< PathID_t, TransitHop_ptr, PathID_t::Hash >;
-
-      struct SyncTransitMap_t
-      {
-        using Mutex_t = util::NullMutex;
-        using Lock_t  = util::NullLock;
-
-        Mutex_t first;  // protects second
-        TransitHopsMap_t second GUARDED_BY(first);
-
-        void
-        ForEach(std::function< void(const TransitHop_ptr&) > visit)
-            LOCKS_EXCLUDED(first)
-        {
-          Lock_t lock(&first);
-          for(const auto& item : second)
-            visit(item.second);
-        }
-      };
-
       // maps path id -> pathset owner of path
       using OwnedPathsMap_t =
           std::unordered_map< PathID_t, Path_ptr, PathID_t::Hash >;
@@ -167,10 +156,11 @@ namespace llarp
 
      private:
       AbstractRouter* m_Router;
-      SyncTransitMap_t m_TransitPaths;
+      TransitHopIndex m_TransitPaths;
       SyncOwnedPathsMap_t m_OurPaths;
       bool m_AllowTransit;
       util::DecayingHashSet< llarp::Addr > m_PathLimits;
+      CommitPipeline m_Commits;
     };
   }  // namespace path
 }  // namespace llarp
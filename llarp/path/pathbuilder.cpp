@@ -229,11 +229,11 @@ namespace llarp
         return got;
       }
 
+      std::set< RouterID > excluding = exclude;
       do
       {
         cur.Clear();
         --tries;
-        std::set< RouterID > excluding = exclude;
         if(db->select_random_hop_excluding(cur, excluding))
         {
           excluding.insert(cur.pubkey);
@@ -242,7 +242,15 @@ namespace llarp
         }
       } while(tries > 0);
 
-      return false;
+      // most of what we know is excluded or bad, look at all of them once
+      // rather than keep guessing
+      return db->select_random_hop_weighted(
+          cur, [&](const RouterContact& rc) -> double {
+            if(excluding.count(rc.pubkey)
+               || m_router->routerProfiling().IsBadForPath(rc.pubkey))
+              return 0;
+            return 1;
+          });
     }
 
     bool
@@ -98,7 +98,7 @@ namespace llarp
       if(!IsEndpoint(r->pubkey()))
         return false;
 
-      std::array< byte_t, MAX_LINK_MSG_SIZE - 128 > tmp;
+      PooledBuffer tmp(MAX_LINK_MSG_SIZE - 128);
       llarp_buffer_t buf(tmp);
       if(!msg.BEncode(&buf))
       {
@@ -117,8 +117,18 @@ namespace llarp
         CryptoManager::instance()->randbytes(buf.cur, dlt);
         buf.sz += dlt;
       }
-      buf.cur = buf.base;
-      return HandleDownstream(buf, N, r);
+      tmp.resize(buf.sz);
+      return HandleDownstream(std::move(tmp), N, r);
+    }
+
+    void
+    TransitHop::CryptAll(TrafficQueue_t& msgs)
+    {
+      std::vector< XChaCha20Job > jobs;
+      jobs.reserve(msgs.size());
+      for(auto& ev : msgs)
+        jobs.push_back({ev.first.data(), ev.first.size(), &pathKey, ev.second});
+      CryptoManager::instance()->xchacha20_batch(jobs.data(), jobs.size());
     }
 
     void
@@ -132,18 +142,17 @@ namespace llarp
           auto maybe = self->m_DownstreamGather.tryPopFront();
           if(not maybe.has_value())
             break;
-          msgs.emplace_back(maybe.value());
+          msgs.emplace_back(std::move(maybe.value()));
         } while(true);
         self->HandleAllDownstream(std::move(msgs), r);
       };
+      CryptAll(*msgs);
       for(auto& ev : *msgs)
       {
         RelayDownstreamMessage msg;
-        const llarp_buffer_t buf(ev.first);
         msg.pathid = info.rxID;
         msg.Y      = ev.second ^ nonceXOR;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
-        msg.X = buf;
+        msg.X      = std::move(ev.first);
         llarp::LogDebug("relay ", msg.X.size(), " bytes downstream from ",
                         info.upstream, " to ", info.downstream);
         if(m_DownstreamGather.full())
@@ -151,7 +160,7 @@ namespace llarp
           LogicCall(r->logic(), flushIt);
         }
         if(m_DownstreamGather.enabled())
-          m_DownstreamGather.pushBack(msg);
+          m_DownstreamGather.pushBack(std::move(msg));
       }
       m_DownstreamWorkCounter--;
       if(m_DownstreamWorkCounter == 0)
@@ -169,24 +178,23 @@ namespace llarp
           auto maybe = self->m_UpstreamGather.tryPopFront();
           if(not maybe.has_value())
             break;
-          msgs.emplace_back(maybe.value());
+          msgs.emplace_back(std::move(maybe.value()));
         } while(true);
         self->HandleAllUpstream(std::move(msgs), r);
       };
+      CryptAll(*msgs);
       for(auto& ev : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
         RelayUpstreamMessage msg;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
         msg.pathid = info.txID;
         msg.Y      = ev.second ^ nonceXOR;
-        msg.X      = buf;
+        msg.X      = std::move(ev.first);
         if(m_UpstreamGather.full())
         {
           LogicCall(r->logic(), flushIt);
         }
         if(m_UpstreamGather.enabled())
-          m_UpstreamGather.pushBack(msg);
+          m_UpstreamGather.pushBack(std::move(msg));
       }
       m_UpstreamWorkCounter--;
       if(m_UpstreamWorkCounter == 0)
@@ -223,6 +231,7 @@ namespace llarp
                           info.downstream, " to ", info.upstream);
           r->SendToOrQueue(info.upstream, &msg);
         }
+        BufferPool::Forwarded(msgs.size());
       }
       r->linkManager().PumpLinks();
     }
@@ -237,6 +246,7 @@ namespace llarp
                         info.upstream, " to ", info.downstream);
         r->SendToOrQueue(info.downstream, &msg);
       }
+      BufferPool::Forwarded(msgs.size());
       r->linkManager().PumpLinks();
     }
 
@@ -439,18 +449,16 @@ namespace llarp
         return SendRoutingMessage(discarded, r);
       }
 
-      std::array< byte_t, service::MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+      PooledBuffer tmp(service::MAX_PROTOCOL_MESSAGE_SIZE);
       llarp_buffer_t buf(tmp);
       if(!msg.T.BEncode(&buf))
       {
         llarp::LogWarn(info, " failed to transfer data message, encode failed");
         return SendRoutingMessage(discarded, r);
       }
-      // rewind
-      buf.sz  = buf.cur - buf.base;
-      buf.cur = buf.base;
+      tmp.resize(buf.cur - buf.base);
       // send
-      if(path->HandleDownstream(buf, msg.Y, r))
+      if(path->HandleDownstream(std::move(tmp), msg.Y, r))
       {
         m_FlushOthers.emplace(path);
         return true;
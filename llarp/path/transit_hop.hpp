@@ -227,6 +227,10 @@ namespace llarp
                           AbstractRouter* r) override;
 
      private:
+      /// add or remove our onion layer on every packet in msgs in one batch
+      void
+      CryptAll(TrafficQueue_t& msgs);
+
       void
       SetSelfDestruct();
 
@@ -0,0 +1,105 @@
+#include <path/transit_hop_index.hpp>
+
+#include <utility>
+
+namespace llarp
+{
+  namespace path
+  {
+    constexpr size_t TransitHopIndex::InitialCapacity;
+
+    TransitHopIndex::TransitHopIndex()
+        : m_Slots(InitialCapacity * 4), m_Mask(InitialCapacity * 4 - 1)
+    {
+    }
+
+    bool
+    TransitHopIndex::Put(TransitHop_ptr hop)
+    {
+      if(hop->info.txID.IsZero() || hop->info.rxID.IsZero())
+        return false;
+      // keep at most half the slots in use so probes stay short
+      if((m_Entries + m_Removed + 2) * 2 > m_Slots.size())
+      {
+        size_t capacity = m_Slots.size();
+        while((m_Entries + 2) * 4 > capacity)
+          capacity *= 2;
+        Rehash(capacity);
+      }
+      const PathID_t rxID = hop->info.rxID;
+      Insert(hop->info.txID, hop);
+      Insert(rxID, std::move(hop));
+      return true;
+    }
+
+    void
+    TransitHopIndex::Insert(const PathID_t& id, TransitHop_ptr hop)
+    {
+      for(size_t idx = Home(id);; idx = (idx + 1) & m_Mask)
+      {
+        Slot& slot = m_Slots[idx];
+        if(slot.hop)
+          continue;
+        if(not slot.IsEmpty())
+          m_Removed--;
+        slot.id  = id;
+        slot.hop = std::move(hop);
+        m_Entries++;
+        return;
+      }
+    }
+
+    void
+    TransitHopIndex::Rehash(size_t capacity)
+    {
+      std::vector< Slot > slots(capacity);
+      std::swap(slots, m_Slots);
+      m_Mask    = capacity - 1;
+      m_Entries = 0;
+      m_Removed = 0;
+      for(auto& slot : slots)
+      {
+        if(slot.hop)
+          Insert(slot.id, std::move(slot.hop));
+      }
+    }
+
+    void
+    TransitHopIndex::ForEach(
+        std::function< void(const TransitHop_ptr&) > visit) const
+    {
+      for(const auto& slot : m_Slots)
+      {
+        // every hop is in here twice, visit it by its tx id only
+        if(slot.hop && slot.id == slot.hop->info.txID)
+          visit(slot.hop);
+      }
+    }
+
+    size_t
+    TransitHopIndex::RemoveIf(std::function< bool(const TransitHop&) > remove,
+                              std::function< void(const PathID_t&) > removed)
+    {
+      const size_t entries = m_Entries;
+      for(auto& slot : m_Slots)
+      {
+        if(slot.hop == nullptr || not remove(*slot.hop))
+          continue;
+        removed(slot.id);
+        slot.hop.reset();
+        m_Entries--;
+        m_Removed++;
+      }
+      // once enough is gone rebuild in one go, which clears out the removed
+      // slots so lookups don't have to probe past them
+      if(m_Removed * 4 > m_Slots.size())
+      {
+        size_t capacity = m_Slots.size();
+        while(capacity > InitialCapacity * 4 && m_Entries * 8 < capacity)
+          capacity /= 2;
+        Rehash(capacity);
+      }
+      return (entries - m_Entries) / 2;
+    }
+  }  // namespace path
+}  // namespace llarp
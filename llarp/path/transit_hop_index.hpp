@@ -0,0 +1,133 @@
+#ifndef LLARP_PATH_TRANSIT_HOP_INDEX_HPP
+#define LLARP_PATH_TRANSIT_HOP_INDEX_HPP
+
+#include <path/path_types.hpp>
+#include <path/transit_hop.hpp>
+#include <router_id.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace llarp
+{
+  namespace path
+  {
+    using TransitHop_ptr = std::shared_ptr< TransitHop >;
+
+    /// open addressed index of the transit hops we relay for, by both of
+    /// their path ids. every relayed message looks its hop up here, so a
+    /// lookup is a linear probe over slots holding the path id inline with
+    /// the hop, the match is checked in place and no shared_ptr is copied
+    /// until a hop is found.
+    ///
+    /// hops are only ever removed in bulk by RemoveIf, which the path
+    /// context calls when it expires paths.
+    ///
+    /// not synchronized, it is only used from the logic thread.
+    struct TransitHopIndex
+    {
+      /// a new index has room for this many hops before it grows
+      static constexpr size_t InitialCapacity = 64;
+
+      TransitHopIndex();
+
+      /// add a hop under its tx and rx ids, false if it has a zero id
+      bool
+      Put(TransitHop_ptr hop);
+
+      /// find the first hop with path id `id` for which `match(hop)` is true
+      template < typename Match_t >
+      const TransitHop_ptr*
+      Find(const PathID_t& id, Match_t match) const
+      {
+        for(size_t idx = Home(id);; idx = (idx + 1) & m_Mask)
+        {
+          const Slot& slot = m_Slots[idx];
+          if(slot.IsEmpty())
+            return nullptr;
+          if(slot.hop && slot.id == id && match(*slot.hop))
+            return &slot.hop;
+        }
+      }
+
+      /// the hop with path id `id` whose upstream is `remote`
+      const TransitHop_ptr*
+      FindByUpstream(const PathID_t& id, const RouterID& remote) const
+      {
+        return Find(id, [&remote](const TransitHop& hop) {
+          return hop.info.upstream == remote;
+        });
+      }
+
+      /// the hop with path id `id` whose downstream is `remote`
+      const TransitHop_ptr*
+      FindByDownstream(const PathID_t& id, const RouterID& remote) const
+      {
+        return Find(id, [&remote](const TransitHop& hop) {
+          return hop.info.downstream == remote;
+        });
+      }
+
+      /// visit every hop once
+      void
+      ForEach(std::function< void(const TransitHop_ptr&) > visit) const;
+
+      /// remove every hop for which `remove(hop)` is true, calls `removed`
+      /// with each path id dropped. returns the number of hops removed.
+      size_t
+      RemoveIf(std::function< bool(const TransitHop&) > remove,
+               std::function< void(const PathID_t&) > removed);
+
+      /// number of hops
+      size_t
+      Size() const
+      {
+        return m_Entries / 2;
+      }
+
+      size_t
+      Capacity() const
+      {
+        return m_Slots.size();
+      }
+
+     private:
+      /// a zero id marks an empty slot, a non zero id without a hop a
+      /// removed one. transit hops never have a zero path id.
+      struct Slot
+      {
+        PathID_t id;
+        TransitHop_ptr hop;
+
+        bool
+        IsEmpty() const
+        {
+          return hop == nullptr && id.IsZero();
+        }
+      };
+
+      size_t
+      Home(const PathID_t& id) const
+      {
+        return PathID_t::Hash{}(id) & m_Mask;
+      }
+
+      void
+      Insert(const PathID_t& id, TransitHop_ptr hop);
+
+      /// reinsert everything into `capacity` slots, dropping removed slots
+      void
+      Rehash(size_t capacity);
+
+      std::vector< Slot > m_Slots;
+      size_t m_Mask;
+      /// slots holding a hop
+      size_t m_Entries = 0;
+      /// slots a hop was removed from
+      size_t m_Removed = 0;
+    };
+  }  // namespace path
+}  // namespace llarp
+
+#endif
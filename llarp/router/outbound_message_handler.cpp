@@ -6,16 +6,15 @@
 #include <constants/link_layer.hpp>
 #include <util/meta/memfn.hpp>
 #include <util/status.hpp>
+#include <util/time.hpp>
 
 #include <algorithm>
 #include <cstdlib>
 
 namespace llarp
 {
-  const PathID_t OutboundMessageHandler::zeroID;
-
   OutboundMessageHandler::OutboundMessageHandler(size_t maxQueueSize)
-      : outboundQueue(maxQueueSize), removedPaths(20), removedSomePaths(false)
+      : outboundQueue(maxQueueSize), removedPaths(20)
   {
   }
 
@@ -24,23 +23,23 @@ namespace llarp
                                        const ILinkMessage *msg,
                                        SendStatusHandler callback)
   {
-    std::array< byte_t, MAX_LINK_MSG_SIZE > linkmsg_buffer;
-    llarp_buffer_t buf(linkmsg_buffer);
+    // encode straight into the pooled buffer the link layer will send from
+    Message message;
+    message.first = ILinkSession::Message_t(MAX_LINK_MSG_SIZE);
+    llarp_buffer_t buf(message.first);
 
     if(!EncodeBuffer(msg, buf))
     {
       return false;
     }
 
-    Message message;
     message.first.resize(buf.sz);
     message.second = callback;
 
-    std::copy_n(buf.base, buf.sz, message.first.data());
-
     if(_linkManager->HasSessionTo(remote))
     {
-      QueueOutboundMessage(remote, std::move(message), msg->pathid);
+      QueueOutboundMessage(remote, std::move(message), msg->pathid,
+                           msg->Traffic());
       return true;
     }
 
@@ -74,7 +73,7 @@ namespace llarp
     m_Killer.TryAccess([self = this]() {
       self->ProcessOutboundQueue();
       self->RemoveEmptyPathQueues();
-      self->SendRoundRobin();
+      self->SendFairly();
     });
   }
 
@@ -85,12 +84,11 @@ namespace llarp
         [self = this, pathid]() { self->removedPaths.pushBack(pathid); });
   }
 
-  // TODO: this
   util::StatusObject
   OutboundMessageHandler::ExtractStatus() const
   {
-    util::StatusObject status{};
-    return status;
+    // only touched from the logic thread, which is where we get called
+    return scheduler.ExtractStatus();
   }
 
   void
@@ -99,8 +97,6 @@ namespace llarp
   {
     _linkManager = linkManager;
     _logic       = logic;
-
-    outboundMessageQueues.emplace(zeroID, MessageQueue());
   }
 
   void
@@ -199,10 +195,9 @@ namespace llarp
   bool
   OutboundMessageHandler::Send(const RouterID &remote, const Message &msg)
   {
-    const llarp_buffer_t buf(msg.first);
     auto callback = msg.second;
     return _linkManager->SendTo(
-        remote, buf, [=](ILinkSession::DeliveryStatus status) {
+        remote, msg.first, [=](ILinkSession::DeliveryStatus status) {
           if(status == ILinkSession::DeliveryStatus::eDeliverySuccess)
             DoCallback(callback, SendStatus::Success);
           else
@@ -224,13 +219,16 @@ namespace llarp
   bool
   OutboundMessageHandler::QueueOutboundMessage(const RouterID &remote,
                                                Message &&msg,
-                                               const PathID_t &pathid)
+                                               const PathID_t &pathid,
+                                               TrafficClass traffic)
   {
     MessageQueueEntry entry;
     entry.message      = std::move(msg);
     auto callback_copy = entry.message.second;
     entry.router       = remote;
     entry.pathid       = pathid;
+    entry.traffic      = traffic;
+    entry.queued       = time_now_ms();
     if(outboundQueue.tryPushBack(std::move(entry))
        != llarp::thread::QueueReturn::Success)
     {
@@ -246,109 +244,25 @@ namespace llarp
     while(not outboundQueue.empty())
     {
       // TODO: can we add util::thread::Queue::front() for move semantics here?
-      MessageQueueEntry entry = outboundQueue.popFront();
-
-      auto itr_pair =
-          outboundMessageQueues.emplace(entry.pathid, MessageQueue());
-
-      if(itr_pair.second && !entry.pathid.IsZero())
-      {
-        roundRobinOrder.push(entry.pathid);
-      }
-
-      MessageQueue &path_queue = itr_pair.first->second;
-      if(path_queue.size() >= MAX_PATH_QUEUE_SIZE)
-      {
-        path_queue.pop();  // head drop
-      }
-      path_queue.push(std::move(entry));
+      scheduler.Queue(outboundQueue.popFront(), [&](MessageQueueEntry &&old) {
+        DoCallback(old.message.second, SendStatus::Congestion);
+      });
     }
   }
 
   void
   OutboundMessageHandler::RemoveEmptyPathQueues()
   {
-    removedSomePaths = false;
-    if(removedPaths.empty())
-      return;
-
     while(not removedPaths.empty())
-    {
-      auto itr = outboundMessageQueues.find(removedPaths.popFront());
-      if(itr != outboundMessageQueues.end())
-      {
-        outboundMessageQueues.erase(itr);
-      }
-    }
-    removedSomePaths = true;
+      scheduler.RemovePath(removedPaths.popFront());
   }
 
   void
-  OutboundMessageHandler::SendRoundRobin()
+  OutboundMessageHandler::SendFairly()
   {
-    // send non-routing messages first priority
-    auto &non_routing_mq = outboundMessageQueues[zeroID];
-    while(not non_routing_mq.empty())
-    {
-      MessageQueueEntry entry = std::move(non_routing_mq.front());
-      non_routing_mq.pop();
-
+    scheduler.Drain(time_now_ms(), [&](MessageQueueEntry &&entry) {
       Send(entry.router, entry.message);
-    }
-
-    size_t empty_count = 0;
-    size_t num_queues  = roundRobinOrder.size();
-
-    if(removedSomePaths)
-    {
-      for(size_t i = 0; i < num_queues; i++)
-      {
-        PathID_t pathid = std::move(roundRobinOrder.front());
-        roundRobinOrder.pop();
-
-        if(outboundMessageQueues.find(pathid) != outboundMessageQueues.end())
-        {
-          roundRobinOrder.push(std::move(pathid));
-        }
-      }
-    }
-
-    num_queues        = roundRobinOrder.size();
-    size_t sent_count = 0;
-    if(num_queues == 0)  // if no queues, return
-    {
-      return;
-    }
-
-    while(sent_count
-          < MAX_OUTBOUND_MESSAGES_PER_TICK)  // TODO: better stop condition
-    {
-      PathID_t pathid = std::move(roundRobinOrder.front());
-      roundRobinOrder.pop();
-
-      auto &message_queue = outboundMessageQueues[pathid];
-      if(message_queue.size() > 0)
-      {
-        MessageQueueEntry entry = std::move(message_queue.front());
-        message_queue.pop();
-
-        Send(entry.router, entry.message);
-        empty_count = 0;
-        sent_count++;
-      }
-      else
-      {
-        empty_count++;
-      }
-
-      roundRobinOrder.push(std::move(pathid));
-
-      // if num_queues empty queues in a row, all queues empty.
-      if(empty_count == num_queues)
-      {
-        break;
-      }
-    }
+    });
   }
 
   void
@@ -2,7 +2,9 @@
 #define LLARP_ROUTER_OUTBOUND_MESSAGE_HANDLER_HPP
 
 #include <router/i_outbound_message_handler.hpp>
+#include <router/outbound_scheduler.hpp>
 
+#include <link/session.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
 #include <util/thread/threading.hpp>
@@ -45,15 +47,8 @@ namespace llarp
     Init(ILinkManager *linkManager, std::shared_ptr< Logic > logic);
 
    private:
-    using Message = std::pair< std::vector< byte_t >, SendStatusHandler >;
-
-    struct MessageQueueEntry
-    {
-      Message message;
-      PathID_t pathid;
-      RouterID router;
-    };
-
+    using Message           = OutboundScheduler::Message;
+    using MessageQueueEntry = OutboundScheduler::Entry;
     using MessageQueue = std::queue< MessageQueueEntry >;
 
     void
@@ -91,7 +86,7 @@ namespace llarp
 
     bool
     QueueOutboundMessage(const RouterID &remote, Message &&msg,
-                         const PathID_t &pathid);
+                         const PathID_t &pathid, TrafficClass traffic);
 
     void
     ProcessOutboundQueue();
@@ -100,7 +95,7 @@ namespace llarp
     RemoveEmptyPathQueues();
 
     void
-    SendRoundRobin();
+    SendFairly();
 
     void
     FinalizeSessionRequest(const RouterID &router, SendStatus status)
@@ -108,26 +103,18 @@ namespace llarp
 
     llarp::thread::Queue< MessageQueueEntry > outboundQueue;
     llarp::thread::Queue< PathID_t > removedPaths;
-    bool removedSomePaths;
 
     mutable util::Mutex _mutex;  // protects pendingSessionMessageQueues
 
     std::unordered_map< RouterID, MessageQueue, RouterID::Hash >
         pendingSessionMessageQueues GUARDED_BY(_mutex);
 
-    std::unordered_map< PathID_t, MessageQueue, PathID_t::Hash >
-        outboundMessageQueues;
-
-    std::queue< PathID_t > roundRobinOrder;
+    OutboundScheduler scheduler;
 
     ILinkManager *_linkManager;
     std::shared_ptr< Logic > _logic;
 
     util::ContentionKiller m_Killer;
-
-    // paths cannot have pathid "0", so it can be used as the "pathid"
-    // for non-traffic (control) messages, so they can be prioritized.
-    static const PathID_t zeroID;
   };
 
 }  // namespace llarp
@@ -0,0 +1,220 @@
+#include <router/outbound_scheduler.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace llarp
+{
+  constexpr size_t OutboundScheduler::NumClasses;
+  constexpr size_t OutboundScheduler::TickBudget;
+  constexpr size_t OutboundScheduler::PeerBudget;
+  constexpr size_t OutboundScheduler::PathQuantum;
+
+  OutboundScheduler::OutboundScheduler()
+  {
+    for(size_t idx = 0; idx < NumClasses; ++idx)
+    {
+      const std::string category =
+          std::string("Outbound") + ClassName(TrafficClass(idx));
+      auto& cls = m_Classes[idx];
+      cls.sojourn =
+          std::make_unique< metrics::ShardedHistogram >(category, "Sojourn");
+      cls.depth =
+          std::make_unique< metrics::ShardedCounter >(category, "Depth");
+    }
+  }
+
+  OutboundScheduler::~OutboundScheduler() = default;
+
+  size_t
+  OutboundScheduler::Quantum(TrafficClass traffic)
+  {
+    // control keeps the links up and path builds time out, so under load
+    // they get the most. data only ever gets starved down to its share.
+    switch(traffic)
+    {
+      case TrafficClass::Control:
+        return 4 * MAX_LINK_MSG_SIZE;
+      case TrafficClass::PathBuild:
+      case TrafficClass::DHT:
+        return 2 * MAX_LINK_MSG_SIZE;
+      case TrafficClass::Data:
+      default:
+        return MAX_LINK_MSG_SIZE;
+    }
+  }
+
+  const char*
+  OutboundScheduler::ClassName(TrafficClass traffic)
+  {
+    switch(traffic)
+    {
+      case TrafficClass::Control:
+        return "Control";
+      case TrafficClass::PathBuild:
+        return "PathBuild";
+      case TrafficClass::DHT:
+        return "DHT";
+      case TrafficClass::Data:
+        return "Data";
+      default:
+        return "Unknown";
+    }
+  }
+
+  void
+  OutboundScheduler::Queue(Entry entry, const SendFunc& dropped)
+  {
+    auto& cls = m_Classes[size_t(entry.traffic)];
+    auto itr  = cls.flows.find(entry.pathid);
+    if(itr == cls.flows.end())
+    {
+      itr = cls.flows.emplace(entry.pathid, Flow{}).first;
+      cls.active.emplace_back(entry.pathid);
+    }
+    auto& entries = itr->second.entries;
+    if(entries.size() >= MAX_PATH_QUEUE_SIZE)
+    {
+      // head drop, the oldest is the least useful by now
+      Entry old = std::move(entries.front());
+      entries.pop_front();
+      cls.size--;
+      cls.drops++;
+      dropped(std::move(old));
+    }
+    entries.emplace_back(std::move(entry));
+    cls.size++;
+  }
+
+  size_t
+  OutboundScheduler::Drain(llarp_time_t now, const SendFunc& send,
+                           size_t budget)
+  {
+    for(auto& cls : m_Classes)
+      cls.depth->tick(int(cls.size));
+
+    PeerBytes peers;
+    size_t sent = 0;
+    while(budget > 0)
+    {
+      size_t round = 0;
+      for(size_t idx = 0; idx < NumClasses; ++idx)
+      {
+        auto& cls = m_Classes[idx];
+        if(cls.active.empty())
+        {
+          cls.deficit = 0;
+          continue;
+        }
+        const size_t quantum = Quantum(TrafficClass(idx));
+        cls.deficit          = std::min(cls.deficit + quantum, quantum * 2);
+        round += Serve(cls, now, send, budget, peers);
+      }
+      // nothing queued or all that is left is over some budget
+      if(round == 0)
+        break;
+      sent += round;
+    }
+    return sent;
+  }
+
+  size_t
+  OutboundScheduler::Serve(Class& cls, llarp_time_t now, const SendFunc& send,
+                           size_t& budget, PeerBytes& peers)
+  {
+    size_t sent = 0;
+    // every path gets at most one turn per round
+    for(size_t turns = cls.active.size(); turns > 0 && cls.deficit > 0;
+        --turns)
+    {
+      const PathID_t pathid = cls.active.front();
+      cls.active.pop_front();
+      auto itr     = cls.flows.find(pathid);
+      Flow& flow   = itr->second;
+      flow.deficit = std::min(flow.deficit + PathQuantum, PathQuantum * 2);
+      while(not flow.entries.empty())
+      {
+        Entry& entry    = flow.entries.front();
+        const size_t sz = entry.message.first.size();
+        if(sz > flow.deficit || sz > cls.deficit || sz > budget)
+          break;
+        if(entry.traffic != TrafficClass::Control)
+        {
+          size_t& peerBytes = peers[entry.router];
+          if(peerBytes + sz > PeerBudget)
+            break;
+          peerBytes += sz;
+        }
+        flow.deficit -= sz;
+        cls.deficit  -= sz;
+        budget       -= sz;
+
+        const llarp_time_t sojourn =
+            now > entry.queued ? now - entry.queued : 0;
+        cls.maxSojourn = std::max(cls.maxSojourn, sojourn);
+        cls.sojourn->tick(int(sojourn));
+        cls.size--;
+        cls.sent++;
+        cls.bytes += sz;
+
+        send(std::move(entry));
+        flow.entries.pop_front();
+        sent++;
+      }
+      if(flow.entries.empty())
+        cls.flows.erase(itr);
+      else
+        cls.active.emplace_back(pathid);
+    }
+    return sent;
+  }
+
+  void
+  OutboundScheduler::RemovePath(const PathID_t& pathid)
+  {
+    for(auto& cls : m_Classes)
+    {
+      auto itr = cls.flows.find(pathid);
+      if(itr == cls.flows.end())
+        continue;
+      cls.size -= itr->second.entries.size();
+      cls.flows.erase(itr);
+      cls.active.erase(
+          std::remove(cls.active.begin(), cls.active.end(), pathid),
+          cls.active.end());
+    }
+  }
+
+  size_t
+  OutboundScheduler::Size() const
+  {
+    size_t sz = 0;
+    for(const auto& cls : m_Classes)
+      sz += cls.size;
+    return sz;
+  }
+
+  size_t
+  OutboundScheduler::Size(TrafficClass traffic) const
+  {
+    return m_Classes[size_t(traffic)].size;
+  }
+
+  util::StatusObject
+  OutboundScheduler::ExtractStatus() const
+  {
+    util::StatusObject obj{};
+    for(size_t idx = 0; idx < NumClasses; ++idx)
+    {
+      const auto& cls = m_Classes[idx];
+      obj[ClassName(TrafficClass(idx))] =
+          util::StatusObject{{"queued", cls.size},
+                             {"paths", cls.flows.size()},
+                             {"sent", cls.sent},
+                             {"bytes", cls.bytes},
+                             {"drops", cls.drops},
+                             {"maxSojourn", cls.maxSojourn}};
+    }
+    return obj;
+  }
+}  // namespace llarp
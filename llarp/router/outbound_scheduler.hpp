@@ -0,0 +1,130 @@
+#ifndef LLARP_ROUTER_OUTBOUND_SCHEDULER_HPP
+#define LLARP_ROUTER_OUTBOUND_SCHEDULER_HPP
+
+#include <constants/link_layer.hpp>
+#include <link/session.hpp>
+#include <messages/link_message.hpp>
+#include <path/path_types.hpp>
+#include <router/i_outbound_message_handler.hpp>
+#include <router_id.hpp>
+#include <util/metrics/sharded.hpp>
+#include <util/status.hpp>
+#include <util/types.hpp>
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace llarp
+{
+  /// deficit round robin over the outbound link messages of one router.
+  ///
+  /// every TrafficClass gets a share of each Drain weighted by its quantum,
+  /// and inside a class every path gets an equal share, so a few bulk paths
+  /// can't hold back control, path build or dht messages and a busy path
+  /// can't hold back the other paths. a class or path that has nothing to
+  /// send leaves its share to the others. on top of that no peer gets more
+  /// than PeerBudget bytes per Drain outside of control messages.
+  ///
+  /// not thread safe, only used from the router's logic thread.
+  struct OutboundScheduler
+  {
+    using Message = std::pair< ILinkSession::Message_t, SendStatusHandler >;
+
+    struct Entry
+    {
+      Message message;
+      PathID_t pathid;
+      RouterID router;
+      TrafficClass traffic = TrafficClass::Control;
+      /// when it was queued, for the sojourn time
+      llarp_time_t queued = 0;
+    };
+
+    using SendFunc = std::function< void(Entry&&) >;
+
+    static constexpr size_t NumClasses = 4;
+
+    /// bytes one Drain may send in total
+    static constexpr size_t TickBudget =
+        MAX_OUTBOUND_MESSAGES_PER_TICK * MAX_LINK_MSG_SIZE;
+
+    /// bytes one peer may get out of a Drain, control messages excluded
+    static constexpr size_t PeerBudget = TickBudget / 4;
+
+    /// bytes a path gets per round inside its class
+    static constexpr size_t PathQuantum = MAX_LINK_MSG_SIZE;
+
+    OutboundScheduler();
+
+    ~OutboundScheduler();
+
+    /// bytes a class gets per round, relative to the other classes
+    static size_t
+    Quantum(TrafficClass traffic);
+
+    static const char*
+    ClassName(TrafficClass traffic);
+
+    /// queue an entry, if its path already has MAX_PATH_QUEUE_SIZE entries
+    /// the oldest one is dropped and handed to `dropped`
+    void
+    Queue(Entry entry, const SendFunc& dropped);
+
+    /// send up to `budget` bytes in fair order
+    /// returns how many entries were sent
+    size_t
+    Drain(llarp_time_t now, const SendFunc& send, size_t budget = TickBudget);
+
+    /// forget a path and anything still queued on it
+    void
+    RemovePath(const PathID_t& pathid);
+
+    size_t
+    Size() const;
+
+    size_t
+    Size(TrafficClass traffic) const;
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    struct Flow
+    {
+      std::deque< Entry > entries;
+      size_t deficit = 0;
+    };
+
+    struct Class
+    {
+      std::unordered_map< PathID_t, Flow, PathID_t::Hash > flows;
+      /// paths with something queued in the order they get served
+      std::deque< PathID_t > active;
+      size_t deficit = 0;
+      size_t size    = 0;
+      uint64_t sent  = 0;
+      uint64_t bytes = 0;
+      uint64_t drops = 0;
+
+      llarp_time_t maxSojourn = 0;
+      std::unique_ptr< metrics::ShardedHistogram > sojourn;
+      std::unique_ptr< metrics::ShardedCounter > depth;
+    };
+
+    using PeerBytes = std::unordered_map< RouterID, size_t, RouterID::Hash >;
+
+    /// serve the paths of one class for one round
+    /// returns how many entries it sent
+    size_t
+    Serve(Class& cls, llarp_time_t now, const SendFunc& send, size_t& budget,
+          PeerBytes& peers);
+
+    std::array< Class, NumClasses > m_Classes;
+  };
+}  // namespace llarp
+
+#endif
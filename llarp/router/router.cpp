@@ -14,6 +14,7 @@
 #include <net/net.hpp>
 #include <rpc/rpc.hpp>
 #include <util/buffer.hpp>
+#include <util/buffer_pool.hpp>
 #include <util/encode.hpp>
 #include <util/logging/file_logger.hpp>
 #include <util/logging/json_logger.hpp>
@@ -78,7 +79,11 @@ namespace llarp
           {"dht", _dht->impl->ExtractStatus()},
           {"services", _hiddenServiceContext.ExtractStatus()},
           {"exit", _exitContext.ExtractStatus()},
-          {"links", _linkManager.ExtractStatus()}};
+          {"links", _linkManager.ExtractStatus()},
+          {"outbound", _outboundMessageHandler.ExtractStatus()},
+          {"pathBuilds", paths.ExtractCommitStatus()},
+          {"rcVerifyCache", RouterContact::VerifyCache().ExtractStatus()},
+          {"buffers", BufferPool::ExtractAllStatus()}};
     }
     else
     {
@@ -115,19 +120,12 @@ namespace llarp
       return _rcLookupHandler.GetRandomWhitelistRouter(router);
     }
 
-    auto pick_router = [&](auto &collection) -> bool {
-      const auto sz = collection.size();
-      auto itr      = collection.begin();
-      if(sz == 0)
-        return false;
-      if(sz > 1)
-        std::advance(itr, randint() % sz);
-      router = itr->first;
-      return true;
-    };
-
-    absl::ReaderMutexLock l(&nodedb()->access);
-    return pick_router(nodedb()->entries);
+    const auto candidates = nodedb()->GetCandidates();
+    const auto *rc = util::SampleUniform(candidates->fresh, &randint);
+    if(rc == nullptr)
+      return false;
+    router = (*rc)->pubkey;
+    return true;
   }
 
   void
@@ -377,6 +375,8 @@ namespace llarp
 
     // IWP config
     m_OutboundPort = std::get< LinksConfig::Port >(conf->links.outboundLink());
+    m_BatchedUDP   = conf->router.udpBatching();
+    m_LinkShards   = std::max(conf->router.linkShards(), 1);
     // Router config
     _rc.SetNick(conf->router.nickname());
     _outboundSessionMaker.maxConnectedRouters =
@@ -542,6 +542,8 @@ namespace llarp
       const auto &key = std::get< LinksConfig::Interface >(serverConfig);
       int af          = std::get< LinksConfig::AddressFamily >(serverConfig);
       uint16_t port   = std::get< LinksConfig::Port >(serverConfig);
+      server->SetBatchedIO(m_BatchedUDP);
+      server->SetShards(m_LinkShards);
       if(!server->Configure(netloop(), key, af, port))
       {
         LogError("failed to bind inbound link on ", key, " port ", port);
@@ -594,13 +596,13 @@ namespace llarp
 
     if(conf->logging.m_LogJSON)
     {
-      LogContext::Instance().logStream = std::make_unique< JSONLogStream >(
-          diskworker(), logfile, 100, logfile != stdout);
+      LogContext::Instance().SetLogStream(std::make_unique< JSONLogStream >(
+          diskworker(), logfile, 100, logfile != stdout));
     }
     else if(logfile != stdout)
     {
-      LogContext::Instance().logStream =
-          std::make_unique< FileLogStream >(diskworker(), logfile, 100, true);
+      LogContext::Instance().SetLogStream(
+          std::make_unique< FileLogStream >(diskworker(), logfile, 100, true));
     }
 
     netConfig.insert(conf->dns.netConfig.begin(), conf->dns.netConfig.end());
@@ -1187,6 +1189,9 @@ namespace llarp
     if(!link)
       return false;
 
+    link->SetBatchedIO(m_BatchedUDP);
+    link->SetShards(m_LinkShards);
+
     const auto afs = {AF_INET, AF_INET6};
 
     for(const auto af : afs)
@@ -196,6 +196,10 @@ namespace llarp
     Sign(Signature &sig, const llarp_buffer_t &buf) const override;
 
     uint16_t m_OutboundPort = 0;
+    /// use batched udp io on our links
+    bool m_BatchedUDP = false;
+    /// how many sockets each link spreads its udp io over
+    size_t m_LinkShards = 1;
     /// how often do we resign our RC? milliseconds.
     // TODO: make configurable
     llarp_time_t rcRegenInterval = 60 * 60 * 1000;
@@ -7,10 +7,12 @@
 #include <util/buffer.hpp>
 #include <util/logging/logger.hpp>
 #include <util/mem.hpp>
+#include <util/metrics/sharded.hpp>
 #include <util/printer.hpp>
 #include <util/time.hpp>
 
 #include <fstream>
+#include <new>
 #include <util/fs.hpp>
 
 namespace llarp
@@ -300,6 +302,19 @@ namespace llarp
 
   bool
   RouterContact::Verify(llarp_time_t now, bool allowExpired) const
+  {
+    if(!VerifyFields(now, allowExpired))
+      return false;
+    if(!VerifySignature())
+    {
+      llarp::LogError("invalid signature");
+      return false;
+    }
+    return true;
+  }
+
+  bool
+  RouterContact::VerifyFields(llarp_time_t now, bool allowExpired) const
   {
     if(netID != NetID::DefaultValue())
     {
@@ -332,22 +347,22 @@ namespace llarp
         return false;
       }
     }
-    if(!VerifySignature())
-    {
-      llarp::LogError("invalid signature");
-      return false;
-    }
     return true;
   }
 
+  SignatureCache &
+  RouterContact::VerifyCache()
+  {
+    static SignatureCache cache;
+    return cache;
+  }
+
   bool
-  RouterContact::VerifySignature() const
+  RouterContact::SignedContent(llarp_buffer_t &buf) const
   {
     RouterContact copy;
     copy = *this;
     copy.signature.Zero();
-    std::array< byte_t, MAX_RC_SIZE > tmp;
-    llarp_buffer_t buf(tmp);
     if(!copy.BEncode(&buf))
     {
       llarp::LogError("bencode failed");
@@ -355,7 +370,101 @@ namespace llarp
     }
     buf.sz  = buf.cur - buf.base;
     buf.cur = buf.base;
-    return CryptoManager::instance()->verify(pubkey, buf, signature);
+    return true;
+  }
+
+  /// we see the same RCs over and over from gossip, lookups and the nodedb
+  /// so skip the verify if we already did it for this exact content
+  static bool
+  CachedSignature(const RouterContact &rc, const ShortHash &digest,
+                  llarp_time_t now)
+  {
+    struct Counters
+    {
+      metrics::ShardedCounter hit{"RouterContact", "VerifyCacheHit"};
+      metrics::ShardedCounter miss{"RouterContact", "VerifyCacheMiss"};
+    };
+    // looked up once on the first verify, the metrics manager is made
+    // before any RC is loaded and lives until exit; never destroyed so it
+    // doesn't unregister from a manager that is already gone
+    alignas(Counters) static unsigned char storage[sizeof(Counters)];
+    static Counters &counters = *new(storage) Counters();
+    auto &cache    = RouterContact::VerifyCache();
+    const bool hit = cache.Check(rc.pubkey, rc.signature, digest, now);
+    (hit ? counters.hit : counters.miss).tick();
+    return hit;
+  }
+
+  bool
+  RouterContact::VerifySignature() const
+  {
+    std::array< byte_t, MAX_RC_SIZE > tmp;
+    llarp_buffer_t buf(tmp);
+    if(!SignedContent(buf))
+      return false;
+
+    auto crypto    = CryptoManager::instance();
+    const auto now = time_now_ms();
+    ShortHash digest;
+    const bool cacheable =
+        TimeUntilExpires(now) > 0 && crypto->shorthash(digest, buf);
+    if(cacheable && CachedSignature(*this, digest, now))
+      return true;
+    if(!crypto->verify(pubkey, buf, signature))
+      return false;
+    if(cacheable)
+      VerifyCache().Add(pubkey, signature, digest, last_updated + Lifetime);
+    return true;
+  }
+
+  size_t
+  RouterContact::VerifyBatch(const std::vector< RouterContact > &rcs,
+                             llarp_time_t now, std::vector< char > &valid)
+  {
+    valid.assign(rcs.size(), 0);
+    auto crypto = CryptoManager::instance();
+    std::vector< std::array< byte_t, MAX_RC_SIZE > > contents(rcs.size());
+    std::vector< ShortHash > digests(rcs.size());
+    std::vector< char > cacheable(rcs.size(), 0);
+    std::vector< VerifyJob > jobs;
+    std::vector< size_t > owners;
+    size_t good = 0;
+    for(size_t idx = 0; idx < rcs.size(); ++idx)
+    {
+      const auto &rc = rcs[idx];
+      llarp_buffer_t buf(contents[idx]);
+      if(!rc.VerifyFields(now, true) || !rc.SignedContent(buf))
+        continue;
+      cacheable[idx] =
+          rc.TimeUntilExpires(now) > 0 && crypto->shorthash(digests[idx], buf);
+      if(cacheable[idx] && CachedSignature(rc, digests[idx], now))
+      {
+        valid[idx] = 1;
+        good++;
+        continue;
+      }
+      jobs.push_back({&rc.pubkey, buf.base, buf.sz, &rc.signature, false});
+      owners.push_back(idx);
+    }
+    if(jobs.empty())
+      return good;
+    crypto->verify_batch(jobs.data(), jobs.size());
+    for(size_t job = 0; job < jobs.size(); ++job)
+    {
+      const size_t idx = owners[job];
+      const auto &rc   = rcs[idx];
+      if(!jobs[job].valid)
+      {
+        llarp::LogError("invalid signature on RC for ", RouterID(rc.pubkey));
+        continue;
+      }
+      valid[idx] = 1;
+      good++;
+      if(cacheable[idx])
+        VerifyCache().Add(rc.pubkey, rc.signature, digests[idx],
+                          rc.last_updated + Lifetime);
+    }
+    return good;
   }
 
   bool
@@ -3,6 +3,7 @@
 
 #include <constants/version.hpp>
 #include <crypto/types.hpp>
+#include <crypto/signature_cache.hpp>
 #include <net/address_info.hpp>
 #include <net/exit_info.hpp>
 #include <util/aligned.hpp>
@@ -73,6 +74,10 @@ namespace llarp
     static llarp_time_t UpdateInterval;
     static llarp_time_t StaleInsertionAge;
 
+    /// the signatures VerifySignature already checked
+    static SignatureCache &
+    VerifyCache();
+
     RouterContact()
     {
       Clear();
@@ -172,6 +177,13 @@ namespace llarp
     bool
     Verify(llarp_time_t now, bool allowExpired = true) const;
 
+    /// Verify(now) every rc in rcs with the signatures the cache doesn't
+    /// know handed to one Crypto::verify_batch call, valid[idx] is set for
+    /// the good ones. returns how many are.
+    static size_t
+    VerifyBatch(const std::vector< RouterContact > &rcs, llarp_time_t now,
+                std::vector< char > &valid);
+
     bool
     Sign(const llarp::SecretKey &secret);
 
@@ -208,6 +220,15 @@ namespace llarp
 
     bool
     VerifySignature() const;
+
+   private:
+    /// everything Verify checks but the signature
+    bool
+    VerifyFields(llarp_time_t now, bool allowExpired) const;
+
+    /// put what the signature is over into buf and rewind it
+    bool
+    SignedContent(llarp_buffer_t &buf) const;
   };
 
   inline std::ostream &
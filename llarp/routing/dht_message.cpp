@@ -50,6 +50,7 @@ namespace llarp
     {
       // set source as us
       llarp::dht::Key_t us{r->pubkey()};
+      dht::VerifyIntroSets(M, r->Now());
       for(const auto& msg : M)
       {
         msg->From   = us;
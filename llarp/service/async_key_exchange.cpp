@@ -67,7 +67,7 @@ namespace llarp
       // set sender
       self->msg.sender = self->m_LocalIdentity.pub;
       // set version
-      self->msg.version = LLARP_PROTO_VERSION;
+      self->msg.version = SERVICE_PROTOCOL_VERSION;
       // encrypt and sign
       if(frame->EncryptAndSign(self->msg, K, self->m_LocalIdentity))
         LogicCall(self->logic,
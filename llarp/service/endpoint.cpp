@@ -5,6 +5,7 @@
 #include <dht/messages/gotintro.hpp>
 #include <dht/messages/gotrouter.hpp>
 #include <dht/messages/pubintro.hpp>
+#include <ev/ev.hpp>
 #include <nodedb.hpp>
 #include <profiling.hpp>
 #include <router/abstractrouter.hpp>
@@ -364,6 +365,15 @@ namespace llarp
       return true;
     }
 
+    uint64_t
+    Endpoint::GetProtocolVersionFor(const ConvoTag& tag) const
+    {
+      auto itr = Sessions().find(tag);
+      if(itr == Sessions().end())
+        return 0;
+      return itr->second.version;
+    }
+
     void
     Endpoint::PutIntroFor(const ConvoTag& tag, const Introduction& intro)
     {
@@ -847,6 +857,7 @@ namespace llarp
     {
       msg->sender.UpdateAddr();
       PutSenderFor(msg->tag, msg->sender, true);
+      Sessions()[msg->tag].version = msg->version;
       PutReplyIntroFor(msg->tag, path->intro);
       Introduction intro;
       intro.pathID    = from;
@@ -914,8 +925,13 @@ namespace llarp
         RemoveConvoTag(frame.T);
         return true;
       }
-      if(!frame.AsyncDecryptAndVerify(EndpointLogic(), p, CryptoWorker(),
-                                      m_Identity, m_DataHandler))
+      // frames on known convos wait a moment so their signatures can be
+      // checked together
+      const bool queued = frame.T.IsZero()
+          ? frame.AsyncDecryptAndVerify(EndpointLogic(), p, CryptoWorker(),
+                                        m_Identity, m_DataHandler)
+          : QueueInboundFrame(p, frame);
+      if(!queued)
       {
         // send discard
         ProtocolFrame f;
@@ -937,6 +953,54 @@ namespace llarp
       return true;
     }
 
+    bool
+    Endpoint::QueueInboundFrame(path::Path_ptr p, const ProtocolFrame& frame)
+    {
+      InboundFrame inbound;
+      if(!m_DataHandler->GetCachedSessionKeyFor(frame.T, inbound.sessionKey))
+      {
+        LogError("No cached session for T=", frame.T);
+        return false;
+      }
+      if(!m_DataHandler->GetSenderFor(frame.T, inbound.sender))
+      {
+        LogError("No sender for T=", frame.T);
+        return false;
+      }
+      inbound.path  = std::move(p);
+      inbound.frame = frame;
+      bool first;
+      {
+        util::Lock lock(&m_state->m_InboundFramesMutex);
+        first = m_state->m_InboundFrames.empty();
+        m_state->m_InboundFrames.emplace_back(std::move(inbound));
+      }
+      // the logic runs calls inline, so flush from the next loop iteration
+      // and take everything the paths hand us until then with it
+      if(first)
+      {
+        auto self = this;
+        EndpointNetLoop()->call_soon([self]() { self->FlushInboundFrames(); });
+      }
+      return true;
+    }
+
+    void
+    Endpoint::FlushInboundFrames()
+    {
+      std::vector< InboundFrame > frames;
+      {
+        util::Lock lock(&m_state->m_InboundFramesMutex);
+        frames.swap(m_state->m_InboundFrames);
+      }
+      if(frames.empty())
+        return;
+      const size_t count = frames.size();
+      if(!AsyncDecryptAndVerifyInbound(std::move(frames), m_DataHandler,
+                                       CryptoWorker()))
+        LogError("failed to queue ", count, " inbound frames");
+    }
+
     void Endpoint::HandlePathDied(path::Path_ptr)
     {
       RegenAndPublishIntroSet(true);
@@ -1215,9 +1279,14 @@ namespace llarp
             f.S         = 1;
             f.F         = m->introReply.pathID;
             transfer->P = remoteIntro.pathID;
-            auto self   = this;
-            return CryptoWorker()->addJob([transfer, p, m, K, self]() {
-              if(not transfer->T.EncryptAndSign(*m, K, self->m_Identity))
+            const bool mac =
+                GetProtocolVersionFor(f.T) >= SERVICE_PROTOCOL_VERSION;
+            auto self = this;
+            return CryptoWorker()->addJob([transfer, p, m, K, self, mac]() {
+              const bool ok = mac
+                  ? transfer->T.EncryptAndMAC(*m, K)
+                  : transfer->T.EncryptAndSign(*m, K, self->m_Identity);
+              if(not ok)
               {
                 LogError("failed to encrypt and sign");
                 return;
@@ -321,6 +321,9 @@ namespace llarp
       bool
       GetSenderFor(const ConvoTag& remote, ServiceInfo& si) const override;
 
+      uint64_t
+      GetProtocolVersionFor(const ConvoTag& remote) const override;
+
       void
       PutIntroFor(const ConvoTag& remote, const Introduction& intro) override;
 
@@ -442,6 +445,15 @@ namespace llarp
       void
       FlushRecvData();
 
+      /// look up the session for a frame on a known convo and queue it for
+      /// FlushInboundFrames, false if we don't have the session
+      bool
+      QueueInboundFrame(path::Path_ptr p, const ProtocolFrame& frame);
+
+      /// hand every queued inbound frame to the workers in one job
+      void
+      FlushInboundFrames();
+
       friend struct EndpointUtil;
 
       // clang-format off
@@ -5,6 +5,7 @@
 #include <router_id.hpp>
 #include <service/address.hpp>
 #include <service/pendingbuffer.hpp>
+#include <service/protocol.hpp>
 #include <service/router_lookup_job.hpp>
 #include <service/session.hpp>
 #include <service/tag_lookup_job.hpp>
@@ -16,6 +17,7 @@
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 struct llarp_ev_loop;
 using llarp_ev_loop_ptr = std::shared_ptr< llarp_ev_loop >;
@@ -58,6 +60,11 @@ namespace llarp
       util::Mutex m_SendQueueMutex;  // protects m_SendQueue
       std::deque< SendEvent_t > m_SendQueue GUARDED_BY(m_SendQueueMutex);
 
+      util::Mutex m_InboundFramesMutex;  // protects m_InboundFrames
+      /// frames on known convos that go to the workers together
+      std::vector< InboundFrame > m_InboundFrames
+          GUARDED_BY(m_InboundFramesMutex);
+
       PendingTraffic m_PendingTraffic;
 
       Sessions m_RemoteSessions;
@@ -53,6 +53,10 @@ namespace llarp
       virtual bool
       GetSenderFor(const ConvoTag& remote, ServiceInfo& si) const = 0;
 
+      /// protocol version the remote on this convo speaks, 0 if unknown
+      virtual uint64_t
+      GetProtocolVersionFor(const ConvoTag& remote) const = 0;
+
       virtual void
       PutIntroFor(const ConvoTag& remote, const Introduction& intro) = 0;
 
@@ -44,6 +44,13 @@ namespace llarp
         return enckey;
       }
 
+      /// the key Verify checks signatures against
+      const PubKey&
+      SigningPublicKey() const
+      {
+        return signkey;
+      }
+
       bool
       Update(const byte_t* enc, const byte_t* sign,
              const OptNonce& nonce = OptNonce())
@@ -1,7 +1,10 @@
 #include <service/intro_set.hpp>
 
+#include <crypto/crypto.hpp>
 #include <path/path.hpp>
 
+#include <array>
+
 namespace llarp
 {
   namespace service
@@ -113,11 +116,16 @@ namespace llarp
       return GetNewestIntroExpiration() < now;
     }
 
+    SignatureCache&
+    IntroSet::VerifyCache()
+    {
+      static SignatureCache cache;
+      return cache;
+    }
+
     bool
-    IntroSet::Verify(llarp_time_t now) const
+    IntroSet::SignedContent(llarp_buffer_t& buf) const
     {
-      std::array< byte_t, MAX_INTROSET_SIZE > tmp;
-      llarp_buffer_t buf(tmp);
       IntroSet copy;
       copy = *this;
       copy.Z.Zero();
@@ -128,10 +136,88 @@ namespace llarp
       // rewind and resize buffer
       buf.sz  = buf.cur - buf.base;
       buf.cur = buf.base;
-      if(!A.Verify(buf, Z))
+      return true;
+    }
+
+    bool
+    IntroSet::Verify(llarp_time_t now) const
+    {
+      std::array< byte_t, MAX_INTROSET_SIZE > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!SignedContent(buf))
       {
         return false;
       }
+      auto crypto = CryptoManager::instance();
+      ShortHash digest;
+      const bool hashed = crypto->shorthash(digest, buf);
+      if(!hashed
+         || !VerifyCache().Check(A.SigningPublicKey(), Z, digest, now))
+      {
+        if(!A.Verify(buf, Z))
+        {
+          return false;
+        }
+        if(hashed)
+          VerifyCache().Add(A.SigningPublicKey(), Z, digest,
+                            GetNewestIntroExpiration());
+      }
+      return VerifyFields(now);
+    }
+
+    size_t
+    IntroSet::VerifyBatch(const std::vector< const IntroSet* >& sets,
+                          llarp_time_t now, std::vector< char >& valid)
+    {
+      valid.assign(sets.size(), 0);
+      auto crypto = CryptoManager::instance();
+      std::vector< std::array< byte_t, MAX_INTROSET_SIZE > > contents(
+          sets.size());
+      std::vector< ShortHash > digests(sets.size());
+      std::vector< char > hashed(sets.size(), 0);
+      std::vector< VerifyJob > jobs;
+      std::vector< size_t > owners;
+      size_t good = 0;
+      for(size_t idx = 0; idx < sets.size(); ++idx)
+      {
+        const auto& set = *sets[idx];
+        llarp_buffer_t buf(contents[idx]);
+        if(!set.SignedContent(buf) || !set.VerifyFields(now))
+          continue;
+        hashed[idx] = crypto->shorthash(digests[idx], buf);
+        if(hashed[idx]
+           && VerifyCache().Check(set.A.SigningPublicKey(), set.Z,
+                                  digests[idx], now))
+        {
+          valid[idx] = 1;
+          good++;
+          continue;
+        }
+        jobs.push_back(
+            {&set.A.SigningPublicKey(), buf.base, buf.sz, &set.Z, false});
+        owners.push_back(idx);
+      }
+      if(jobs.empty())
+        return good;
+      crypto->verify_batch(jobs.data(), jobs.size());
+      for(size_t job = 0; job < jobs.size(); ++job)
+      {
+        if(!jobs[job].valid)
+          continue;
+        const size_t idx = owners[job];
+        const auto& set  = *sets[idx];
+        valid[idx]       = 1;
+        good++;
+        if(hashed[idx])
+          VerifyCache().Add(set.A.SigningPublicKey(), set.Z, digests[idx],
+                            set.GetNewestIntroExpiration());
+      }
+      return good;
+    }
+
+    bool
+    IntroSet::VerifyFields(llarp_time_t now) const
+    {
       // validate PoW
       if(W && !W->IsValid(now))
       {
@@ -1,6 +1,7 @@
 #ifndef LLARP_SERVICE_INTRO_SET_HPP
 #define LLARP_SERVICE_INTRO_SET_HPP
 
+#include <crypto/signature_cache.hpp>
 #include <crypto/types.hpp>
 #include <pow.hpp>
 #include <service/info.hpp>
@@ -70,8 +71,29 @@ namespace llarp
       bool
       Verify(llarp_time_t now) const;
 
+      /// Verify(now) every introset in sets with the signatures the cache
+      /// doesn't know handed to one Crypto::verify_batch call, valid[idx] is
+      /// set for the good ones. returns how many are.
+      static size_t
+      VerifyBatch(const std::vector< const IntroSet* >& sets,
+                  llarp_time_t now, std::vector< char >& valid);
+
+      /// signatures we checked already, floods and lookups see the same
+      /// introsets from many peers
+      static SignatureCache&
+      VerifyCache();
+
       util::StatusObject
       ExtractStatus() const;
+
+     private:
+      /// everything Verify checks but the signature
+      bool
+      VerifyFields(llarp_time_t now) const;
+
+      /// put what the signature is over into buf and rewind it
+      bool
+      SignedContent(llarp_buffer_t& buf) const;
     };
 
     inline bool
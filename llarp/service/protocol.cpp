@@ -6,6 +6,9 @@
 #include <util/meta/memfn.hpp>
 #include <util/thread/logic.hpp>
 
+#include <sodium/utils.h>
+
+#include <algorithm>
 #include <utility>
 
 namespace llarp
@@ -114,6 +117,11 @@ namespace llarp
       }
       if(!BEncodeWriteDictEntry("F", F, buf))
         return false;
+      if(!M.IsZero())
+      {
+        if(!BEncodeWriteDictEntry("M", M, buf))
+          return false;
+      }
       if(!N.IsZero())
       {
         if(!BEncodeWriteDictEntry("N", N, buf))
@@ -155,6 +163,8 @@ namespace llarp
         return false;
       if(!BEncodeMaybeReadDictEntry("C", C, read, key, val))
         return false;
+      if(!BEncodeMaybeReadDictEntry("M", M, read, key, val))
+        return false;
       if(!BEncodeMaybeReadDictEntry("N", N, read, key, val))
         return false;
       if(!BEncodeMaybeReadDictInt("S", S, read, key, val))
@@ -200,13 +210,13 @@ namespace llarp
       return localIdent.Sign(Z, buf);
     }
 
-    bool
-    ProtocolFrame::EncryptAndSign(const ProtocolMessage& msg,
-                                  const SharedSecret& sessionKey,
-                                  const Identity& localIdent)
+    /// encrypt msg into frame.D and encode the frame with Z and M zeroed
+    /// into buf, ready to be signed or MACed
+    static bool
+    EncryptAndEncode(ProtocolFrame& frame, const ProtocolMessage& msg,
+                     const SharedSecret& sessionKey, llarp_buffer_t& buf)
     {
-      std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
-      llarp_buffer_t buf(tmp);
+      const size_t capacity = buf.sz;
       // encode message
       if(!msg.BEncode(&buf))
       {
@@ -217,24 +227,38 @@ namespace llarp
       buf.sz  = buf.cur - buf.base;
       buf.cur = buf.base;
       // encrypt
-      CryptoManager::instance()->xchacha20(buf, sessionKey, N);
+      CryptoManager::instance()->xchacha20(buf, sessionKey, frame.N);
       // put encrypted buffer
-      D = buf;
-      // zero out signature
-      Z.Zero();
-      llarp_buffer_t buf2(tmp);
-      // encode frame
-      if(!BEncode(&buf2))
+      frame.D = buf;
+      // zero out signature and mac
+      frame.Z.Zero();
+      frame.M.Zero();
+      // encode frame over the same space
+      buf.cur = buf.base;
+      buf.sz  = capacity;
+      if(!frame.BEncode(&buf))
       {
         LogError("frame too big to encode");
-        DumpBuffer(buf2);
+        DumpBuffer(buf);
         return false;
       }
       // rewind
-      buf2.sz  = buf2.cur - buf2.base;
-      buf2.cur = buf2.base;
+      buf.sz  = buf.cur - buf.base;
+      buf.cur = buf.base;
+      return true;
+    }
+
+    bool
+    ProtocolFrame::EncryptAndSign(const ProtocolMessage& msg,
+                                  const SharedSecret& sessionKey,
+                                  const Identity& localIdent)
+    {
+      std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!EncryptAndEncode(*this, msg, sessionKey, buf))
+        return false;
       // sign
-      if(!localIdent.Sign(Z, buf2))
+      if(!localIdent.Sign(Z, buf))
       {
         LogError("failed to sign? wtf?!");
         return false;
@@ -242,6 +266,36 @@ namespace llarp
       return true;
     }
 
+    /// the MAC gets a key of its own so the xchacha20 key is never also
+    /// used to key blake2b
+    static bool
+    DeriveMACKey(SharedSecret& macKey, const SharedSecret& sessionKey)
+    {
+      static constexpr char label[] = "lokinet-frame-mac";
+      const llarp_buffer_t buf(label, sizeof(label) - 1);
+      return CryptoManager::instance()->hmac(macKey.data(), buf, sessionKey);
+    }
+
+    bool
+    ProtocolFrame::EncryptAndMAC(const ProtocolMessage& msg,
+                                 const SharedSecret& sessionKey)
+    {
+      std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!EncryptAndEncode(*this, msg, sessionKey, buf))
+        return false;
+      // a keyed hash is a lot cheaper than an ed25519 signature and only
+      // we and the remote know the session key
+      SharedSecret macKey;
+      if(!DeriveMACKey(macKey, sessionKey)
+         || !CryptoManager::instance()->hmac(M.data(), buf, macKey))
+      {
+        LogError("failed to mac frame");
+        return false;
+      }
+      return true;
+    }
+
     struct AsyncFrameDecrypt
     {
       path::Path_ptr path;
@@ -358,29 +412,23 @@ namespace llarp
       N       = other.N;
       Z       = other.Z;
       T       = other.T;
+      M       = other.M;
       R       = other.R;
       S       = other.S;
       version = other.version;
       return *this;
     }
 
-    struct AsyncDecrypt
-    {
-      ServiceInfo si;
-      SharedSecret shared;
-      ProtocolFrame frame;
-    };
-
     bool
     ProtocolFrame::AsyncDecryptAndVerify(
         std::shared_ptr< Logic > logic, path::Path_ptr recvPath,
         const std::shared_ptr< llarp::thread::ThreadPool >& worker,
         const Identity& localIdent, IDataHandler* handler) const
     {
-      auto msg     = std::make_shared< ProtocolMessage >();
-      msg->handler = handler;
       if(T.IsZero())
       {
+        auto msg     = std::make_shared< ProtocolMessage >();
+        msg->handler = handler;
         LogInfo("Got protocol frame with new convo");
         // we need to dh
         auto dh  = new AsyncFrameDecrypt(logic, localIdent, handler, msg, *this,
@@ -389,60 +437,169 @@ namespace llarp
         return worker->addJob(std::bind(&AsyncFrameDecrypt::Work, dh));
       }
 
-      auto v = new AsyncDecrypt();
-
-      if(!handler->GetCachedSessionKeyFor(T, v->shared))
+      InboundFrame inbound;
+      if(!handler->GetCachedSessionKeyFor(T, inbound.sessionKey))
       {
         LogError("No cached session for T=", T);
-        delete v;
         return false;
       }
 
-      if(!handler->GetSenderFor(T, v->si))
+      if(!handler->GetSenderFor(T, inbound.sender))
       {
         LogError("No sender for T=", T);
-        delete v;
         return false;
       }
-      v->frame = *this;
-      return worker->addJob(
-          [v, msg = std::move(msg), recvPath = std::move(recvPath)]() {
-            if(not v->frame.Verify(v->si))
-            {
-              LogError("Signature failure from ", v->si.Addr());
-              delete v;
-              return;
-            }
-            if(not v->frame.DecryptPayloadInto(v->shared, *msg))
-            {
-              LogError("failed to decrypt message");
-              delete v;
-              return;
-            }
-            RecvDataEvent ev;
-            ev.fromPath = std::move(recvPath);
-            ev.pathid   = v->frame.F;
-            ev.msg      = std::move(msg);
-            msg->handler->QueueRecvData(std::move(ev));
-            delete v;
-          });
+      inbound.path  = std::move(recvPath);
+      inbound.frame = *this;
+      std::vector< InboundFrame > frames;
+      frames.emplace_back(std::move(inbound));
+      return AsyncDecryptAndVerifyInbound(std::move(frames), handler, worker);
+    }
+
+    bool
+    AsyncDecryptAndVerifyInbound(
+        std::vector< InboundFrame > frames, IDataHandler* handler,
+        const std::shared_ptr< llarp::thread::ThreadPool >& worker)
+    {
+      auto batch = std::make_shared< std::vector< InboundFrame > >(
+          std::move(frames));
+      return worker->addJob([batch, handler]() {
+        std::vector< char > verified(batch->size(), 0);
+        // macs are cheap on their own, the signed ones go in one batch
+        std::vector< const ProtocolFrame* > signedFrames;
+        std::vector< const ServiceInfo* > signers;
+        std::vector< size_t > owners;
+        for(size_t idx = 0; idx < batch->size(); ++idx)
+        {
+          const auto& item = (*batch)[idx];
+          if(item.frame.M.IsZero())
+          {
+            signedFrames.emplace_back(&item.frame);
+            signers.emplace_back(&item.sender);
+            owners.emplace_back(idx);
+          }
+          else
+            verified[idx] = item.frame.VerifyMAC(item.sessionKey);
+        }
+        if(not signedFrames.empty())
+        {
+          std::vector< char > valid;
+          ProtocolFrame::VerifyBatch(signedFrames, signers, valid);
+          for(size_t job = 0; job < owners.size(); ++job)
+            verified[owners[job]] = valid[job];
+        }
+        for(size_t idx = 0; idx < batch->size(); ++idx)
+        {
+          auto& item     = (*batch)[idx];
+          const bool mac = not item.frame.M.IsZero();
+          if(not verified[idx])
+          {
+            LogError(mac ? "MAC" : "Signature", " failure from ",
+                     item.sender.Addr());
+            continue;
+          }
+          auto msg     = std::make_shared< ProtocolMessage >();
+          msg->handler = handler;
+          if(not item.frame.DecryptPayloadInto(item.sessionKey, *msg))
+          {
+            LogError("failed to decrypt message");
+            continue;
+          }
+          // both ends hold the session key, so make sure this isn't one of
+          // our own frames sent back at us
+          if(mac and msg->sender != item.sender)
+          {
+            LogError("MAC frame on T=", item.frame.T, " has wrong sender");
+            continue;
+          }
+          RecvDataEvent ev;
+          ev.fromPath = std::move(item.path);
+          ev.pathid   = item.frame.F;
+          ev.msg      = std::move(msg);
+          handler->QueueRecvData(std::move(ev));
+        }
+      });
     }
 
     bool
     ProtocolFrame::operator==(const ProtocolFrame& other) const
     {
       return C == other.C && D == other.D && N == other.N && Z == other.Z
-          && T == other.T && S == other.S && version == other.version;
+          && T == other.T && M == other.M && S == other.S
+          && version == other.version;
+    }
+
+    /// put what a frame's signature is over into buf and rewind it
+    static bool
+    SignedContent(const ProtocolFrame& frame, llarp_buffer_t& buf)
+    {
+      ProtocolFrame copy(frame);
+      // zero out signature for verify
+      copy.Z.Zero();
+      // serialize
+      if(!copy.BEncode(&buf))
+      {
+        LogError("bencode fail");
+        return false;
+      }
+      // rewind buffer
+      buf.sz  = buf.cur - buf.base;
+      buf.cur = buf.base;
+      return true;
     }
 
     bool
     ProtocolFrame::Verify(const ServiceInfo& svc) const
+    {
+      std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!SignedContent(*this, buf))
+        return false;
+      // verify
+      return svc.Verify(buf, Z);
+    }
+
+    size_t
+    ProtocolFrame::VerifyBatch(
+        const std::vector< const ProtocolFrame* >& frames,
+        const std::vector< const ServiceInfo* >& signers,
+        std::vector< char >& valid)
+    {
+      valid.assign(frames.size(), 0);
+      std::vector< std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > > contents(
+          frames.size());
+      std::vector< VerifyJob > jobs;
+      std::vector< size_t > owners;
+      for(size_t idx = 0; idx < frames.size(); ++idx)
+      {
+        llarp_buffer_t buf(contents[idx]);
+        if(!SignedContent(*frames[idx], buf))
+          continue;
+        jobs.push_back({&signers[idx]->SigningPublicKey(), buf.base, buf.sz,
+                        &frames[idx]->Z, false});
+        owners.push_back(idx);
+      }
+      if(jobs.empty())
+        return 0;
+      CryptoManager::instance()->verify_batch(jobs.data(), jobs.size());
+      size_t good = 0;
+      for(size_t job = 0; job < jobs.size(); ++job)
+      {
+        if(!jobs[job].valid)
+          continue;
+        valid[owners[job]] = 1;
+        good++;
+      }
+      return good;
+    }
+
+    bool
+    ProtocolFrame::VerifyMAC(const SharedSecret& sessionKey) const
     {
       ProtocolFrame copy(*this);
-      // save signature
-      // zero out signature for verify
+      // mac is over the frame with no signature or mac
       copy.Z.Zero();
-      // serialize
+      copy.M.Zero();
       std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
       llarp_buffer_t buf(tmp);
       if(!copy.BEncode(&buf))
@@ -450,12 +607,16 @@ namespace llarp
         LogError("bencode fail");
         return false;
       }
-
       // rewind buffer
       buf.sz  = buf.cur - buf.base;
       buf.cur = buf.base;
-      // verify
-      return svc.Verify(buf, Z);
+      SharedSecret macKey;
+      ShortHash digest;
+      if(!DeriveMACKey(macKey, sessionKey)
+         || !CryptoManager::instance()->hmac(digest.data(), buf, macKey))
+        return false;
+      // constant time, an early mismatch must not tell how much was right
+      return sodium_memcmp(digest.data(), M.data(), digest.size()) == 0;
     }
 
     bool
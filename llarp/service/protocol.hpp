@@ -37,6 +37,14 @@ namespace llarp
     constexpr ProtocolType eProtocolTrafficV4 = 1UL;
     constexpr ProtocolType eProtocolTrafficV6 = 2UL;
 
+    /// version of the messages inside protocol frames, sent as "v" in every
+    /// ProtocolMessage. the frame itself stays at LLARP_PROTO_VERSION so older
+    /// endpoints can still decode it.
+    ///
+    /// 1: frames on an established convo may carry a MAC (M) under the session
+    /// key instead of an ed25519 signature (Z)
+    constexpr uint64_t SERVICE_PROTOCOL_VERSION = 1;
+
     /// inner message
     struct ProtocolMessage
     {
@@ -51,7 +59,7 @@ namespace llarp
       IDataHandler* handler = nullptr;
       ConvoTag tag;
       uint64_t seqno   = 0;
-      uint64_t version = LLARP_PROTO_VERSION;
+      uint64_t version = SERVICE_PROTOCOL_VERSION;
 
       bool
       DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val);
@@ -84,6 +92,8 @@ namespace llarp
       Signature Z;
       PathID_t F;
       service::ConvoTag T;
+      /// mac under the session key for T, set instead of Z
+      ShortHash M;
 
       ProtocolFrame(const ProtocolFrame& other)
           : routing::IMessage()
@@ -94,6 +104,7 @@ namespace llarp
           , Z(other.Z)
           , F(other.F)
           , T(other.T)
+          , M(other.M)
       {
         S       = other.S;
         version = other.version;
@@ -122,6 +133,11 @@ namespace llarp
       EncryptAndSign(const ProtocolMessage& msg, const SharedSecret& sharedkey,
                      const Identity& localIdent);
 
+      /// like EncryptAndSign but authenticates with a MAC under the session
+      /// key, only for a convo whose remote speaks SERVICE_PROTOCOL_VERSION
+      bool
+      EncryptAndMAC(const ProtocolMessage& msg, const SharedSecret& sharedkey);
+
       bool
       Sign(const Identity& localIdent);
 
@@ -156,6 +172,7 @@ namespace llarp
         T.Zero();
         N.Zero();
         Z.Zero();
+        M.Zero();
         R       = 0;
         version = LLARP_PROTO_VERSION;
       }
@@ -163,10 +180,39 @@ namespace llarp
       bool
       Verify(const ServiceInfo& from) const;
 
+      /// Verify(*signers[idx]) every frame in frames with the signatures
+      /// handed to one Crypto::verify_batch call, valid[idx] is set for the
+      /// good ones. returns how many are.
+      static size_t
+      VerifyBatch(const std::vector< const ProtocolFrame* >& frames,
+                  const std::vector< const ServiceInfo* >& signers,
+                  std::vector< char >& valid);
+
+      bool
+      VerifyMAC(const SharedSecret& sharedkey) const;
+
       bool
       HandleMessage(routing::IMessageHandler* h,
                     AbstractRouter* r) const override;
     };
+
+    /// a frame on a convo we have the session for, waiting to be verified
+    /// and decrypted
+    struct InboundFrame
+    {
+      path::Path_ptr path;
+      ProtocolFrame frame;
+      ServiceInfo sender;
+      SharedSecret sessionKey;
+    };
+
+    /// verify and decrypt frames on known convos in one worker job, the
+    /// signed ones go through ProtocolFrame::VerifyBatch together. the good
+    /// ones are handed to handler->QueueRecvData
+    bool
+    AsyncDecryptAndVerifyInbound(
+        std::vector< InboundFrame > frames, IDataHandler* handler,
+        const std::shared_ptr< llarp::thread::ThreadPool >& worker);
   }  // namespace service
 }  // namespace llarp
 
@@ -102,9 +102,15 @@ namespace llarp
       m->sender     = m_Endpoint->GetIdentity().pub;
       m->tag        = f->T;
       m->PutBuffer(payload);
+      // no need to sign every frame once the remote can check a mac instead
+      const bool mac = m_DataHandler->GetProtocolVersionFor(f->T)
+          >= SERVICE_PROTOCOL_VERSION;
       auto self = this;
-      m_Endpoint->CryptoWorker()->addJob([f, m, shared, path, self]() {
-        if(not f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity()))
+      m_Endpoint->CryptoWorker()->addJob([f, m, shared, path, self, mac]() {
+        const bool ok = mac
+            ? f->EncryptAndMAC(*m, shared)
+            : f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity());
+        if(not ok)
         {
           LogError(self->m_Endpoint->Name(), " failed to sign message");
           return;
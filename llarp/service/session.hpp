@@ -24,6 +24,8 @@ namespace llarp
       Introduction lastInboundIntro;
       llarp_time_t lastUsed = 0;
       uint64_t seqno        = 0;
+      /// the SERVICE_PROTOCOL_VERSION the remote last sent
+      uint64_t version      = 0;
       bool inbound          = false;
 
       util::StatusObject
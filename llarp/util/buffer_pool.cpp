@@ -0,0 +1,264 @@
+#include <util/buffer_pool.hpp>
+
+#include <constants/link_layer.hpp>
+#include <util/bencode.h>
+#include <util/buffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace llarp
+{
+  static std::atomic< uint64_t > g_Allocations{0};
+  static std::atomic< uint64_t > g_Forwarded{0};
+
+  /// room for a udp datagram on any link we run
+  static constexpr size_t MTUBlockSize = 1500;
+
+  static constexpr size_t
+  BlockStride(size_t sz)
+  {
+    return sizeof(BufferPool::Block)
+        + ((sz + alignof(BufferPool::Block) - 1)
+           & ~(alignof(BufferPool::Block) - 1));
+  }
+
+  BufferPool::BufferPool(size_t blockSize, size_t slabBlocks)
+      : m_BlockSize(blockSize), m_SlabBlocks(slabBlocks)
+  {
+  }
+
+  BufferPool::~BufferPool() = default;
+
+  BufferPool::Block*
+  BufferPool::Acquire()
+  {
+    Block* block = nullptr;
+    {
+      util::Lock lock(&m_Mutex);
+      if(m_Free.empty())
+      {
+        const size_t stride = BlockStride(m_BlockSize);
+        m_Slabs.emplace_back(new byte_t[stride * m_SlabBlocks]);
+        g_Allocations++;
+        byte_t* slab = m_Slabs.back().get();
+        m_Free.reserve(m_Free.size() + m_SlabBlocks);
+        for(size_t idx = 0; idx < m_SlabBlocks; ++idx)
+        {
+          auto* b     = new(slab + (idx * stride)) Block;
+          b->pool     = this;
+          b->capacity = m_BlockSize;
+          m_Free.push_back(b);
+        }
+      }
+      block = m_Free.back();
+      m_Free.pop_back();
+      m_InUse++;
+    }
+    block->refs.store(1);
+    return block;
+  }
+
+  void
+  BufferPool::Release(Block* block)
+  {
+    util::Lock lock(&m_Mutex);
+    m_Free.push_back(block);
+    m_InUse--;
+  }
+
+  util::StatusObject
+  BufferPool::ExtractStatus() const
+  {
+    util::Lock lock(&m_Mutex);
+    return util::StatusObject{{"blockSize", uint64_t{m_BlockSize}},
+                              {"slabs", uint64_t{m_Slabs.size()}},
+                              {"inUse", uint64_t{m_InUse}},
+                              {"free", uint64_t{m_Free.size()}}};
+  }
+
+  BufferPool&
+  BufferPool::MTU()
+  {
+    // intentionally leaked so buffers outliving static destruction stay valid
+    static BufferPool* pool = new BufferPool(MTUBlockSize, 256);
+    return *pool;
+  }
+
+  BufferPool&
+  BufferPool::LinkMessage()
+  {
+    static BufferPool* pool = new BufferPool(MAX_LINK_MSG_SIZE, 32);
+    return *pool;
+  }
+
+  BufferPool::Block*
+  BufferPool::AcquireFor(size_t sz)
+  {
+    if(sz <= MTUBlockSize)
+      return MTU().Acquire();
+    if(sz <= MAX_LINK_MSG_SIZE)
+      return LinkMessage().Acquire();
+    g_Allocations++;
+    auto* block     = new(new byte_t[BlockStride(sz)]) Block;
+    block->pool     = nullptr;
+    block->capacity = sz;
+    block->refs.store(1);
+    return block;
+  }
+
+  void
+  BufferPool::Unref(Block* block)
+  {
+    if(block->refs.fetch_sub(1) != 1)
+      return;
+    if(block->pool)
+      block->pool->Release(block);
+    else
+    {
+      block->~Block();
+      delete[] reinterpret_cast< byte_t* >(block);
+    }
+  }
+
+  uint64_t
+  BufferPool::Allocations()
+  {
+    return g_Allocations.load();
+  }
+
+  void
+  BufferPool::Forwarded(uint64_t n)
+  {
+    g_Forwarded += n;
+  }
+
+  util::StatusObject
+  BufferPool::ExtractAllStatus()
+  {
+    const uint64_t allocs    = g_Allocations.load();
+    const uint64_t forwarded = g_Forwarded.load();
+    return util::StatusObject{
+        {"mtu", MTU().ExtractStatus()},
+        {"linkMessage", LinkMessage().ExtractStatus()},
+        {"allocations", allocs},
+        {"forwarded", forwarded},
+        {"allocsPerForward",
+         forwarded ? double(allocs) / double(forwarded) : 0.0}};
+  }
+
+  PooledBuffer::PooledBuffer(size_t sz)
+      : m_Block(BufferPool::AcquireFor(sz)), m_Size(sz)
+  {
+  }
+
+  PooledBuffer::PooledBuffer(const byte_t* ptr, size_t sz) : PooledBuffer(sz)
+  {
+    std::copy_n(ptr, sz, data());
+  }
+
+  PooledBuffer::PooledBuffer(const llarp_buffer_t& buf)
+      : PooledBuffer(buf.base, buf.sz)
+  {
+  }
+
+  PooledBuffer::PooledBuffer(const PooledBuffer& other)
+      : m_Block(other.m_Block), m_Size(other.m_Size)
+  {
+    if(m_Block)
+      m_Block->refs++;
+  }
+
+  PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+      : m_Block(other.m_Block), m_Size(other.m_Size)
+  {
+    other.m_Block = nullptr;
+    other.m_Size  = 0;
+  }
+
+  PooledBuffer::~PooledBuffer()
+  {
+    Clear();
+  }
+
+  PooledBuffer&
+  PooledBuffer::operator=(const PooledBuffer& other)
+  {
+    if(other.m_Block)
+      other.m_Block->refs++;
+    Clear();
+    m_Block = other.m_Block;
+    m_Size  = other.m_Size;
+    return *this;
+  }
+
+  PooledBuffer&
+  PooledBuffer::operator=(PooledBuffer&& other) noexcept
+  {
+    if(this != &other)
+    {
+      Clear();
+      m_Block       = other.m_Block;
+      m_Size        = other.m_Size;
+      other.m_Block = nullptr;
+      other.m_Size  = 0;
+    }
+    return *this;
+  }
+
+  PooledBuffer&
+  PooledBuffer::operator=(const llarp_buffer_t& buf)
+  {
+    if(m_Block && m_Block->refs.load() == 1 && m_Block->capacity >= buf.sz)
+    {
+      std::memmove(data(), buf.base, buf.sz);
+      m_Size = buf.sz;
+    }
+    else
+    {
+      // writing into a shared block would change it under the other holders
+      *this = PooledBuffer(buf);
+    }
+    return *this;
+  }
+
+  void
+  PooledBuffer::resize(size_t sz)
+  {
+    if(sz > capacity())
+    {
+      PooledBuffer bigger(sz);
+      std::copy_n(data(), m_Size, bigger.data());
+      *this = std::move(bigger);
+    }
+    m_Size = sz;
+  }
+
+  void
+  PooledBuffer::Clear()
+  {
+    if(m_Block)
+      BufferPool::Unref(m_Block);
+    m_Block = nullptr;
+    m_Size  = 0;
+  }
+
+  bool
+  PooledBuffer::BEncode(llarp_buffer_t* buf) const
+  {
+    return bencode_write_bytestring(buf, data(), m_Size);
+  }
+
+  bool
+  PooledBuffer::BDecode(llarp_buffer_t* buf)
+  {
+    llarp_buffer_t strbuf;
+    if(!bencode_read_string(buf, &strbuf))
+      return false;
+    if(strbuf.sz > MAX_LINK_MSG_SIZE)
+      return false;
+    *this = strbuf;
+    return true;
+  }
+}  // namespace llarp
@@ -0,0 +1,219 @@
+#ifndef LLARP_UTIL_BUFFER_POOL_HPP
+#define LLARP_UTIL_BUFFER_POOL_HPP
+
+#include <util/status.hpp>
+#include <util/thread/threading.hpp>
+#include <util/types.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct llarp_buffer_t;
+
+namespace llarp
+{
+  /// fixed size block allocator, carves blocks out of slabs and keeps
+  /// released blocks on a free list so steady state traffic never touches the
+  /// heap
+  struct BufferPool
+  {
+    /// header in front of every block handed out
+    struct alignas(16) Block
+    {
+      std::atomic< uint32_t > refs;
+      /// owning pool, nullptr for oversized blocks taken from the heap
+      BufferPool* pool;
+      size_t capacity;
+
+      byte_t*
+      data()
+      {
+        return reinterpret_cast< byte_t* >(this + 1);
+      }
+    };
+
+    BufferPool(size_t blockSize, size_t slabBlocks);
+
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+
+    BufferPool&
+    operator=(const BufferPool&) = delete;
+
+    /// get a block with a single reference
+    Block*
+    Acquire() LOCKS_EXCLUDED(m_Mutex);
+
+    /// put a block with no references back on the free list
+    void
+    Release(Block* block) LOCKS_EXCLUDED(m_Mutex);
+
+    size_t
+    BlockSize() const
+    {
+      return m_BlockSize;
+    }
+
+    util::StatusObject
+    ExtractStatus() const LOCKS_EXCLUDED(m_Mutex);
+
+    /// pool for single datagrams
+    static BufferPool&
+    MTU();
+
+    /// pool for whole link layer messages
+    static BufferPool&
+    LinkMessage();
+
+    /// get a block holding at least sz bytes from the smallest pool that fits,
+    /// falls back to the heap for anything bigger
+    static Block*
+    AcquireFor(size_t sz);
+
+    /// drop one reference to block, recycling it when it was the last one
+    static void
+    Unref(Block* block);
+
+    /// number of times any pool went to the heap
+    static uint64_t
+    Allocations();
+
+    /// count n packets relayed through us
+    static void
+    Forwarded(uint64_t n);
+
+    static util::StatusObject
+    ExtractAllStatus();
+
+   private:
+    const size_t m_BlockSize;
+    const size_t m_SlabBlocks;
+    mutable util::Mutex m_Mutex;
+    std::vector< Block* > m_Free GUARDED_BY(m_Mutex);
+    std::vector< std::unique_ptr< byte_t[] > > m_Slabs GUARDED_BY(m_Mutex);
+    size_t m_InUse GUARDED_BY(m_Mutex) = 0;
+  };
+
+  /// handle to a refcounted pooled buffer, copies share the same block so a
+  /// packet can be handed along without copying its bytes
+  struct PooledBuffer
+  {
+    PooledBuffer() = default;
+
+    /// acquire a buffer of sz bytes, contents are not initialized
+    explicit PooledBuffer(size_t sz);
+
+    PooledBuffer(const byte_t* ptr, size_t sz);
+
+    explicit PooledBuffer(const llarp_buffer_t& buf);
+
+    PooledBuffer(const PooledBuffer& other);
+
+    PooledBuffer(PooledBuffer&& other) noexcept;
+
+    ~PooledBuffer();
+
+    PooledBuffer&
+    operator=(const PooledBuffer& other);
+
+    PooledBuffer&
+    operator=(PooledBuffer&& other) noexcept;
+
+    /// copy the contents of buf into a buffer we own exclusively
+    PooledBuffer&
+    operator=(const llarp_buffer_t& buf);
+
+    byte_t*
+    data()
+    {
+      return m_Block ? m_Block->data() : nullptr;
+    }
+
+    const byte_t*
+    data() const
+    {
+      return m_Block ? m_Block->data() : nullptr;
+    }
+
+    size_t
+    size() const
+    {
+      return m_Size;
+    }
+
+    size_t
+    capacity() const
+    {
+      return m_Block ? m_Block->capacity : 0;
+    }
+
+    bool
+    empty() const
+    {
+      return m_Size == 0;
+    }
+
+    /// true if no other buffer shares our block, so writing to it is safe
+    bool
+    unique() const
+    {
+      return m_Block == nullptr || m_Block->refs.load() == 1;
+    }
+
+    byte_t*
+    begin()
+    {
+      return data();
+    }
+
+    byte_t*
+    end()
+    {
+      return data() + m_Size;
+    }
+
+    const byte_t*
+    begin() const
+    {
+      return data();
+    }
+
+    const byte_t*
+    end() const
+    {
+      return data() + m_Size;
+    }
+
+    byte_t& operator[](size_t idx)
+    {
+      return data()[idx];
+    }
+
+    const byte_t& operator[](size_t idx) const
+    {
+      return data()[idx];
+    }
+
+    /// set our size, moves the contents to a bigger block when needed
+    void
+    resize(size_t sz);
+
+    /// drop our reference to the underlying block
+    void
+    Clear();
+
+    bool
+    BEncode(llarp_buffer_t* buf) const;
+
+    bool
+    BDecode(llarp_buffer_t* buf);
+
+   private:
+    BufferPool::Block* m_Block = nullptr;
+    size_t m_Size              = 0;
+  };
+}  // namespace llarp
+
+#endif
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 namespace llarp
@@ -40,10 +41,21 @@ namespace llarp
       {
       }
 
+      ~CoDelQueue()
+      {
+        for(size_t idx = 0; idx < m_QueueIdx; ++idx)
+          Slot(idx)->~T();
+      }
+
+      CoDelQueue(const CoDelQueue&) = delete;
+
+      CoDelQueue&
+      operator=(const CoDelQueue&) = delete;
+
       size_t
       Size() LOCKS_EXCLUDED(m_QueueMutex)
       {
-        Lock_t lock(m_QueueMutex);
+        Lock_t lock(&m_QueueMutex);
         return m_QueueIdx;
       }
 
@@ -55,17 +67,16 @@ namespace llarp
         Lock_t lock(&m_QueueMutex);
         if(m_QueueIdx == MaxSize)
           return false;
-        T* t = &m_Queue[m_QueueIdx];
-        new(t) T(std::forward< Args >(args)...);
+        T* t = new(Slot(m_QueueIdx)) T(std::forward< Args >(args)...);
         if(!pred(*t))
         {
           t->~T();
           return false;
         }
 
-        _putTime(m_Queue[m_QueueIdx]);
+        _putTime(*t);
         if(firstPut == 0)
-          firstPut = _getTime(m_Queue[m_QueueIdx]);
+          firstPut = _getTime(*t);
         ++m_QueueIdx;
 
         return true;
@@ -78,11 +89,10 @@ namespace llarp
         Lock_t lock(&m_QueueMutex);
         if(m_QueueIdx == MaxSize)
           return;
-        T* t = &m_Queue[m_QueueIdx];
-        new(t) T(std::forward< Args >(args)...);
-        _putTime(m_Queue[m_QueueIdx]);
+        T* t = new(Slot(m_QueueIdx)) T(std::forward< Args >(args)...);
+        _putTime(*t);
         if(firstPut == 0)
-          firstPut = _getTime(m_Queue[m_QueueIdx]);
+          firstPut = _getTime(*t);
         ++m_QueueIdx;
       }
 
@@ -106,8 +116,8 @@ namespace llarp
 
         if(m_QueueIdx == 1)
         {
-          visitor(m_Queue[0]);
-          T* t = &m_Queue[0];
+          T* t = Slot(0);
+          visitor(*t);
           t->~T();
           m_QueueIdx = 0;
           firstPut   = 0;
@@ -117,9 +127,19 @@ namespace llarp
         while(m_QueueIdx)
         {
           llarp::LogDebug(m_name, " - queue has ", m_QueueIdx);
-          T* item = &m_Queue[idx++];
+          T* item = Slot(idx);
           if(f(*item))
+          {
+            // keep what the filter held back at the front
+            for(size_t left = 0; idx > 0 && left < m_QueueIdx; ++left)
+            {
+              T* from = Slot(idx + left);
+              new(Slot(left)) T(std::move(*from));
+              from->~T();
+            }
             break;
+          }
+          ++idx;
           --m_QueueIdx;
           auto dlt = start - _getTime(*item);
           // llarp::LogInfo("CoDelQueue::Process - dlt ", dlt);
@@ -152,8 +172,18 @@ namespace llarp
       llarp_time_t nextTickInterval = initialIntervalMs;
       llarp_time_t nextTickAt       = 0;
       Mutex_t m_QueueMutex;
+      T*
+      Slot(size_t idx)
+      {
+        return reinterpret_cast< T* >(&m_Queue[idx]);
+      }
+
+      using Storage_t =
+          typename std::aligned_storage< sizeof(T), alignof(T) >::type;
+
       size_t m_QueueIdx GUARDED_BY(m_QueueMutex);
-      std::array< T, MaxSize > m_Queue GUARDED_BY(m_QueueMutex);
+      /// only the first m_QueueIdx slots hold live items
+      std::array< Storage_t, MaxSize > m_Queue GUARDED_BY(m_QueueMutex);
       std::string m_name;
       GetTime _getTime;
       PutTime _putTime;
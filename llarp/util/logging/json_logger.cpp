@@ -1,5 +1,6 @@
 #include <util/logging/json_logger.hpp>
 #include <util/json.hpp>
+#include <util/logging/logger_internal.hpp>
 
 namespace llarp
 {
@@ -8,7 +9,7 @@ namespace llarp
                            const std::string& nodename, const std::string msg)
   {
     json::Object obj;
-    obj["time"]     = llarp::time_now_ms();
+    obj["time"]     = log_timestamp().now;
     obj["nickname"] = nodename;
     obj["file"]     = std::string(fname);
     obj["line"]     = lineno;
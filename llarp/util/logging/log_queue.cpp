@@ -0,0 +1,195 @@
+#include <util/logging/log_queue.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace llarp
+{
+  constexpr size_t LogRecord::MaxMessageSize;
+  constexpr size_t LogRing::Capacity;
+  constexpr llarp_time_t LogQueue::DrainInterval;
+
+  bool
+  LogRing::Push(LogLevel lvl, const char* file, int line, uint16_t threadID,
+                llarp_time_t when, string_view msg)
+  {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if(t - head.load(std::memory_order_acquire) >= Capacity)
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    LogRecord& rec = records[t % Capacity];
+    rec.level      = lvl;
+    rec.file       = file;
+    rec.line       = line;
+    rec.threadID   = threadID;
+    rec.when       = when;
+    rec.size       = std::min(msg.size(), LogRecord::MaxMessageSize);
+    std::memcpy(rec.message, msg.data(), rec.size);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t
+  LogRing::Size() const
+  {
+    return tail.load(std::memory_order_acquire)
+        - head.load(std::memory_order_acquire);
+  }
+
+  static std::atomic< uint64_t > nextQueueID{1};
+
+  LogQueue::LogQueue(Sink_t sink)
+      : m_Sink(std::move(sink)), m_ID(nextQueueID.fetch_add(1))
+  {
+  }
+
+  LogQueue::~LogQueue()
+  {
+    Stop();
+  }
+
+  void
+  LogQueue::Start()
+  {
+    util::Lock lock(&m_WakeMutex);
+    if(m_Running)
+      return;
+    m_Running = true;
+    m_Thread  = std::thread(&LogQueue::Run, this);
+  }
+
+  void
+  LogQueue::Stop()
+  {
+    {
+      util::Lock lock(&m_WakeMutex);
+      if(not m_Running)
+        return;
+      m_Running = false;
+    }
+    m_Wake.Signal();
+    m_Thread.join();
+    Drain();
+  }
+
+  void
+  LogQueue::Run()
+  {
+    util::SetThreadName("llarp-log");
+    while(true)
+    {
+      Drain();
+      util::Lock lock(&m_WakeMutex);
+      if(not m_Running)
+        return;
+      m_Wake.WaitWithTimeout(&m_WakeMutex, absl::Milliseconds(DrainInterval));
+    }
+  }
+
+  std::shared_ptr< LogRing >
+  LogQueue::RingForThisThread()
+  {
+    /// marks the ring orphaned when the thread exits
+    struct Owner
+    {
+      uint64_t queue = 0;
+      std::shared_ptr< LogRing > ring;
+
+      ~Owner()
+      {
+        if(ring)
+          ring->orphaned = true;
+      }
+    };
+    static thread_local Owner owner;
+    if(owner.queue != m_ID || owner.ring == nullptr)
+    {
+      if(owner.ring)
+        owner.ring->orphaned = true;
+      owner.ring  = std::make_shared< LogRing >();
+      owner.queue = m_ID;
+      util::Lock lock(&m_RingsMutex);
+      m_Rings.emplace_back(owner.ring);
+    }
+    return owner.ring;
+  }
+
+  void
+  LogQueue::Push(LogLevel lvl, const char* file, int line, uint16_t threadID,
+                 llarp_time_t when, string_view msg)
+  {
+    const auto ring = RingForThisThread();
+    if(ring->Push(lvl, file, line, threadID, when, msg)
+       && ring->Size() == LogRing::Capacity / 2)
+    {
+      // don't wait for the timeout when a thread is logging this much
+      m_Wake.Signal();
+    }
+  }
+
+  void
+  LogQueue::Drain()
+  {
+    struct Batch
+    {
+      std::shared_ptr< LogRing > ring;
+      size_t end;
+    };
+    util::Lock drainLock(&m_DrainMutex);
+    std::vector< Batch > batches;
+    std::vector< const LogRecord* > records;
+    uint64_t dropped = 0;
+    {
+      util::Lock lock(&m_RingsMutex);
+      auto itr = m_Rings.begin();
+      while(itr != m_Rings.end())
+      {
+        auto& ring       = *itr;
+        const size_t beg = ring->head.load(std::memory_order_relaxed);
+        const size_t end = ring->tail.load(std::memory_order_acquire);
+        dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        if(beg == end && ring->orphaned)
+        {
+          itr = m_Rings.erase(itr);
+          continue;
+        }
+        for(size_t idx = beg; idx != end; ++idx)
+          records.emplace_back(&ring->records[idx % LogRing::Capacity]);
+        if(beg != end)
+          batches.push_back({ring, end});
+        ++itr;
+      }
+    }
+    // each ring is in order already, this interleaves them
+    std::stable_sort(records.begin(), records.end(),
+                     [](const LogRecord* left, const LogRecord* right) {
+                       return left->when < right->when;
+                     });
+    for(const auto* rec : records)
+      m_Sink(*rec);
+    // the slots belong to the threads again once we release them
+    const llarp_time_t lastWhen = records.empty() ? 0 : records.back()->when;
+    // only now may the threads reuse the slots
+    for(const auto& batch : batches)
+      batch.ring->head.store(batch.end, std::memory_order_release);
+
+    if(dropped)
+    {
+      m_Dropped += dropped;
+      LogRecord rec;
+      const std::string msg = "dropped " + std::to_string(dropped)
+          + " log lines, logging faster than we can write";
+      rec.level    = eLogWarn;
+      rec.file     = "log_queue.cpp";
+      rec.line     = __LINE__;
+      rec.threadID = 0;
+      rec.when     = lastWhen;
+      rec.size     = std::min(msg.size(), LogRecord::MaxMessageSize);
+      std::memcpy(rec.message, msg.data(), rec.size);
+      m_Sink(rec);
+    }
+  }
+}  // namespace llarp
@@ -0,0 +1,139 @@
+#ifndef LLARP_UTIL_LOG_QUEUE_HPP
+#define LLARP_UTIL_LOG_QUEUE_HPP
+
+#include <util/logging/loglevel.hpp>
+#include <util/string_view.hpp>
+#include <util/thread/threading.hpp>
+#include <util/types.hpp>
+
+#include <absl/base/thread_annotations.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace llarp
+{
+  /// a log line on its way to the log thread
+  struct LogRecord
+  {
+    /// longer messages are cut short
+    static constexpr size_t MaxMessageSize = 480;
+
+    LogLevel level;
+    /// the call site's tag, a string literal so we never copy it
+    const char* file;
+    int line;
+    uint16_t threadID;
+    llarp_time_t when;
+    uint16_t size;
+    char message[MaxMessageSize];
+
+    string_view
+    Message() const
+    {
+      return string_view(message, size);
+    }
+  };
+
+  /// log records from one thread, pushed by that thread and popped by the
+  /// log thread without either taking a lock
+  struct LogRing
+  {
+    static constexpr size_t Capacity = 256;
+
+    /// returns false and counts a drop if full
+    bool
+    Push(LogLevel lvl, const char* file, int line, uint16_t threadID,
+         llarp_time_t when, string_view msg);
+
+    /// how many records are queued
+    size_t
+    Size() const;
+
+    std::array< LogRecord, Capacity > records;
+    // padding keeps the two threads' indices off each other's cache lines,
+    // alignas wouldn't hold as rings come from make_shared
+    char padHead[64];
+    /// next record the log thread pops
+    std::atomic< size_t > head{0};
+    char padTail[64];
+    /// next slot the owning thread fills
+    std::atomic< size_t > tail{0};
+    std::atomic< uint64_t > dropped{0};
+    /// the owning thread exited, drop the ring once it is empty
+    std::atomic< bool > orphaned{false};
+  };
+
+  /// hands log lines from every thread to one thread that writes them out,
+  /// so logging never waits on a lock or on io. each thread gets its own
+  /// ring the first time it logs. a thread that logs faster than the log
+  /// thread keeps up loses lines rather than blocking, the losses are
+  /// counted and reported in the log.
+  struct LogQueue
+  {
+    using Sink_t = std::function< void(const LogRecord&) >;
+
+    /// how long the log thread sleeps when nobody wakes it
+    static constexpr llarp_time_t DrainInterval = 10;
+
+    explicit LogQueue(Sink_t sink);
+
+    ~LogQueue();
+
+    LogQueue(const LogQueue&) = delete;
+    LogQueue&
+    operator=(const LogQueue&) = delete;
+
+    /// start the log thread
+    void
+    Start() LOCKS_EXCLUDED(m_WakeMutex);
+
+    /// stop the log thread once it wrote everything queued
+    void
+    Stop() LOCKS_EXCLUDED(m_WakeMutex);
+
+    /// queue a line from the calling thread
+    void
+    Push(LogLevel lvl, const char* file, int line, uint16_t threadID,
+         llarp_time_t when, string_view msg);
+
+    /// write out everything queued so far, ordered by time across threads
+    void
+    Drain() LOCKS_EXCLUDED(m_DrainMutex, m_RingsMutex);
+
+    /// lines lost to full rings since we started
+    uint64_t
+    Dropped() const
+    {
+      return m_Dropped.load();
+    }
+
+   private:
+    std::shared_ptr< LogRing >
+    RingForThisThread() LOCKS_EXCLUDED(m_RingsMutex);
+
+    void
+    Run();
+
+    const Sink_t m_Sink;
+    /// tells the rings of queues that lived at the same address apart
+    const uint64_t m_ID;
+    /// held while writing so lines go out in order
+    util::Mutex m_DrainMutex ACQUIRED_BEFORE(m_RingsMutex);
+    util::Mutex m_RingsMutex;
+    std::vector< std::shared_ptr< LogRing > > m_Rings
+        GUARDED_BY(m_RingsMutex);
+    std::atomic< uint64_t > m_Dropped{0};
+
+    util::Mutex m_WakeMutex;
+    util::Condition m_Wake;
+    bool m_Running GUARDED_BY(m_WakeMutex) = false;
+    std::thread m_Thread;
+  };
+}  // namespace llarp
+
+#endif
@@ -23,10 +23,29 @@ namespace llarp
 #endif
 #endif
 
+  const LogOrigin*&
+  CurrentLogOrigin()
+  {
+    static thread_local const LogOrigin* origin = nullptr;
+    return origin;
+  }
+
   LogContext::LogContext()
-      : logStream(std::make_unique< Stream_t >(_LOGSTREAM_INIT))
-      , started(llarp::time_now_ms())
+      : started(llarp::time_now_ms())
+      , m_Stream(std::make_unique< Stream_t >(_LOGSTREAM_INIT))
+      , m_Queue([&](const LogRecord& rec) {
+        const LogOrigin origin{rec.threadID, rec.when};
+        CurrentLogOrigin() = &origin;
+        Write(rec.level, rec.file, rec.line, rec.Message());
+        CurrentLogOrigin() = nullptr;
+      })
   {
+    m_Queue.Start();
+  }
+
+  LogContext::~LogContext()
+  {
+    m_Queue.Stop();
   }
 
   LogContext&
@@ -48,14 +67,139 @@ namespace llarp
     curLevel = startupLevel;
   }
 
+  void
+  LogContext::Append(LogLevel lvl, const char* fname, int lineno,
+                     string_view msg)
+  {
+    // a log stream logging while the log thread writes queues like anyone
+    // else, writing from here would deadlock
+    const bool onLogThread = CurrentLogOrigin() != nullptr;
+    if(not onLogThread
+       && (lvl >= eLogError || msg.size() > LogRecord::MaxMessageSize))
+    {
+      // what was queued before goes out first
+      m_Queue.Drain();
+      // a stream logging from in here has to queue too, we hold its mutex
+      const LogOrigin origin{log_thread_id(), llarp::time_now_ms()};
+      CurrentLogOrigin() = &origin;
+      Write(lvl, fname, lineno, msg);
+      CurrentLogOrigin() = nullptr;
+      return;
+    }
+    m_Queue.Push(lvl, fname, lineno, log_thread_id(), llarp::time_now_ms(),
+                 msg);
+  }
+
+  void
+  LogContext::Write(LogLevel lvl, const char* fname, int lineno,
+                    string_view msg)
+  {
+    util::Lock lock(&m_StreamMutex);
+    m_Stream->AppendLog(lvl, fname, lineno, nodeName,
+                        std::string(msg.data(), msg.size()));
+  }
+
+  ILogStream_ptr
+  LogContext::SetLogStream(ILogStream_ptr stream)
+  {
+    util::Lock lock(&m_StreamMutex);
+    std::swap(m_Stream, stream);
+    return stream;
+  }
+
+  void
+  LogContext::Tick(llarp_time_t now)
+  {
+    // don't hold up the event loop on a slow write
+    if(not m_StreamMutex.TryLock())
+      return;
+    m_Stream->Tick(now);
+    m_StreamMutex.Unlock();
+  }
+
+  void
+  LogContext::Flush()
+  {
+    m_Queue.Drain();
+  }
+
+  uint64_t
+  LogContext::DroppedLines() const
+  {
+    return m_Queue.Dropped();
+  }
+
+  LogLineStream::Buffer::Buffer()
+  {
+    Reset();
+  }
+
+  void
+  LogLineStream::Buffer::Reset()
+  {
+    m_Spill.clear();
+    setp(m_Data, m_Data + sizeof(m_Data));
+  }
+
+  string_view
+  LogLineStream::Buffer::Line()
+  {
+    if(m_Spill.empty())
+      return string_view(pbase(), pptr() - pbase());
+    m_Spill.append(pbase(), pptr());
+    setp(m_Data, m_Data + sizeof(m_Data));
+    return m_Spill;
+  }
+
+  LogLineStream::Buffer::int_type
+  LogLineStream::Buffer::overflow(int_type ch)
+  {
+    m_Spill.append(pbase(), pptr());
+    setp(m_Data, m_Data + sizeof(m_Data));
+    if(not traits_type::eq_int_type(ch, traits_type::eof()))
+      m_Spill.push_back(traits_type::to_char_type(ch));
+    return traits_type::not_eof(ch);
+  }
+
+  LogLineStream::LogLineStream()
+      : std::ostream(nullptr), m_Buffer(), m_Flags(flags())
+  {
+    rdbuf(&m_Buffer);
+  }
+
+  LogLineStream&
+  LogLineStream::ForThisThread()
+  {
+    static thread_local LogLineStream stream;
+    return stream;
+  }
+
+  void
+  LogLineStream::Reset()
+  {
+    m_Buffer.Reset();
+    clear();
+    flags(m_Flags);
+    width(0);
+    precision(6);
+    fill(' ');
+  }
+
+  string_view
+  LogLineStream::Line()
+  {
+    return m_Buffer.Line();
+  }
+
   log_timestamp::log_timestamp() : log_timestamp("%c %Z")
   {
   }
 
   log_timestamp::log_timestamp(const char* fmt)
       : format(fmt)
-      , now(llarp::time_now_ms())
-      , delta(llarp::time_now_ms() - LogContext::Instance().started)
+      , now(CurrentLogOrigin() ? CurrentLogOrigin()->when
+                               : llarp::time_now_ms())
+      , delta(now - LogContext::Instance().started)
   {
   }
 
@@ -2,8 +2,22 @@
 #define LLARP_UTIL_LOGGER_HPP
 
 #include <util/time.hpp>
+#include <util/logging/log_queue.hpp>
 #include <util/logging/logstream.hpp>
 #include <util/logging/logger_internal.hpp>
+#include <util/string_view.hpp>
+#include <util/thread/threading.hpp>
+
+#include <absl/base/thread_annotations.h>
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/// log calls below this level are compiled out
+#ifndef LLARP_LOG_MIN_LEVEL
+#define LLARP_LOG_MIN_LEVEL 0
+#endif
 /*
 #ifdef _WIN32
 #define VC_EXTRALEAN
@@ -83,11 +97,11 @@ namespace llarp
   struct LogContext
   {
     LogContext();
+    ~LogContext();
     LogLevel curLevel     = eLogInfo;
     LogLevel startupLevel = eLogInfo;
     LogLevel runtimeLevel = eLogWarn;
-    ILogStream_ptr logStream;
-    std::string nodeName = "lokinet";
+    std::string nodeName  = "lokinet";
 
     const llarp_time_t started;
 
@@ -99,11 +113,100 @@ namespace llarp
 
     void
     RevertRuntimeLevel();
+
+    /// write out a formatted line. errors and lines too long for the queue
+    /// are written before this returns so they make it out even if we are
+    /// about to crash, everything else goes to the log thread.
+    void
+    Append(LogLevel lvl, const char* fname, int lineno, string_view msg)
+        LOCKS_EXCLUDED(m_StreamMutex);
+
+    /// log to stream from now on, returns the stream we logged to before
+    ILogStream_ptr
+    SetLogStream(ILogStream_ptr stream) LOCKS_EXCLUDED(m_StreamMutex);
+
+    /// called every end of event loop tick, skipped while the log thread is
+    /// writing
+    void
+    Tick(llarp_time_t now) LOCKS_EXCLUDED(m_StreamMutex);
+
+    /// write out everything queued so far
+    void
+    Flush();
+
+    /// lines lost because threads logged faster than we could write
+    uint64_t
+    DroppedLines() const;
+
+   private:
+    void
+    Write(LogLevel lvl, const char* fname, int lineno, string_view msg)
+        LOCKS_EXCLUDED(m_StreamMutex);
+
+    util::Mutex m_StreamMutex;
+    ILogStream_ptr m_Stream GUARDED_BY(m_StreamMutex);
+    /// after m_Stream so it's stopped and drained before the stream goes away
+    LogQueue m_Queue;
+  };
+
+  /// formats log lines into a reused buffer so the usual log call doesn't
+  /// allocate, lines that outgrow it spill into a string
+  struct LogLineStream : public std::ostream
+  {
+    LogLineStream();
+
+    /// the stream for the calling thread
+    static LogLineStream&
+    ForThisThread();
+
+    /// start a new line with the default formatting
+    void
+    Reset();
+
+    /// the line formatted since the last reset
+    string_view
+    Line();
+
+    /// set while formatting a line, log calls made by an operator<< of
+    /// that line's arguments format on their own stream
+    bool busy = false;
+
+   private:
+    struct Buffer : public std::streambuf
+    {
+      Buffer();
+
+      void
+      Reset();
+
+      string_view
+      Line();
+
+     protected:
+      int_type
+      overflow(int_type ch) override;
+
+     private:
+      char m_Data[LogRecord::MaxMessageSize];
+      std::string m_Spill;
+    };
+
+    Buffer m_Buffer;
+    const std::ios_base::fmtflags m_Flags;
   };
 
   void
   SetLogLevel(LogLevel lvl);
 
+  /** internal */
+  inline bool
+  _LogEnabled(LogLevel lvl)
+  {
+    // constant for levels compiled out so the optimiser drops the call
+    return int(lvl) >= LLARP_LOG_MIN_LEVEL
+        && LogContext::Instance().curLevel <= lvl;
+  }
+
   /** internal */
   template < typename... TArgs >
   void
@@ -113,9 +216,19 @@ namespace llarp
     if(log.curLevel > lvl)
       return;
 
-    std::stringstream ss;
-    LogAppend(ss, std::forward< TArgs >(args)...);
-    log.logStream->AppendLog(lvl, fname, lineno, log.nodeName, ss.str());
+    auto& line = LogLineStream::ForThisThread();
+    if(line.busy)
+    {
+      std::stringstream ss;
+      LogAppend(ss, std::forward< TArgs >(args)...);
+      log.Append(lvl, fname, lineno, ss.str());
+      return;
+    }
+    line.Reset();
+    line.busy = true;
+    LogAppend(line, std::forward< TArgs >(args)...);
+    log.Append(lvl, fname, lineno, line.Line());
+    line.busy = false;
   }
   /*
     std::stringstream ss;
@@ -244,28 +357,44 @@ namespace llarp
   */
 }  // namespace llarp
 
-#define LogTrace(...) _Log(llarp::eLogTrace, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogDebug(...) _Log(llarp::eLogDebug, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogInfo(...) _Log(llarp::eLogInfo, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogWarn(...) _Log(llarp::eLogWarn, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogError(...) _Log(llarp::eLogError, LOG_TAG, __LINE__, __VA_ARGS__)
+/// the arguments are only evaluated if the level is logged. callers may
+/// qualify the macros with llarp:: so the expansion starts with a name in
+/// llarp, _Log is then found through the level's namespace.
+#define _LogIfEnabled(lvl, tag, line, ...) \
+  _LogEnabled(lvl) ? _Log(lvl, tag, line, __VA_ARGS__) : void()
+
+#define LogTrace(...) \
+  _LogIfEnabled(llarp::eLogTrace, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogDebug(...) \
+  _LogIfEnabled(llarp::eLogDebug, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogInfo(...) \
+  _LogIfEnabled(llarp::eLogInfo, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogWarn(...) \
+  _LogIfEnabled(llarp::eLogWarn, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogError(...) \
+  _LogIfEnabled(llarp::eLogError, LOG_TAG, __LINE__, __VA_ARGS__)
 
-#define LogTraceTag(tag, ...) _Log(llarp::eLogTrace, tag, __LINE__, __VA_ARGS__)
-#define LogDebugTag(tag, ...) _Log(llarp::eLogDebug, tag, __LINE__, __VA_ARGS__)
-#define LogInfoTag(tag, ...) _Log(llarp::eLogInfo, tag, __LINE__, __VA_ARGS__)
-#define LogWarnTag(tag, ...) _Log(llarp::eLogWarn, tag, __LINE__, __VA_ARGS__)
-#define LogErrorTag(tag, ...) _Log(llarp::eLogError, tag, __LINE__, __VA_ARGS__)
+#define LogTraceTag(tag, ...) \
+  _LogIfEnabled(llarp::eLogTrace, tag, __LINE__, __VA_ARGS__)
+#define LogDebugTag(tag, ...) \
+  _LogIfEnabled(llarp::eLogDebug, tag, __LINE__, __VA_ARGS__)
+#define LogInfoTag(tag, ...) \
+  _LogIfEnabled(llarp::eLogInfo, tag, __LINE__, __VA_ARGS__)
+#define LogWarnTag(tag, ...) \
+  _LogIfEnabled(llarp::eLogWarn, tag, __LINE__, __VA_ARGS__)
+#define LogErrorTag(tag, ...) \
+  _LogIfEnabled(llarp::eLogError, tag, __LINE__, __VA_ARGS__)
 
 #define LogTraceExplicit(tag, line, ...) \
-  _Log(llarp::eLogTrace, tag, line, __VA_ARGS__)
+  _LogIfEnabled(llarp::eLogTrace, tag, line, __VA_ARGS__)
 #define LogDebugExplicit(tag, line, ...) \
-  _Log(llarp::eLogDebug, tag, line, __VA_ARGS__)
+  _LogIfEnabled(llarp::eLogDebug, tag, line, __VA_ARGS__)
 #define LogInfoExplicit(tag, line, ...) \
-  _Log(llarp::eLogInfo, tag, line __VA_ARGS__)
+  _LogIfEnabled(llarp::eLogInfo, tag, line, __VA_ARGS__)
 #define LogWarnExplicit(tag, line, ...) \
-  _Log(llarp::eLogWarn, tag, line, __VA_ARGS__)
+  _LogIfEnabled(llarp::eLogWarn, tag, line, __VA_ARGS__)
 #define LogErrorExplicit(tag, line, ...) \
-  _Log(llarp::eLogError, tag, line, __VA_ARGS__)
+  _LogIfEnabled(llarp::eLogError, tag, line, __VA_ARGS__)
 
 #ifndef LOG_TAG
 #define LOG_TAG "default"
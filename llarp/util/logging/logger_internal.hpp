@@ -7,6 +7,7 @@
 #include <absl/time/time.h>
 #include <ctime>
 #include <iomanip>
+#include <ostream>
 #include <sstream>
 #include <util/thread/threading.hpp>
 
@@ -15,25 +16,45 @@ namespace llarp
   /** internal */
   template < typename TArg >
   void
-  LogAppend(std::stringstream& ss, TArg&& arg) noexcept
+  LogAppend(std::ostream& ss, TArg&& arg) noexcept
   {
     ss << std::forward< TArg >(arg);
   }
   /** internal */
   template < typename TArg, typename... TArgs >
   void
-  LogAppend(std::stringstream& ss, TArg&& arg, TArgs&&... args) noexcept
+  LogAppend(std::ostream& ss, TArg&& arg, TArgs&&... args) noexcept
   {
     LogAppend(ss, std::forward< TArg >(arg));
     LogAppend(ss, std::forward< TArgs >(args)...);
   }
 
+  /// where and when a queued log line was logged, set by the log thread
+  /// while it writes the line so log streams print that rather than
+  /// their own thread and time
+  struct LogOrigin
+  {
+    uint16_t threadID;
+    llarp_time_t when;
+  };
+
+  /// the origin of the line being written on this thread, if it was queued
+  const LogOrigin*&
+  CurrentLogOrigin();
+
+  inline uint16_t
+  log_thread_id()
+  {
+    static thread_local const uint16_t id =
+        std::hash< std::thread::id >{}(std::this_thread::get_id()) % 1000;
+    return id;
+  }
+
   inline std::string
   thread_id_string()
   {
-    auto tid = std::this_thread::get_id();
-    std::hash< std::thread::id > h;
-    uint16_t id = h(tid) % 1000;
+    const auto* origin = CurrentLogOrigin();
+    uint16_t id        = origin ? origin->threadID : log_thread_id();
 #if defined(ANDROID) || defined(RPI)
     char buff[8] = {0};
     snprintf(buff, sizeof(buff), "%u", id);
@@ -219,6 +219,12 @@ namespace llarp
               const absl::Duration &now, bool clear)
           EXCLUSIVE_LOCKS_REQUIRED(manager.m_mutex)
       {
+        auto sources = manager.m_sources.equal_range(category);
+        for(auto it = sources.first; it != sources.second; ++it)
+        {
+          it->second->flush();
+        }
+
         // Collect records from the repo.
         const Records result = clear
             ? Records(manager.m_doubleRepo.collectAndClear(category),
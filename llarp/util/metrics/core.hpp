@@ -154,6 +154,22 @@ namespace llarp
       publish(const Sample &sample) = 0;
     };
 
+    /// A metric that keeps its own state and only moves it into its
+    /// collectors when its category is collected, so that updating it never
+    /// takes a collector's lock
+    class CollectedSource
+    {
+     public:
+      virtual ~CollectedSource() = default;
+
+      virtual const Category *
+      category() const = 0;
+
+      /// Move everything gathered since the last call into the collectors
+      virtual void
+      flush() = 0;
+    };
+
     template < typename Value >
     static inline void
     combine(TaggedRecords< Value > &records,
@@ -673,6 +689,7 @@ namespace llarp
      private:
       // Map categories to the times they were last reset
       using ResetTimes = std::map< const Category *, absl::Duration >;
+      using Sources = std::multimap< const Category *, CollectedSource * >;
 
       friend struct PublisherHelper;
 
@@ -680,6 +697,7 @@ namespace llarp
       CollectorRepo< double > m_doubleRepo;
       CollectorRepo< int > m_intRepo;
       PublisherRegistry m_publishers GUARDED_BY(m_mutex);
+      Sources m_sources GUARDED_BY(m_mutex);
 
       const absl::Duration m_createTime;
       ResetTimes m_resetTimes;
@@ -730,6 +748,30 @@ namespace llarp
         absl::WriterMutexLock l(&m_mutex);
         return m_publishers.removePublisher(publisher);
       }
+
+      /// Flush `source` into its collectors whenever its category is
+      /// collected, until it is removed
+      void
+      addSource(CollectedSource *source)
+      {
+        absl::WriterMutexLock l(&m_mutex);
+        m_sources.emplace(source->category(), source);
+      }
+
+      void
+      removeSource(CollectedSource *source)
+      {
+        absl::WriterMutexLock l(&m_mutex);
+        auto range = m_sources.equal_range(source->category());
+        for(auto it = range.first; it != range.second; ++it)
+        {
+          if(it->second == source)
+          {
+            m_sources.erase(it);
+            return;
+          }
+        }
+      }
       bool
       removePublisher(const std::shared_ptr< Publisher > &publisher)
       {
@@ -0,0 +1,80 @@
+#include <util/metrics/sharded.hpp>
+
+#include <limits>
+
+namespace llarp
+{
+  namespace metrics
+  {
+    constexpr size_t ShardedHistogram::NUM_BUCKETS;
+
+    ShardedMetric::ShardedMetric(string_view category, string_view name,
+                                 Manager *manager)
+        : m_manager(DefaultManager::manager(manager))
+        , m_collector(IntMetric::lookup(category, name, m_manager))
+        , m_enabled(m_collector ? &m_collector->id().category()->enabledRaw()
+                                : nullptr)
+    {
+      if(m_collector)
+      {
+        m_manager->addSource(this);
+      }
+    }
+
+    ShardedMetric::~ShardedMetric()
+    {
+      if(m_collector)
+      {
+        m_manager->removeSource(this);
+      }
+    }
+
+    void
+    ShardedCounter::flush()
+    {
+      if(!m_collector)
+      {
+        return;
+      }
+      for(auto &shard : m_shards)
+      {
+        const Record< int > rec = shard.take();
+        if(rec.count() != 0)
+        {
+          m_collector->accumulate(rec.count(), rec.total(), rec.min(),
+                                  rec.max());
+        }
+      }
+    }
+
+    void
+    ShardedHistogram::flush()
+    {
+      ShardedCounter::flush();
+      if(!m_collector)
+      {
+        return;
+      }
+      std::array< int, NUM_BUCKETS > counts{};
+      for(auto &shard : m_buckets)
+      {
+        for(size_t i = 0; i < NUM_BUCKETS; ++i)
+        {
+          counts[i] += shard.counts[i].exchange(0, std::memory_order_relaxed);
+        }
+      }
+      for(size_t i = 0; i < NUM_BUCKETS; ++i)
+      {
+        if(counts[i] == 0)
+        {
+          continue;
+        }
+        // the bucket's bounds stand in for the values we didn't keep
+        const int64_t upper = (int64_t(1) << i) - 1;
+        const int lower     = i == 0 ? std::numeric_limits< int >::min()
+                                     : int(int64_t(1) << (i - 1));
+        m_collector->accumulate(counts[i], 0, lower, int(upper), "le", upper);
+      }
+    }
+  }  // namespace metrics
+}  // namespace llarp
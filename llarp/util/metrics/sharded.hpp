@@ -0,0 +1,343 @@
+#ifndef LLARP_METRICS_SHARDED_HPP
+#define LLARP_METRICS_SHARDED_HPP
+
+#include <util/metrics/core.hpp>
+#include <util/string_view.hpp>
+#include <util/thread/threading.hpp>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace metrics
+  {
+    /// How many threads can update a sharded metric before any of them share
+    /// a shard
+    static constexpr size_t NUM_METRIC_SHARDS = 16;
+
+    /// Bytes left unused after each shard so no two shards' data can share a
+    /// cache line. Padding rather than alignas, as C++14 heap allocation
+    /// doesn't honour alignment beyond max_align_t.
+    static constexpr size_t METRIC_SHARD_PAD = 64;
+
+    /// The shard the calling thread updates, handed out round robin
+    inline size_t
+    metricShard()
+    {
+      static std::atomic< size_t > next{0};
+      static thread_local const size_t shard = next++ % NUM_METRIC_SHARDS;
+      return shard;
+    }
+
+    /// Count, total, min and max of the updates made through one shard,
+    /// padded onto cache lines of its own so threads don't contend
+    struct IntShard
+    {
+      std::atomic< int > count{0};
+      std::atomic< int > total{0};
+      std::atomic< int > min{Record< int >::DEFAULT_MIN()};
+      std::atomic< int > max{Record< int >::DEFAULT_MAX()};
+      char pad[METRIC_SHARD_PAD];
+
+      void
+      update(int val)
+      {
+        count.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(val, std::memory_order_relaxed);
+        int cur = min.load(std::memory_order_relaxed);
+        while(val < cur
+              && !min.compare_exchange_weak(cur, val,
+                                            std::memory_order_relaxed))
+        {
+        }
+        cur = max.load(std::memory_order_relaxed);
+        while(val > cur
+              && !max.compare_exchange_weak(cur, val,
+                                            std::memory_order_relaxed))
+        {
+        }
+      }
+
+      /// Take what was gathered and start over
+      Record< int >
+      take()
+      {
+        return Record< int >(
+            count.exchange(0, std::memory_order_relaxed),
+            total.exchange(0, std::memory_order_relaxed),
+            min.exchange(Record< int >::DEFAULT_MIN(),
+                         std::memory_order_relaxed),
+            max.exchange(Record< int >::DEFAULT_MAX(),
+                         std::memory_order_relaxed));
+      }
+    };
+
+    /// Common part of the sharded metrics: the collector they flush into
+    /// and their registration with the manager. Without a manager they
+    /// do nothing.
+    class ShardedMetric : public CollectedSource
+    {
+      ShardedMetric(const ShardedMetric &) = delete;
+      ShardedMetric &
+      operator=(const ShardedMetric &) = delete;
+
+     protected:
+      Manager *m_manager;
+      IntCollector *m_collector;  // can be null
+      const std::atomic_bool *m_enabled;
+
+      ShardedMetric(string_view category, string_view name, Manager *manager);
+
+     public:
+      ~ShardedMetric() override;
+
+      bool
+      active() const
+      {
+        return m_enabled ? m_enabled->load(std::memory_order_relaxed) : false;
+      }
+
+      const Category *
+      category() const override
+      {
+        return m_collector ? m_collector->id().category() : nullptr;
+      }
+
+      Id
+      id() const
+      {
+        return m_collector ? m_collector->id() : Id();
+      }
+    };
+
+    /// An int metric for the hot path. Look it up once, then every update is
+    /// a few relaxed atomic operations on the calling thread's shard. The
+    /// shards are only summed up when the category is collected.
+    class ShardedCounter : public ShardedMetric
+    {
+      std::array< IntShard, NUM_METRIC_SHARDS > m_shards;
+
+     public:
+      ShardedCounter(string_view category, string_view name,
+                     Manager *manager = nullptr)
+          : ShardedMetric(category, name, manager)
+      {
+      }
+
+      void
+      tick(int val = 1)
+      {
+        if(active())
+        {
+          m_shards[metricShard()].update(val);
+        }
+      }
+
+      void
+      flush() override;
+    };
+
+    /// A sharded counter that also counts updates into power of two buckets,
+    /// published as records tagged "le" with the bucket's upper bound
+    class ShardedHistogram : public ShardedCounter
+    {
+     public:
+      /// bucket 0 holds everything up to 0, bucket `i` values up to 2^i - 1
+      static constexpr size_t NUM_BUCKETS = 32;
+
+      ShardedHistogram(string_view category, string_view name,
+                       Manager *manager = nullptr)
+          : ShardedCounter(category, name, manager)
+      {
+      }
+
+      static size_t
+      bucket(int val)
+      {
+        if(val <= 0)
+        {
+          return 0;
+        }
+        size_t bits = 0;
+        for(size_t shift = 16; shift > 0; shift /= 2)
+        {
+          if(val >> shift)
+          {
+            val >>= shift;
+            bits += shift;
+          }
+        }
+        return bits + 1;
+      }
+
+      void
+      tick(int val)
+      {
+        if(active())
+        {
+          const size_t shard = metricShard();
+          m_buckets[shard].counts[bucket(val)].fetch_add(
+              1, std::memory_order_relaxed);
+          ShardedCounter::tick(val);
+        }
+      }
+
+      void
+      flush() override;
+
+     private:
+      struct BucketShard
+      {
+        std::array< std::atomic< int >, NUM_BUCKETS > counts{};
+        char pad[METRIC_SHARD_PAD];
+      };
+
+      std::array< BucketShard, NUM_METRIC_SHARDS > m_buckets;
+    };
+
+    /// Counts updates per key but only publishes the `k` keys updated most,
+    /// tagged "id" with the key's string form, so per peer stats stay a
+    /// bounded number of records however many peers there are. The untagged
+    /// record has every update.
+    ///
+    /// Each shard keeps a space saving summary of a few times `k` keys: a new
+    /// key evicts the least counted one and inherits its counts, so the
+    /// counts of late arrivals are over estimates by at most what they
+    /// inherited.
+    template < typename Key, typename Hash = typename Key::Hash >
+    class TopKCounter : public ShardedMetric
+    {
+      struct Counts
+      {
+        int count = 0;
+        int total = 0;
+        int min   = Record< int >::DEFAULT_MIN();
+        int max   = Record< int >::DEFAULT_MAX();
+      };
+
+      using Summary = absl::flat_hash_map< Key, Counts, Hash >;
+
+      struct Shard
+      {
+        util::Mutex mutex;
+        Summary summary GUARDED_BY(mutex);
+        char pad[METRIC_SHARD_PAD];
+      };
+
+      const size_t m_k;
+      const size_t m_capacity;
+      std::array< Shard, NUM_METRIC_SHARDS > m_shards;
+
+     public:
+      TopKCounter(string_view category, string_view name, size_t k,
+                  Manager *manager = nullptr)
+          : ShardedMetric(category, name, manager), m_k(k), m_capacity(k * 4)
+      {
+        for(auto &shard : m_shards)
+        {
+          util::Lock l(&shard.mutex);
+          shard.summary.reserve(m_capacity);
+        }
+      }
+
+      size_t
+      k() const
+      {
+        return m_k;
+      }
+
+      void
+      tick(const Key &key, int val = 1)
+      {
+        if(!active())
+        {
+          return;
+        }
+        Shard &shard = m_shards[metricShard()];
+        util::Lock l(&shard.mutex);
+        auto it = shard.summary.find(key);
+        if(it == shard.summary.end())
+        {
+          Counts inherited;
+          if(shard.summary.size() >= m_capacity)
+          {
+            auto least = std::min_element(
+                shard.summary.begin(), shard.summary.end(),
+                [](const auto &a, const auto &b) {
+                  return a.second.count < b.second.count;
+                });
+            inherited.count = least->second.count;
+            inherited.total = least->second.total;
+            shard.summary.erase(least);
+          }
+          it = shard.summary.emplace(key, inherited).first;
+        }
+        Counts &counts = it->second;
+        counts.count++;
+        counts.total += val;
+        counts.min = std::min(counts.min, val);
+        counts.max = std::max(counts.max, val);
+      }
+
+      void
+      flush() override
+      {
+        if(!m_collector)
+        {
+          return;
+        }
+        Summary merged;
+        Counts all;
+        for(auto &shard : m_shards)
+        {
+          Summary taken;
+          {
+            util::Lock l(&shard.mutex);
+            taken.swap(shard.summary);
+            shard.summary.reserve(m_capacity);
+          }
+          for(const auto &entry : taken)
+          {
+            Counts &counts = merged[entry.first];
+            counts.count += entry.second.count;
+            counts.total += entry.second.total;
+            counts.min = std::min(counts.min, entry.second.min);
+            counts.max = std::max(counts.max, entry.second.max);
+            all.count += entry.second.count;
+            all.total += entry.second.total;
+            all.min = std::min(all.min, entry.second.min);
+            all.max = std::max(all.max, entry.second.max);
+          }
+        }
+        if(all.count == 0)
+        {
+          return;
+        }
+        m_collector->accumulate(all.count, all.total, all.min, all.max);
+
+        std::vector< std::pair< Key, Counts > > top(merged.begin(),
+                                                    merged.end());
+        const size_t n = std::min(m_k, top.size());
+        std::partial_sort(top.begin(), top.begin() + n, top.end(),
+                          [](const auto &a, const auto &b) {
+                            return a.second.count > b.second.count;
+                          });
+        for(size_t i = 0; i < n; ++i)
+        {
+          const Counts &counts = top[i].second;
+          m_collector->accumulate(counts.count, counts.total, counts.min,
+                                  counts.max, "id", top[i].first.ToString());
+        }
+      }
+    };
+  }  // namespace metrics
+}  // namespace llarp
+
+#endif
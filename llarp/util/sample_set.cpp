@@ -0,0 +1 @@
+#include <util/sample_set.hpp>
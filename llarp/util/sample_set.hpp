@@ -0,0 +1,152 @@
+#ifndef LLARP_UTIL_SAMPLE_SET_HPP
+#define LLARP_UTIL_SAMPLE_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// pick a uniformly random element of vals, rand returns uniform 64 bit
+    /// values. returns nullptr if vals is empty.
+    template < typename Val_t, typename Rand_t >
+    const Val_t*
+    SampleUniform(const std::vector< Val_t >& vals, Rand_t&& rand)
+    {
+      if(vals.empty())
+        return nullptr;
+      return &vals[rand() % vals.size()];
+    }
+
+    /// pick a uniformly random element of vals that accept(val) is true for.
+    /// tries a few random picks first, which is O(1) as long as most
+    /// elements are acceptable, then falls back to scanning from a random
+    /// point so we only fail if nothing is acceptable.
+    template < typename Val_t, typename Rand_t, typename Accept_t >
+    const Val_t*
+    SampleIf(const std::vector< Val_t >& vals, Rand_t&& rand, Accept_t accept,
+             size_t tries = 8)
+    {
+      const size_t sz = vals.size();
+      if(sz == 0)
+        return nullptr;
+      while(tries--)
+      {
+        const Val_t& val = vals[rand() % sz];
+        if(accept(val))
+          return &val;
+      }
+      const size_t start = rand() % sz;
+      for(size_t idx = 0; idx < sz; ++idx)
+      {
+        const Val_t& val = vals[(start + idx) % sz];
+        if(accept(val))
+          return &val;
+      }
+      return nullptr;
+    }
+
+    /// pick an element of vals with probability proportional to weight(val),
+    /// elements with weight 0 are never picked. one pass over vals.
+    template < typename Val_t, typename Rand_t, typename Weight_t >
+    const Val_t*
+    SampleWeighted(const std::vector< Val_t >& vals, Rand_t&& rand,
+                   Weight_t weight)
+    {
+      const Val_t* picked = nullptr;
+      double total        = 0;
+      for(const auto& val : vals)
+      {
+        const double w = weight(val);
+        if(w <= 0)
+          continue;
+        total += w;
+        // keep val with probability w / total, which leaves every element
+        // seen so far picked in proportion to its weight
+        const double unit = double(rand() >> 11) / double(uint64_t{1} << 53);
+        if(unit * total < w)
+          picked = &val;
+      }
+      return picked;
+    }
+
+    /// values keyed by Key_t kept back to back in a vector so they can be
+    /// handed to the Sample functions, insert and remove are O(1) and remove
+    /// swaps the last value into the hole
+    template < typename Key_t, typename Val_t, typename Hash_t >
+    struct SampleSet
+    {
+      /// put val for key, replacing any value we had for it
+      void
+      Insert(const Key_t& key, Val_t val)
+      {
+        auto itr = m_Index.find(key);
+        if(itr != m_Index.end())
+        {
+          m_Values[itr->second] = std::move(val);
+          return;
+        }
+        m_Index.emplace(key, m_Values.size());
+        m_Keys.emplace_back(key);
+        m_Values.emplace_back(std::move(val));
+      }
+
+      /// returns false if we don't have key
+      bool
+      Remove(const Key_t& key)
+      {
+        auto itr = m_Index.find(key);
+        if(itr == m_Index.end())
+          return false;
+        const size_t idx = itr->second;
+        m_Index.erase(itr);
+        if(idx + 1 != m_Values.size())
+        {
+          m_Keys[idx]          = std::move(m_Keys.back());
+          m_Values[idx]        = std::move(m_Values.back());
+          m_Index[m_Keys[idx]] = idx;
+        }
+        m_Keys.pop_back();
+        m_Values.pop_back();
+        return true;
+      }
+
+      bool
+      Contains(const Key_t& key) const
+      {
+        return m_Index.find(key) != m_Index.end();
+      }
+
+      void
+      Clear()
+      {
+        m_Index.clear();
+        m_Keys.clear();
+        m_Values.clear();
+      }
+
+      size_t
+      Size() const
+      {
+        return m_Values.size();
+      }
+
+      const std::vector< Val_t >&
+      Values() const
+      {
+        return m_Values;
+      }
+
+     private:
+      std::unordered_map< Key_t, size_t, Hash_t > m_Index;
+      std::vector< Key_t > m_Keys;
+      std::vector< Val_t > m_Values;
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
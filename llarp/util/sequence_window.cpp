@@ -0,0 +1 @@
+#include <util/sequence_window.hpp>
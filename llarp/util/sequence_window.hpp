@@ -0,0 +1,195 @@
+#ifndef LLARP_UTIL_SEQUENCE_WINDOW_HPP
+#define LLARP_UTIL_SEQUENCE_WINDOW_HPP
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// values keyed by a monotonic sequence number where live keys are less
+    /// than Size apart. a ring indexed by seq % Size points into a dense array
+    /// so find, insert and erase are O(1) and scans only touch live entries
+    /// laid out back to back. erased slots are reused so a window that has
+    /// reached its working size stops allocating.
+    template < typename Val_t, size_t Size >
+    struct SequenceWindow
+    {
+      static_assert(Size && (Size & (Size - 1)) == 0,
+                    "window size must be a power of 2");
+      static_assert(Size < std::numeric_limits< uint16_t >::max(),
+                    "window size must fit a slot index");
+
+      using Entry_t = std::pair< uint64_t, Val_t >;
+
+      SequenceWindow()
+      {
+        m_Slots.fill(Empty);
+      }
+
+      size_t
+      Count() const
+      {
+        return m_Entries.size();
+      }
+
+      bool
+      IsEmpty() const
+      {
+        return m_Entries.empty();
+      }
+
+      /// get the value for seq or nullptr if we don't have it
+      Val_t*
+      Find(uint64_t seq)
+      {
+        Entry_t* entry = AtSlot(seq);
+        if(entry && entry->first == seq)
+          return &entry->second;
+        return nullptr;
+      }
+
+      /// get whatever entry holds the slot seq maps to, may be a different
+      /// sequence number exactly a multiple of Size away
+      Entry_t*
+      AtSlot(uint64_t seq)
+      {
+        const auto idx = m_Slots[seq & Mask];
+        return idx == Empty ? nullptr : &m_Entries[idx];
+      }
+
+      /// put a value for seq, returns nullptr if the slot is taken by another
+      /// sequence number. pointers into the window are invalidated.
+      Val_t*
+      Emplace(uint64_t seq, Val_t&& val)
+      {
+        auto& idx = m_Slots[seq & Mask];
+        if(idx != Empty)
+          return m_Entries[idx].first == seq ? &m_Entries[idx].second
+                                             : nullptr;
+        idx = static_cast< uint16_t >(m_Entries.size());
+        m_Entries.emplace_back(seq, std::move(val));
+        return &m_Entries.back().second;
+      }
+
+      /// remove seq, returns false if we don't have it. pointers into the
+      /// window are invalidated.
+      bool
+      Erase(uint64_t seq)
+      {
+        const auto idx = m_Slots[seq & Mask];
+        if(idx == Empty || m_Entries[idx].first != seq)
+          return false;
+        EraseAt(idx);
+        return true;
+      }
+
+      /// visit every entry as visit(seq, val)
+      template < typename Visit_t >
+      void
+      ForEach(Visit_t visit)
+      {
+        for(auto& entry : m_Entries)
+          visit(entry.first, entry.second);
+      }
+
+      /// remove every entry where pred(seq, val) is true, pred may move the
+      /// value out
+      template < typename Pred_t >
+      void
+      EraseIf(Pred_t pred)
+      {
+        size_t idx = 0;
+        while(idx < m_Entries.size())
+        {
+          if(pred(m_Entries[idx].first, m_Entries[idx].second))
+            EraseAt(idx);
+          else
+            ++idx;
+        }
+      }
+
+     private:
+      static constexpr uint64_t Mask  = Size - 1;
+      static constexpr uint16_t Empty = std::numeric_limits< uint16_t >::max();
+
+      /// swap the last entry into idx and drop the tail
+      void
+      EraseAt(size_t idx)
+      {
+        m_Slots[m_Entries[idx].first & Mask] = Empty;
+        if(idx + 1 != m_Entries.size())
+        {
+          m_Entries[idx]                       = std::move(m_Entries.back());
+          m_Slots[m_Entries[idx].first & Mask] = static_cast< uint16_t >(idx);
+        }
+        m_Entries.pop_back();
+      }
+
+      std::array< uint16_t, Size > m_Slots;
+      std::vector< Entry_t > m_Entries;
+    };
+
+    template < typename Val_t, size_t Size >
+    constexpr uint64_t SequenceWindow< Val_t, Size >::Mask;
+
+    template < typename Val_t, size_t Size >
+    constexpr uint16_t SequenceWindow< Val_t, Size >::Empty;
+
+    /// remembers which of the last Bits sequence numbers below the highest
+    /// one inserted have been seen, anything older counts as seen
+    template < size_t Bits >
+    struct ReplayWindow
+    {
+      bool
+      Contains(uint64_t seq) const
+      {
+        if(not m_Any || seq > m_Highest)
+          return false;
+        if(m_Highest - seq >= Bits)
+          return true;
+        return m_Seen.test(seq % Bits);
+      }
+
+      void
+      Insert(uint64_t seq)
+      {
+        if(not m_Any || seq > m_Highest)
+        {
+          const uint64_t from = m_Any ? m_Highest + 1 : 0;
+          if(seq - from >= Bits)
+            m_Seen.reset();
+          else
+          {
+            for(uint64_t skipped = from; skipped < seq; ++skipped)
+              m_Seen.reset(skipped % Bits);
+          }
+          m_Highest = seq;
+          m_Any     = true;
+        }
+        else if(m_Highest - seq >= Bits)
+          return;
+        m_Seen.set(seq % Bits);
+      }
+
+      /// number of sequence numbers in the window we have seen
+      size_t
+      Count() const
+      {
+        return m_Seen.count();
+      }
+
+     private:
+      std::bitset< Bits > m_Seen;
+      uint64_t m_Highest = 0;
+      bool m_Any         = false;
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
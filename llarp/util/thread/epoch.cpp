@@ -0,0 +1,97 @@
+#include <util/thread/epoch.hpp>
+
+namespace llarp
+{
+  namespace thread
+  {
+    constexpr size_t EpochManager::MaxReaders;
+
+    EpochManager::Guard::Guard(const EpochManager& mgr)
+        : m_Manager(mgr), m_Slot(mgr.Enter())
+    {
+    }
+
+    EpochManager::Guard::~Guard()
+    {
+      m_Manager.Exit(m_Slot);
+    }
+
+    EpochManager::~EpochManager()
+    {
+      for(auto& retired : m_Retired)
+        retired.second();
+    }
+
+    size_t
+    EpochManager::Enter() const
+    {
+      // spread threads over the slots so readers don't share a cache line
+      static std::atomic< size_t > nextReader{0};
+      static thread_local const size_t start = nextReader++;
+      for(size_t idx = start;; ++idx)
+      {
+        auto& slot        = m_Slots[idx % MaxReaders];
+        uint64_t expected = 0;
+        if(slot.epoch.compare_exchange_strong(expected, m_Epoch.load()))
+          return idx % MaxReaders;
+        if(idx % MaxReaders == (start + MaxReaders - 1) % MaxReaders)
+          std::this_thread::yield();
+      }
+    }
+
+    void
+    EpochManager::Exit(size_t slot) const
+    {
+      m_Slots[slot].epoch.store(0);
+    }
+
+    void
+    EpochManager::Retire(std::function< void(void) > deleter)
+    {
+      {
+        util::Lock lock(&m_Mutex);
+        // readers entering from here on can't see the object any more
+        m_Retired.emplace_back(m_Epoch.fetch_add(1), std::move(deleter));
+      }
+      Reclaim();
+    }
+
+    void
+    EpochManager::Reclaim()
+    {
+      // anything retired after this point may be held by a reader we miss in
+      // the scan below, so it has to wait for the next round
+      uint64_t oldest = m_Epoch.load();
+      for(const auto& slot : m_Slots)
+      {
+        const uint64_t epoch = slot.epoch.load();
+        if(epoch && epoch < oldest)
+          oldest = epoch;
+      }
+      std::vector< std::function< void(void) > > ready;
+      {
+        util::Lock lock(&m_Mutex);
+        auto itr = m_Retired.begin();
+        while(itr != m_Retired.end())
+        {
+          if(itr->first < oldest)
+          {
+            ready.emplace_back(std::move(itr->second));
+            itr = m_Retired.erase(itr);
+          }
+          else
+            ++itr;
+        }
+      }
+      for(const auto& deleter : ready)
+        deleter();
+    }
+
+    size_t
+    EpochManager::Pending() const
+    {
+      util::Lock lock(&m_Mutex);
+      return m_Retired.size();
+    }
+  }  // namespace thread
+}  // namespace llarp
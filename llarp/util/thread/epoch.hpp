@@ -0,0 +1,90 @@
+#ifndef LLARP_UTIL_EPOCH_HPP
+#define LLARP_UTIL_EPOCH_HPP
+
+#include <util/thread/threading.hpp>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// epoch based reclamation for lock free readers
+    ///
+    /// readers hold a Guard while they dereference shared pointers, writers
+    /// unlink objects and hand a deleter to Retire, which is only run once
+    /// every reader that could still see the object has left.
+    class EpochManager
+    {
+     public:
+      /// max readers inside a guard at the same time, more will spin
+      static constexpr size_t MaxReaders = 64;
+
+      struct Guard
+      {
+        explicit Guard(const EpochManager& mgr);
+
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+
+        Guard&
+        operator=(const Guard&) = delete;
+
+       private:
+        const EpochManager& m_Manager;
+        size_t m_Slot;
+      };
+
+      EpochManager() = default;
+
+      /// runs everything still retired
+      ~EpochManager();
+
+      EpochManager(const EpochManager&) = delete;
+
+      EpochManager&
+      operator=(const EpochManager&) = delete;
+
+      /// call deleter once no reader can hold what it frees, must be called
+      /// after the object was made unreachable
+      void
+      Retire(std::function< void(void) > deleter) LOCKS_EXCLUDED(m_Mutex);
+
+      /// run the deleters that are safe to run now
+      void
+      Reclaim() LOCKS_EXCLUDED(m_Mutex);
+
+      /// number of deleters still waiting on readers
+      size_t
+      Pending() const LOCKS_EXCLUDED(m_Mutex);
+
+     private:
+      size_t
+      Enter() const;
+
+      void
+      Exit(size_t slot) const;
+
+      /// padded out to a cache line rather than aligned to one, the manager
+      /// lives in heap objects and C++14 new ignores extended alignment
+      struct Slot
+      {
+        /// epoch the reader in this slot entered at, 0 when free
+        std::atomic< uint64_t > epoch{0};
+        char pad[64 - sizeof(std::atomic< uint64_t >)];
+      };
+
+      mutable std::array< Slot, MaxReaders > m_Slots;
+      std::atomic< uint64_t > m_Epoch{1};
+      mutable util::Mutex m_Mutex;
+      std::vector< std::pair< uint64_t, std::function< void(void) > > >
+          m_Retired GUARDED_BY(m_Mutex);
+    };
+  }  // namespace thread
+}  // namespace llarp
+
+#endif
@@ -7,8 +7,10 @@
 
 namespace llarp
 {
+  constexpr size_t Logic::MaxCallsPerWake;
+
   Logic::Logic(size_t sz)
-      : m_Thread(llarp_init_threadpool(1, "llarp-logic", sz))
+      : m_Thread(llarp_init_threadpool(1, "llarp-logic", sz)), m_Calls("logic")
   {
     llarp_threadpool_start(m_Thread);
     /// set thread id
@@ -31,7 +33,7 @@ namespace llarp
   size_t
   Logic::numPendingJobs() const
   {
-    return m_Thread->pendingJobs();
+    return m_Thread->pendingJobs() + m_Calls.Size();
   }
 
   bool
@@ -50,8 +52,7 @@ namespace llarp
   }
 
   bool
-  Logic::_traceLogicCall(std::function< void(void) > func, const char* tag,
-                         int line)
+  Logic::_traceLogicCall(thread::Task func, const char* tag, int line)
   {
 #define TAG (tag ? tag : LOG_TAG)
 #define LINE (line ? line : __LINE__)
@@ -70,29 +71,27 @@ namespace llarp
 #endif
 
     METRIC("queue");
-    auto f = [self = this, func, tag, line]() {
 #if defined(LOKINET_DEBUG)
+    func = thread::Task([f = std::move(func), tag, line]() mutable {
       metrics::TimerGuard g("logic",
                             std::string(TAG) + ":" + std::to_string(LINE));
+      f();
+    });
 #endif
-      if(self->m_Queue)
-      {
-        func();
-      }
-      else
-      {
-        self->m_Killer.TryAccess(func);
-      }
-    };
     if(can_flush())
     {
       METRIC("fired");
-      f();
+      if(m_Wake)
+        func();
+      else
+        m_Killer.TryAccess([&func]() { func(); });
       return true;
     }
-    if(m_Queue)
+    if(m_Wake)
     {
-      m_Queue(f);
+      // only the first call since the loop last ran needs to wake it
+      if(m_Calls.Push(std::move(func)))
+        m_Wake();
       return true;
     }
     if(m_Thread->LooksFull(5))
@@ -103,7 +102,11 @@ namespace llarp
       METRIC("full");
       std::abort();
     }
-    auto ret = llarp_threadpool_queue_job(m_Thread, f);
+    // the thread pool needs something it can copy
+    auto task = std::make_shared< thread::Task >(std::move(func));
+    auto ret  = llarp_threadpool_queue_job(m_Thread, [self = this, task]() {
+      self->m_Killer.TryAccess([&task]() { (*task)(); });
+    });
     if(not ret)
     {
       METRIC("dropped");
@@ -115,10 +118,25 @@ namespace llarp
   }
 
   void
-  Logic::SetQueuer(std::function< void(std::function< void(void) >) > q)
+  Logic::SetWaker(std::function< void(void) > wake)
+  {
+    m_Wake = std::move(wake);
+    const bool needsWake = m_Calls.Push(
+        [self = this]() { self->m_ID = std::this_thread::get_id(); });
+    if(needsWake)
+      m_Wake();
+  }
+
+  bool
+  Logic::RunQueued()
+  {
+    return m_Calls.Drain(MaxCallsPerWake);
+  }
+
+  void
+  Logic::EnableMetrics()
   {
-    m_Queue = q;
-    m_Queue([self = this]() { self->m_ID = std::this_thread::get_id(); });
+    m_Calls.EnableMetrics();
   }
 
   uint32_t
@@ -3,14 +3,20 @@
 
 #include <ev/ev.hpp>
 #include <util/mem.h>
+#include <util/thread/task_queue.hpp>
 #include <util/thread/threadpool.h>
 #include <absl/types/optional.h>
 
+#include <type_traits>
+
 namespace llarp
 {
   class Logic
   {
    public:
+    /// most queued calls RunQueued runs before giving the event loop back
+    static constexpr size_t MaxCallsPerWake = 256;
+
     Logic(size_t queueLength = size_t{1024 * 8});
 
     ~Logic();
@@ -22,9 +28,21 @@ namespace llarp
     bool
     queue_job(struct llarp_thread_job job);
 
+    /// make the task here where we know what func is so small ones are
+    /// stored inline
+    template < typename Callable,
+               typename = typename std::enable_if< not std::is_same<
+                   typename std::decay< Callable >::type,
+                   thread::Task >::value >::type >
+    bool
+    _traceLogicCall(Callable&& func, const char* filename, int lineo)
+    {
+      return _traceLogicCall(thread::Task(std::forward< Callable >(func)),
+                             filename, lineo);
+    }
+
     bool
-    _traceLogicCall(std::function< void(void) > func, const char* filename,
-                    int lineo);
+    _traceLogicCall(thread::Task func, const char* filename, int lineo);
 
     uint32_t
     call_later(llarp_time_t later, std::function< void(void) > func);
@@ -41,8 +59,21 @@ namespace llarp
     bool
     can_flush() const;
 
+    /// hand calls from other threads to an event loop, which `wake` must
+    /// make call RunQueued on its thread. the loop thread becomes the logic
+    /// thread.
+    void
+    SetWaker(std::function< void(void) > wake);
+
+    /// run calls queued for the event loop, returns true if there are more
+    /// left and it should wake us again
+    bool
+    RunQueued();
+
+    /// publish the call queue's depth and latency under "logic" once the
+    /// default metrics manager exists
     void
-    SetQueuer(std::function< void(std::function< void(void) >) > q);
+    EnableMetrics();
 
     void
     set_event_loop(llarp_ev_loop* loop);
@@ -56,7 +87,8 @@ namespace llarp
     llarp_ev_loop* m_Loop = nullptr;
     absl::optional< ID_t > m_ID;
     util::ContentionKiller m_Killer;
-    std::function< void(std::function< void(void) >) > m_Queue;
+    std::function< void(void) > m_Wake;
+    thread::TaskQueue m_Calls;
   };
 }  // namespace llarp
 
@@ -0,0 +1,215 @@
+#include <util/thread/task_queue.hpp>
+
+#include <util/metrics/sharded.hpp>
+
+namespace llarp
+{
+  namespace thread
+  {
+    constexpr size_t Task::InlineSize;
+
+    /// nodes a thread can reuse. consumers hand spent nodes back through one
+    /// shared stack and a producer that runs out takes all of it at once, so
+    /// nothing but whole list exchanges ever pops it and there is no ABA.
+    struct TaskQueue::NodePool
+    {
+      Node* cached = nullptr;
+
+      ~NodePool()
+      {
+        Free(cached);
+      }
+
+      static void
+      Free(Node* list)
+      {
+        while(list)
+        {
+          Node* node = list;
+          list       = node->next.load(std::memory_order_relaxed);
+          delete node;
+        }
+      }
+
+      /// the calling thread's pool
+      static NodePool&
+      Local()
+      {
+        static thread_local NodePool pool;
+        return pool;
+      }
+
+      static Node*
+      Take()
+      {
+        NodePool& pool = Local();
+        if(pool.cached == nullptr)
+          pool.cached = Returned().head.exchange(nullptr,
+                                                 std::memory_order_acquire);
+        Node* node = pool.cached;
+        if(node == nullptr)
+          return new Node();
+        pool.cached = node->next.load(std::memory_order_relaxed);
+        return node;
+      }
+
+      /// give back a chain of spent nodes from `first` to `last`
+      static void
+      Give(Node* first, Node* last)
+      {
+        auto& head = Returned().head;
+        Node* top  = head.load(std::memory_order_relaxed);
+        do
+        {
+          last->next.store(top, std::memory_order_relaxed);
+        } while(!head.compare_exchange_weak(top, first,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+      }
+
+     private:
+      struct Shared
+      {
+        std::atomic< Node* > head{nullptr};
+
+        ~Shared()
+        {
+          Free(head.load());
+        }
+      };
+
+      static Shared&
+      Returned()
+      {
+        static Shared shared;
+        return shared;
+      }
+    };
+
+    struct TaskQueue::Metrics
+    {
+      metrics::ShardedCounter depth;
+      metrics::ShardedHistogram latency;
+
+      Metrics(string_view category, metrics::Manager* manager)
+          : depth(category, "QueueDepth", manager)
+          , latency(category, "TaskLatency", manager)
+      {
+      }
+    };
+
+    TaskQueue::TaskQueue(string_view category)
+        : m_Head(&m_Stub), m_Tail(&m_Stub), m_Category(category)
+    {
+    }
+
+    TaskQueue::~TaskQueue()
+    {
+      while(Node* node = Pop())
+        delete node;
+      delete m_Metrics.load();
+    }
+
+    void
+    TaskQueue::EnableMetrics(metrics::Manager* manager)
+    {
+      if(m_Metrics.load() || !metrics::DefaultManager::manager(manager))
+        return;
+      auto* made         = new Metrics(m_Category, manager);
+      Metrics* expecting = nullptr;
+      if(!m_Metrics.compare_exchange_strong(expecting, made))
+        delete made;
+    }
+
+    void
+    TaskQueue::Link(Node* node)
+    {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      Node* prev = m_Head.exchange(node, std::memory_order_acq_rel);
+      prev->next.store(node, std::memory_order_release);
+    }
+
+    bool
+    TaskQueue::Push(Task task)
+    {
+      Node* node = NodePool::Take();
+      if(m_Metrics.load(std::memory_order_relaxed))
+        node->queued = std::chrono::steady_clock::now();
+      node->task = std::move(task);
+      // count it before it is visible so the consumer can't take it and
+      // see an empty queue without us waking it
+      const bool wake = m_Size.fetch_add(1, std::memory_order_acq_rel) == 0;
+      Link(node);
+      return wake;
+    }
+
+    TaskQueue::Node*
+    TaskQueue::Pop()
+    {
+      Node* tail = m_Tail;
+      Node* next = tail->next.load(std::memory_order_acquire);
+      if(tail == &m_Stub)
+      {
+        if(next == nullptr)
+          return nullptr;
+        m_Tail = next;
+        tail   = next;
+        next   = next->next.load(std::memory_order_acquire);
+      }
+      if(next)
+      {
+        m_Tail = next;
+        return tail;
+      }
+      // a producer is between taking the head and linking it in
+      if(tail != m_Head.load(std::memory_order_acquire))
+        return nullptr;
+      // tail is the last one, put the stub behind it so we can take it
+      Link(&m_Stub);
+      next = tail->next.load(std::memory_order_acquire);
+      if(next)
+      {
+        m_Tail = next;
+        return tail;
+      }
+      return nullptr;
+    }
+
+    bool
+    TaskQueue::Drain(size_t max)
+    {
+      Metrics* stats = m_Metrics.load(std::memory_order_acquire);
+      if(stats)
+        stats->depth.tick(int(Size()));
+      Node* spent     = nullptr;
+      Node* spentLast = nullptr;
+      for(size_t ran = 0; ran < max; ++ran)
+      {
+        Node* node = Pop();
+        if(node == nullptr)
+          break;
+        // queued before metrics were on
+        if(stats && node->queued != std::chrono::steady_clock::time_point{})
+        {
+          const auto latency = std::chrono::duration_cast<
+              std::chrono::microseconds >(std::chrono::steady_clock::now()
+                                          - node->queued);
+          stats->latency.tick(int(latency.count()));
+        }
+        m_Size.fetch_sub(1, std::memory_order_acq_rel);
+        node->task();
+        node->task   = Task();
+        node->queued = {};
+        node->next.store(spent, std::memory_order_relaxed);
+        if(spent == nullptr)
+          spentLast = node;
+        spent = node;
+      }
+      if(spent)
+        NodePool::Give(spent, spentLast);
+      // also true when the next one isn't linked in yet, the consumer will
+      // come back around for it
+      return Size() > 0;
+    }
+  }  // namespace thread
+}  // namespace llarp
@@ -0,0 +1,264 @@
+#ifndef LLARP_UTIL_THREAD_TASK_QUEUE_HPP
+#define LLARP_UTIL_THREAD_TASK_QUEUE_HPP
+
+#include <util/string_view.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace llarp
+{
+  namespace metrics
+  {
+    class Manager;
+  }  // namespace metrics
+
+  namespace thread
+  {
+    /// a move only nullary callable. callables up to InlineSize bytes, which
+    /// covers lambdas capturing a few pointers or shared_ptrs, are stored in
+    /// place so making a Task doesn't allocate.
+    class Task
+    {
+     public:
+      static constexpr size_t InlineSize = 48;
+
+      template < typename F >
+      struct Fits
+          : std::integral_constant<
+                bool,
+                sizeof(F) <= InlineSize
+                    && alignof(F) <= alignof(std::max_align_t)
+                    && std::is_nothrow_move_constructible< F >::value >
+      {
+      };
+
+      Task() = default;
+
+      template < typename Callable,
+                 typename = typename std::enable_if< not std::is_same<
+                     typename std::decay< Callable >::type,
+                     Task >::value >::type >
+      Task(Callable&& func)
+      {
+        using F = typename std::decay< Callable >::type;
+        Construct< F >(std::forward< Callable >(func), Fits< F >{});
+      }
+
+      Task(Task&& other) noexcept
+      {
+        *this = std::move(other);
+      }
+
+      Task&
+      operator=(Task&& other) noexcept
+      {
+        if(this != &other)
+        {
+          Reset();
+          if(other.m_Ops)
+          {
+            other.m_Ops->move(&other.m_Storage, &m_Storage);
+            m_Ops       = other.m_Ops;
+            other.m_Ops = nullptr;
+          }
+        }
+        return *this;
+      }
+
+      Task(const Task&) = delete;
+
+      Task&
+      operator=(const Task&) = delete;
+
+      ~Task()
+      {
+        Reset();
+      }
+
+      void
+      operator()()
+      {
+        m_Ops->invoke(&m_Storage);
+      }
+
+      explicit operator bool() const
+      {
+        return m_Ops != nullptr;
+      }
+
+     private:
+      struct Ops
+      {
+        void (*invoke)(void*);
+        void (*move)(void* from, void* to);
+        void (*destroy)(void*);
+      };
+
+      template < typename F >
+      struct InlineOps
+      {
+        static void
+        Invoke(void* p)
+        {
+          (*static_cast< F* >(p))();
+        }
+
+        static void
+        Move(void* from, void* to)
+        {
+          new(to) F(std::move(*static_cast< F* >(from)));
+          static_cast< F* >(from)->~F();
+        }
+
+        static void
+        Destroy(void* p)
+        {
+          static_cast< F* >(p)->~F();
+        }
+
+        static const Ops ops;
+      };
+
+      template < typename F >
+      struct HeapOps
+      {
+        static void
+        Invoke(void* p)
+        {
+          (**static_cast< F** >(p))();
+        }
+
+        static void
+        Move(void* from, void* to)
+        {
+          *static_cast< F** >(to) = *static_cast< F** >(from);
+        }
+
+        static void
+        Destroy(void* p)
+        {
+          delete *static_cast< F** >(p);
+        }
+
+        static const Ops ops;
+      };
+
+      template < typename F, typename Callable >
+      void
+      Construct(Callable&& func, std::true_type)
+      {
+        new(&m_Storage) F(std::forward< Callable >(func));
+        m_Ops = &InlineOps< F >::ops;
+      }
+
+      template < typename F, typename Callable >
+      void
+      Construct(Callable&& func, std::false_type)
+      {
+        *reinterpret_cast< F** >(&m_Storage) =
+            new F(std::forward< Callable >(func));
+        m_Ops = &HeapOps< F >::ops;
+      }
+
+      void
+      Reset()
+      {
+        if(m_Ops)
+          m_Ops->destroy(&m_Storage);
+        m_Ops = nullptr;
+      }
+
+      using Storage =
+          std::aligned_storage< InlineSize, alignof(std::max_align_t) >::type;
+
+      Storage m_Storage;
+      const Ops* m_Ops = nullptr;
+    };
+
+    template < typename F >
+    const Task::Ops Task::InlineOps< F >::ops = {&Invoke, &Move, &Destroy};
+
+    template < typename F >
+    const Task::Ops Task::HeapOps< F >::ops = {&Invoke, &Move, &Destroy};
+
+    /// unbounded lock free queue of Tasks with many producers and one consumer
+    /// (an intrusive Vyukov queue), so handing work to a thread never blocks
+    /// or fails. the nodes tasks are linked through are recycled, a producer
+    /// only allocates when its thread has none left over.
+    ///
+    /// Push tells the producer when the queue went from empty to non empty,
+    /// only then does the consumer need a wakeup; a burst of pushes costs one.
+    /// the consumer runs tasks in batches with Drain, and if that leaves tasks
+    /// behind it has to wake itself again.
+    class TaskQueue
+    {
+     public:
+      explicit TaskQueue(string_view category);
+
+      ~TaskQueue();
+
+      TaskQueue(const TaskQueue&) = delete;
+
+      TaskQueue&
+      operator=(const TaskQueue&) = delete;
+
+      /// queue a task from any thread
+      /// returns true if the consumer needs to be woken up for it
+      bool
+      Push(Task task);
+
+      /// run up to `max` queued tasks, consumer thread only
+      /// returns true if there are more left
+      bool
+      Drain(size_t max);
+
+      size_t
+      Size() const
+      {
+        return m_Size.load(std::memory_order_relaxed);
+      }
+
+      /// publish "QueueDepth" and "TaskLatency" (in microseconds) under our
+      /// category to `manager`, or the default one. does nothing without a
+      /// manager, so call it once metrics are set up
+      void
+      EnableMetrics(metrics::Manager* manager = nullptr);
+
+     private:
+      struct Node
+      {
+        std::atomic< Node* > next{nullptr};
+        std::chrono::steady_clock::time_point queued;
+        Task task;
+      };
+
+      struct NodePool;
+      struct Metrics;
+
+      void
+      Link(Node* node);
+
+      Node*
+      Pop();
+
+      std::atomic< Node* > m_Head;
+      std::atomic< size_t > m_Size{0};
+      /// keeps the producers' line away from the consumer's, padded rather
+      /// than aligned so heap allocated owners stay plainly aligned
+      char m_Pad[64];
+      Node* m_Tail;
+      Node m_Stub;
+      const std::string m_Category;
+      /// null until EnableMetrics
+      std::atomic< Metrics* > m_Metrics{nullptr};
+    };
+  }  // namespace thread
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,245 @@
+#include <util/thread/timerwheel.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace llarp
+{
+  namespace thread
+  {
+    static constexpr uint32_t GenerationMask = (uint32_t{1} << 10) - 1;
+
+    constexpr TimerWheel::Handle TimerWheel::INVALID_HANDLE;
+    constexpr uint32_t TimerWheel::NIL;
+
+    TimerWheel::TimerWheel(llarp_time_t now) : m_Now(now)
+    {
+      m_Heads.fill(NIL);
+      m_Counts.fill(0);
+    }
+
+    TimerWheel::Handle
+    TimerWheel::Schedule(llarp_time_t now, llarp_time_t delay,
+                         Callback callback)
+    {
+      util::Lock lock(&m_Mutex);
+      // an idle wheel may not have been advanced in a long time, catch up so
+      // the timer lands in the right level
+      if(m_FreeNodes.size() == m_Nodes.size() && now > m_Now)
+        m_Now = now;
+      const uint32_t idx = AllocNode();
+      if(idx == NIL)
+        return INVALID_HANDLE;
+      auto& node = m_Nodes[idx];
+      // the slot for m_Now was already expired, so the earliest we can fire is
+      // on the next tick
+      node.expiry   = std::max(now + delay, m_Now + 1);
+      node.callback = std::move(callback);
+      node.active   = true;
+      Link(idx);
+      return idx | (uint32_t{node.generation} << IndexBits);
+    }
+
+    bool
+    TimerWheel::Cancel(Handle handle)
+    {
+      const uint32_t idx = handle & ((uint32_t{1} << IndexBits) - 1);
+      const uint32_t gen = handle >> IndexBits;
+      util::Lock lock(&m_Mutex);
+      if(idx >= m_Nodes.size())
+        return false;
+      const auto& node = m_Nodes[idx];
+      if(not node.active || node.generation != gen)
+        return false;
+      Unlink(idx);
+      FreeNode(idx);
+      return true;
+    }
+
+    size_t
+    TimerWheel::Advance(llarp_time_t now, std::vector< Callback >& expired)
+    {
+      const size_t before = expired.size();
+      util::Lock lock(&m_Mutex);
+      while(m_Now < now)
+      {
+        size_t level = 0;
+        while(level < Levels && m_Counts[level] == 0)
+          ++level;
+        if(level == Levels)
+        {
+          // nothing scheduled, just catch up
+          m_Now = now;
+          break;
+        }
+        if(level > 0)
+        {
+          // nothing can expire before the next boundary of the finest
+          // populated level, skip straight to it
+          const llarp_time_t span = llarp_time_t{1} << (LevelBits * level);
+          const llarp_time_t last = m_Now | (span - 1);
+          if(last >= now)
+          {
+            m_Now = now;
+            break;
+          }
+          m_Now = last;
+        }
+        Tick(expired);
+      }
+      return expired.size() - before;
+    }
+
+    llarp_time_t
+    TimerWheel::TimeUntilNext(llarp_time_t now) const
+    {
+      util::Lock lock(&m_Mutex);
+      const llarp_time_t next = NextTick();
+      if(next == std::numeric_limits< llarp_time_t >::max())
+        return next;
+      return next > now ? next - now : 0;
+    }
+
+    size_t
+    TimerWheel::Size() const
+    {
+      util::Lock lock(&m_Mutex);
+      size_t sz = 0;
+      for(const auto count : m_Counts)
+        sz += count;
+      return sz;
+    }
+
+    uint32_t
+    TimerWheel::AllocNode()
+    {
+      if(not m_FreeNodes.empty())
+      {
+        const uint32_t idx = m_FreeNodes.back();
+        m_FreeNodes.pop_back();
+        return idx;
+      }
+      if(m_Nodes.size() >= (size_t{1} << IndexBits))
+        return NIL;
+      m_Nodes.emplace_back();
+      return m_Nodes.size() - 1;
+    }
+
+    void
+    TimerWheel::FreeNode(uint32_t idx)
+    {
+      auto& node      = m_Nodes[idx];
+      node.active     = false;
+      node.callback   = nullptr;
+      node.generation = (node.generation + 1) & GenerationMask;
+      m_FreeNodes.push_back(idx);
+    }
+
+    void
+    TimerWheel::Link(uint32_t idx)
+    {
+      auto& node = m_Nodes[idx];
+      const llarp_time_t maxDelta =
+          (llarp_time_t{1} << (LevelBits * Levels)) - 1;
+      if(node.expiry > m_Now + maxDelta)
+        node.expiry = m_Now + maxDelta;
+      const llarp_time_t delta = node.expiry > m_Now ? node.expiry - m_Now : 0;
+      size_t level             = 0;
+      while(level + 1 < Levels
+            && delta >= (llarp_time_t{1} << (LevelBits * (level + 1))))
+        ++level;
+      const size_t slot = (level * Slots)
+          + ((node.expiry >> (LevelBits * level)) & (Slots - 1));
+      node.slot = slot;
+      node.prev = NIL;
+      node.next = m_Heads[slot];
+      if(node.next != NIL)
+        m_Nodes[node.next].prev = idx;
+      m_Heads[slot] = idx;
+      m_Counts[level]++;
+    }
+
+    void
+    TimerWheel::Unlink(uint32_t idx)
+    {
+      auto& node = m_Nodes[idx];
+      if(node.prev == NIL)
+        m_Heads[node.slot] = node.next;
+      else
+        m_Nodes[node.prev].next = node.next;
+      if(node.next != NIL)
+        m_Nodes[node.next].prev = node.prev;
+      node.prev = NIL;
+      node.next = NIL;
+      m_Counts[node.slot / Slots]--;
+    }
+
+    void
+    TimerWheel::Tick(std::vector< Callback >& expired)
+    {
+      ++m_Now;
+      // cascade every coarse level whose slot boundary we just crossed,
+      // coarsest first so its timers can land in the finer levels below
+      size_t level = 0;
+      while(level + 1 < Levels
+            && (m_Now & ((llarp_time_t{1} << (LevelBits * (level + 1))) - 1))
+                == 0)
+        ++level;
+      for(; level > 0; --level)
+        Cascade(level);
+
+      const size_t slot = m_Now & (Slots - 1);
+      while(m_Heads[slot] != NIL)
+      {
+        const uint32_t idx = m_Heads[slot];
+        Unlink(idx);
+        expired.emplace_back(std::move(m_Nodes[idx].callback));
+        FreeNode(idx);
+      }
+    }
+
+    void
+    TimerWheel::Cascade(size_t level)
+    {
+      const size_t slot = (level * Slots)
+          + ((m_Now >> (LevelBits * level)) & (Slots - 1));
+      uint32_t idx  = m_Heads[slot];
+      m_Heads[slot] = NIL;
+      while(idx != NIL)
+      {
+        const uint32_t next = m_Nodes[idx].next;
+        m_Counts[level]--;
+        Link(idx);
+        idx = next;
+      }
+    }
+
+    llarp_time_t
+    TimerWheel::NextTick() const
+    {
+      llarp_time_t next = std::numeric_limits< llarp_time_t >::max();
+      if(m_Counts[0])
+      {
+        for(llarp_time_t when = m_Now + 1; when < m_Now + Slots; ++when)
+        {
+          if(m_Heads[when & (Slots - 1)] != NIL)
+          {
+            next = when;
+            break;
+          }
+        }
+      }
+      // a coarser level can cascade a timer down that expires before the
+      // nearest one in level 0, so we have to wake up for its boundary too
+      for(size_t level = 1; level < Levels; ++level)
+      {
+        if(m_Counts[level])
+        {
+          const llarp_time_t span = llarp_time_t{1} << (LevelBits * level);
+          next = std::min(next, (m_Now | (span - 1)) + 1);
+        }
+      }
+      return next;
+    }
+  }  // namespace thread
+}  // namespace llarp
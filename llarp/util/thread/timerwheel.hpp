@@ -0,0 +1,115 @@
+#ifndef LLARP_UTIL_TIMERWHEEL_HPP
+#define LLARP_UTIL_TIMERWHEEL_HPP
+
+#include <util/thread/threading.hpp>
+#include <util/types.hpp>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// hashed hierarchical timer wheel with millisecond resolution
+    ///
+    /// timers are kept in intrusive lists hanging off 4 levels of 256 slots,
+    /// so scheduling and cancelling are O(1) and expiry only touches the
+    /// timers that are due plus the occasional cascade from a coarser level.
+    /// timers further out than 2^32 ms are clamped to that.
+    ///
+    /// all members are safe to call from any thread, callbacks are never
+    /// invoked with the internal lock held.
+    class TimerWheel
+    {
+     public:
+      using Callback = std::function< void(void) >;
+      using Handle   = uint32_t;
+
+      static constexpr Handle INVALID_HANDLE = ~Handle{0};
+
+      /// start the wheel at now (in ms)
+      explicit TimerWheel(llarp_time_t now = 0);
+
+      /// schedule callback to run delay ms after now, return its handle
+      Handle
+      Schedule(llarp_time_t now, llarp_time_t delay, Callback callback)
+          LOCKS_EXCLUDED(m_Mutex);
+
+      /// cancel a pending timer, return true if it had not fired yet
+      bool
+      Cancel(Handle handle) LOCKS_EXCLUDED(m_Mutex);
+
+      /// move the wheel forward to now and append the callbacks of all timers
+      /// that expired on the way to expired, return how many were appended.
+      /// timers due on different ms come out in expiry order, timers due on
+      /// the same ms come out in the reverse of the order they were scheduled
+      /// in
+      size_t
+      Advance(llarp_time_t now, std::vector< Callback >& expired)
+          LOCKS_EXCLUDED(m_Mutex);
+
+      /// how long from now the wheel next needs to be advanced: when the
+      /// nearest timer in the finest level expires or a coarser level next
+      /// cascades, whichever comes first. never later than the nearest
+      /// expiry, returns the max llarp_time_t when nothing is scheduled.
+      llarp_time_t
+      TimeUntilNext(llarp_time_t now) const LOCKS_EXCLUDED(m_Mutex);
+
+      /// number of pending timers
+      size_t
+      Size() const LOCKS_EXCLUDED(m_Mutex);
+
+     private:
+      static constexpr size_t LevelBits = 8;
+      static constexpr size_t Slots     = size_t{1} << LevelBits;
+      static constexpr size_t Levels    = 4;
+      static constexpr size_t IndexBits = 22;
+      static constexpr uint32_t NIL     = ~uint32_t{0};
+
+      struct Node
+      {
+        llarp_time_t expiry = 0;
+        uint32_t prev       = NIL;
+        uint32_t next       = NIL;
+        uint16_t generation = 0;
+        uint16_t slot       = 0;
+        bool active         = false;
+        Callback callback;
+      };
+
+      uint32_t
+      AllocNode() EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      void
+      FreeNode(uint32_t idx) EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      void
+      Link(uint32_t idx) EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      void
+      Unlink(uint32_t idx) EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      /// advance by one ms, cascading and expiring as needed
+      void
+      Tick(std::vector< Callback >& expired) EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      /// re-insert every timer in a slot of a coarse level
+      void
+      Cascade(size_t level) EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      llarp_time_t
+      NextTick() const EXCLUSIVE_LOCKS_REQUIRED(m_Mutex);
+
+      mutable util::Mutex m_Mutex;
+      llarp_time_t m_Now GUARDED_BY(m_Mutex);
+      std::vector< Node > m_Nodes GUARDED_BY(m_Mutex);
+      std::vector< uint32_t > m_FreeNodes GUARDED_BY(m_Mutex);
+      std::array< uint32_t, Levels * Slots > m_Heads GUARDED_BY(m_Mutex);
+      std::array< size_t, Levels > m_Counts GUARDED_BY(m_Mutex);
+    };
+  }  // namespace thread
+}  // namespace llarp
+
+#endif
@@ -19,6 +19,8 @@ namespace llarp
                    bool(const llarp_buffer_t &, const llarp_buffer_t &,
                         const SharedSecret &, const byte_t *));
 
+      MOCK_METHOD2(xchacha20_batch, bool(XChaCha20Job *, size_t));
+
       MOCK_METHOD4(dh_client,
                    bool(SharedSecret &, const PubKey &, const SecretKey &,
                         const TunnelNonce &));
@@ -51,6 +53,8 @@ namespace llarp
                    bool(const PubKey &, const llarp_buffer_t &,
                         const Signature &));
 
+      MOCK_METHOD2(verify_batch, bool(VerifyJob *, size_t));
+
       MOCK_METHOD2(seed_to_secretkey,
                    bool(llarp::SecretKey &, const llarp::IdentitySecret &));
 
@@ -1,5 +1,8 @@
 #include <crypto/crypto_libsodium.hpp>
+#include <crypto/ed25519_batch.hpp>
+#include <crypto/xchacha20_avx2.hpp>
 
+#include <chrono>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -67,4 +70,224 @@ namespace llarp
     ASSERT_TRUE(c->pqe_decrypt(block, otherShared, pq_keypair_to_secret(keys)));
     ASSERT_TRUE(otherShared == shared);
   }
+
+  struct XChaCha20BatchTest : public ::testing::TestWithParam< size_t >
+  {
+    llarp::sodium::CryptoLibSodium crypto;
+
+    /// random packets of the sizes we see on paths and a set of hop keys
+    std::vector< std::vector< byte_t > > packets;
+    std::vector< SharedSecret > keys;
+
+    void
+    SetUp()
+    {
+      keys.resize(GetParam());
+      for(auto& key : keys)
+        key.Randomize();
+      for(size_t idx = 0; idx < 64; ++idx)
+      {
+        packets.emplace_back(idx == 0 ? 0 : 1 + (randint() % 1500));
+        crypto.randbytes(packets.back().data(), packets.back().size());
+      }
+    }
+
+    std::vector< XChaCha20Job >
+    MakeJobs(std::vector< std::vector< byte_t > >& bufs, const TunnelNonce& n)
+    {
+      std::vector< XChaCha20Job > jobs;
+      for(auto& buf : bufs)
+      {
+        TunnelNonce nonce = n;
+        for(const auto& key : keys)
+        {
+          jobs.push_back({buf.data(), buf.size(), &key, nonce});
+          nonce.Randomize();
+        }
+      }
+      return jobs;
+    }
+  };
+
+  TEST_P(XChaCha20BatchTest, TestMatchesSingle)
+  {
+    TunnelNonce nonce;
+    nonce.Randomize();
+    auto expected = packets;
+    auto jobs     = MakeJobs(expected, nonce);
+    for(const auto& job : jobs)
+    {
+      const llarp_buffer_t buf(job.buf, job.sz);
+      ASSERT_TRUE(crypto.xchacha20(buf, *job.key, job.nonce));
+    }
+
+    auto batched = packets;
+    auto batch   = jobs;
+    for(size_t idx = 0; idx < batch.size(); ++idx)
+      batch[idx].buf = batched[idx / keys.size()].data();
+    ASSERT_TRUE(crypto.xchacha20_batch(batch.data(), batch.size()));
+    ASSERT_EQ(batched, expected);
+
+    if(sodium::xchacha20_avx2_supported())
+    {
+      auto lanes = packets;
+      for(size_t idx = 0; idx < batch.size(); ++idx)
+        batch[idx].buf = lanes[idx / keys.size()].data();
+      sodium::xchacha20_avx2(batch.data(), batch.size());
+      ASSERT_EQ(lanes, expected);
+    }
+  }
+
+  TEST_P(XChaCha20BatchTest, TestThroughput)
+  {
+    TunnelNonce nonce;
+    nonce.Randomize();
+    auto jobs    = MakeJobs(packets, nonce);
+    size_t bytes = 0;
+    for(const auto& packet : packets)
+      bytes += packet.size();
+    const auto started = std::chrono::steady_clock::now();
+    for(size_t round = 0; round < 32; ++round)
+      ASSERT_TRUE(crypto.xchacha20_batch(jobs.data(), jobs.size()));
+    const std::chrono::duration< double > elapsed =
+        std::chrono::steady_clock::now() - started;
+    const double mbps = (bytes * 32) / (elapsed.count() * 1000 * 1000);
+    RecordProperty("MBps", std::to_string(mbps));
+  }
+
+  INSTANTIATE_TEST_CASE_P(TestCryptoHops, XChaCha20BatchTest,
+                          ::testing::Values(1, 4, 8));
+
+  struct Ed25519BatchTest : public ::testing::TestWithParam< size_t >
+  {
+    llarp::sodium::CryptoLibSodium crypto;
+
+    std::vector< PubKey > keys;
+    std::vector< std::vector< byte_t > > messages;
+    std::vector< Signature > sigs;
+
+    void
+    SetUp()
+    {
+      for(size_t idx = 0; idx < GetParam(); ++idx)
+      {
+        SecretKey secret;
+        crypto.identity_keygen(secret);
+        keys.push_back(secret.toPublic());
+        messages.emplace_back(1 + (randint() % 1024));
+        crypto.randbytes(messages.back().data(), messages.back().size());
+        sigs.emplace_back();
+        const llarp_buffer_t buf(messages.back().data(),
+                                 messages.back().size());
+        ASSERT_TRUE(crypto.sign(sigs.back(), secret, buf));
+      }
+    }
+
+    std::vector< VerifyJob >
+    MakeJobs()
+    {
+      std::vector< VerifyJob > jobs;
+      for(size_t idx = 0; idx < keys.size(); ++idx)
+        jobs.push_back({&keys[idx], messages[idx].data(), messages[idx].size(),
+                        &sigs[idx], false});
+      return jobs;
+    }
+
+    /// batch results must be what verifying each one alone says
+    void
+    CheckMatchesSingle()
+    {
+      auto jobs = MakeJobs();
+      bool all  = true;
+      for(auto& job : jobs)
+      {
+        const llarp_buffer_t buf(job.data, job.size);
+        job.valid = crypto.verify(*job.signer, buf, *job.sig);
+        all &= job.valid;
+      }
+      auto batch = MakeJobs();
+      ASSERT_EQ(crypto.verify_batch(batch.data(), batch.size()), all);
+      for(size_t idx = 0; idx < jobs.size(); ++idx)
+        ASSERT_EQ(batch[idx].valid, jobs[idx].valid) << idx;
+    }
+  };
+
+  TEST_P(Ed25519BatchTest, TestMatchesSingle)
+  {
+    CheckMatchesSingle();
+
+    // flip one bit of the message, R, S or the key of one job at a time
+    for(size_t round = 0; round < 16; ++round)
+    {
+      const size_t idx = randint() % keys.size();
+      byte_t* target   = nullptr;
+      switch(round % 4)
+      {
+        case 0:
+          target = messages[idx].data() + randint() % messages[idx].size();
+          break;
+        case 1:
+          target = sigs[idx].data() + randint() % 32;
+          break;
+        case 2:
+          target = sigs[idx].data() + 32 + randint() % 32;
+          break;
+        default:
+          target = keys[idx].data() + randint() % PubKey::SIZE;
+      }
+      const byte_t bit = 1 << (randint() % 8);
+      *target ^= bit;
+      CheckMatchesSingle();
+      *target ^= bit;
+    }
+  }
+
+  TEST_P(Ed25519BatchTest, TestOddInputs)
+  {
+    // S + L, the same signature but not in canonical form
+    static const byte_t order[32] = {
+        0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+        0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+    unsigned carry = 0;
+    for(size_t idx = 0; idx < 32; ++idx)
+    {
+      carry += sigs[0][32 + idx] + order[idx];
+      sigs[0][32 + idx] = carry & 0xff;
+      carry >>= 8;
+    }
+    CheckMatchesSingle();
+
+    // the identity as a key, it has small order
+    keys.back().Zero();
+    keys.back()[0] = 1;
+    CheckMatchesSingle();
+  }
+
+  TEST_P(Ed25519BatchTest, TestThroughput)
+  {
+    auto jobs = MakeJobs();
+    auto started = std::chrono::steady_clock::now();
+    for(auto& job : jobs)
+    {
+      const llarp_buffer_t buf(job.data, job.size);
+      ASSERT_TRUE(crypto.verify(*job.signer, buf, *job.sig));
+    }
+    const std::chrono::duration< double, std::micro > single =
+        std::chrono::steady_clock::now() - started;
+    started = std::chrono::steady_clock::now();
+    ASSERT_TRUE(crypto.verify_batch(jobs.data(), jobs.size()));
+    const std::chrono::duration< double, std::micro > batched =
+        std::chrono::steady_clock::now() - started;
+    RecordProperty("us_per_sig_single",
+                   std::to_string(single.count() / jobs.size()));
+    RecordProperty("us_per_sig_batched",
+                   std::to_string(batched.count() / jobs.size()));
+    RecordProperty("batch_supported",
+                   sodium::ed25519_verify_batch_supported() ? "1" : "0");
+  }
+
+  INSTANTIATE_TEST_CASE_P(TestCryptoSigs, Ed25519BatchTest,
+                          ::testing::Values(1, 4, 50, 130));
+
 }  // namespace llarp
@@ -0,0 +1,153 @@
+#include <crypto/signature_cache.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <llarp_test.hpp>
+#include <router_contact.hpp>
+#include <util/time.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct SignatureCacheTest : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+  PubKey signer;
+  Signature sig;
+  ShortHash digest;
+
+  SignatureCacheTest()
+  {
+    signer.Randomize();
+    sig.Randomize();
+    digest.Randomize();
+  }
+};
+
+TEST_F(SignatureCacheTest, HitsOnlyExactEntry)
+{
+  SignatureCache cache;
+  ASSERT_FALSE(cache.Check(signer, sig, digest, 0));
+  cache.Add(signer, sig, digest, 1000);
+  ASSERT_TRUE(cache.Check(signer, sig, digest, 0));
+
+  ShortHash otherDigest;
+  otherDigest.Randomize();
+  ASSERT_FALSE(cache.Check(signer, sig, otherDigest, 0));
+  PubKey otherSigner;
+  otherSigner.Randomize();
+  ASSERT_FALSE(cache.Check(otherSigner, sig, digest, 0));
+
+  ASSERT_EQ(cache.Hits(), 1u);
+  ASSERT_EQ(cache.Misses(), 3u);
+}
+
+TEST_F(SignatureCacheTest, Expires)
+{
+  SignatureCache cache;
+  cache.Add(signer, sig, digest, 1000);
+  ASSERT_TRUE(cache.Check(signer, sig, digest, 999));
+  ASSERT_FALSE(cache.Check(signer, sig, digest, 1000));
+  ASSERT_EQ(cache.Size(), 0u);
+}
+
+TEST_F(SignatureCacheTest, Bounded)
+{
+  SignatureCache cache(64);
+  std::vector< std::thread > threads;
+  for(int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&cache, this]() {
+      for(int i = 0; i < 1000; ++i)
+      {
+        Signature other;
+        other.Randomize();
+        cache.Add(signer, other, digest, 1000);
+        cache.Check(signer, other, digest, 0);
+      }
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+  ASSERT_LE(cache.Size(), 64u);
+  ASSERT_EQ(cache.Hits() + cache.Misses(), 4000u);
+}
+
+TEST_F(SignatureCacheTest, RouterContact)
+{
+  SecretKey sign, encr;
+  m_crypto.identity_keygen(sign);
+  m_crypto.encryption_keygen(encr);
+
+  RouterContact rc;
+  rc.enckey = encr.toPublic();
+  rc.pubkey = sign.toPublic();
+  rc.SetNick("cached");
+  ASSERT_TRUE(rc.Sign(sign));
+
+  auto& cache       = RouterContact::VerifyCache();
+  const auto hits   = cache.Hits();
+  const auto misses = cache.Misses();
+  ASSERT_TRUE(rc.Verify(time_now_ms()));
+  ASSERT_EQ(cache.Misses(), misses + 1);
+  ASSERT_TRUE(rc.Verify(time_now_ms()));
+  ASSERT_EQ(cache.Hits(), hits + 1);
+
+  // same signature over different content
+  RouterContact forged = rc;
+  forged.SetNick("forged");
+  ASSERT_FALSE(forged.Verify(time_now_ms()));
+  ASSERT_EQ(cache.Hits(), hits + 1);
+}
+
+TEST_F(SignatureCacheTest, VerifyBatchCost)
+{
+  // a GotRouterMessage reply full of RCs
+  static constexpr size_t NumRCs = 50;
+  std::vector< RouterContact > rcs(NumRCs);
+  for(auto& rc : rcs)
+  {
+    SecretKey sign, encr;
+    m_crypto.identity_keygen(sign);
+    m_crypto.encryption_keygen(encr);
+    rc.enckey = encr.toPublic();
+    rc.pubkey = sign.toPublic();
+    ASSERT_TRUE(rc.Sign(sign));
+  }
+  rcs[7].SetNick("forged");
+
+  const auto took = [](std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+               std::chrono::steady_clock::now() - started)
+        .count();
+  };
+
+  RouterContact::VerifyCache().Clear();
+  auto started = std::chrono::steady_clock::now();
+  size_t good  = 0;
+  for(const auto& rc : rcs)
+    good += rc.Verify(time_now_ms());
+  const auto oneByOne = took(started);
+  ASSERT_EQ(good, NumRCs - 1);
+
+  RouterContact::VerifyCache().Clear();
+  std::vector< char > valid;
+  started = std::chrono::steady_clock::now();
+  ASSERT_EQ(RouterContact::VerifyBatch(rcs, time_now_ms(), valid), NumRCs - 1);
+  const auto batched = took(started);
+  ASSERT_FALSE(valid[7]);
+
+  // the same reply again, say from another peer
+  started = std::chrono::steady_clock::now();
+  ASSERT_EQ(RouterContact::VerifyBatch(rcs, time_now_ms(), valid), NumRCs - 1);
+  const auto cached = took(started);
+
+  RecordProperty("us_per_reply_one_by_one", std::to_string(oneByOne));
+  RecordProperty("us_per_reply_batched", std::to_string(batched));
+  RecordProperty("us_per_reply_cached", std::to_string(cached));
+}
@@ -111,7 +111,7 @@ namespace llarp
 
       MOCK_CONST_METHOD0(pendingExploreLookups, const PendingExploreLookups&());
 
-      MOCK_METHOD0(services, dht::Bucket< dht::ISNode >*());
+      MOCK_METHOD0(services, dht::IntroSetBucket*());
 
       MOCK_CONST_METHOD0(AllowTransit, const bool&());
       MOCK_METHOD0(AllowTransit, bool&());
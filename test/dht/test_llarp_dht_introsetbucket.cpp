@@ -0,0 +1,157 @@
+#include <dht/introsetbucket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct TestDhtIntroSetBucket : public ::testing::Test
+{
+  TestDhtIntroSetBucket() : randInt(0), bucket(us, [&]() { return randInt++; })
+  {
+  }
+
+  /// an introset for a service made up from `n` expiring at `expiresAt`
+  static dht::ISNode
+  MakeNode(uint32_t n, const service::Tag& tag, llarp_time_t expiresAt)
+  {
+    std::array< byte_t, 32 > enc{};
+    std::array< byte_t, 32 > sign{};
+    std::copy_n(reinterpret_cast< const byte_t* >(&n), sizeof(n), enc.begin());
+    sign[0] = 1;
+    service::IntroSet introset;
+    introset.A.Update(enc.data(), sign.data());
+    introset.topic = tag;
+    introset.T     = expiresAt;
+    introset.I.emplace_back();
+    introset.I.back().expiresAt = expiresAt;
+    return dht::ISNode(introset);
+  }
+
+  uint64_t randInt;
+  dht::Key_t us;
+  dht::IntroSetBucket bucket;
+};
+
+TEST_F(TestDhtIntroSetBucket, TagLookup)
+{
+  const service::Tag red("red");
+  const service::Tag blue("blue");
+  for(uint32_t n = 0; n < 10; ++n)
+    bucket.PutNode(MakeNode(n, n % 2 ? red : blue, 1000));
+  ASSERT_EQ(bucket.size(), 10u);
+  ASSERT_EQ(bucket.TagCount(red), 5u);
+  ASSERT_EQ(bucket.TagCount(blue), 5u);
+  ASSERT_EQ(bucket.TagCount(service::Tag("green")), 0u);
+
+  auto found = bucket.GetRandomWithTagExcluding(red, 2, {});
+  ASSERT_EQ(found.size(), 2u);
+  for(const auto& introset : found)
+    ASSERT_EQ(introset.topic, red);
+
+  // everything but what we already have
+  const auto all = bucket.GetRandomWithTagExcluding(red, 10, {});
+  ASSERT_EQ(all.size(), 5u);
+  found = bucket.GetRandomWithTagExcluding(red, 10, found);
+  ASSERT_EQ(found.size(), 3u);
+
+  // republishing under another tag moves it, older ones are ignored
+  bucket.PutNode(MakeNode(1, blue, 2000));
+  bucket.PutNode(MakeNode(3, blue, 500));
+  ASSERT_EQ(bucket.size(), 10u);
+  ASSERT_EQ(bucket.TagCount(red), 4u);
+  ASSERT_EQ(bucket.TagCount(blue), 6u);
+
+  bucket.DelNode(MakeNode(3, red, 0).ID);
+  ASSERT_EQ(bucket.TagCount(red), 3u);
+  ASSERT_EQ(bucket.size(), 9u);
+}
+
+TEST_F(TestDhtIntroSetBucket, Expiry)
+{
+  const service::Tag tag("tag");
+  for(uint32_t n = 0; n < 10; ++n)
+    bucket.PutNode(MakeNode(n, tag, 1000 + n * 100));
+  // a republish that lives longer outlives what was stored before
+  bucket.PutNode(MakeNode(0, tag, 5000));
+
+  bucket.ExpireIntroSets(1000);
+  ASSERT_EQ(bucket.size(), 10u);
+  bucket.ExpireIntroSets(1450);
+  ASSERT_EQ(bucket.size(), 6u);
+  ASSERT_EQ(bucket.TagCount(tag), 6u);
+  for(const auto& item : bucket.Storage())
+    ASSERT_FALSE(item.second.introset.IsExpired(1450));
+  bucket.ExpireIntroSets(4000);
+  ASSERT_EQ(bucket.size(), 1u);
+  bucket.ExpireIntroSets(6000);
+  ASSERT_EQ(bucket.size(), 0u);
+  ASSERT_EQ(bucket.TagCount(tag), 0u);
+}
+
+// timing comparison, 100k introsets, run with
+// --gtest_also_run_disabled_tests
+TEST_F(TestDhtIntroSetBucket, DISABLED_Scale)
+{
+  // tag lookups and cleanup at 100k stored introsets, against scanning
+  // every one of them the way lookups and cleanup used to
+  static constexpr uint32_t Stored  = 100000;
+  static constexpr size_t Lookups   = 10000;
+  static constexpr size_t Cleanups  = 1000;
+  static constexpr size_t ScanTimes = 20;
+
+  const std::array< service::Tag, 4 > tags = {
+      {service::Tag("a"), service::Tag("b"), service::Tag("c"),
+       service::Tag("rare")}};
+  for(uint32_t n = 0; n < Stored; ++n)
+    bucket.PutNode(
+        MakeNode(n, n % 1000 ? tags[n % 3] : tags[3], 1000000 + n));
+  ASSERT_EQ(bucket.size(), Stored);
+
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+  size_t found = 0;
+  auto started = steady_clock::now();
+  for(size_t idx = 0; idx < Lookups; ++idx)
+    found += bucket.GetRandomWithTagExcluding(tags[3], 2, {}).size();
+  const auto indexed = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+  ASSERT_EQ(found, Lookups * 2);
+
+  started = steady_clock::now();
+  for(size_t idx = 0; idx < Cleanups; ++idx)
+    bucket.ExpireIntroSets(1000000 + idx);
+  const auto expired = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+  ASSERT_EQ(bucket.size(), Stored - Cleanups + 1);
+
+  started = steady_clock::now();
+  for(size_t idx = 0; idx < ScanTimes; ++idx)
+  {
+    size_t matched           = 0;
+    const std::string wanted = tags[3].ToString();
+    for(const auto& item : bucket.Storage())
+    {
+      if(item.second.introset.topic.ToString() == wanted)
+        matched++;
+      if(item.second.introset.IsExpired(0))
+        matched++;
+    }
+    ASSERT_GT(matched, 0u);
+  }
+  const auto scanned = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+
+  const auto perSec = [](size_t times, microseconds elapsed) {
+    return std::to_string(times * 1000000.0
+                          / std::max< int64_t >(elapsed.count(), 1));
+  };
+  RecordProperty("introsets", std::to_string(Stored));
+  RecordProperty("tag_lookups_per_sec", perSec(Lookups, indexed));
+  RecordProperty("cleanups_per_sec", perSec(Cleanups, expired));
+  RecordProperty("full_scans_per_sec", perSec(ScanTimes, scanned));
+}
@@ -0,0 +1,553 @@
+#include <dht/routingtable.hpp>
+#include <dht/txholder.hpp>
+#include <util/time.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+using Key_t = dht::Key_t;
+
+static Key_t
+RandomKey(std::mt19937_64& rng)
+{
+  Key_t key;
+  for(size_t idx = 0; idx < Key_t::SIZE; ++idx)
+    key[idx] = rng() & 0xff;
+  return key;
+}
+
+/// keys sorted by distance to `target`
+static std::vector< Key_t >
+SortedByDistance(std::vector< Key_t > keys, const Key_t& target)
+{
+  std::sort(keys.begin(), keys.end(),
+            [&target](const Key_t& left, const Key_t& right) {
+              return (left ^ target) < (right ^ target);
+            });
+  return keys;
+}
+
+struct TestDhtRoutingTable : public ::testing::Test
+{
+  TestDhtRoutingTable() : rng(1234), us(RandomKey(rng)), table(us)
+  {
+  }
+
+  void
+  InsertRandom(size_t count)
+  {
+    while(count--)
+    {
+      keys.emplace_back(RandomKey(rng));
+      ASSERT_TRUE(table.Insert(keys.back()));
+    }
+  }
+
+  std::mt19937_64 rng;
+  Key_t us;
+  dht::RoutingTable table;
+  std::vector< Key_t > keys;
+};
+
+TEST_F(TestDhtRoutingTable, InsertErase)
+{
+  InsertRandom(1000);
+  ASSERT_EQ(table.Size(), 1000u);
+  ASSERT_GT(table.Buckets(), 1000u / dht::RoutingTable::BucketSize);
+  ASSERT_FALSE(table.Insert(keys[0]));
+  for(const auto& key : keys)
+    ASSERT_TRUE(table.Has(key));
+
+  for(size_t idx = 0; idx < keys.size(); idx += 2)
+    ASSERT_TRUE(table.Erase(keys[idx]));
+  ASSERT_FALSE(table.Erase(keys[0]));
+  ASSERT_EQ(table.Size(), 500u);
+  for(size_t idx = 0; idx < keys.size(); ++idx)
+    ASSERT_EQ(table.Has(keys[idx]), idx % 2 == 1);
+
+  // emptied buckets are merged back
+  for(size_t idx = 1; idx < keys.size(); idx += 2)
+    ASSERT_TRUE(table.Erase(keys[idx]));
+  ASSERT_EQ(table.Size(), 0u);
+  ASSERT_EQ(table.Buckets(), 1u);
+
+  InsertRandom(10);
+  table.Clear();
+  ASSERT_EQ(table.Size(), 0u);
+  ASSERT_FALSE(table.Has(keys.back()));
+}
+
+TEST_F(TestDhtRoutingTable, ClosestMatchesScan)
+{
+  InsertRandom(2000);
+  std::vector< Key_t > found;
+  for(size_t round = 0; round < 200; ++round)
+  {
+    const Key_t target = round % 2 ? RandomKey(rng) : keys[round];
+    std::set< Key_t > exclude;
+    while(exclude.size() < round % 5)
+      exclude.insert(keys[rng() % keys.size()]);
+    const size_t N = 1 + round % 16;
+
+    std::vector< Key_t > expected;
+    for(const auto& key : SortedByDistance(keys, target))
+    {
+      if(expected.size() == N)
+        break;
+      if(exclude.count(key) == 0)
+        expected.emplace_back(key);
+    }
+    table.Closest(target, N, exclude, found);
+    ASSERT_EQ(found, expected);
+  }
+  table.Closest(us, 0, {}, found);
+  ASSERT_TRUE(found.empty());
+}
+
+TEST_F(TestDhtRoutingTable, SelectAndRank)
+{
+  InsertRandom(500);
+  const auto sorted = SortedByDistance(keys, us);
+  for(size_t rank = 0; rank < sorted.size(); ++rank)
+  {
+    ASSERT_EQ(table.Select(rank), sorted[rank]);
+    ASSERT_EQ(table.Rank(sorted[rank]), rank);
+  }
+}
+
+TEST_F(TestDhtRoutingTable, Refresh)
+{
+  Key_t target;
+  ASSERT_FALSE(table.Refresh(10, 20, target));
+  InsertRandom(200);
+  // every bucket comes up once, then they are all fresh
+  const size_t buckets = table.Buckets();
+  for(size_t idx = 0; idx < buckets; ++idx)
+    ASSERT_TRUE(table.Refresh(10, 20, target));
+  ASSERT_FALSE(table.Refresh(10, 20, target));
+
+  // a bucket a lookup landed in stays fresh
+  table.Touch(keys[0], 100);
+  size_t stale = 0;
+  while(table.Refresh(50, 60, target))
+    ++stale;
+  ASSERT_EQ(stale, buckets - 1);
+}
+
+// timing comparison, run with --gtest_also_run_disabled_tests
+TEST_F(TestDhtRoutingTable, DISABLED_ClosestVsScan)
+{
+  // finding the closest key by walking buckets against comparing the
+  // distance to every key, the way Bucket used to
+  static constexpr size_t Stored  = 100000;
+  static constexpr size_t Queries = 10000;
+  static constexpr size_t Scans   = 100;
+  InsertRandom(Stored);
+
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+  std::vector< Key_t > found;
+  const std::set< Key_t > exclude;
+  auto started = steady_clock::now();
+  for(size_t idx = 0; idx < Queries; ++idx)
+  {
+    table.Closest(keys[idx] ^ us, 1, exclude, found);
+    ASSERT_EQ(found.size(), 1u);
+  }
+  const auto walked = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+
+  started = steady_clock::now();
+  for(size_t idx = 0; idx < Scans; ++idx)
+  {
+    const Key_t target = keys[idx] ^ us;
+    Key_t mindist;
+    mindist.Fill(0xff);
+    Key_t closest;
+    for(const auto& key : keys)
+    {
+      const auto dist = key ^ target;
+      if(dist < mindist)
+      {
+        mindist = dist;
+        closest = key;
+      }
+    }
+    table.Closest(target, 1, exclude, found);
+    ASSERT_EQ(found[0], closest);
+  }
+  const auto scanned = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+
+  const auto perSec = [](size_t times, microseconds elapsed) {
+    return std::to_string(times * 1000000.0
+                          / std::max< int64_t >(elapsed.count(), 1));
+  };
+  RecordProperty("keys", std::to_string(Stored));
+  RecordProperty("buckets", std::to_string(table.Buckets()));
+  RecordProperty("closest_per_sec", perSec(Queries, walked));
+  RecordProperty("scans_per_sec", perSec(Scans, scanned));
+}
+
+/// a network of nodes that each know their closest peers and others spread
+/// over every prefix length the way filled k-buckets would be, a fraction
+/// of them dead, run in process with simulated latency
+struct SimNetwork
+{
+  static constexpr size_t Closest = 8;
+  static constexpr size_t Spread  = 56;
+
+  using Holder_t = dht::TXHolder< Key_t, Key_t, Key_t::Hash, 5000 >;
+
+  SimNetwork(size_t count, size_t deadPercent, uint64_t seed) : rng(seed)
+  {
+    dht::RoutingTable everyone(Key_t{});
+    while(keys.size() < count)
+    {
+      const Key_t key = RandomKey(rng);
+      if(not everyone.Insert(key))
+        continue;
+      index.emplace(key, keys.size());
+      keys.emplace_back(key);
+      dead.emplace_back(rng() % 100 < deadPercent);
+    }
+    std::vector< Key_t > closest;
+    for(const auto& key : keys)
+    {
+      tables.emplace_back(std::make_unique< dht::RoutingTable >(key));
+      everyone.Closest(key, Closest, {key}, closest);
+      for(const auto& peer : closest)
+        tables.back()->Insert(peer);
+      // the peer closest to a random key sharing the first `shared` bits
+      // with ours
+      for(size_t idx = 0; idx < Spread; ++idx)
+      {
+        const size_t shared = idx % 16;
+        Key_t target        = RandomKey(rng);
+        for(size_t bit = 0; bit < shared; ++bit)
+        {
+          const byte_t mask = 1 << (7 - (bit % 8));
+          target[bit / 8]   = (target[bit / 8] & ~mask) | (key[bit / 8] & mask);
+        }
+        everyone.Closest(target, 1, {key}, closest);
+        tables.back()->Insert(closest[0]);
+      }
+    }
+  }
+
+  size_t
+  RandomAlive()
+  {
+    size_t idx;
+    do
+    {
+      idx = rng() % keys.size();
+    } while(dead[idx]);
+    return idx;
+  }
+
+  llarp_time_t
+  Latency()
+  {
+    return 20 + rng() % 131;
+  }
+
+  void
+  At(llarp_time_t when, std::function< void(void) > event)
+  {
+    events.emplace(when, std::move(event));
+  }
+
+  /// `from` asks `to` for `target`, the reply comes back a round trip
+  /// later, dead nodes never reply
+  void
+  Request(size_t from, const dht::TXOwner& to, const Key_t& target)
+  {
+    const size_t peer = index.at(to.node);
+    if(dead[peer])
+      return;
+    const llarp_time_t arrives = now + Latency() + Latency();
+    if(to.node == target || tables[peer]->Has(target))
+    {
+      At(arrives, [=]() { holder->Found(to, target, {target}); });
+      return;
+    }
+    std::vector< Key_t > closer;
+    tables[peer]->Closest(target, 1, {keys[from]}, closer);
+    if(closer.empty() || not((closer[0] ^ target) < (to.node ^ target)))
+    {
+      At(arrives, [=]() { holder->NotFound(to, nullptr); });
+      return;
+    }
+    const Key_t next = closer[0];
+    At(arrives, [=]() {
+      holder->NotFound(to, std::make_unique< Key_t >(next));
+    });
+  }
+
+  std::mt19937_64 rng;
+  std::vector< Key_t > keys;
+  std::vector< bool > dead;
+  std::vector< std::unique_ptr< dht::RoutingTable > > tables;
+  std::unordered_map< Key_t, size_t, Key_t::Hash > index;
+  std::multimap< llarp_time_t, std::function< void(void) > > events;
+  std::unique_ptr< Holder_t > holder;
+  llarp_time_t now = 0;
+};
+
+constexpr size_t SimNetwork::Closest;
+constexpr size_t SimNetwork::Spread;
+
+/// an iterative lookup from one node of the simulated network
+struct SimLookup final : public dht::TX< Key_t, Key_t >
+{
+  SimLookup(SimNetwork& network, size_t origin, const Key_t& target,
+            size_t alpha, bool& done, bool& found)
+      : dht::TX< Key_t, Key_t >(dht::TXOwner(network.keys[origin], 1), target,
+                                nullptr)
+      , net(network)
+      , from(origin)
+      , parallelism(alpha)
+      , isDone(done)
+      , isFound(found)
+  {
+    peersAsked.insert(network.keys[origin]);
+  }
+
+  bool
+  Validate(const Key_t& value) const override
+  {
+    return value == target;
+  }
+
+  size_t
+  Parallelism() const override
+  {
+    return parallelism;
+  }
+
+  void
+  Start(const dht::TXOwner& peer) override
+  {
+    net.Request(from, peer, target);
+  }
+
+  bool
+  GetNextPeer(Key_t& next, const std::set< Key_t >& exclude) override
+  {
+    std::vector< Key_t > closest;
+    net.tables[from]->Closest(target, 1, exclude, closest);
+    if(closest.empty())
+      return false;
+    next = closest[0];
+    return true;
+  }
+
+  void
+  DoNextRequest(const Key_t& peer) override
+  {
+    Start(dht::TXOwner(peer, whoasked.txid));
+  }
+
+  void
+  SendReply() override
+  {
+    isDone  = true;
+    isFound = not valuesFound.empty();
+  }
+
+  SimNetwork& net;
+  const size_t from;
+  const size_t parallelism;
+  bool& isDone;
+  bool& isFound;
+};
+
+// 10k node simulation, run with --gtest_also_run_disabled_tests
+TEST(TestDhtLookupSimulation, DISABLED_ParallelLookups)
+{
+  // the same lookups on a 10k node network with a tenth of it gone,
+  // asking one peer at a time against asking LookupAlpha at once
+  static constexpr size_t Nodes   = 10000;
+  static constexpr size_t Lookups = 2000;
+  SimNetwork net(Nodes, 10, 5678);
+
+  struct Result
+  {
+    double mean;
+    llarp_time_t p99;
+    double success;
+  };
+  const auto run = [&net](size_t alpha, uint64_t seed) -> Result {
+    net.rng.seed(seed);
+    std::vector< llarp_time_t > latencies;
+    size_t succeeded = 0;
+    for(size_t idx = 0; idx < Lookups; ++idx)
+    {
+      const size_t origin = net.RandomAlive();
+      size_t owner;
+      do
+      {
+        owner = net.RandomAlive();
+      } while(owner == origin);
+      const Key_t target = net.keys[owner];
+      std::vector< Key_t > first;
+      net.tables[origin]->Closest(target, 1, {}, first);
+
+      bool done  = false;
+      bool found = false;
+      net.now    = 0;
+      net.events.clear();
+      net.holder = std::make_unique< SimNetwork::Holder_t >();
+      const llarp_time_t started = time_now_ms();
+      net.holder->NewTX(
+          dht::TXOwner(first[0], idx + 1),
+          dht::TXOwner(net.keys[origin], idx + 1), target,
+          new SimLookup(net, origin, target, alpha, done, found));
+
+      // lookups that stall on dead peers give up when the holder expires
+      // them, which it is given a chance to do every simulated second
+      std::function< void(void) > tick = [&]() {
+        net.holder->Expire(started + net.now);
+        if(not done)
+          net.At(net.now + 1000, tick);
+      };
+      net.At(1000, tick);
+      while(not done && not net.events.empty())
+      {
+        auto itr = net.events.begin();
+        net.now  = itr->first;
+        auto event = std::move(itr->second);
+        net.events.erase(itr);
+        event();
+      }
+      EXPECT_TRUE(done);
+      latencies.emplace_back(net.now);
+      if(found)
+        ++succeeded;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for(const auto latency : latencies)
+      total += latency;
+    return {total / latencies.size(), latencies[latencies.size() * 99 / 100],
+            double(succeeded) / Lookups};
+  };
+
+  const Result single   = run(1, 42);
+  const Result parallel = run(dht::LookupAlpha, 42);
+
+  RecordProperty("nodes", std::to_string(Nodes));
+  RecordProperty("lookups", std::to_string(Lookups));
+  RecordProperty("alpha_1_mean_ms", std::to_string(single.mean));
+  RecordProperty("alpha_1_p99_ms", std::to_string(single.p99));
+  RecordProperty("alpha_1_success", std::to_string(single.success));
+  RecordProperty("alpha_3_mean_ms", std::to_string(parallel.mean));
+  RecordProperty("alpha_3_p99_ms", std::to_string(parallel.p99));
+  RecordProperty("alpha_3_success", std::to_string(parallel.success));
+
+  ASSERT_GT(single.success, 0.5);
+  ASSERT_GE(parallel.success, single.success);
+  ASSERT_LT(parallel.mean, single.mean);
+  ASSERT_LT(parallel.p99, single.p99);
+}
+
+/// a lookup that knows a fixed set of peers and records who it asks
+struct ScriptedLookup final : public dht::TX< Key_t, Key_t >
+{
+  ScriptedLookup(const Key_t& us, const Key_t& target,
+                 std::vector< Key_t > peers, std::vector< Key_t >& askedPeers,
+                 bool& done)
+      : dht::TX< Key_t, Key_t >(dht::TXOwner(us, 1), target, nullptr)
+      , known(SortedByDistance(std::move(peers), target))
+      , asked(askedPeers)
+      , isDone(done)
+  {
+  }
+
+  bool
+  Validate(const Key_t& value) const override
+  {
+    return value == target;
+  }
+
+  size_t
+  Parallelism() const override
+  {
+    return 1;
+  }
+
+  void
+  Start(const dht::TXOwner& peer) override
+  {
+    asked.emplace_back(peer.node);
+  }
+
+  bool
+  GetNextPeer(Key_t& next, const std::set< Key_t >& exclude) override
+  {
+    for(const auto& peer : known)
+    {
+      if(exclude.count(peer) == 0)
+      {
+        next = peer;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void
+  DoNextRequest(const Key_t&) override
+  {
+  }
+
+  void
+  SendReply() override
+  {
+    isDone = true;
+  }
+
+  const std::vector< Key_t > known;
+  std::vector< Key_t >& asked;
+  bool& isDone;
+};
+
+TEST(TestDhtLookupSimulation, StopsAtClosestAnswered)
+{
+  const auto key = [](byte_t first) {
+    Key_t k;
+    k.Zero();
+    k[0] = first;
+    return k;
+  };
+  const Key_t target = key(0);
+  std::vector< Key_t > asked;
+  bool done = false;
+  dht::TXHolder< Key_t, Key_t, Key_t::Hash > holder;
+  holder.NewTX(dht::TXOwner(key(0x10), 1), dht::TXOwner(key(0xff), 1),
+               target,
+               new ScriptedLookup(key(0xff), target,
+                                  {key(0x08), key(0x20), key(0x30)}, asked,
+                                  done));
+  // a hint further from the target than who gave it is not followed
+  holder.NotFound(dht::TXOwner(key(0x10), 1),
+                  std::make_unique< Key_t >(key(0x40)));
+  ASSERT_FALSE(done);
+  // nobody left that is closer than the closest one that answered
+  holder.NotFound(dht::TXOwner(key(0x08), 1), nullptr);
+  ASSERT_TRUE(done);
+  const std::vector< Key_t > expected = {key(0x10), key(0x08)};
+  ASSERT_EQ(asked, expected);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <dns/cache.hpp>
+#include <dns/dns.hpp>
+#include <dns/message.hpp>
+#include <net/ip.hpp>
+#include <net/net.hpp>
+#include <util/endian.hpp>
+
+using namespace llarp;
+using namespace llarp::dns;
+
+struct DNSCacheTest : public ::testing::Test
+{
+  static Message
+  Query(const std::string& name, QType_t qtype = qTypeA)
+  {
+    MessageHeader hdr;
+    hdr.id       = 0x1234;
+    hdr.fields   = flags_RD;
+    hdr.qd_count = 1;
+    hdr.an_count = 0;
+    hdr.ns_count = 0;
+    hdr.ar_count = 0;
+    Message msg(hdr);
+    msg.questions[0].qname  = name;
+    msg.questions[0].qtype  = qtype;
+    msg.questions[0].qclass = qClassIN;
+    return msg;
+  }
+
+  static Cache::Buffer_t
+  Encode(const Message& msg)
+  {
+    std::array< byte_t, 1500 > tmp = {{0}};
+    llarp_buffer_t buf(tmp);
+    EXPECT_TRUE(msg.Encode(&buf));
+    return Cache::Buffer_t(buf.base, buf.cur);
+  }
+
+  /// nxdomain with an soa in the authority section
+  static Message
+  NXReply(const std::string& name, RR_TTL_t ttl, RR_TTL_t minimum)
+  {
+    auto msg = Query(name);
+    msg.AddNXReply();
+    ResourceRecord soa;
+    soa.rr_name  = "loki.";
+    soa.rr_type  = qTypeSOA;
+    soa.rr_class = qClassIN;
+    soa.ttl      = ttl;
+    std::array< byte_t, 128 > tmp = {{0}};
+    llarp_buffer_t buf(tmp);
+    EXPECT_TRUE(EncodeName(&buf, "ns.loki."));
+    EXPECT_TRUE(EncodeName(&buf, "admin.loki."));
+    for(const uint32_t field : {1u, 2u, 3u, 4u, minimum})
+      EXPECT_TRUE(buf.put_uint32(field));
+    soa.rData.assign(buf.base, buf.cur);
+    msg.authorities.emplace_back(std::move(soa));
+    return msg;
+  }
+
+  static RR_TTL_t
+  AnswerTTL(const Cache::Buffer_t& reply)
+  {
+    Cache::Buffer_t copy = reply;
+    llarp_buffer_t buf(copy);
+    MessageHeader hdr;
+    EXPECT_TRUE(hdr.Decode(&buf));
+    Message msg(hdr);
+    EXPECT_TRUE(msg.Decode(&buf));
+    EXPECT_FALSE(msg.answers.empty());
+    return msg.answers.empty() ? 0 : msg.answers[0].ttl;
+  }
+};
+
+TEST_F(DNSCacheTest, CountsDownTTL)
+{
+  Cache cache;
+  auto reply = Query("example.com.");
+  reply.AddINReply(net::IPPacket::ExpandV4(ipaddr_ipv4_bits(1, 2, 3, 4)),
+                   false, 60);
+  const auto key = Cache::Key(reply.questions[0]);
+  ASSERT_EQ(key, Cache::Key(Query("EXAMPLE.com.").questions[0]));
+  ASSERT_NE(key, Cache::Key(Query("example.com.", qTypeAAAA).questions[0]));
+
+  Cache::Buffer_t got;
+  bool prefetch = false;
+  ASSERT_FALSE(cache.Get(key, 1, 1000, got, prefetch));
+  ASSERT_TRUE(cache.Put(key, Encode(reply), 1000));
+
+  ASSERT_TRUE(cache.Get(key, 0xbeef, 11000, got, prefetch));
+  ASSERT_FALSE(prefetch);
+  ASSERT_EQ(0xbeef, bufbe16toh(got.data()));
+  ASSERT_EQ(50u, AnswerTTL(got));
+
+  // the second hit close to expiry asks for a refresh, only once
+  ASSERT_TRUE(cache.Get(key, 1, 56000, got, prefetch));
+  ASSERT_TRUE(prefetch);
+  ASSERT_EQ(5u, AnswerTTL(got));
+  ASSERT_TRUE(cache.Get(key, 1, 57000, got, prefetch));
+  ASSERT_FALSE(prefetch);
+
+  ASSERT_FALSE(cache.Get(key, 1, 61000, got, prefetch));
+  ASSERT_EQ(0u, cache.Size());
+}
+
+TEST_F(DNSCacheTest, NegativeCaching)
+{
+  Cache cache;
+  const auto key = Cache::Key(Query("nope.loki.").questions[0]);
+  // no soa, nothing to take a negative ttl from
+  auto bare = Query("nope.loki.");
+  bare.AddNXReply();
+  ASSERT_FALSE(cache.Put(key, Encode(bare), 0));
+
+  // the smaller of the soa ttl and its minimum
+  ASSERT_TRUE(cache.Put(key, Encode(NXReply("nope.loki.", 600, 30)), 0));
+  Cache::Buffer_t got;
+  bool prefetch = false;
+  ASSERT_TRUE(cache.Get(key, 1, 29000, got, prefetch));
+  ASSERT_EQ(flags_RCODENameError,
+            bufbe16toh(got.data() + 2) & flags_RCODEMask);
+  ASSERT_FALSE(cache.Get(key, 1, 30000, got, prefetch));
+
+  // capped no matter what the zone says
+  ASSERT_TRUE(
+      cache.Put(key, Encode(NXReply("nope.loki.", 86400, 86400)), 0));
+  ASSERT_TRUE(
+      cache.Get(key, 1, Cache::MaxNegativeTTL * 1000 - 1, got, prefetch));
+  ASSERT_FALSE(
+      cache.Get(key, 1, Cache::MaxNegativeTTL * 1000, got, prefetch));
+
+  // servfail is never cached
+  auto fail = Query("nope.loki.");
+  fail.AddServFail();
+  ASSERT_FALSE(cache.Put(key, Encode(fail), 0));
+}
+
+TEST_F(DNSCacheTest, BoundedSize)
+{
+  Cache cache(Cache::NumShards * 4);
+  for(size_t idx = 0; idx < 1000; ++idx)
+  {
+    auto reply = Query("host" + std::to_string(idx) + ".example.com.");
+    reply.AddINReply(net::IPPacket::ExpandV4(ipaddr_ipv4_bits(1, 2, 3, 4)),
+                     false, 60);
+    ASSERT_TRUE(cache.Put(Cache::Key(reply.questions[0]), Encode(reply), 0));
+    ASSERT_LE(cache.Size(), Cache::NumShards * 4);
+  }
+  // the most recent one is still there
+  Cache::Buffer_t got;
+  bool prefetch = false;
+  ASSERT_TRUE(cache.Get(
+      Cache::Key(Query("host999.example.com.").questions[0]), 1, 0, got,
+      prefetch));
+  const auto status = cache.ExtractStatus();
+  ASSERT_EQ(1u, status["hits"].get< uint64_t >());
+}
@@ -0,0 +1,51 @@
+#ifndef TEST_LLARP_LINK_MOCK_LINK_SESSION
+#define TEST_LLARP_LINK_MOCK_LINK_SESSION
+
+#include <link/session.hpp>
+
+#include <gmock/gmock.h>
+
+namespace llarp
+{
+  namespace test
+  {
+    struct MockLinkSession final : public ILinkSession
+    {
+      MOCK_METHOD0(BorrowSelf, std::shared_ptr< ILinkSession >());
+
+      MOCK_METHOD0(Pump, void());
+
+      MOCK_METHOD1(Tick, void(llarp_time_t));
+
+      MOCK_METHOD2(SendMessageBuffer, bool(Message_t, CompletionHandler));
+
+      MOCK_METHOD0(Start, void());
+
+      MOCK_METHOD0(Close, void());
+
+      MOCK_METHOD0(SendKeepAlive, bool());
+
+      MOCK_CONST_METHOD0(IsEstablished, bool());
+
+      MOCK_CONST_METHOD1(TimedOut, bool(llarp_time_t));
+
+      MOCK_CONST_METHOD0(GetPubKey, PubKey());
+
+      MOCK_CONST_METHOD0(GetRemoteEndpoint, Addr());
+
+      MOCK_CONST_METHOD0(GetRemoteRC, RouterContact());
+
+      MOCK_CONST_METHOD0(SendQueueBacklog, size_t());
+
+      MOCK_CONST_METHOD0(GetLinkLayer, ILinkLayer*());
+
+      MOCK_METHOD0(RenegotiateSession, bool());
+
+      MOCK_CONST_METHOD0(ShouldPing, bool());
+
+      MOCK_CONST_METHOD0(ExtractStatus, util::StatusObject());
+    };
+  }  // namespace test
+}  // namespace llarp
+
+#endif
@@ -3,6 +3,7 @@
 #include <iwp/iwp.hpp>
 #include <llarp_test.hpp>
 #include <iwp/iwp.hpp>
+#include <iwp/session.hpp>
 #include <memory>
 #include <messages/link_intro.hpp>
 #include <messages/discard.hpp>
@@ -11,9 +12,89 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <random>
+
 using namespace ::llarp;
 using namespace ::testing;
 
+/// forwards datagrams between a front port and a fixed back peer through a
+/// bottleneck that serializes, delays and randomly drops them, both ways
+struct LossyRelay
+{
+  /// bottleneck rate in bytes per ms
+  size_t rate = 1000;
+  /// one way propagation delay
+  llarp_time_t delay = 40;
+  /// datagrams that would wait longer than this for the bottleneck are dropped
+  llarp_time_t maxQueue = 50;
+  /// chance a datagram is lost on the wire
+  double loss = 0.01;
+
+  llarp_ev_loop_ptr loop;
+  llarp_udp_io front{};
+  llarp_udp_io back{};
+  Addr frontPeer;
+  Addr backPeer;
+  std::mt19937 rng{1234};
+
+  struct Bottleneck
+  {
+    llarp_time_t freeAt = 0;
+  } toBack, toFront;
+
+  bool
+  Start(llarp_ev_loop_ptr ev, uint16_t frontPort, uint16_t backPort,
+        const Addr& peer)
+  {
+    loop     = ev;
+    backPeer = peer;
+    for(auto* udp : {&front, &back})
+    {
+      udp->user     = this;
+      udp->tick     = nullptr;
+      udp->recvfrom = &LossyRelay::OnRecv;
+    }
+    const Addr frontAddr(127, 0, 0, 1, frontPort);
+    const Addr backAddr(127, 0, 0, 1, backPort);
+    return llarp_ev_add_udp(loop.get(), &front, frontAddr) != -1
+        && llarp_ev_add_udp(loop.get(), &back, backAddr) != -1;
+  }
+
+  static void
+  OnRecv(llarp_udp_io* udp, const sockaddr* from, ManagedBuffer buf)
+  {
+    auto* self = static_cast< LossyRelay* >(udp->user);
+    if(udp == &self->front)
+    {
+      self->frontPeer = Addr(*from);
+      self->Forward(self->toBack, &self->back, self->backPeer, buf.underlying);
+    }
+    else
+      self->Forward(self->toFront, &self->front, self->frontPeer,
+                    buf.underlying);
+  }
+
+  void
+  Forward(Bottleneck& link, llarp_udp_io* out, Addr to,
+          const llarp_buffer_t& pkt)
+  {
+    const auto now    = loop->time_now();
+    const auto start  = std::max(now, link.freeAt);
+    const auto depart = start + (pkt.sz + rate - 1) / rate;
+    if(depart - now > maxQueue)
+      return;
+    link.freeAt = depart;
+    if(std::uniform_real_distribution< double >(0, 1)(rng) < loss)
+      return;
+    std::vector< byte_t > data(pkt.base, pkt.base + pkt.sz);
+    loop->call_after_delay(depart - now + delay, [out, to, data]() {
+      const llarp_buffer_t buf(data);
+      llarp_ev_udp_sendto(out, to, buf);
+    });
+  }
+};
+
 struct LinkLayerTest : public test::LlarpTest< llarp::sodium::CryptoLibSodium >
 {
   static constexpr uint16_t AlicePort = 41163;
@@ -49,6 +130,10 @@ struct LinkLayerTest : public test::LlarpTest< llarp::sodium::CryptoLibSodium >
 
     bool madeSession = false;
     bool gotLIM      = false;
+    bool batchedIO   = false;
+    size_t shards    = 1;
+    /// sockets the link actually spread its io over
+    size_t boundShards = 0;
 
     bool
     IsGucci() const
@@ -93,8 +178,11 @@ struct LinkLayerTest : public test::LlarpTest< llarp::sodium::CryptoLibSodium >
     {
       if(!link)
         return false;
+      link->SetBatchedIO(batchedIO);
+      link->SetShards(shards);
       if(!link->Configure(loop, localLoopBack(), AF_INET, port))
         return false;
+      boundShards = link->NumShards();
       /*
        * TODO: ephemeral key management
       if(!link->GenEphemeralKeys())
@@ -186,145 +274,408 @@ struct LinkLayerTest : public test::LlarpTest< llarp::sodium::CryptoLibSodium >
     llarp_ev_loop_stop(netLoop);
     m_logic->stop();
   }
-};
 
-TEST_F(LinkLayerTest, TestIWP)
-{
-#ifdef WIN32
-  GTEST_SKIP();
-#else
-  auto sendDiscardMessage = [](ILinkSession* s, auto callback) -> bool {
-    // send discard message in reply to complete unit test
-    std::vector< byte_t > tmp(32);
-    llarp_buffer_t otherBuf(tmp);
-    DiscardMessage discard;
-    if(!discard.BEncode(&otherBuf))
-      return false;
-    return s->SendMessageBuffer(std::move(tmp), callback);
+  /// what a transfer over a LossyRelay achieved
+  struct LossyResult
+  {
+    size_t delivered     = 0;
+    size_t dropped       = 0;
+    llarp_time_t spent   = 0;
+    uint64_t txFragments = 0;
+    uint64_t retransmits = 0;
+
+    double
+    Goodput() const
+    {
+      return spent ? double(delivered * MessageSize) / spent : 0;
+    }
+
+    double
+    RetransmitRatio() const
+    {
+      return txFragments ? double(retransmits) / txFragments : 0;
+    }
   };
-  Alice.link = iwp::NewInboundLink(
-      // KeyManager
-      Alice.keyManager,
 
-      // GetRCFunc
-      [&]() -> const RouterContact& { return Alice.GetRC(); },
+  static constexpr size_t MessageSize      = 4000;
+  static constexpr size_t NumMessages      = 200;
+  static constexpr size_t MessagesInFlight = 16;
+  static constexpr uint16_t RelayFrontPort = 41200;
+  static constexpr uint16_t RelayBackPort  = 41201;
 
-      // LinkMessageHandler
-      [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
-        llarp_buffer_t copy(buf.base, buf.sz);
-        if(not Alice.gotLIM)
-        {
+  /// have alice push NumMessages at bob through a lossy relay, keeping
+  /// MessagesInFlight outstanding like an upper layer would
+  LossyResult
+  RunLossy(iwp::CongestionControlFactory cc)
+  {
+    LossyResult result;
+    LossyRelay relay;
+    std::shared_ptr< ILinkSession > session;
+    size_t queued          = 0;
+    size_t done            = 0;
+    llarp_time_t startedAt = 0;
+    std::function< void(void) > sendMore;
+    auto onDone = [&](ILinkSession::DeliveryStatus status) {
+      done++;
+      if(status == ILinkSession::DeliveryStatus::eDeliveryDropped)
+        result.dropped++;
+      if(done < NumMessages)
+      {
+        sendMore();
+        return;
+      }
+      const auto stats   = session->ExtractStatus();
+      result.spent       = netLoop->time_now() - startedAt;
+      result.txFragments = stats["txFragments"];
+      result.retransmits = stats["retransmits"];
+      Stop();
+    };
+    sendMore = [&]() {
+      while(queued < NumMessages && queued - done < MessagesInFlight)
+      {
+        ILinkSession::Message_t msg(MessageSize);
+        std::fill(msg.begin(), msg.end(), 'x');
+        if(not session->SendMessageBuffer(std::move(msg), onDone))
+          return;
+        queued++;
+      }
+    };
+
+    auto alice = iwp::NewInboundLink(
+        Alice.keyManager,
+        [&]() -> const RouterContact& { return Alice.GetRC(); },
+        [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
+          llarp_buffer_t copy(buf.base, buf.sz);
           LinkIntroMessage msg;
           if(msg.BDecode(&copy))
-          {
             Alice.gotLIM = s->GotLIM(&msg);
+          return Alice.gotLIM;
+        },
+        [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
+          return m_crypto.sign(sig, Alice.keyManager->identityKey, buf);
+        },
+        [&](ILinkSession* s) -> bool {
+          Alice.madeSession = true;
+          session           = s->BorrowSelf();
+          startedAt         = netLoop->time_now();
+          sendMore();
+          return true;
+        },
+        [](RouterContact, RouterContact) -> bool { return true; },
+        [&](ILinkSession*) { Stop(); }, [](RouterID) {}, []() {});
+    alice->SetCongestionControl(cc);
+    Alice.link = alice;
+
+    Bob.link = iwp::NewInboundLink(
+        Bob.keyManager, [&]() -> const RouterContact& { return Bob.GetRC(); },
+        [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
+          if(Bob.gotLIM)
+          {
+            if(buf.sz == MessageSize)
+              result.delivered++;
+            return true;
           }
-        }
-        return Alice.gotLIM;
-      },
+          llarp_buffer_t copy(buf.base, buf.sz);
+          LinkIntroMessage msg;
+          if(msg.BDecode(&copy))
+            Bob.gotLIM = s->GotLIM(&msg);
+          return Bob.gotLIM;
+        },
+        [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
+          return m_crypto.sign(sig, Bob.keyManager->identityKey, buf);
+        },
+        [&](ILinkSession*) -> bool {
+          Bob.madeSession = true;
+          return true;
+        },
+        [](RouterContact, RouterContact) -> bool { return true; },
+        [](ILinkSession*) {}, [](RouterID) {}, []() {});
+
+    // the relay delays datagrams on the loop's timers which fire into logic
+    m_logic->set_event_loop(netLoop.get());
+    netLoop->set_logic(m_logic);
+    EXPECT_TRUE(Alice.Start(m_logic, netLoop, AlicePort));
+    EXPECT_TRUE(Bob.Start(m_logic, netLoop, BobPort));
+    EXPECT_TRUE(relay.Start(netLoop, RelayFrontPort, RelayBackPort,
+                            Addr(127, 0, 0, 1, BobPort)));
+    // alice dials bob through the relay
+    RouterContact viaRelay = Bob.GetRC();
+    viaRelay.addrs[0].port = RelayFrontPort;
+    LogicCall(m_logic, [&]() { Alice.link->TryEstablishTo(viaRelay); });
+
+    m_logic->call_later(20000, std::bind(&LinkLayerTest::Stop, this));
+    llarp_ev_loop_run_single_process(netLoop, m_logic);
+    session.reset();
+    return result;
+  }
 
-      // SignBufferFunc
-      [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
-        return m_crypto.sign(sig, Alice.keyManager->identityKey, buf);
-      },
+  /// get ready for another run in the same test
+  void
+  Reset()
+  {
+    Alice.TearDown();
+    Bob.TearDown();
+    Alice = Context();
+    Bob   = Context();
+    Alice.Setup();
+    Bob.Setup();
+    netLoop = llarp_make_ev_loop();
+    m_logic.reset(new Logic());
+  }
 
-      // SessionEstablishedHandler
-      [&, this](ILinkSession* s) -> bool {
-        const auto rc = s->GetRemoteRC();
-        if(rc.pubkey != Bob.GetRC().pubkey)
-          return false;
-        LogInfo("alice established with bob");
-        Alice.madeSession = true;
-        sendDiscardMessage(s, [&](auto status) {
-          success =
-              status == llarp::ILinkSession::DeliveryStatus::eDeliverySuccess;
-          LogInfo("message sent to bob suceess=", success);
-          this->Stop();
-        });
-        return true;
-      },
+  void
+  RunIWP()
+  {
+    auto sendDiscardMessage = [](ILinkSession* s, auto callback) -> bool {
+      // send discard message in reply to complete unit test
+      ILinkSession::Message_t tmp(32);
+      llarp_buffer_t otherBuf(tmp);
+      DiscardMessage discard;
+      if(!discard.BEncode(&otherBuf))
+        return false;
+      tmp.resize(otherBuf.cur - otherBuf.base);
+      return s->SendMessageBuffer(std::move(tmp), callback);
+    };
+    Alice.link = iwp::NewInboundLink(
+        // KeyManager
+        Alice.keyManager,
+
+        // GetRCFunc
+        [&]() -> const RouterContact& { return Alice.GetRC(); },
+
+        // LinkMessageHandler
+        [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
+          llarp_buffer_t copy(buf.base, buf.sz);
+          if(not Alice.gotLIM)
+          {
+            LinkIntroMessage msg;
+            if(msg.BDecode(&copy))
+            {
+              Alice.gotLIM = s->GotLIM(&msg);
+            }
+          }
+          return Alice.gotLIM;
+        },
+
+        // SignBufferFunc
+        [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
+          return m_crypto.sign(sig, Alice.keyManager->identityKey, buf);
+        },
+
+        // SessionEstablishedHandler
+        [&, this](ILinkSession* s) -> bool {
+          const auto rc = s->GetRemoteRC();
+          if(rc.pubkey != Bob.GetRC().pubkey)
+            return false;
+          LogInfo("alice established with bob");
+          Alice.madeSession = true;
+          sendDiscardMessage(s, [&](auto status) {
+            success =
+                status == llarp::ILinkSession::DeliveryStatus::eDeliverySuccess;
+            LogInfo("message sent to bob suceess=", success);
+            this->Stop();
+          });
+          return true;
+        },
 
-      // SessionRenegotiateHandler
-      [&](RouterContact, RouterContact) -> bool { return true; },
+        // SessionRenegotiateHandler
+        [&](RouterContact, RouterContact) -> bool { return true; },
 
-      // TimeoutHandler
-      [&](ILinkSession* session) {
-        ASSERT_FALSE(session->IsEstablished());
-        Stop();
-      },
+        // TimeoutHandler
+        [&](ILinkSession* session) {
+          ASSERT_FALSE(session->IsEstablished());
+          Stop();
+        },
 
-      // SessionClosedHandler
-      [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
+        // SessionClosedHandler
+        [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
 
-      // PumpDoneHandler
-      []() {});
+        // PumpDoneHandler
+        []() {});
 
-  Bob.link = iwp::NewInboundLink(
-      // KeyManager
-      Bob.keyManager,
+    Bob.link = iwp::NewInboundLink(
+        // KeyManager
+        Bob.keyManager,
 
-      // GetRCFunc
-      [&]() -> const RouterContact& { return Bob.GetRC(); },
+        // GetRCFunc
+        [&]() -> const RouterContact& { return Bob.GetRC(); },
 
-      // LinkMessageHandler
-      [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
-        llarp_buffer_t copy(buf.base, buf.sz);
-        if(not Bob.gotLIM)
-        {
-          LinkIntroMessage msg;
-          if(msg.BDecode(&copy))
+        // LinkMessageHandler
+        [&](ILinkSession* s, const llarp_buffer_t& buf) -> bool {
+          llarp_buffer_t copy(buf.base, buf.sz);
+          if(not Bob.gotLIM)
           {
-            Bob.gotLIM = s->GotLIM(&msg);
+            LinkIntroMessage msg;
+            if(msg.BDecode(&copy))
+            {
+              Bob.gotLIM = s->GotLIM(&msg);
+            }
+            return Bob.gotLIM;
           }
-          return Bob.gotLIM;
-        }
-        DiscardMessage discard;
-        if(discard.BDecode(&copy))
-        {
-          LogInfo("bog got discard message from alice");
+          DiscardMessage discard;
+          if(discard.BDecode(&copy))
+          {
+            LogInfo("bog got discard message from alice");
+            return true;
+          }
+          return false;
+        },
+
+        // SignBufferFunc
+        [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
+          return m_crypto.sign(sig, Bob.keyManager->identityKey, buf);
+        },
+
+        // SessionEstablishedHandler
+        [&](ILinkSession* s) -> bool {
+          if(s->GetRemoteRC().pubkey != Alice.GetRC().pubkey)
+            return false;
+          LogInfo("bob established with alice");
+          Bob.madeSession = true;
+
           return true;
-        }
-        return false;
-      },
+        },
 
-      // SignBufferFunc
-      [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
-        return m_crypto.sign(sig, Bob.keyManager->identityKey, buf);
-      },
+        // SessionRenegotiateHandler
+        [&](RouterContact newrc, RouterContact oldrc) -> bool {
+          return newrc.pubkey == oldrc.pubkey;
+        },
 
-      // SessionEstablishedHandler
-      [&](ILinkSession* s) -> bool {
-        if(s->GetRemoteRC().pubkey != Alice.GetRC().pubkey)
-          return false;
-        LogInfo("bob established with alice");
-        Bob.madeSession = true;
+        // TimeoutHandler
+        [&](ILinkSession* session) { ASSERT_FALSE(session->IsEstablished()); },
 
-        return true;
-      },
+        // SessionClosedHandler
+        [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
 
-      // SessionRenegotiateHandler
-      [&](RouterContact newrc, RouterContact oldrc) -> bool {
-        return newrc.pubkey == oldrc.pubkey;
-      },
+        // PumpDoneHandler
+        []() {});
 
-      // TimeoutHandler
-      [&](ILinkSession* session) { ASSERT_FALSE(session->IsEstablished()); },
+    ASSERT_TRUE(Alice.Start(m_logic, netLoop, AlicePort));
+    ASSERT_TRUE(Bob.Start(m_logic, netLoop, BobPort));
 
-      // SessionClosedHandler
-      [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
+    LogicCall(m_logic,
+              [&]() { ASSERT_TRUE(Alice.link->TryEstablishTo(Bob.GetRC())); });
 
-      // PumpDoneHandler
-      []() {});
+    RunMainloop();
+    ASSERT_TRUE(Alice.IsGucci());
+    ASSERT_TRUE(Bob.IsGucci());
+    ASSERT_TRUE(success);
+  }
+};
+
+TEST_F(LinkLayerTest, TestIWP)
+{
+#ifdef WIN32
+  GTEST_SKIP();
+#else
+  RunIWP();
+#endif
+};
 
+TEST_F(LinkLayerTest, TestIWPBatched)
+{
+#ifdef WIN32
+  GTEST_SKIP();
+#else
+  Alice.batchedIO = true;
+  Bob.batchedIO   = true;
+  RunIWP();
+#endif
+};
+
+TEST_F(LinkLayerTest, TestIWPSharded)
+{
+#ifdef WIN32
+  GTEST_SKIP();
+#else
+  Alice.shards = 2;
+  Bob.shards   = 4;
+  RunIWP();
+  ASSERT_EQ(Alice.boundShards, 2u);
+  ASSERT_EQ(Bob.boundShards, 4u);
+#endif
+};
+
+TEST_F(LinkLayerTest, TestIWPSessionTickCost)
+{
+#ifdef WIN32
+  GTEST_SKIP();
+#else
+  static constexpr size_t outstanding = 1000;
+  static constexpr size_t ticks       = 1000;
+
+  Alice.link = iwp::NewOutboundLink(
+      Alice.keyManager,
+      [&]() -> const RouterContact& { return Alice.GetRC(); },
+      [](ILinkSession*, const llarp_buffer_t&) -> bool { return true; },
+      [&](Signature& sig, const llarp_buffer_t& buf) -> bool {
+        return m_crypto.sign(sig, Alice.keyManager->identityKey, buf);
+      },
+      [](ILinkSession*) -> bool { return true; },
+      [](RouterContact, RouterContact) -> bool { return true; },
+      [](ILinkSession*) {}, [](RouterID) {}, []() {});
   ASSERT_TRUE(Alice.Start(m_logic, netLoop, AlicePort));
-  ASSERT_TRUE(Bob.Start(m_logic, netLoop, BobPort));
 
-  LogicCall(m_logic,
-            [&]() { ASSERT_TRUE(Alice.link->TryEstablishTo(Bob.GetRC())); });
+  // a session that never handshakes still tracks everything we queue on it
+  auto session =
+      Alice.link->NewOutboundSession(Bob.GetRC(), Alice.GetRC().addrs[0]);
+  size_t timedOut = 0;
+  for(size_t idx = 0; idx < outstanding; ++idx)
+  {
+    ILinkSession::Message_t msg(32);
+    ASSERT_TRUE(session->SendMessageBuffer(
+        std::move(msg), [&](ILinkSession::DeliveryStatus status) {
+          if(status == ILinkSession::DeliveryStatus::eDeliveryDropped)
+            timedOut++;
+        }));
+  }
+  ASSERT_EQ(outstanding, session->SendQueueBacklog());
+
+  const auto now   = Alice.link->Now();
+  const auto start = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < ticks; ++idx)
+    session->Tick(now);
+  const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(
+      std::chrono::steady_clock::now() - start);
+  RecordProperty("ns_per_tick_1k_outstanding",
+                 std::to_string(elapsed.count() / ticks));
+  ASSERT_EQ(outstanding, session->SendQueueBacklog());
+  ASSERT_EQ(0u, timedOut);
+
+  session->Tick(now + iwp::Session::DeliveryTimeout * 4);
+  ASSERT_EQ(0u, session->SendQueueBacklog());
+  ASSERT_EQ(outstanding, timedOut);
+  Stop();
+#endif
+};
 
-  RunMainloop();
-  ASSERT_TRUE(Alice.IsGucci());
-  ASSERT_TRUE(Bob.IsGucci());
-  ASSERT_TRUE(success);
+TEST_F(LinkLayerTest, TestIWPLossyLink)
+{
+#ifdef WIN32
+  GTEST_SKIP();
+#else
+  const auto fixed = RunLossy([]() -> iwp::CongestionControl_ptr {
+    return std::make_unique< iwp::FixedInterval >(
+        llarp_time_t{iwp::Session::TXFlushInterval});
+  });
+  Reset();
+  const auto cubic = RunLossy([]() -> iwp::CongestionControl_ptr {
+    return std::make_unique< iwp::Cubic >();
+  });
+  for(const auto& item : {std::make_pair("fixed", fixed),
+                          std::make_pair("cubic", cubic)})
+  {
+    const std::string name = item.first;
+    const auto& result     = item.second;
+    RecordProperty(name + "_goodput_bytes_per_ms",
+                   std::to_string(result.Goodput()));
+    RecordProperty(name + "_retransmit_ratio",
+                   std::to_string(result.RetransmitRatio()));
+    RecordProperty(name + "_dropped", std::to_string(result.dropped));
+  }
+  ASSERT_GT(cubic.delivered, 0u);
+  // pacing into the bottleneck instead of bursting past it means far fewer
+  // fragments need a second go
+  ASSERT_LT(cubic.RetransmitRatio(), fixed.RetransmitRatio());
 #endif
 };
@@ -0,0 +1,114 @@
+#include <link/session_index.hpp>
+
+#include <link/mock_link_session.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using llarp::Addr;
+using llarp::SessionIndex;
+using llarp::test::MockLinkSession;
+
+static Addr
+MakeAddr(uint32_t idx)
+{
+  return Addr(10, (idx >> 16) & 0xff, (idx >> 8) & 0xff, idx & 0xff,
+              1000 + (idx % 50000));
+}
+
+TEST(SessionIndex, PutGetRemove)
+{
+  SessionIndex index;
+  auto first  = std::make_shared< MockLinkSession >();
+  auto second = std::make_shared< MockLinkSession >();
+  const Addr addr("127.0.0.1", 1090);
+  const Addr other("127.0.0.1", 1091);
+  ASSERT_EQ(index.Get(addr), nullptr);
+  index.Put(addr, first);
+  ASSERT_EQ(index.Get(addr), first);
+  ASSERT_EQ(index.Get(other), nullptr);
+  // replacing keeps a single entry
+  index.Put(addr, second);
+  ASSERT_EQ(index.Get(addr), second);
+  ASSERT_EQ(index.Size(), 1u);
+  ASSERT_TRUE(index.Remove(addr));
+  ASSERT_FALSE(index.Remove(addr));
+  ASSERT_EQ(index.Get(addr), nullptr);
+  ASSERT_EQ(index.Size(), 0u);
+}
+
+TEST(SessionIndex, Grow)
+{
+  SessionIndex index;
+  std::vector< std::shared_ptr< MockLinkSession > > sessions;
+  for(uint32_t idx = 0; idx < 5000; ++idx)
+  {
+    sessions.emplace_back(std::make_shared< MockLinkSession >());
+    index.Put(MakeAddr(idx), sessions.back());
+  }
+  ASSERT_EQ(index.Size(), sessions.size());
+  // drop every other one so lookups have to probe past tombstones
+  for(uint32_t idx = 0; idx < 5000; idx += 2)
+    ASSERT_TRUE(index.Remove(MakeAddr(idx)));
+  for(uint32_t idx = 0; idx < 5000; ++idx)
+  {
+    if(idx % 2)
+      ASSERT_EQ(index.Get(MakeAddr(idx)), sessions[idx]);
+    else
+      ASSERT_EQ(index.Get(MakeAddr(idx)), nullptr);
+  }
+  // removed sessions must have been released once no reader could see them
+  for(uint32_t idx = 0; idx < 5000; idx += 2)
+    ASSERT_EQ(sessions[idx].use_count(), 1);
+}
+
+TEST(SessionIndex, ConcurrentReaders)
+{
+  // many simulated peers looked up from several receive threads while
+  // sessions come and go
+  static constexpr uint32_t Peers = 4096;
+  static constexpr size_t Readers = 4;
+  static constexpr size_t Lookups = 200000;
+  SessionIndex index;
+  std::vector< std::shared_ptr< MockLinkSession > > sessions;
+  for(uint32_t idx = 0; idx < Peers; ++idx)
+  {
+    sessions.emplace_back(std::make_shared< MockLinkSession >());
+    index.Put(MakeAddr(idx), sessions.back());
+  }
+  std::atomic< bool > stop{false};
+  std::atomic< size_t > wrong{0};
+  std::vector< std::thread > readers;
+  for(size_t reader = 0; reader < Readers; ++reader)
+  {
+    readers.emplace_back([&, reader]() {
+      for(size_t idx = 0; idx < Lookups; ++idx)
+      {
+        const uint32_t peer = (idx * 7 + reader) % Peers;
+        auto session        = index.Get(MakeAddr(peer));
+        // the first half of the peers is never touched by the writer
+        if(peer < Peers / 2 && session != sessions[peer])
+          ++wrong;
+      }
+    });
+  }
+  std::thread writer([&]() {
+    uint32_t peer = Peers / 2;
+    while(not stop)
+    {
+      index.Remove(MakeAddr(peer));
+      index.Put(MakeAddr(peer), sessions[peer]);
+      if(++peer == Peers)
+        peer = Peers / 2;
+    }
+  });
+  for(auto& reader : readers)
+    reader.join();
+  stop = true;
+  writer.join();
+  ASSERT_EQ(wrong, 0u);
+  ASSERT_EQ(index.Size(), Peers);
+}
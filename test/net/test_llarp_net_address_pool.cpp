@@ -0,0 +1,124 @@
+#include <net/address_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct AddressPoolTest : public ::testing::Test
+{
+  static huint128_t
+  IP(uint64_t n)
+  {
+    return huint128_t{absl::uint128{n}};
+  }
+};
+
+TEST_F(AddressPoolTest, TakesBackLeastRecentlyActive)
+{
+  net::AddressPool pool;
+  pool.SetRange(IP(10), IP(14));
+  // a statically mapped address in the middle of the range is skipped
+  pool.Pin(IP(12));
+
+  huint128_t ip;
+  ASSERT_TRUE(pool.Allocate(ip, 1));
+  ASSERT_EQ(ip, IP(11));
+  ASSERT_TRUE(pool.Allocate(ip, 2));
+  ASSERT_EQ(ip, IP(13));
+  ASSERT_TRUE(pool.Allocate(ip, 3));
+  ASSERT_EQ(ip, IP(14));
+  ASSERT_FALSE(pool.Allocate(ip, 4));
+  ASSERT_EQ(pool.Size(), 4u);
+
+  ASSERT_TRUE(pool.Oldest(ip));
+  ASSERT_EQ(ip, IP(11));
+
+  // touches only count once flushed, which taking the oldest does
+  pool.Touch(IP(11), 5);
+  pool.Touch(IP(11), 6);
+  pool.Touch(IP(13), 7);
+  pool.Touch(IP(12), 8);
+  ASSERT_EQ(pool.LastActive(IP(11)), 1u);
+  ASSERT_TRUE(pool.Oldest(ip));
+  ASSERT_EQ(ip, IP(14));
+  ASSERT_EQ(pool.LastActive(IP(11)), 6u);
+  ASSERT_EQ(pool.LastActive(IP(12)),
+            std::numeric_limits< llarp_time_t >::max());
+
+  pool.Release(ip);
+  ASSERT_EQ(pool.LastActive(IP(14)), 0u);
+  ASSERT_TRUE(pool.Allocate(ip, 9));
+  ASSERT_EQ(ip, IP(14));
+  ASSERT_TRUE(pool.Oldest(ip));
+  ASSERT_EQ(ip, IP(11));
+
+  // pinning takes an address out of the running for good
+  pool.Pin(IP(11));
+  pool.Pin(IP(13));
+  pool.Pin(IP(14));
+  ASSERT_FALSE(pool.Oldest(ip));
+  ASSERT_FALSE(pool.Allocate(ip, 10));
+}
+
+TEST_F(AddressPoolTest, Churn)
+{
+  // a full /16 where every new client takes back the least recently
+  // active address, against scanning a map of activity for it
+  static constexpr uint64_t Mappings = 65534;
+  static constexpr size_t Rounds     = 20000;
+
+  net::AddressPool pool;
+  pool.SetRange(IP(0), IP(Mappings));
+  std::unordered_map< huint128_t, llarp_time_t, huint128_t::Hash > activity;
+  llarp_time_t now = 1;
+  huint128_t ip;
+  while(pool.Allocate(ip, now))
+    activity[ip] = now++;
+  ASSERT_EQ(pool.Size(), Mappings);
+
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+  auto started = steady_clock::now();
+  for(size_t round = 0; round < Rounds; ++round)
+  {
+    // traffic to a handful of clients, then a new one shows up
+    for(uint64_t n = 1; n <= 16; ++n)
+      pool.Touch(IP((round * 16 + n) % Mappings + 1), now++);
+    ASSERT_TRUE(pool.Oldest(ip));
+    pool.Release(ip);
+    ASSERT_TRUE(pool.Allocate(ip, now++));
+  }
+  const auto pooled = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+  ASSERT_EQ(pool.Size(), Mappings);
+
+  // the old way, fewer rounds as each one walks every mapping
+  static constexpr size_t ScanRounds = 200;
+  started                            = steady_clock::now();
+  for(size_t round = 0; round < ScanRounds; ++round)
+  {
+    for(uint64_t n = 1; n <= 16; ++n)
+      activity[IP((round * 16 + n) % Mappings + 1)] = now++;
+    auto oldest = activity.begin();
+    for(auto itr = activity.begin(); itr != activity.end(); ++itr)
+      if(itr->second < oldest->second)
+        oldest = itr;
+    oldest->second = now++;
+  }
+  const auto scanned = std::chrono::duration_cast< microseconds >(
+      steady_clock::now() - started);
+
+  const auto perSec = [](size_t rounds, microseconds elapsed) {
+    return std::to_string(rounds * 1000000.0
+                          / std::max< int64_t >(elapsed.count(), 1));
+  };
+  RecordProperty("mappings", std::to_string(Mappings));
+  RecordProperty("evictions_per_sec_pool", perSec(Rounds, pooled));
+  RecordProperty("evictions_per_sec_scan", perSec(ScanRounds, scanned));
+}
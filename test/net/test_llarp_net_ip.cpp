@@ -0,0 +1,150 @@
+#include <net/ip.hpp>
+
+#include <util/codel.hpp>
+#include <util/endian.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct IPPacketTest : public ::testing::Test
+{
+  static llarp_time_t now;
+
+  struct PutNow
+  {
+    void
+    operator()(net::IPPacket& pkt) const
+    {
+      pkt.timestamp = now;
+    }
+  };
+
+  struct GetNow
+  {
+    llarp_time_t
+    operator()() const
+    {
+      return now;
+    }
+  };
+
+  using Queue_t =
+      util::CoDelQueue< net::IPPacket, net::IPPacket::GetTime, PutNow,
+                        net::IPPacket::CompareOrder, GetNow, util::NullMutex,
+                        util::NullLock >;
+
+  /// an ipv4 udp packet from 10.0.0.1 to 10.0.0.2
+  static std::array< byte_t, 1200 >
+  MakeRaw()
+  {
+    std::array< byte_t, 1200 > raw{};
+    raw[0] = 0x45;
+    htobe16buf(raw.data() + 2, raw.size());
+    raw[8] = 64;
+    raw[9] = 17;
+    htobe32buf(raw.data() + 12, 0x0a000001);
+    htobe32buf(raw.data() + 16, 0x0a000002);
+    return raw;
+  }
+};
+
+llarp_time_t IPPacketTest::now = 1000;
+
+TEST_F(IPPacketTest, SharesUntilWritten)
+{
+  auto raw = MakeRaw();
+  net::IPPacket pkt;
+  ASSERT_TRUE(pkt.Load(llarp_buffer_t(raw)));
+  ASSERT_EQ(pkt.size(), raw.size());
+  ASSERT_TRUE(pkt.IsV4());
+  ASSERT_EQ(pkt.dstv4(), huint32_t{0x0a000002});
+
+  // copies are handles to the same bytes
+  net::IPPacket copy = pkt;
+  ASSERT_EQ(copy.buf.data(), pkt.buf.data());
+  ASSERT_LE(sizeof(net::IPPacket), 32u);
+
+  // changing one in place leaves the other alone
+  copy.UpdateIPv4Address(xhtonl(huint32_t{0x0a000003}),
+                         xhtonl(huint32_t{0x0a000004}));
+  ASSERT_NE(copy.buf.data(), pkt.buf.data());
+  ASSERT_EQ(copy.srcv4(), huint32_t{0x0a000003});
+  ASSERT_EQ(pkt.srcv4(), huint32_t{0x0a000001});
+
+  // a packet nobody else holds is changed where it is
+  const byte_t* before = pkt.buf.data();
+  pkt.UpdateIPv4Address(xhtonl(huint32_t{0x0a000005}),
+                        xhtonl(huint32_t{0x0a000002}));
+  ASSERT_EQ(pkt.buf.data(), before);
+  ASSERT_EQ(pkt.srcv4(), huint32_t{0x0a000005});
+
+  std::array< byte_t, net::IPPacket::MaxSize + 1 > big{};
+  ASSERT_FALSE(pkt.Load(llarp_buffer_t(big)));
+}
+
+TEST_F(IPPacketTest, QueueOfHandles)
+{
+  auto raw = MakeRaw();
+  net::IPPacket pkt;
+  ASSERT_TRUE(pkt.Load(llarp_buffer_t(raw)));
+
+  Queue_t queue("test", PutNow{}, GetNow{});
+  for(size_t idx = 0; idx < 100; ++idx)
+    queue.Emplace(pkt);
+  ASSERT_EQ(queue.Size(), 100u);
+  ASSERT_FALSE(pkt.buf.unique());
+
+  size_t visited = 0;
+  queue.Process([&](net::IPPacket& queued) {
+    ASSERT_EQ(queued.buf.data(), pkt.buf.data());
+    visited++;
+  });
+  ASSERT_EQ(visited, 100u);
+  ASSERT_EQ(queue.Size(), 0u);
+  // the queue let go of every reference
+  ASSERT_TRUE(pkt.buf.unique());
+
+  // and does on destruction too
+  {
+    Queue_t other("test", PutNow{}, GetNow{});
+    other.Emplace(pkt);
+    ASSERT_FALSE(pkt.buf.unique());
+  }
+  ASSERT_TRUE(pkt.buf.unique());
+}
+
+TEST_F(IPPacketTest, QueueThroughput)
+{
+  static constexpr size_t Rounds = 2000;
+
+  auto raw = MakeRaw();
+  Queue_t queue("test", PutNow{}, GetNow{});
+  size_t bytes       = 0;
+  const auto started = std::chrono::steady_clock::now();
+  for(size_t round = 0; round < Rounds; ++round)
+  {
+    for(size_t idx = 0; idx < 64; ++idx)
+    {
+      net::IPPacket pkt;
+      pkt.Load(llarp_buffer_t(raw));
+      queue.Emplace(std::move(pkt));
+    }
+    now += 1000;
+    queue.Process([&](net::IPPacket& pkt) { bytes += pkt.size(); });
+  }
+  using std::chrono::microseconds;
+  const auto elapsed = std::chrono::duration_cast< microseconds >(
+      std::chrono::steady_clock::now() - started);
+  ASSERT_EQ(bytes, Rounds * 64 * raw.size());
+
+  RecordProperty("queue_bytes", std::to_string(sizeof(Queue_t)));
+  RecordProperty("packets_per_sec",
+                 std::to_string(Rounds * 64 * 1000000.0
+                                / std::max< int64_t >(elapsed.count(), 1)));
+}
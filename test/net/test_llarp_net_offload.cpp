@@ -0,0 +1,232 @@
+#include <net/offload.hpp>
+
+#include <util/endian.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+using namespace ::llarp::net;
+
+struct OffloadTest : public ::testing::Test
+{
+  using Packet = std::vector< byte_t >;
+
+  static constexpr size_t MSS = 1400;
+
+  static uint16_t
+  Fold(const byte_t* buf, size_t sz, uint32_t sum = 0)
+  {
+    for(size_t idx = 0; idx + 1 < sz; idx += 2)
+      sum += bufbe16toh(buf + idx);
+    if(sz % 2)
+      sum += uint32_t(buf[sz - 1]) << 8;
+    while(sum >> 16)
+      sum = (sum & 0xFFff) + (sum >> 16);
+    return uint16_t(sum);
+  }
+
+  /// a valid ipv4 tcp segment with `payload` bytes of data
+  static Packet
+  Segment(uint32_t seq, size_t payload, byte_t flags = 0x10)
+  {
+    Packet pkt(40 + payload);
+    pkt[0] = 0x45;
+    htobe16buf(pkt.data() + 2, uint16_t(pkt.size()));
+    htobe16buf(pkt.data() + 4, uint16_t(seq));
+    pkt[8] = 64;
+    pkt[9] = 6;
+    htobe32buf(pkt.data() + 12, 0x0a000001);
+    htobe32buf(pkt.data() + 16, 0x0a000002);
+    htobe16buf(pkt.data() + 10, uint16_t(~Fold(pkt.data(), 20)));
+    byte_t* tcp = pkt.data() + 20;
+    htobe16buf(tcp, 1234);
+    htobe16buf(tcp + 2, 80);
+    htobe32buf(tcp + 4, seq);
+    htobe32buf(tcp + 8, 42);
+    tcp[12] = 5 << 4;
+    tcp[13] = flags;
+    htobe16buf(tcp + 14, 65535);
+    for(size_t idx = 0; idx < payload; ++idx)
+      tcp[20 + idx] = byte_t(seq + idx);
+    const uint32_t pseudo =
+        Fold(pkt.data() + 12, 8) + 6 + uint32_t(20 + payload);
+    htobe16buf(tcp + 16, uint16_t(~Fold(tcp, 20 + payload, pseudo)));
+    return pkt;
+  }
+
+  static bool
+  ChecksumsOK(const Packet& pkt)
+  {
+    const uint32_t pseudo =
+        Fold(pkt.data() + 12, 8) + 6 + uint32_t(pkt.size() - 20);
+    return Fold(pkt.data(), 20) == 0xFFff
+        && Fold(pkt.data() + 20, pkt.size() - 20, pseudo) == 0xFFff;
+  }
+
+  std::vector< std::pair< VnetHeader, Packet > > written;
+
+  const TCPCoalescer::Writer write = [&](const VnetHeader& hdr,
+                                         const byte_t* pkt, size_t sz) {
+    written.emplace_back(hdr, Packet(pkt, pkt + sz));
+    return true;
+  };
+
+  static std::vector< Packet >
+  Cut(VnetHeader hdr, Packet pkt)
+  {
+    std::vector< Packet > segs;
+    const bool ok = SegmentOffloaded(
+        hdr, pkt.data(), pkt.size(), [&](const llarp_buffer_t& buf) {
+          segs.emplace_back(buf.base, buf.base + buf.sz);
+        });
+    if(not ok)
+      segs.clear();
+    return segs;
+  }
+};
+
+constexpr size_t OffloadTest::MSS;
+
+TEST_F(OffloadTest, CoalesceAndSegment)
+{
+  std::vector< Packet > sent;
+  for(size_t idx = 0; idx < 10; ++idx)
+  {
+    const bool last = idx == 9;
+    sent.emplace_back(
+        Segment(1000 + idx * MSS, last ? 200 : MSS, last ? 0x18 : 0x10));
+    ASSERT_TRUE(ChecksumsOK(sent.back()));
+  }
+
+  TCPCoalescer gro;
+  for(const auto& pkt : sent)
+    ASSERT_TRUE(gro.Write(pkt.data(), pkt.size(), write));
+  ASSERT_TRUE(written.empty());
+  ASSERT_EQ(gro.Pending(), 10u);
+  ASSERT_TRUE(gro.Flush(write));
+  ASSERT_EQ(gro.Pending(), 0u);
+
+  // one write for all of them
+  ASSERT_EQ(written.size(), 1u);
+  const auto& hdr = written[0].first;
+  ASSERT_EQ(hdr.gsoType, VnetHeader::GSOTCPv4);
+  ASSERT_EQ(hdr.gsoSize, MSS);
+  ASSERT_EQ(hdr.hdrLen, 40u);
+  ASSERT_EQ(written[0].second.size(), 40u + 9 * MSS + 200);
+
+  // and what the kernel would have handed us comes back the same
+  const auto segs = Cut(hdr, written[0].second);
+  ASSERT_EQ(segs.size(), sent.size());
+  for(size_t idx = 0; idx < segs.size(); ++idx)
+  {
+    ASSERT_TRUE(ChecksumsOK(segs[idx]));
+    // ip ids differ, everything else doesn't
+    Packet expect = sent[idx];
+    Packet got    = segs[idx];
+    std::fill_n(expect.begin() + 4, 2, 0);
+    std::fill_n(expect.begin() + 10, 2, 0);
+    std::fill_n(got.begin() + 4, 2, 0);
+    std::fill_n(got.begin() + 10, 2, 0);
+    ASSERT_EQ(got, expect);
+  }
+}
+
+TEST_F(OffloadTest, KeepsOrder)
+{
+  TCPCoalescer gro;
+  const auto first  = Segment(0, MSS);
+  const auto second = Segment(MSS, MSS);
+  // out of order segment can't join
+  const auto gap = Segment(4 * MSS, MSS);
+  // a syn goes out on its own after whatever is pending
+  const auto syn = Segment(0, 0, 0x02);
+
+  gro.Write(first.data(), first.size(), write);
+  gro.Write(second.data(), second.size(), write);
+  gro.Write(gap.data(), gap.size(), write);
+  ASSERT_EQ(written.size(), 1u);
+  gro.Write(syn.data(), syn.size(), write);
+  ASSERT_EQ(written.size(), 3u);
+  ASSERT_EQ(gro.Pending(), 0u);
+
+  ASSERT_EQ(written[0].first.gsoType, VnetHeader::GSOTCPv4);
+  ASSERT_EQ(written[0].second.size(), 40u + 2 * MSS);
+  // single segments go out untouched
+  ASSERT_EQ(written[1].first.gsoType, VnetHeader::GSONone);
+  ASSERT_EQ(written[1].second, gap);
+  ASSERT_EQ(written[2].second, syn);
+}
+
+TEST_F(OffloadTest, PartialChecksum)
+{
+  auto pkt = Segment(7, 333);
+  const auto good = pkt;
+  // what the kernel gives us with checksum offload on
+  const uint32_t pseudo = Fold(pkt.data() + 12, 8) + 6 + uint32_t(20 + 333);
+  htobe16buf(pkt.data() + 36, Fold(nullptr, 0, pseudo));
+  VnetHeader hdr;
+  hdr.flags      = VnetHeader::NeedsChecksum;
+  hdr.csumStart  = 20;
+  hdr.csumOffset = 16;
+  const auto segs = Cut(hdr, pkt);
+  ASSERT_EQ(segs.size(), 1u);
+  ASSERT_EQ(segs[0], good);
+
+  // nonsense offsets get dropped
+  hdr.csumStart = uint16_t(pkt.size());
+  ASSERT_TRUE(Cut(hdr, pkt).empty());
+  hdr.csumStart = 20;
+  hdr.gsoType   = VnetHeader::GSOTCPv6;
+  hdr.gsoSize   = MSS;
+  ASSERT_TRUE(Cut(hdr, pkt).empty());
+}
+
+TEST_F(OffloadTest, Throughput)
+{
+  // one 64k super packet per read or write against a syscall per segment
+  static constexpr size_t Rounds   = 200;
+  static constexpr size_t PerRound = (MaxOffloadSize - 40) / MSS;
+
+  std::vector< Packet > segs;
+  for(size_t idx = 0; idx < PerRound; ++idx)
+    segs.emplace_back(Segment(idx * MSS, MSS));
+
+  TCPCoalescer gro;
+  size_t bytes  = 0;
+  size_t writes = 0;
+  size_t cut    = 0;
+  const TCPCoalescer::Writer count = [&](const VnetHeader& hdr,
+                                         const byte_t* pkt, size_t sz) {
+    writes++;
+    Packet copy(pkt, pkt + sz);
+    SegmentOffloaded(hdr, copy.data(), copy.size(),
+                     [&](const llarp_buffer_t& buf) {
+                       bytes += buf.sz;
+                       cut++;
+                     });
+    return true;
+  };
+  const auto started = std::chrono::steady_clock::now();
+  for(size_t round = 0; round < Rounds; ++round)
+  {
+    for(const auto& pkt : segs)
+      gro.Write(pkt.data(), pkt.size(), count);
+    gro.Flush(count);
+  }
+  using std::chrono::microseconds;
+  const auto elapsed = std::chrono::duration_cast< microseconds >(
+      std::chrono::steady_clock::now() - started);
+
+  ASSERT_EQ(writes, Rounds);
+  ASSERT_EQ(cut, Rounds * PerRound);
+
+  RecordProperty("segments_per_syscall", std::to_string(cut / writes));
+  RecordProperty(
+      "MBps_coalesce_and_segment",
+      std::to_string(bytes / std::max< double >(elapsed.count(), 1)));
+}
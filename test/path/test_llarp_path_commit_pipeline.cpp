@@ -0,0 +1,308 @@
+#include <path/commit_pipeline.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+#include <crypto/encrypted_frame.hpp>
+#include <messages/relay_commit.hpp>
+#include <util/time.hpp>
+
+#include <llarp_test.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+using namespace ::llarp::path;
+
+namespace
+{
+  struct FakeCommit : public PendingCommit
+  {
+    RouterID from;
+    std::vector< int >* decrypted;
+    std::vector< int >* finished;
+    int id;
+    bool good;
+
+    FakeCommit(RouterID _from, std::vector< int >* _decrypted,
+               std::vector< int >* _finished, int _id, bool _good = true)
+        : from(_from)
+        , decrypted(_decrypted)
+        , finished(_finished)
+        , id(_id)
+        , good(_good)
+    {
+    }
+
+    RouterID
+    From() const override
+    {
+      return from;
+    }
+
+    bool
+    Decrypt() override
+    {
+      decrypted->push_back(id);
+      return good;
+    }
+
+    void
+    Finish() override
+    {
+      finished->push_back(id);
+    }
+  };
+
+  /// runs nothing until told to, so we can see how the work was split up
+  struct DeferredJobs
+  {
+    std::vector< CommitPipeline::Job_t > worker;
+    std::vector< CommitPipeline::Job_t > logic;
+
+    CommitPipeline::Dispatch_t
+    ToWorker()
+    {
+      return [&](CommitPipeline::Job_t job) {
+        worker.emplace_back(std::move(job));
+      };
+    }
+
+    CommitPipeline::Dispatch_t
+    ToLogic()
+    {
+      return [&](CommitPipeline::Job_t job) {
+        logic.emplace_back(std::move(job));
+      };
+    }
+
+    /// run everything queued until nothing is left, returns how many worker
+    /// jobs ran
+    size_t
+    RunAll()
+    {
+      size_t jobs = 0;
+      while(not worker.empty() || not logic.empty())
+      {
+        auto workerJobs = std::move(worker);
+        worker.clear();
+        jobs += workerJobs.size();
+        for(auto& job : workerJobs)
+          job();
+        auto logicJobs = std::move(logic);
+        logic.clear();
+        for(auto& job : logicJobs)
+          job();
+      }
+      return jobs;
+    }
+  };
+
+  RouterID
+  MakeRouterID(byte_t fill)
+  {
+    RouterID id;
+    id.Fill(fill);
+    return id;
+  }
+}  // namespace
+
+TEST(CommitPipeline, BatchesWhileBusy)
+{
+  DeferredJobs jobs;
+  std::vector< int > decrypted, finished;
+  CommitPipeline pipeline(jobs.ToWorker(), jobs.ToLogic(), 1);
+  const auto now = time_now_ms();
+
+  // the first one goes straight to a worker
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(MakeRouterID(1), &decrypted, &finished,
+                                     0),
+      now));
+  ASSERT_EQ(jobs.worker.size(), 1u);
+  ASSERT_EQ(pipeline.InFlight(), 1u);
+
+  // the rest wait for it and then go as one batch
+  for(int id = 1; id <= 10; ++id)
+  {
+    ASSERT_TRUE(pipeline.Queue(
+        std::make_shared< FakeCommit >(MakeRouterID(id + 1), &decrypted,
+                                       &finished, id, id != 5),
+        now));
+  }
+  ASSERT_EQ(jobs.worker.size(), 1u);
+  ASSERT_EQ(pipeline.Queued(), 10u);
+
+  ASSERT_EQ(jobs.RunAll(), 2u);
+  ASSERT_EQ(pipeline.Queued(), 0u);
+  ASSERT_EQ(pipeline.InFlight(), 0u);
+  // oldest first
+  ASSERT_EQ(decrypted, std::vector< int >({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+  // a failed decrypt is not finished
+  ASSERT_EQ(finished, std::vector< int >({0, 1, 2, 3, 4, 6, 7, 8, 9, 10}));
+}
+
+TEST(CommitPipeline, BoundedPerPeer)
+{
+  DeferredJobs jobs;
+  std::vector< int > decrypted, finished;
+  CommitPipeline pipeline(jobs.ToWorker(), jobs.ToLogic(), 1);
+  const auto now    = time_now_ms();
+  const auto greedy = MakeRouterID(1);
+
+  // one in flight and the rest queued
+  for(size_t id = 0; id <= CommitPipeline::MaxPerPeer; ++id)
+  {
+    ASSERT_TRUE(pipeline.Queue(std::make_shared< FakeCommit >(
+                                   greedy, &decrypted, &finished, int(id)),
+                               now));
+  }
+  ASSERT_FALSE(pipeline.Queue(
+      std::make_shared< FakeCommit >(greedy, &decrypted, &finished, -1), now));
+  // other peers still get in
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(MakeRouterID(2), &decrypted, &finished,
+                                     -2),
+      now));
+
+  jobs.RunAll();
+  ASSERT_EQ(finished.size(), CommitPipeline::MaxPerPeer + 2);
+  ASSERT_EQ(finished.back(), -2);
+
+  // and once drained the greedy peer can queue again
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(greedy, &decrypted, &finished, -3), now));
+}
+
+TEST(CommitPipeline, DropsStale)
+{
+  DeferredJobs jobs;
+  std::vector< int > decrypted, finished;
+  CommitPipeline pipeline(jobs.ToWorker(), jobs.ToLogic(), 1);
+  const auto now = time_now_ms();
+
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(MakeRouterID(1), &decrypted, &finished,
+                                     0),
+      now));
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(MakeRouterID(2), &decrypted, &finished,
+                                     1),
+      now - CommitPipeline::MaxWait - 1));
+  ASSERT_TRUE(pipeline.Queue(
+      std::make_shared< FakeCommit >(MakeRouterID(3), &decrypted, &finished,
+                                     2),
+      now));
+
+  jobs.RunAll();
+  ASSERT_EQ(decrypted, std::vector< int >({0, 2}));
+  ASSERT_EQ(finished, std::vector< int >({0, 2}));
+  ASSERT_EQ(pipeline.ExtractStatus()["expired"], 1u);
+}
+
+namespace
+{
+  /// does the same crypto an LRCM does for our hop
+  struct CryptoCommit : public PendingCommit
+  {
+    RouterID from;
+    const SecretKey& ourKey;
+    EncryptedFrame frame;
+    SharedSecret pathKey;
+    ShortHash nonceXOR;
+    size_t* finished;
+
+    CryptoCommit(RouterID _from, const SecretKey& key, EncryptedFrame _frame,
+                 size_t* _finished)
+        : from(_from)
+        , ourKey(key)
+        , frame(std::move(_frame))
+        , finished(_finished)
+    {
+    }
+
+    RouterID
+    From() const override
+    {
+      return from;
+    }
+
+    bool
+    Decrypt() override
+    {
+      if(!frame.DecryptInPlace(ourKey))
+        return false;
+      auto buf = frame.Buffer();
+      buf->cur = buf->base + EncryptedFrameOverheadSize;
+      LR_CommitRecord record;
+      if(!record.BDecode(buf))
+        return false;
+      auto crypto = CryptoManager::instance();
+      if(!crypto->dh_server(pathKey, record.commkey, ourKey,
+                            record.tunnelNonce))
+        return false;
+      return crypto->shorthash(nonceXOR, llarp_buffer_t(pathKey));
+    }
+
+    void
+    Finish() override
+    {
+      (*finished)++;
+    }
+  };
+}  // namespace
+
+struct CommitPipelineBench : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+};
+
+TEST_F(CommitPipelineBench, CommitsPerCore)
+{
+  static constexpr size_t NumCommits = 256;
+  SecretKey ours;
+  m_crypto.encryption_keygen(ours);
+
+  size_t finished = 0;
+  std::vector< PendingCommit_ptr > commits;
+  for(size_t idx = 0; idx < NumCommits; ++idx)
+  {
+    SecretKey client, commkey;
+    m_crypto.encryption_keygen(client);
+    m_crypto.encryption_keygen(commkey);
+    LR_CommitRecord record;
+    record.commkey = commkey.toPublic();
+    record.nextHop.Randomize();
+    record.tunnelNonce.Randomize();
+    record.txid.Randomize();
+    record.rxid.Randomize();
+
+    EncryptedFrame frame;
+    auto buf = frame.Buffer();
+    buf->cur = buf->base + EncryptedFrameOverheadSize;
+    ASSERT_TRUE(record.BEncode(buf));
+    buf->cur = buf->base + EncryptedFrameOverheadSize;
+    ASSERT_TRUE(frame.EncryptInPlace(client, ours.toPublic()));
+    RouterID from;
+    from.Randomize();
+    commits.emplace_back(
+        std::make_shared< CryptoCommit >(from, ours, frame, &finished));
+  }
+
+  // everything on this thread, so what we measure is what one core does
+  DeferredJobs jobs;
+  CommitPipeline pipeline(jobs.ToWorker(), jobs.ToLogic(), 1);
+  const auto started = std::chrono::steady_clock::now();
+  for(auto& commit : commits)
+    ASSERT_TRUE(pipeline.Queue(commit, time_now_ms()));
+  const size_t batches = jobs.RunAll();
+  const auto took = std::chrono::duration_cast< std::chrono::microseconds >(
+      std::chrono::steady_clock::now() - started);
+  ASSERT_EQ(finished, NumCommits);
+
+  const double perSec =
+      NumCommits * 1000000.0 / std::max< int64_t >(took.count(), 1);
+  RecordProperty("commits_per_sec_per_core", std::to_string(perSec));
+  RecordProperty("batches", std::to_string(batches));
+}
@@ -0,0 +1,183 @@
+#include <path/transit_hop_index.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+
+#include <llarp_test.hpp>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+using namespace ::llarp::path;
+
+namespace
+{
+  TransitHop_ptr
+  MakeHop(llarp_time_t started = 0)
+  {
+    auto hop = std::make_shared< TransitHop >();
+    hop->info.txID.Randomize();
+    hop->info.rxID.Randomize();
+    hop->info.upstream.Randomize();
+    hop->info.downstream.Randomize();
+    hop->started = started;
+    return hop;
+  }
+}  // namespace
+
+struct TransitHopIndexTest
+    : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+};
+
+TEST_F(TransitHopIndexTest, FindByEitherId)
+{
+  TransitHopIndex index;
+  auto hop = MakeHop();
+  ASSERT_TRUE(index.Put(hop));
+  ASSERT_EQ(index.Size(), 1u);
+
+  const auto& info = hop->info;
+  for(const auto& id : {info.txID, info.rxID})
+  {
+    auto found = index.FindByUpstream(id, info.upstream);
+    ASSERT_NE(found, nullptr);
+    ASSERT_EQ(*found, hop);
+    found = index.FindByDownstream(id, info.downstream);
+    ASSERT_NE(found, nullptr);
+    ASSERT_EQ(*found, hop);
+    // wrong side
+    ASSERT_EQ(index.FindByUpstream(id, info.downstream), nullptr);
+  }
+  PathID_t other;
+  other.Randomize();
+  ASSERT_EQ(index.FindByUpstream(other, info.upstream), nullptr);
+
+  auto zero = MakeHop();
+  zero->info.rxID.Zero();
+  ASSERT_FALSE(index.Put(zero));
+  ASSERT_EQ(index.Size(), 1u);
+}
+
+TEST_F(TransitHopIndexTest, SharedPathId)
+{
+  TransitHopIndex index;
+  auto first  = MakeHop();
+  auto second = MakeHop();
+  second->info.txID = first->info.txID;
+  ASSERT_TRUE(index.Put(first));
+  ASSERT_TRUE(index.Put(second));
+
+  const auto& id = first->info.txID;
+  ASSERT_EQ(*index.FindByUpstream(id, first->info.upstream), first);
+  ASSERT_EQ(*index.FindByUpstream(id, second->info.upstream), second);
+
+  size_t visited = 0;
+  index.ForEach([&](const TransitHop_ptr&) { visited++; });
+  ASSERT_EQ(visited, 2u);
+}
+
+TEST_F(TransitHopIndexTest, GrowAndExpire)
+{
+  TransitHopIndex index;
+  std::vector< TransitHop_ptr > hops;
+  // every other hop expires long before the rest
+  for(size_t idx = 0; idx < 1000; ++idx)
+  {
+    hops.emplace_back(MakeHop(idx % 2 ? 0 : 1000000));
+    ASSERT_TRUE(index.Put(hops.back()));
+  }
+  ASSERT_EQ(index.Size(), 1000u);
+  ASSERT_GE(index.Capacity(), 4000u);
+
+  const llarp_time_t now = hops[1]->ExpireTime() + 1;
+  std::vector< PathID_t > removed;
+  const size_t expired = index.RemoveIf(
+      [now](const TransitHop& hop) { return hop.Expired(now); },
+      [&](const PathID_t& id) { removed.emplace_back(id); });
+  ASSERT_EQ(expired, 500u);
+  ASSERT_EQ(removed.size(), 1000u);
+  ASSERT_EQ(index.Size(), 500u);
+
+  for(size_t idx = 0; idx < hops.size(); ++idx)
+  {
+    const auto& info = hops[idx]->info;
+    auto found       = index.FindByDownstream(info.rxID, info.downstream);
+    if(idx % 2)
+      ASSERT_EQ(found, nullptr);
+    else
+      ASSERT_EQ(*found, hops[idx]);
+  }
+
+  // removing everything shrinks it back down
+  index.RemoveIf([](const TransitHop&) { return true; },
+                 [](const PathID_t&) {});
+  ASSERT_EQ(index.Size(), 0u);
+  ASSERT_EQ(index.Capacity(), TransitHopIndex::InitialCapacity * 4);
+}
+
+// timing comparison, run with --gtest_also_run_disabled_tests
+TEST_F(TransitHopIndexTest, DISABLED_LookupCost)
+{
+  static constexpr size_t NumHops    = 100000;
+  static constexpr size_t NumLookups = 200000;
+
+  TransitHopIndex index;
+  // what the path context used to keep its transit hops in
+  std::unordered_multimap< PathID_t, TransitHop_ptr, PathID_t::Hash > map;
+  std::vector< TransitHop_ptr > hops;
+  for(size_t idx = 0; idx < NumHops; ++idx)
+  {
+    hops.emplace_back(MakeHop());
+    ASSERT_TRUE(index.Put(hops.back()));
+    map.emplace(hops.back()->info.txID, hops.back());
+    map.emplace(hops.back()->info.rxID, hops.back());
+  }
+
+  const auto perLookup = [](std::chrono::steady_clock::duration dlt) {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(dlt).count()
+        / double(NumLookups);
+  };
+
+  size_t found = 0;
+  auto started = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < NumLookups; ++idx)
+  {
+    const auto& info = hops[(idx * 7919) % NumHops]->info;
+    std::function< bool(const TransitHop_ptr&) > check =
+        [&info](const TransitHop_ptr& hop) {
+          return hop->info.downstream == info.downstream;
+        };
+    auto range = map.equal_range(info.txID);
+    for(auto itr = range.first; itr != range.second; ++itr)
+    {
+      if(check(itr->second))
+      {
+        TransitHop_ptr hop = itr->second;
+        found += hop != nullptr;
+        break;
+      }
+    }
+  }
+  const auto multimap = std::chrono::steady_clock::now() - started;
+  ASSERT_EQ(found, NumLookups);
+
+  found   = 0;
+  started = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < NumLookups; ++idx)
+  {
+    const auto& info = hops[(idx * 7919) % NumHops]->info;
+    TransitHop_ptr hop = *index.FindByDownstream(info.txID, info.downstream);
+    found += hop != nullptr;
+  }
+  const auto indexed = std::chrono::steady_clock::now() - started;
+  ASSERT_EQ(found, NumLookups);
+
+  RecordProperty("ns_per_lookup_multimap", std::to_string(perLookup(multimap)));
+  RecordProperty("ns_per_lookup_index", std::to_string(perLookup(indexed)));
+}
@@ -0,0 +1,171 @@
+#include <router/outbound_scheduler.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+#include <llarp_test.hpp>
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct OutboundSchedulerTest : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+  using Entry = OutboundScheduler::Entry;
+
+  OutboundScheduler scheduler;
+  std::vector< Entry > sent;
+  size_t drops = 0;
+
+  const OutboundScheduler::SendFunc send = [&](Entry&& entry) {
+    sent.emplace_back(std::move(entry));
+  };
+
+  const OutboundScheduler::SendFunc dropped = [&](Entry&&) { drops++; };
+
+  static Entry
+  MakeEntry(TrafficClass traffic, const PathID_t& pathid,
+            const RouterID& router, size_t sz = 1024)
+  {
+    Entry entry;
+    entry.message.first = ILinkSession::Message_t(sz);
+    entry.pathid        = pathid;
+    entry.router        = router;
+    entry.traffic       = traffic;
+    return entry;
+  }
+
+  static PathID_t
+  RandomPath()
+  {
+    PathID_t pathid;
+    pathid.Randomize();
+    return pathid;
+  }
+
+  static RouterID
+  RandomRouter()
+  {
+    RouterID router;
+    router.Randomize();
+    return router;
+  }
+};
+
+TEST_F(OutboundSchedulerTest, DataDoesNotStarveTheRest)
+{
+  // a relay busy with bulk transfers on many paths
+  for(size_t path = 0; path < 50; ++path)
+  {
+    const auto pathid = RandomPath();
+    const auto router = RandomRouter();
+    for(size_t idx = 0; idx < MAX_PATH_QUEUE_SIZE; ++idx)
+      scheduler.Queue(MakeEntry(TrafficClass::Data, pathid, router), dropped);
+  }
+  for(size_t idx = 0; idx < 8; ++idx)
+  {
+    scheduler.Queue(
+        MakeEntry(TrafficClass::DHT, PathID_t(), RandomRouter(), 2048),
+        dropped);
+    scheduler.Queue(
+        MakeEntry(TrafficClass::PathBuild, PathID_t(), RandomRouter(), 4096),
+        dropped);
+  }
+
+  scheduler.Drain(0, send);
+  ASSERT_EQ(drops, 0u);
+  // everything but bulk data goes out in the first tick
+  ASSERT_EQ(scheduler.Size(TrafficClass::DHT), 0u);
+  ASSERT_EQ(scheduler.Size(TrafficClass::PathBuild), 0u);
+  ASSERT_GT(scheduler.Size(TrafficClass::Data), 0u);
+
+  size_t bytes = 0;
+  for(const auto& entry : sent)
+    bytes += entry.message.first.size();
+  ASSERT_LE(bytes, OutboundScheduler::TickBudget);
+}
+
+TEST_F(OutboundSchedulerTest, PathsShareFairly)
+{
+  const auto busy   = RandomPath();
+  const auto quiet  = RandomPath();
+  const auto router = RandomRouter();
+  for(size_t idx = 0; idx < MAX_PATH_QUEUE_SIZE; ++idx)
+    scheduler.Queue(MakeEntry(TrafficClass::Data, busy, router), dropped);
+  for(size_t idx = 0; idx < 4; ++idx)
+    scheduler.Queue(MakeEntry(TrafficClass::Data, quiet, router), dropped);
+
+  // enough for a few messages only
+  scheduler.Drain(0, send, 16 * 1024);
+  ASSERT_EQ(sent.size(), 16u);
+  size_t fromQuiet = 0;
+  for(const auto& entry : sent)
+    fromQuiet += entry.pathid == quiet;
+  ASSERT_EQ(fromQuiet, 4u);
+}
+
+TEST_F(OutboundSchedulerTest, PeerBudget)
+{
+  const auto hog   = RandomRouter();
+  const auto other = RandomRouter();
+  for(size_t path = 0; path < 20; ++path)
+  {
+    const auto pathid = RandomPath();
+    for(size_t idx = 0; idx < 10; ++idx)
+      scheduler.Queue(MakeEntry(TrafficClass::Data, pathid, hog, 8000),
+                      dropped);
+  }
+  scheduler.Queue(MakeEntry(TrafficClass::Data, RandomPath(), other, 8000),
+                  dropped);
+  scheduler.Queue(MakeEntry(TrafficClass::Control, PathID_t(), hog, 8000),
+                  dropped);
+
+  scheduler.Drain(0, send);
+  std::map< RouterID, size_t > bytes;
+  size_t control = 0;
+  for(const auto& entry : sent)
+  {
+    if(entry.traffic == TrafficClass::Control)
+      control++;
+    else
+      bytes[entry.router] += entry.message.first.size();
+  }
+  ASSERT_EQ(control, 1u);
+  ASSERT_LE(bytes[hog], OutboundScheduler::PeerBudget);
+  ASSERT_EQ(bytes[other], 8000u);
+
+  // the rest goes out over the next ticks
+  size_t ticks = 0;
+  while(scheduler.Size() > 0 && ticks++ < 100)
+    scheduler.Drain(0, send);
+  ASSERT_EQ(scheduler.Size(), 0u);
+  ASSERT_EQ(sent.size(), 202u);
+}
+
+TEST_F(OutboundSchedulerTest, HeadDropAndRemove)
+{
+  const auto pathid = RandomPath();
+  const auto router = RandomRouter();
+  for(size_t idx = 0; idx <= MAX_PATH_QUEUE_SIZE; ++idx)
+  {
+    auto entry   = MakeEntry(TrafficClass::Data, pathid, router);
+    entry.queued = idx;
+    scheduler.Queue(std::move(entry), dropped);
+  }
+  ASSERT_EQ(drops, 1u);
+  ASSERT_EQ(scheduler.Size(), MAX_PATH_QUEUE_SIZE);
+
+  scheduler.Drain(100, send, 1024);
+  ASSERT_EQ(sent.size(), 1u);
+  // the oldest one is the one that got dropped
+  ASSERT_EQ(sent[0].queued, 1u);
+
+  scheduler.RemovePath(pathid);
+  ASSERT_EQ(scheduler.Size(), 0u);
+  ASSERT_EQ(scheduler.Drain(100, send), 0u);
+
+  auto status = scheduler.ExtractStatus();
+  ASSERT_EQ(status["Data"]["drops"], 1u);
+  ASSERT_EQ(status["Data"]["maxSojourn"], 99u);
+}
@@ -13,6 +13,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <vector>
+
 using namespace llarp;
 using namespace testing;
 
@@ -44,6 +46,54 @@ TEST_F(HiddenServiceTest, TestGenerateIntroSet)
   ASSERT_TRUE(I.Verify(now));
 }
 
+struct IntroSetBatchTest : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+  service::Identity ident;
+
+  IntroSetBatchTest()
+  {
+    ident.RegenerateKeys();
+  }
+
+  service::IntroSet
+  MakeIntroSet(llarp_time_t now)
+  {
+    service::IntroSet I;
+    I.T = now;
+    service::Introduction intro;
+    intro.expiresAt = now + (path::default_lifetime / 2);
+    intro.router.Randomize();
+    intro.pathID.Randomize();
+    I.I.emplace_back(std::move(intro));
+    return I;
+  }
+};
+
+TEST_F(IntroSetBatchTest, VerifyBatchKeepsGoodSets)
+{
+  const auto now = time_now_ms();
+  std::vector< service::IntroSet > sets;
+  for(size_t idx = 0; idx < 3; ++idx)
+  {
+    sets.emplace_back(MakeIntroSet(now));
+    ASSERT_TRUE(ident.SignIntroSet(sets.back(), now));
+  }
+  sets[1].I[0].pathID.Randomize();
+
+  std::vector< const service::IntroSet* > batch;
+  for(const auto& set : sets)
+    batch.emplace_back(&set);
+  std::vector< char > valid;
+  ASSERT_EQ(2u, service::IntroSet::VerifyBatch(batch, now, valid));
+  ASSERT_EQ(std::vector< char >({1, 0, 1}), valid);
+
+  // what the batch verified is found in the cache afterwards
+  const auto hits = service::IntroSet::VerifyCache().Hits();
+  ASSERT_TRUE(sets[0].Verify(now));
+  ASSERT_FALSE(sets[1].Verify(now));
+  ASSERT_EQ(hits + 1, service::IntroSet::VerifyCache().Hits());
+}
+
 TEST_F(HiddenServiceTest, TestAddressToFromString)
 {
   auto str = ident.pub.Addr().ToString();
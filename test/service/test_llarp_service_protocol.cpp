@@ -0,0 +1,168 @@
+#include <service/protocol.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <llarp_test.hpp>
+#include <service/identity.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::llarp;
+
+struct ProtocolFrameTest : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+  service::Identity alice;
+  SharedSecret sessionKey;
+  service::ConvoTag tag;
+  service::ProtocolMessage msg;
+
+  ProtocolFrameTest()
+  {
+    alice.RegenerateKeys();
+    sessionKey.Randomize();
+    tag.Randomize();
+    msg.tag    = tag;
+    msg.sender = alice.pub;
+    msg.seqno  = 1;
+    std::array< byte_t, 1280 > packet;
+    packet.fill('x');
+    msg.PutBuffer(llarp_buffer_t(packet));
+  }
+
+  service::ProtocolFrame
+  MakeFrame()
+  {
+    service::ProtocolFrame frame;
+    frame.T = tag;
+    frame.F.Randomize();
+    frame.N.Randomize();
+    return frame;
+  }
+};
+
+TEST_F(ProtocolFrameTest, MACFrame)
+{
+  auto frame = MakeFrame();
+  ASSERT_TRUE(frame.EncryptAndMAC(msg, sessionKey));
+  ASSERT_TRUE(frame.Z.IsZero());
+  ASSERT_FALSE(frame.M.IsZero());
+  ASSERT_TRUE(frame.VerifyMAC(sessionKey));
+
+  // survives the wire
+  std::array< byte_t, service::MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+  llarp_buffer_t buf(tmp);
+  ASSERT_TRUE(frame.BEncode(&buf));
+  buf.sz  = buf.cur - buf.base;
+  buf.cur = buf.base;
+  service::ProtocolFrame decoded;
+  ASSERT_TRUE(decoded.BDecode(&buf));
+  ASSERT_EQ(decoded, frame);
+  ASSERT_TRUE(decoded.VerifyMAC(sessionKey));
+
+  service::ProtocolMessage got;
+  ASSERT_TRUE(decoded.DecryptPayloadInto(sessionKey, got));
+  ASSERT_EQ(got.payload, msg.payload);
+  ASSERT_EQ(got.sender, alice.pub);
+  ASSERT_EQ(got.version, service::SERVICE_PROTOCOL_VERSION);
+
+  SharedSecret otherKey;
+  otherKey.Randomize();
+  ASSERT_FALSE(frame.VerifyMAC(otherKey));
+
+  decoded.D.data()[0] ^= 1;
+  ASSERT_FALSE(decoded.VerifyMAC(sessionKey));
+}
+
+TEST_F(ProtocolFrameTest, MACKeyIsNotSessionKey)
+{
+  auto frame = MakeFrame();
+  ASSERT_TRUE(frame.EncryptAndMAC(msg, sessionKey));
+
+  // what the mac would be if the session key keyed it directly
+  service::ProtocolFrame copy(frame);
+  copy.M.Zero();
+  std::array< byte_t, service::MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+  llarp_buffer_t buf(tmp);
+  ASSERT_TRUE(copy.BEncode(&buf));
+  buf.sz  = buf.cur - buf.base;
+  buf.cur = buf.base;
+  ShortHash raw;
+  ASSERT_TRUE(CryptoManager::instance()->hmac(raw.data(), buf, sessionKey));
+  ASSERT_NE(raw, frame.M);
+}
+
+TEST_F(ProtocolFrameTest, SignedFrameHasNoMAC)
+{
+  // what we still send to endpoints that don't know about macs
+  auto frame = MakeFrame();
+  ASSERT_TRUE(frame.EncryptAndSign(msg, sessionKey, alice));
+  ASSERT_TRUE(frame.M.IsZero());
+  ASSERT_TRUE(frame.Verify(alice.pub));
+  ASSERT_FALSE(frame.VerifyMAC(sessionKey));
+
+  std::array< byte_t, service::MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+  llarp_buffer_t buf(tmp);
+  ASSERT_TRUE(frame.BEncode(&buf));
+  const std::string encoded(tmp.begin(), tmp.begin() + (buf.cur - buf.base));
+  ASSERT_EQ(encoded.find("1:M"), std::string::npos);
+}
+
+TEST_F(ProtocolFrameTest, VerifyBatchKeepsGoodFrames)
+{
+  std::vector< service::ProtocolFrame > frames(3, MakeFrame());
+  for(auto& frame : frames)
+    ASSERT_TRUE(frame.EncryptAndSign(msg, sessionKey, alice));
+  frames[1].Z[0] ^= 1;
+
+  std::vector< const service::ProtocolFrame* > batch;
+  std::vector< const service::ServiceInfo* > signers;
+  for(const auto& frame : frames)
+  {
+    batch.emplace_back(&frame);
+    signers.emplace_back(&alice.pub);
+  }
+  std::vector< char > valid;
+  ASSERT_EQ(2u, service::ProtocolFrame::VerifyBatch(batch, signers, valid));
+  ASSERT_EQ(std::vector< char >({1, 0, 1}), valid);
+}
+
+TEST_F(ProtocolFrameTest, AuthenticateCost)
+{
+  static constexpr size_t NumFrames = 2000;
+
+  const auto perFrame = [](std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+               std::chrono::steady_clock::now() - started)
+               .count()
+        / (1000.0 * NumFrames);
+  };
+
+  auto frame   = MakeFrame();
+  size_t good  = 0;
+  auto started = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < NumFrames; ++idx)
+  {
+    frame.EncryptAndSign(msg, sessionKey, alice);
+    good += frame.Verify(alice.pub);
+  }
+  const auto signedFrame = perFrame(started);
+  ASSERT_EQ(good, NumFrames);
+
+  good    = 0;
+  started = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < NumFrames; ++idx)
+  {
+    frame.EncryptAndMAC(msg, sessionKey);
+    good += frame.VerifyMAC(sessionKey);
+  }
+  const auto macFrame = perFrame(started);
+  ASSERT_EQ(good, NumFrames);
+
+  RecordProperty("us_per_frame_signed", std::to_string(signedFrame));
+  RecordProperty("us_per_frame_mac", std::to_string(macFrame));
+}
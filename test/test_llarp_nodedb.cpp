@@ -0,0 +1,225 @@
+#include <nodedb.hpp>
+#include <nodedb_store.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <llarp_test.hpp>
+#include <router_contact.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+using namespace ::llarp;
+
+struct NodeDBTest : public test::LlarpTest< sodium::CryptoLibSodium >
+{
+  const fs::path dir;
+
+  NodeDBTest()
+      : dir(fs::temp_directory_path()
+            / ("llarp-nodedb-test-" + std::to_string(randint())))
+  {
+    llarp_nodedb::ensure_dir(dir.string().c_str());
+  }
+
+  ~NodeDBTest()
+  {
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+  }
+
+  static RouterContact
+  MakeRC()
+  {
+    SecretKey sk;
+    CryptoManager::instance()->identity_keygen(sk);
+    RouterContact rc;
+    EXPECT_TRUE(rc.Sign(sk));
+    return rc;
+  }
+
+  fs::path
+  StorePath() const
+  {
+    return dir / "nodedb.store";
+  }
+
+  /// where the one file per rc layout kept an rc
+  fs::path
+  LegacyPath(const RouterContact &rc) const
+  {
+    const RouterID pk(rc.pubkey);
+    // first hex nibble of the pubkey
+    const fs::path sub = dir / std::string(1, "0123456789abcdef"[pk[0] >> 4]);
+    fs::create_directory(sub);
+    return sub / (pk.ToString() + ".signed");
+  }
+
+  /// everything live in the store at StorePath
+  std::vector< RouterContact >
+  ReadStore()
+  {
+    std::vector< RouterContact > rcs;
+    NodeDBStore store(StorePath());
+    EXPECT_TRUE(store.Open([&](const std::vector< string_view > &records) {
+      for(const auto &record : records)
+      {
+        llarp_buffer_t buf(record.data(), record.size());
+        rcs.emplace_back();
+        EXPECT_TRUE(rcs.back().BDecode(&buf));
+      }
+    }));
+    return rcs;
+  }
+};
+
+TEST_F(NodeDBTest, StoreLastRecordWins)
+{
+  const auto a = MakeRC();
+  const auto b = MakeRC();
+  auto newer   = a;
+  newer.last_updated++;
+  {
+    NodeDBStore store(StorePath());
+    ASSERT_TRUE(store.Open(nullptr));
+    ASSERT_TRUE(store.Put(a));
+    ASSERT_TRUE(store.Put(b));
+    ASSERT_TRUE(store.Put(newer));
+    ASSERT_TRUE(store.Remove(RouterID(b.pubkey)));
+    ASSERT_FALSE(store.Remove(RouterID(b.pubkey)));
+    ASSERT_EQ(1u, store.Count());
+    ASSERT_TRUE(store.Flush());
+  }
+  const auto rcs = ReadStore();
+  ASSERT_EQ(1u, rcs.size());
+  ASSERT_EQ(newer, rcs[0]);
+}
+
+TEST_F(NodeDBTest, StoreCutsTornTail)
+{
+  const auto a = MakeRC();
+  size_t whole = 0;
+  {
+    NodeDBStore store(StorePath());
+    ASSERT_TRUE(store.Open(nullptr));
+    ASSERT_TRUE(store.Put(a));
+    ASSERT_TRUE(store.Flush());
+    whole = store.FileSize();
+  }
+  {
+    // half a record, as if we died while appending it
+    std::ofstream f(StorePath().string(),
+                    std::ios::binary | std::ios::app | std::ios::out);
+    const char header[] = {0, 0, 1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 1};
+    f.write(header, sizeof(header));
+  }
+  ASSERT_EQ(1u, ReadStore().size());
+  ASSERT_EQ(whole, fs::file_size(StorePath()));
+
+  const auto b = MakeRC();
+  {
+    NodeDBStore store(StorePath());
+    ASSERT_TRUE(store.Open(nullptr));
+    ASSERT_TRUE(store.Put(b));
+  }
+  ASSERT_EQ(2u, ReadStore().size());
+}
+
+TEST_F(NodeDBTest, StoreSkipsCorruptRecord)
+{
+  const auto a = MakeRC();
+  const auto b = MakeRC();
+  const auto c = MakeRC();
+  size_t offset = 0;
+  {
+    NodeDBStore store(StorePath());
+    ASSERT_TRUE(store.Open(nullptr));
+    ASSERT_TRUE(store.Put(a));
+    offset = store.FileSize();
+    ASSERT_TRUE(store.Put(b));
+    ASSERT_TRUE(store.Put(c));
+    ASSERT_TRUE(store.Flush());
+  }
+  {
+    // flip a byte inside b's rc, its length header stays intact
+    std::fstream f(StorePath().string(),
+                   std::ios::binary | std::ios::in | std::ios::out);
+    const auto pos = offset + NodeDBStore::RecordHeaderSize + 64;
+    f.seekg(pos);
+    const char ch = f.get();
+    f.seekp(pos);
+    f.put(~ch);
+  }
+  const auto size = fs::file_size(StorePath());
+  const auto rcs  = ReadStore();
+  ASSERT_EQ(2u, rcs.size());
+  ASSERT_TRUE(std::find(rcs.begin(), rcs.end(), c) != rcs.end());
+  ASSERT_EQ(size, fs::file_size(StorePath()));
+}
+
+TEST_F(NodeDBTest, StoreCompacts)
+{
+  const auto a = MakeRC();
+  const auto b = MakeRC();
+  NodeDBStore store(StorePath());
+  ASSERT_TRUE(store.Open(nullptr));
+  ASSERT_TRUE(store.Put(b));
+  while(not store.ShouldCompact())
+    ASSERT_TRUE(store.Put(a));
+  const size_t before = store.FileSize();
+  ASSERT_TRUE(store.Compact({&a, &b}));
+  ASSERT_LT(store.FileSize(), before);
+  ASSERT_EQ(2u, store.Count());
+  ASSERT_FALSE(store.ShouldCompact());
+  ASSERT_FALSE(fs::exists(StorePath().string() + ".tmp"));
+  ASSERT_TRUE(store.Put(a));
+  ASSERT_TRUE(store.Flush());
+  ASSERT_EQ(2u, ReadStore().size());
+}
+
+TEST_F(NodeDBTest, LoadMigratesRCFiles)
+{
+  const auto a = MakeRC();
+  const auto b = MakeRC();
+  auto expired = MakeRC();
+  expired.last_updated = 0;
+  {
+    llarp_nodedb db(nullptr);
+    ASSERT_TRUE(a.Write(LegacyPath(a).c_str()));
+    ASSERT_TRUE(expired.Write(LegacyPath(expired).c_str()));
+    ASSERT_EQ(1, db.load_dir(dir.string().c_str()));
+    ASSERT_FALSE(fs::exists(LegacyPath(a)));
+    ASSERT_TRUE(db.Insert(b));
+    db.SaveAll();
+  }
+  llarp_nodedb db(nullptr);
+  ASSERT_EQ(2, db.load_dir(dir.string().c_str()));
+  ASSERT_TRUE(db.Has(a.pubkey));
+  ASSERT_TRUE(db.Has(b.pubkey));
+  db.Remove(a.pubkey);
+  db.SaveAll();
+  ASSERT_EQ(1u, ReadStore().size());
+}
+
+// 50k keygens and signs, run with --gtest_also_run_disabled_tests
+TEST_F(NodeDBTest, DISABLED_StartupTime)
+{
+  static constexpr size_t NumRCs = 50 * 1000;
+  {
+    NodeDBStore store(StorePath());
+    ASSERT_TRUE(store.Open(nullptr));
+    for(size_t idx = 0; idx < NumRCs; ++idx)
+      ASSERT_TRUE(store.Put(MakeRC()));
+    ASSERT_TRUE(store.Flush());
+  }
+  llarp_nodedb db(nullptr);
+  const auto started = std::chrono::steady_clock::now();
+  ASSERT_EQ(ssize_t(NumRCs), db.load_dir(dir.string().c_str()));
+  const std::chrono::duration< double, std::milli > elapsed =
+      std::chrono::steady_clock::now() - started;
+  ASSERT_EQ(NumRCs, db.num_loaded());
+  RecordProperty("load_ms_50k", std::to_string(elapsed.count()));
+}
@@ -47,3 +47,27 @@ TEST_F(RCTest, TestSignVerify)
   ASSERT_TRUE(rc.Sign(sign));
   ASSERT_TRUE(rc.Verify(time_now_ms()));
 }
+
+TEST_F(RCTest, TestVerifyBatch)
+{
+  std::vector< RC_t > rcs(3);
+  for(auto &rc : rcs)
+  {
+    SecKey_t sign;
+    rc.pubkey = sign.toPublic();
+  }
+  rcs[2].exits.emplace_back(rcs[2].pubkey, nuint32_t{50000});
+
+  // all signatures are checked by a single call, the second one is bad
+  EXPECT_CALL(m_crypto, verify(_, _, _)).Times(0);
+  EXPECT_CALL(m_crypto, verify_batch(_, 3))
+      .WillOnce(Invoke([](VerifyJob *jobs, size_t n) {
+        for(size_t idx = 0; idx < n; ++idx)
+          jobs[idx].valid = idx != 1;
+        return false;
+      }));
+
+  std::vector< char > valid;
+  ASSERT_EQ(RC_t::VerifyBatch(rcs, time_now_ms(), valid), 2u);
+  ASSERT_EQ(valid, std::vector< char >({1, 0, 1}));
+}
@@ -0,0 +1,190 @@
+#include <util/metrics/metrics.hpp>
+#include <util/metrics/sharded.hpp>
+
+#include <router_id.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace llarp;
+using namespace metrics;
+
+static const Record< int > *
+findRecord(const Records &records, string_view metric, const Tags &tags = {})
+{
+  for(const auto &tagged : records.intRecords)
+  {
+    if(tagged.id.metricName() != metric)
+    {
+      continue;
+    }
+    auto it = tagged.data.find(tags);
+    return it == tagged.data.end() ? nullptr : &it->second;
+  }
+  return nullptr;
+}
+
+TEST(MetricsSharded, CounterAcrossThreads)
+{
+  Manager manager;
+  ShardedCounter counter("Sharded", "Counter", &manager);
+  ASSERT_TRUE(counter.active());
+
+  std::vector< std::thread > threads;
+  for(int t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([&counter, t]() {
+      for(int i = 0; i < 1000; ++i)
+      {
+        counter.tick(t + 1);
+      }
+    });
+  }
+  for(auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  Records records;
+  manager.collectSample(records, true);
+  const auto *rec = findRecord(records, "Counter");
+  ASSERT_NE(nullptr, rec);
+  ASSERT_EQ(8000u, rec->count());
+  ASSERT_EQ(36000, rec->total());
+  ASSERT_EQ(1, rec->min());
+  ASSERT_EQ(8, rec->max());
+
+  // the shards were emptied
+  Records again;
+  manager.collectSample(again, true);
+  ASSERT_EQ(nullptr, findRecord(again, "Counter"));
+}
+
+TEST(MetricsSharded, HistogramBuckets)
+{
+  ASSERT_EQ(0u, ShardedHistogram::bucket(-5));
+  ASSERT_EQ(0u, ShardedHistogram::bucket(0));
+  ASSERT_EQ(1u, ShardedHistogram::bucket(1));
+  ASSERT_EQ(2u, ShardedHistogram::bucket(3));
+  ASSERT_EQ(3u, ShardedHistogram::bucket(4));
+  ASSERT_EQ(11u, ShardedHistogram::bucket(1500));
+  ASSERT_EQ(31u, ShardedHistogram::bucket(std::numeric_limits< int >::max()));
+
+  Manager manager;
+  ShardedHistogram histogram("Sharded", "Histogram", &manager);
+  for(int val : {1, 100, 120, 1500})
+  {
+    histogram.tick(val);
+  }
+  Records records;
+  manager.collectSample(records, true);
+  const auto *all = findRecord(records, "Histogram");
+  ASSERT_NE(nullptr, all);
+  ASSERT_EQ(4u, all->count());
+  ASSERT_EQ(1721, all->total());
+
+  const auto *hundreds =
+      findRecord(records, "Histogram", packToTags("le", int64_t(127)));
+  ASSERT_NE(nullptr, hundreds);
+  ASSERT_EQ(2u, hundreds->count());
+  ASSERT_EQ(nullptr,
+            findRecord(records, "Histogram", packToTags("le", int64_t(255))));
+}
+
+TEST(MetricsSharded, TopKKeepsHeavyHitters)
+{
+  Manager manager;
+  TopKCounter< RouterID > peers("Sharded", "Peers", 4, &manager);
+  std::vector< RouterID > heavy(4);
+  for(size_t i = 0; i < heavy.size(); ++i)
+  {
+    heavy[i].Randomize();
+  }
+  // lots of peers we hear from once, a few we hear from all the time
+  for(int round = 0; round < 100; ++round)
+  {
+    RouterID once;
+    once.Randomize();
+    peers.tick(once);
+    for(const auto &id : heavy)
+    {
+      peers.tick(id, 10);
+    }
+  }
+
+  Records records;
+  manager.collectSample(records, true);
+  const auto *all = findRecord(records, "Peers");
+  ASSERT_NE(nullptr, all);
+  ASSERT_EQ(500u, all->count());
+
+  size_t published = 0;
+  for(const auto &tagged : records.intRecords)
+  {
+    if(tagged.id.metricName() == string_view("Peers"))
+    {
+      // the untagged total and one record per top peer
+      published = tagged.data.size();
+    }
+  }
+  ASSERT_EQ(1 + peers.k(), published);
+  for(const auto &id : heavy)
+  {
+    const auto *rec =
+        findRecord(records, "Peers", packToTags("id", id.ToString()));
+    ASSERT_NE(nullptr, rec) << id;
+    ASSERT_GE(rec->count(), 100u);
+  }
+}
+
+TEST(MetricsSharded, NoManager)
+{
+  ShardedCounter counter("Sharded", "Counter");
+  ASSERT_FALSE(counter.active());
+  counter.tick();
+  counter.flush();
+}
+
+TEST(MetricsSharded, IncrementCost)
+{
+  DefaultManagerGuard guard;
+  static constexpr size_t Iterations = 100000;
+  RouterID peer;
+  peer.Randomize();
+
+  const auto perCall = [](std::chrono::steady_clock::duration dlt) {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(dlt).count()
+        / double(Iterations);
+  };
+
+  // what the link message parser used to do for every message
+  auto started = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < Iterations; ++i)
+  {
+    integerTick("Bench", "RX", 1, "id", peer.ToString());
+  }
+  const auto tagged = std::chrono::steady_clock::now() - started;
+
+  ShardedCounter counter("Bench", "ShardedRX");
+  TopKCounter< RouterID > peers("Bench", "PeerRX", 16);
+  started = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < Iterations; ++i)
+  {
+    counter.tick();
+    peers.tick(peer);
+  }
+  const auto sharded = std::chrono::steady_clock::now() - started;
+
+  Records records;
+  guard.instance()->collectSample(records, true);
+  const auto *rec = findRecord(records, "ShardedRX");
+  ASSERT_NE(nullptr, rec);
+  ASSERT_EQ(Iterations, rec->count());
+
+  RecordProperty("ns_per_tick_tagged", std::to_string(perCall(tagged)));
+  RecordProperty("ns_per_tick_sharded", std::to_string(perCall(sharded)));
+}
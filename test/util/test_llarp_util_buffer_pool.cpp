@@ -0,0 +1,94 @@
+#include <util/buffer_pool.hpp>
+#include <util/buffer.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+struct BufferPoolTest : public ::testing::Test
+{
+};
+
+TEST_F(BufferPoolTest, TestRecycle)
+{
+  llarp::BufferPool pool(64, 4);
+  auto* first = pool.Acquire();
+  ASSERT_NE(first, nullptr);
+  ASSERT_EQ(first->capacity, 64u);
+  ASSERT_EQ(first->pool, &pool);
+  first->refs = 0;
+  pool.Release(first);
+  // the block we just released comes straight back
+  auto* second = pool.Acquire();
+  ASSERT_EQ(first, second);
+  second->refs = 0;
+  pool.Release(second);
+}
+
+TEST_F(BufferPoolTest, TestNoAllocationsInSteadyState)
+{
+  {
+    // warm up
+    llarp::PooledBuffer buf(size_t{1500});
+  }
+  const auto allocs = llarp::BufferPool::Allocations();
+  for(size_t idx = 0; idx < 1000; ++idx)
+  {
+    llarp::PooledBuffer buf(size_t{1200});
+    ASSERT_EQ(buf.size(), 1200u);
+  }
+  ASSERT_EQ(llarp::BufferPool::Allocations(), allocs);
+}
+
+TEST_F(BufferPoolTest, TestShareAndMove)
+{
+  std::array< byte_t, 32 > data;
+  std::fill(data.begin(), data.end(), 0xa5);
+  llarp::PooledBuffer first(data.data(), data.size());
+  llarp::PooledBuffer second = first;
+  // copies share the block
+  ASSERT_EQ(first.data(), second.data());
+  llarp::PooledBuffer third = std::move(second);
+  ASSERT_TRUE(second.empty());
+  ASSERT_EQ(second.data(), nullptr);
+  ASSERT_EQ(first.data(), third.data());
+  ASSERT_TRUE(std::equal(third.begin(), third.end(), data.begin()));
+
+  // assigning bytes into a shared buffer must not clobber the other holder
+  std::array< byte_t, 16 > other;
+  std::fill(other.begin(), other.end(), 0x5a);
+  third = llarp_buffer_t(other);
+  ASSERT_NE(first.data(), third.data());
+  ASSERT_EQ(third.size(), other.size());
+  ASSERT_TRUE(std::equal(first.begin(), first.end(), data.begin()));
+  ASSERT_TRUE(std::equal(third.begin(), third.end(), other.begin()));
+}
+
+TEST_F(BufferPoolTest, TestResize)
+{
+  llarp::PooledBuffer buf(size_t{100});
+  std::fill(buf.begin(), buf.end(), 0x11);
+  buf.resize(10);
+  ASSERT_EQ(buf.size(), 10u);
+  // growing past the block moves us into a bigger one
+  buf.resize(4000);
+  ASSERT_EQ(buf.size(), 4000u);
+  ASSERT_GE(buf.capacity(), 4000u);
+  ASSERT_TRUE(std::all_of(buf.begin(), buf.begin() + 10,
+                          [](byte_t b) { return b == 0x11; }));
+}
+
+TEST_F(BufferPoolTest, TestBEncode)
+{
+  std::array< byte_t, 64 > tmp;
+  llarp_buffer_t out(tmp);
+  const std::string str("pooled");
+  llarp::PooledBuffer buf(reinterpret_cast< const byte_t* >(str.data()),
+                          str.size());
+  ASSERT_TRUE(buf.BEncode(&out));
+  out.sz  = out.cur - out.base;
+  out.cur = out.base;
+  llarp::PooledBuffer decoded;
+  ASSERT_TRUE(decoded.BDecode(&out));
+  ASSERT_EQ(decoded.size(), str.size());
+  ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), buf.begin()));
+}
@@ -0,0 +1,166 @@
+#include <util/logging/log_queue.hpp>
+#include <util/logging/logger.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+struct LogQueueTest : public ::testing::Test
+{
+  struct Line
+  {
+    uint16_t threadID;
+    llarp_time_t when;
+    std::string msg;
+  };
+
+  std::vector< Line > lines;
+
+  LogQueue::Sink_t
+  Sink()
+  {
+    return [&](const LogRecord& rec) {
+      lines.push_back({rec.threadID, rec.when, std::string(rec.Message())});
+    };
+  }
+};
+
+/// counts what it would have written
+struct NullLogStream : public ILogStream
+{
+  size_t& lines;
+
+  explicit NullLogStream(size_t& count) : lines(count)
+  {
+  }
+
+  void
+  PreLog(std::stringstream&, LogLevel, const char*, int,
+         const std::string&) const override
+  {
+  }
+
+  void
+  Print(LogLevel, const char*, const std::string&) override
+  {
+  }
+
+  void
+  PostLog(std::stringstream&) const override
+  {
+  }
+
+  void
+  AppendLog(LogLevel, const char*, int, const std::string&,
+            const std::string) override
+  {
+    lines++;
+  }
+
+  void
+  Tick(llarp_time_t) override
+  {
+  }
+};
+
+TEST_F(LogQueueTest, OrderedAcrossThreads)
+{
+  LogQueue queue(Sink());
+  std::vector< std::thread > threads;
+  for(uint16_t id = 0; id < 4; ++id)
+  {
+    threads.emplace_back([&queue, id]() {
+      for(llarp_time_t when = id; when < 200; when += 4)
+        queue.Push(eLogInfo, "test", __LINE__, id, when,
+                   "line " + std::to_string(when));
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+  queue.Drain();
+
+  ASSERT_EQ(200u, lines.size());
+  for(llarp_time_t when = 0; when < 200; ++when)
+  {
+    ASSERT_EQ(when, lines[when].when);
+    ASSERT_EQ(when % 4, lines[when].threadID);
+    ASSERT_EQ("line " + std::to_string(when), lines[when].msg);
+  }
+  ASSERT_EQ(0u, queue.Dropped());
+}
+
+TEST_F(LogQueueTest, CountsDrops)
+{
+  LogQueue queue(Sink());
+  const std::string big(LogRecord::MaxMessageSize * 2, 'x');
+  for(size_t idx = 0; idx < LogRing::Capacity + 10; ++idx)
+    queue.Push(eLogInfo, "test", __LINE__, 0, idx, big);
+  queue.Drain();
+
+  // every line that fit, cut short, then one line saying what was lost
+  ASSERT_EQ(LogRing::Capacity + 1, lines.size());
+  ASSERT_EQ(LogRecord::MaxMessageSize, lines.front().msg.size());
+  ASSERT_NE(std::string::npos, lines.back().msg.find("dropped 10 "));
+  ASSERT_EQ(10u, queue.Dropped());
+
+  // the ring has room again
+  lines.clear();
+  queue.Push(eLogInfo, "test", __LINE__, 0, 0, "again");
+  queue.Drain();
+  ASSERT_EQ(1u, lines.size());
+  ASSERT_EQ(10u, queue.Dropped());
+}
+
+TEST_F(LogQueueTest, StopWritesEverything)
+{
+  LogQueue queue(Sink());
+  queue.Start();
+  for(llarp_time_t when = 0; when < 100; ++when)
+    queue.Push(eLogInfo, "test", __LINE__, 0, when, "line");
+  queue.Stop();
+  ASSERT_EQ(100u, lines.size());
+}
+
+TEST_F(LogQueueTest, LogCallCost)
+{
+  static constexpr size_t Burst  = LogRing::Capacity / 2;
+  static constexpr size_t Bursts = 200;
+  auto& ctx                      = LogContext::Instance();
+  const auto level               = ctx.curLevel;
+  size_t written                 = 0;
+  auto old = ctx.SetLogStream(std::make_unique< NullLogStream >(written));
+
+  // filtered out by level, never formatted
+  ctx.curLevel = eLogWarn;
+  auto started = std::chrono::steady_clock::now();
+  for(size_t idx = 0; idx < Burst * Bursts; ++idx)
+    LogInfo("filtered ", idx, " ", 1.5);
+  const auto filtered = std::chrono::steady_clock::now() - started;
+
+  // formatted and queued, the writing happens off the clock
+  ctx.curLevel = eLogInfo;
+  std::chrono::steady_clock::duration queued{0};
+  for(size_t burst = 0; burst < Bursts; ++burst)
+  {
+    started = std::chrono::steady_clock::now();
+    for(size_t idx = 0; idx < Burst; ++idx)
+      LogInfo("queued ", idx, " ", 1.5);
+    queued += std::chrono::steady_clock::now() - started;
+    ctx.Flush();
+  }
+  ctx.curLevel = level;
+  ctx.SetLogStream(std::move(old));
+
+  ASSERT_EQ(Burst * Bursts, written);
+  const auto perCall = [](std::chrono::steady_clock::duration dlt) {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(dlt).count()
+        / double(Burst * Bursts);
+  };
+  RecordProperty("ns_per_log_filtered", std::to_string(perCall(filtered)));
+  RecordProperty("ns_per_log_queued", std::to_string(perCall(queued)));
+}
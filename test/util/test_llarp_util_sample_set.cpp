@@ -0,0 +1,84 @@
+#include <util/sample_set.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+using Set = llarp::util::SampleSet< int, int, std::hash< int > >;
+
+TEST(SampleSet, InsertRemove)
+{
+  Set set;
+  for(int key = 0; key < 10; ++key)
+    set.Insert(key, key * 10);
+  ASSERT_EQ(10u, set.Size());
+  set.Insert(3, 33);
+  ASSERT_EQ(10u, set.Size());
+
+  ASSERT_TRUE(set.Remove(0));
+  ASSERT_FALSE(set.Remove(0));
+  ASSERT_TRUE(set.Remove(5));
+  ASSERT_FALSE(set.Contains(5));
+  ASSERT_TRUE(set.Contains(9));
+  ASSERT_EQ(8u, set.Size());
+
+  // what is left stays back to back and the moved values are still found
+  std::map< int, size_t > seen;
+  for(const auto val : set.Values())
+    seen[val]++;
+  const std::map< int, size_t > expect{{10, 1}, {20, 1}, {33, 1}, {40, 1},
+                                       {60, 1}, {70, 1}, {80, 1}, {90, 1}};
+  ASSERT_EQ(expect, seen);
+  ASSERT_TRUE(set.Remove(9));
+  ASSERT_TRUE(set.Remove(1));
+  ASSERT_EQ(6u, set.Size());
+}
+
+TEST(SampleSet, Sample)
+{
+  std::mt19937_64 rng{42};
+  auto rand = [&]() -> uint64_t { return rng(); };
+  const std::vector< int > empty;
+  ASSERT_EQ(nullptr, llarp::util::SampleUniform(empty, rand));
+
+  std::vector< int > vals;
+  for(int val = 0; val < 100; ++val)
+    vals.push_back(val);
+  std::map< int, size_t > counts;
+  for(size_t idx = 0; idx < 10000; ++idx)
+    counts[*llarp::util::SampleUniform(vals, rand)]++;
+  ASSERT_EQ(100u, counts.size());
+
+  // only one acceptable value, found by the scan after the guesses miss
+  for(size_t idx = 0; idx < 100; ++idx)
+  {
+    const auto* val =
+        llarp::util::SampleIf(vals, rand, [](int v) { return v == 77; });
+    ASSERT_NE(nullptr, val);
+    ASSERT_EQ(77, *val);
+  }
+  ASSERT_EQ(nullptr,
+            llarp::util::SampleIf(vals, rand, [](int v) { return v > 100; }));
+}
+
+TEST(SampleSet, SampleWeighted)
+{
+  std::mt19937_64 rng{42};
+  auto rand = [&]() -> uint64_t { return rng(); };
+  const std::vector< int > vals{0, 1, 2, 3};
+  // value 3 is three times as likely as 1, 0 and 2 never come up
+  std::map< int, size_t > counts;
+  for(size_t idx = 0; idx < 40000; ++idx)
+  {
+    const auto* val = llarp::util::SampleWeighted(
+        vals, rand, [](int v) -> double { return v % 2 ? v : 0; });
+    ASSERT_NE(nullptr, val);
+    counts[*val]++;
+  }
+  ASSERT_EQ(2u, counts.size());
+  ASSERT_NEAR(3.0, double(counts[3]) / counts[1], 0.3);
+  ASSERT_EQ(nullptr, llarp::util::SampleWeighted(vals, rand, [](int) {
+              return 0.0;
+            }));
+}
@@ -0,0 +1,75 @@
+#include <util/sequence_window.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using Window = llarp::util::SequenceWindow< std::string, 8 >;
+
+TEST(SequenceWindow, EmplaceFindErase)
+{
+  Window window;
+  ASSERT_TRUE(window.IsEmpty());
+  ASSERT_NE(nullptr, window.Emplace(3, "three"));
+  ASSERT_NE(nullptr, window.Emplace(4, "four"));
+  ASSERT_EQ(2u, window.Count());
+  ASSERT_EQ("three", *window.Find(3));
+  ASSERT_EQ(nullptr, window.Find(5));
+  // same slot as 3 but a window further on
+  ASSERT_EQ(nullptr, window.Find(11));
+  ASSERT_EQ(nullptr, window.Emplace(11, "eleven"));
+  ASSERT_EQ(3u, window.AtSlot(11)->first);
+
+  ASSERT_TRUE(window.Erase(3));
+  ASSERT_FALSE(window.Erase(3));
+  ASSERT_EQ("four", *window.Find(4));
+  ASSERT_NE(nullptr, window.Emplace(11, "eleven"));
+  ASSERT_EQ("eleven", *window.Find(11));
+  ASSERT_EQ(2u, window.Count());
+}
+
+TEST(SequenceWindow, EraseIf)
+{
+  Window window;
+  for(uint64_t seq = 100; seq < 108; ++seq)
+    ASSERT_NE(nullptr, window.Emplace(seq, std::to_string(seq)));
+  window.EraseIf([](uint64_t seq, std::string&) { return seq % 2 == 0; });
+  ASSERT_EQ(4u, window.Count());
+  size_t visited = 0;
+  window.ForEach([&](uint64_t seq, std::string& val) {
+    ASSERT_EQ(1u, seq % 2);
+    ASSERT_EQ(std::to_string(seq), val);
+    visited++;
+  });
+  ASSERT_EQ(4u, visited);
+  for(uint64_t seq = 100; seq < 108; ++seq)
+    ASSERT_EQ(seq % 2 == 1, window.Find(seq) != nullptr);
+}
+
+TEST(ReplayWindow, Slide)
+{
+  llarp::util::ReplayWindow< 64 > replay;
+  ASSERT_FALSE(replay.Contains(0));
+  replay.Insert(5);
+  ASSERT_TRUE(replay.Contains(5));
+  ASSERT_FALSE(replay.Contains(4));
+  ASSERT_FALSE(replay.Contains(6));
+  replay.Insert(2);
+  ASSERT_TRUE(replay.Contains(2));
+  ASSERT_EQ(2u, replay.Count());
+
+  // slide part way, what we saw stays seen
+  replay.Insert(60);
+  ASSERT_TRUE(replay.Contains(5));
+  ASSERT_FALSE(replay.Contains(59));
+  // bits reused from the last lap must read as unseen
+  replay.Insert(69);
+  ASSERT_TRUE(replay.Contains(5));
+  ASSERT_FALSE(replay.Contains(66));
+  ASSERT_TRUE(replay.Contains(69));
+  // everything older than the window counts as seen
+  replay.Insert(1000);
+  ASSERT_TRUE(replay.Contains(900));
+  ASSERT_FALSE(replay.Contains(999));
+  ASSERT_EQ(1u, replay.Count());
+}
@@ -0,0 +1,217 @@
+#include <util/thread/task_queue.hpp>
+
+#include <util/metrics/metrics.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/queue.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace llarp;
+using namespace llarp::thread;
+
+TEST(TestTask, InlineAndHeap)
+{
+  auto counter = std::make_shared< int >(0);
+
+  auto inc = [counter]() { ++*counter; };
+  static_assert(Task::Fits< decltype(inc) >::value, "");
+  Task small(inc);
+  ASSERT_TRUE(small);
+  small();
+  ASSERT_EQ(*counter, 1);
+
+  std::array< char, Task::InlineSize * 2 > blob{};
+  auto big = [counter, blob]() { *counter += 1 + blob[0]; };
+  static_assert(not Task::Fits< decltype(big) >::value, "");
+  Task large(big);
+  large();
+  ASSERT_EQ(*counter, 2);
+
+  // moves keep the callable alive exactly once
+  Task moved(std::move(small));
+  ASSERT_FALSE(small);
+  moved();
+  ASSERT_EQ(*counter, 3);
+  large = std::move(moved);
+  large();
+  ASSERT_EQ(*counter, 4);
+  // counter, inc, big and the one in large
+  ASSERT_EQ(counter.use_count(), 4);
+
+  large = Task();
+  ASSERT_EQ(counter.use_count(), 3);
+}
+
+TEST(TestTaskQueue, ManyProducers)
+{
+  static constexpr size_t NumProducers = 4;
+  static constexpr size_t PerProducer  = 50000;
+
+  TaskQueue queue("test");
+  size_t ran = 0;
+  std::atomic< size_t > wakes{0};
+
+  std::vector< std::thread > producers;
+  for(size_t idx = 0; idx < NumProducers; ++idx)
+  {
+    producers.emplace_back([&]() {
+      for(size_t call = 0; call < PerProducer; ++call)
+      {
+        if(queue.Push([&ran]() { ++ran; }))
+          wakes++;
+      }
+    });
+  }
+
+  while(ran < NumProducers * PerProducer)
+    queue.Drain(64);
+  for(auto& producer : producers)
+    producer.join();
+
+  ASSERT_EQ(ran, NumProducers * PerProducer);
+  ASSERT_EQ(queue.Size(), 0u);
+  ASSERT_FALSE(queue.Drain(64));
+  ASSERT_GE(wakes.load(), 1u);
+  ASSERT_LE(wakes.load(), NumProducers * PerProducer);
+}
+
+TEST(TestTaskQueue, DestroyUnrun)
+{
+  auto counter = std::make_shared< int >(0);
+  {
+    TaskQueue queue("test");
+    ASSERT_TRUE(queue.Push([counter]() { ++*counter; }));
+    ASSERT_FALSE(queue.Push([counter]() { ++*counter; }));
+    ASSERT_EQ(queue.Size(), 2u);
+    ASSERT_TRUE(queue.Drain(1));
+    ASSERT_EQ(*counter, 1);
+  }
+  ASSERT_EQ(*counter, 1);
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(TestTaskQueue, LogicWakesOncePerBatch)
+{
+  auto logic = std::make_shared< Logic >();
+  size_t wakes = 0;
+  logic->SetWaker([&wakes]() { wakes++; });
+  ASSERT_EQ(wakes, 1u);
+  // this thread is the logic thread now
+  ASSERT_FALSE(logic->RunQueued());
+  ASSERT_TRUE(logic->can_flush());
+
+  size_t ran = 0;
+  std::thread other([&]() {
+    for(size_t idx = 0; idx < Logic::MaxCallsPerWake * 2; ++idx)
+      LogicCall(logic, [&ran]() { ++ran; });
+  });
+  other.join();
+  ASSERT_EQ(wakes, 2u);
+  ASSERT_EQ(logic->numPendingJobs(), Logic::MaxCallsPerWake * 2);
+
+  ASSERT_TRUE(logic->RunQueued());
+  ASSERT_EQ(ran, Logic::MaxCallsPerWake);
+  ASSERT_FALSE(logic->RunQueued());
+  ASSERT_EQ(ran, Logic::MaxCallsPerWake * 2);
+
+  // calls from the logic thread run right away
+  LogicCall(logic, [&ran]() { ++ran; });
+  ASSERT_EQ(ran, Logic::MaxCallsPerWake * 2 + 1);
+  logic->stop();
+}
+
+TEST(TestTaskQueue, LogicMetricsAfterSetup)
+{
+  // the daemon makes its logic before the metrics manager exists
+  auto logic = std::make_shared< Logic >();
+  metrics::DefaultManagerGuard guard;
+  logic->EnableMetrics();
+  logic->SetWaker([]() {});
+  ASSERT_FALSE(logic->RunQueued());
+
+  metrics::Records records;
+  guard.instance()->collectSample(records, true);
+  const auto published = [&records](const std::string& name) {
+    for(const auto& tagged : records.intRecords)
+    {
+      if(std::string(tagged.id.categoryName()) == "logic"
+         && std::string(tagged.id.metricName()) == name)
+        return !tagged.data.empty();
+    }
+    return false;
+  };
+  ASSERT_TRUE(published("QueueDepth"));
+  ASSERT_TRUE(published("TaskLatency"));
+  logic->stop();
+  // its metrics have to go before the manager they registered with
+  logic.reset();
+}
+
+TEST(TestTaskQueue, CallsPerSecond)
+{
+  static constexpr size_t NumCalls = 200000;
+
+  const auto perSecond = [](std::chrono::steady_clock::time_point started) {
+    using std::chrono::microseconds;
+    const auto elapsed = std::chrono::duration_cast< microseconds >(
+        std::chrono::steady_clock::now() - started);
+    return NumCalls * 1000000.0 / std::max< int64_t >(elapsed.count(), 1);
+  };
+
+  // what logic calls went through before, a bounded queue of
+  // std::function and a wake for every call
+  size_t ran = 0;
+  std::atomic< size_t > wakes{0};
+  Queue< std::function< void(void) > > old(1024);
+  auto started = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    for(size_t idx = 0; idx < NumCalls; ++idx)
+    {
+      old.pushBack([&ran]() { ++ran; });
+      wakes++;
+    }
+  });
+  while(ran < NumCalls)
+  {
+    if(old.empty())
+      continue;
+    auto f = old.popFront();
+    f();
+  }
+  producer.join();
+  const auto oldRate  = perSecond(started);
+  const auto oldWakes = wakes.load();
+
+  ran   = 0;
+  wakes = 0;
+  TaskQueue queue("test");
+  started  = std::chrono::steady_clock::now();
+  producer = std::thread([&]() {
+    for(size_t idx = 0; idx < NumCalls; ++idx)
+    {
+      if(queue.Push([&ran]() { ++ran; }))
+        wakes++;
+    }
+  });
+  while(ran < NumCalls)
+    queue.Drain(Logic::MaxCallsPerWake);
+  producer.join();
+  const auto newRate = perSecond(started);
+
+  ASSERT_EQ(oldWakes, NumCalls);
+  ASSERT_LE(wakes.load(), NumCalls);
+
+  RecordProperty("calls_per_sec_function_queue", std::to_string(oldRate));
+  RecordProperty("calls_per_sec_task_queue", std::to_string(newRate));
+  RecordProperty("wakes_task_queue", std::to_string(wakes.load()));
+}
@@ -0,0 +1,149 @@
+#include <util/thread/timerwheel.hpp>
+
+#include <gtest/gtest.h>
+
+using TimerWheel = llarp::thread::TimerWheel;
+
+static void
+RunAll(std::vector< TimerWheel::Callback >& expired)
+{
+  for(const auto& f : expired)
+    f();
+  expired.clear();
+}
+
+TEST(TimerWheel, smoke)
+{
+  TimerWheel wheel(1000);
+  std::vector< TimerWheel::Callback > expired;
+  int fired = 0;
+  wheel.Schedule(1000, 10, [&]() { fired++; });
+  ASSERT_EQ(1u, wheel.Size());
+  ASSERT_EQ(10u, wheel.TimeUntilNext(1000));
+
+  ASSERT_EQ(0u, wheel.Advance(1009, expired));
+  ASSERT_EQ(1u, wheel.Advance(1010, expired));
+  RunAll(expired);
+  ASSERT_EQ(1, fired);
+  ASSERT_EQ(0u, wheel.Size());
+}
+
+TEST(TimerWheel, cancel)
+{
+  TimerWheel wheel(0);
+  std::vector< TimerWheel::Callback > expired;
+  int fired = 0;
+  auto a    = wheel.Schedule(0, 5, [&]() { fired += 1; });
+  auto b    = wheel.Schedule(0, 5, [&]() { fired += 10; });
+  ASSERT_TRUE(wheel.Cancel(a));
+  // second cancel of the same handle is a no op
+  ASSERT_FALSE(wheel.Cancel(a));
+  wheel.Advance(10, expired);
+  RunAll(expired);
+  ASSERT_EQ(10, fired);
+  // already fired
+  ASSERT_FALSE(wheel.Cancel(b));
+  // a stale handle must not cancel whatever reused its node
+  auto c = wheel.Schedule(10, 5, [&]() { fired += 100; });
+  ASSERT_FALSE(wheel.Cancel(a));
+  wheel.Advance(20, expired);
+  RunAll(expired);
+  ASSERT_EQ(110, fired);
+  ASSERT_FALSE(wheel.Cancel(c));
+}
+
+TEST(TimerWheel, cascade)
+{
+  TimerWheel wheel(123);
+  std::vector< TimerWheel::Callback > expired;
+  std::vector< llarp_time_t > delays{1,     255,   256,    257,    1000,
+                                     65535, 65536, 100000, 5000000};
+  std::vector< llarp_time_t > fired;
+  llarp_time_t now = 123;
+  for(const auto delay : delays)
+    wheel.Schedule(now, delay, [&fired, &now]() { fired.push_back(now); });
+
+  // walk time forward in uneven steps, every timer must fire on the first
+  // advance that reaches its expiry
+  while(wheel.Size())
+  {
+    now += 97;
+    wheel.Advance(now, expired);
+    RunAll(expired);
+  }
+  ASSERT_EQ(delays.size(), fired.size());
+  for(size_t idx = 0; idx < delays.size(); ++idx)
+  {
+    const llarp_time_t expiry = 123 + delays[idx];
+    ASSERT_GE(fired[idx], expiry);
+    ASSERT_LT(fired[idx], expiry + 97);
+  }
+}
+
+TEST(TimerWheel, order)
+{
+  TimerWheel wheel(0);
+  std::vector< TimerWheel::Callback > expired;
+  std::vector< int > order;
+  wheel.Schedule(0, 300, [&]() { order.push_back(3); });
+  wheel.Schedule(0, 2, [&]() { order.push_back(1); });
+  wheel.Schedule(0, 70000, [&]() { order.push_back(4); });
+  wheel.Schedule(0, 20, [&]() { order.push_back(2); });
+  ASSERT_EQ(4u, wheel.Advance(80000, expired));
+  RunAll(expired);
+  ASSERT_EQ(order, std::vector< int >({1, 2, 3, 4}));
+}
+
+TEST(TimerWheel, next_with_coarse_level)
+{
+  TimerWheel wheel(0);
+  std::vector< TimerWheel::Callback > expired;
+  // sits in level 1 until it cascades down at 256
+  wheel.Schedule(0, 300, []() {});
+  wheel.Advance(250, expired);
+  // sits in level 0 and expires after the one above
+  wheel.Schedule(250, 200, []() {});
+  ASSERT_EQ(6u, wheel.TimeUntilNext(250));
+  wheel.Advance(256, expired);
+  ASSERT_TRUE(expired.empty());
+  ASSERT_EQ(44u, wheel.TimeUntilNext(256));
+  ASSERT_EQ(1u, wheel.Advance(300, expired));
+}
+
+TEST(TimerWheel, idle)
+{
+  TimerWheel wheel(0);
+  std::vector< TimerWheel::Callback > expired;
+  bool fired = false;
+  // a timer scheduled long after the wheel last moved must not fire early
+  wheel.Schedule(1000000, 50, [&]() { fired = true; });
+  wheel.Advance(1000049, expired);
+  ASSERT_TRUE(expired.empty());
+  wheel.Advance(1000050, expired);
+  RunAll(expired);
+  ASSERT_TRUE(fired);
+}
+
+// load test, run with --gtest_also_run_disabled_tests
+TEST(TimerWheel, DISABLED_ScheduleCancelMillion)
+{
+  static constexpr size_t count = 1000000;
+  TimerWheel wheel(0);
+  std::vector< TimerWheel::Handle > handles;
+  handles.reserve(count);
+  size_t fired = 0;
+  for(size_t idx = 0; idx < count; ++idx)
+    handles.push_back(
+        wheel.Schedule(0, 1 + (idx * 7919) % 600000, [&]() { fired++; }));
+  ASSERT_EQ(count, wheel.Size());
+  // cancel every other timer, let the rest expire
+  for(size_t idx = 0; idx < count; idx += 2)
+    ASSERT_TRUE(wheel.Cancel(handles[idx]));
+  ASSERT_EQ(count / 2, wheel.Size());
+  std::vector< TimerWheel::Callback > expired;
+  expired.reserve(count / 2);
+  ASSERT_EQ(count / 2, wheel.Advance(600000, expired));
+  RunAll(expired);
+  ASSERT_EQ(count / 2, fired);
+  ASSERT_EQ(0u, wheel.Size());
+}